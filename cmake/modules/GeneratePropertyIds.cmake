@@ -0,0 +1,54 @@
+# Writes PropertyIds.h: one enum per element class, numbering its own
+# Q_PROPERTY declarations in the order they appear. That is the order moc
+# uses, so an id is just QMetaProperty::propertyIndex() minus the class's
+# propertyOffset(). Testing::propertyIdsTest() makes sure the two agree.
+#
+# Usage: cmake -DSRCDIR=<src> -DOUTPUT=<PropertyIds.h> -P GeneratePropertyIds.cmake
+
+SET( ELEMENTS
+   "BeerXMLElement:BeerXMLElement.h"
+   "BrewNote:brewnote.h"
+   "Equipment:equipment.h"
+   "Fermentable:fermentable.h"
+   "Hop:hop.h"
+   "Instruction:instruction.h"
+   "Mash:mash.h"
+   "MashStep:mashstep.h"
+   "Misc:misc.h"
+   "Recipe:recipe.h"
+   "Style:style.h"
+   "Water:water.h"
+   "Yeast:yeast.h"
+)
+
+SET( _out "// Generated from the Q_PROPERTY declarations by\n// cmake/modules/GeneratePropertyIds.cmake. Edit the headers, not this.\n\n" )
+SET( _out "${_out}#ifndef _PROPERTYIDS_H\n#define _PROPERTYIDS_H\n\nnamespace PropertyIds {\n" )
+
+FOREACH( _element ${ELEMENTS} )
+   STRING( REPLACE ":" ";" _pair ${_element} )
+   LIST( GET _pair 0 _class )
+   LIST( GET _pair 1 _header )
+
+   FILE( STRINGS "${SRCDIR}/${_header}" _lines REGEX "Q_PROPERTY" )
+   SET( _ids "" )
+   SET( _names "" )
+   FOREACH( _line ${_lines} )
+      # Commented out ones start with //, and don't match
+      IF( _line MATCHES "^[ \t]*Q_PROPERTY[ \t]*\\([ \t]*[^ \t]+[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]+READ" )
+         SET( _ids "${_ids}         ${CMAKE_MATCH_1},\n" )
+         SET( _names "${_names}         \"${CMAKE_MATCH_1}\",\n" )
+      ENDIF()
+   ENDFOREACH()
+
+   SET( _out "${_out}   //! ${_class}, from ${_header}\n   namespace ${_class} {\n" )
+   SET( _out "${_out}      enum Id {\n${_ids}         count\n      };\n" )
+   SET( _out "${_out}      static const char* const names[] = {\n${_names}         0\n      };\n   }\n" )
+ENDFOREACH()
+
+SET( _out "${_out}}\n\n#endif /* _PROPERTYIDS_H */\n" )
+
+# Only touch the real file when something changed, or everything that
+# includes it gets rebuilt for nothing
+FILE( WRITE "${OUTPUT}.tmp" "${_out}" )
+EXECUTE_PROCESS( COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}" )
+FILE( REMOVE "${OUTPUT}.tmp" )
@@ -18,9 +18,30 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <cmath>
+#include <QVector>
 #include "Algorithms.h"
 #include "PhysicalConstants.h"
 
+namespace
+{
+   // Everything past about 47 SRM is black anyway
+   double const srmTableMax = 50.0;
+   // Entries per SRM
+   int const srmTableSteps = 100;
+
+   QVector<QRgb> makeSrmTable()
+   {
+      int size = qRound(srmTableMax * srmTableSteps) + 1;
+      QVector<QRgb> table(size);
+      int i;
+
+      for( i = 0; i < size; ++i )
+         table[i] = Algorithms::srmToColorExact(i / (double)srmTableSteps).rgb();
+
+      return table;
+   }
+}
+
 Polynomial Algorithms::platoFromSG_20C20C(
    Polynomial() << -616.868 << 1111.14 << -630.272 << 135.997
 );
@@ -37,6 +58,49 @@ double Algorithms::round(double d)
    return floor(d+0.5);
 }
 
+QColor Algorithms::srmToColor(double srm)
+{
+   // Made by whoever asks first. The compiler sees to the locking
+   static QVector<QRgb> const table = makeSrmTable();
+
+   // Off the end of the table (or not a number). Rare enough to just work out
+   if( !(srm >= 0.0 && srm <= srmTableMax) )
+      return srmToColorExact(srm);
+
+   return QColor(table[qRound(srm * srmTableSteps)]);
+}
+
+QColor Algorithms::ebcToColor(double ebc)
+{
+   // Same conversion as EBCUnit::toSI()
+   return srmToColor(ebc * 12.7 / 25.0);
+}
+
+QColor Algorithms::srmToColorExact(double srm)
+{
+   QColor ret;
+   
+   //==========My approximation from a photo and spreadsheet===========
+   //double red = 232.9 * pow( (double)0.93, srm );
+   //double green = (double)-106.25 * log(srm) + 280.9;
+   //
+   //int r = (int)Algorithms::round(red);
+   //int g = (int)Algorithms::round(green);
+   //int b = 0;
+   
+   // Philip Lee's approximation from a color swatch and curve fitting.
+   int r = 0.5 + (272.098 - 5.80255*srm); if( r > 253.0 ) r = 253.0;
+   int g = (srm > 35)? 0 : 0.5 + (2.41975e2 - 1.3314e1*srm + 1.881895e-1*srm*srm);
+   int b = 0.5 + (179.3 - 28.7*srm);
+   
+   r = (r < 0) ? 0 : ((r > 255)? 255 : r);
+   g = (g < 0) ? 0 : ((g > 255)? 255 : g);
+   b = (b < 0) ? 0 : ((b > 255)? 255 : b);
+   ret.setRgb( r, g, b );
+
+   return ret;
+}
+
 double Algorithms::hydrometer15CCorrection( double celsius )
 {
    return hydroCorrection15CPoly.eval(celsius) * 1e-3;
@@ -99,6 +99,28 @@ public:
 
       return ret;
    }
+
+   /*!
+    * \brief Evaluate the polynomial at each of the \c n points in \c x
+    *
+    * Sums the terms in the same order as eval(), so the answers are the same
+    * to the last bit, just with the loop over points on the inside.
+    */
+   void eval(double const* x, size_t n, double* ret) const
+   {
+      size_t i, j;
+
+      for( j = 0; j < n; ++j )
+         ret[j] = 0.0;
+      for( i = order(); i > 0; --i )
+      {
+         double const c = _coeffs[i];
+         for( j = 0; j < n; ++j )
+            ret[j] += c * intPow( x[j], i );
+      }
+      for( j = 0; j < n; ++j )
+         ret[j] += _coeffs[0];
+   }
    
    /*!
     * \brief Root-finding by the secant method.
@@ -190,31 +212,15 @@ public:
 
    /*!
     * \brief Return the approximate color for a given SRM value
+    *
+    * Looked up in a table, to the nearest hundredth of an SRM, so the
+    * trees and tables can ask for every row they paint.
     */
-   static QColor srmToColor(double srm)
-   {
-      QColor ret;
-      
-      //==========My approximation from a photo and spreadsheet===========
-      //double red = 232.9 * pow( (double)0.93, srm );
-      //double green = (double)-106.25 * log(srm) + 280.9;
-      //
-      //int r = (int)Algorithms::round(red);
-      //int g = (int)Algorithms::round(green);
-      //int b = 0;
-      
-      // Philip Lee's approximation from a color swatch and curve fitting.
-      int r = 0.5 + (272.098 - 5.80255*srm); if( r > 253.0 ) r = 253.0;
-      int g = (srm > 35)? 0 : 0.5 + (2.41975e2 - 1.3314e1*srm + 1.881895e-1*srm*srm);
-      int b = 0.5 + (179.3 - 28.7*srm);
-      
-      r = (r < 0) ? 0 : ((r > 255)? 255 : r);
-      g = (g < 0) ? 0 : ((g > 255)? 255 : g);
-      b = (b < 0) ? 0 : ((b > 255)? 255 : b);
-      ret.setRgb( r, g, b );
-
-      return ret;
-   }
+   static QColor srmToColor(double srm);
+   //! \brief srmToColor() for a color in \b ebc
+   static QColor ebcToColor(double ebc);
+   //! \brief The curve fit itself, which srmToColor()'s table is made from
+   static QColor srmToColorExact(double srm);
    
    /*!
     * \brief Given dissolved sugar and wort volume, get SG in Plato
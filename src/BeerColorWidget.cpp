@@ -19,6 +19,7 @@
 
 #include <QWidget>
 #include <QPixmap>
+#include <QPixmapCache>
 #include <QPaintEvent>
 #include <QPainter>
 #include <QRect>
@@ -65,20 +66,44 @@ void BeerColorWidget::parseChanges(QMetaProperty, QVariant)
 void BeerColorWidget::paintEvent(QPaintEvent *)
 {
    QPainter painter(this);
-   QRect rect;
 
    int x1 = (size().width() - 90) / 2;
    int y1 = 0;
-   rect.setCoords( x1, y1, x1+87, y1+130 );
-   painter.setBrush(color);
+
+   painter.drawPixmap( QPoint(x1,y1), swatch(color) );
+}
+
+QPixmap BeerColorWidget::swatch( QColor const& c ) const
+{
+   QString key = QString("BeerColorWidget:%1").arg(c.rgba(), 0, 16);
+   QPixmap ret;
+
+   if( QPixmapCache::find(key, &ret) )
+      return ret;
+
+   // The rectangle's outline takes a pixel past its corner
+   ret = QPixmap( glass.size().expandedTo(QSize(89,131)) );
+   ret.fill(Qt::transparent);
+
+   QPainter painter(&ret);
+   QRect rect;
+   rect.setCoords( 0, 0, 87, 130 );
+   painter.setBrush(c);
    painter.drawRect(rect);
+   painter.drawImage( QPoint(0,0), glass );
+   painter.end();
 
-   painter.drawImage( QPoint(x1,y1), glass );
+   QPixmapCache::insert(key, ret);
+   return ret;
 }
 
 void BeerColorWidget::setColor( QColor newColor )
 {
+   // Most recipe changes don't touch the color at all
+   if( newColor == color )
+      return;
+
    color = QColor(newColor);
    
-   repaint();
+   update();
 }
@@ -27,6 +27,7 @@ class BeerColorWidget;
 #include <QColor>
 #include <QPaintEvent>
 #include <QImage>
+#include <QPixmap>
 #include <QMetaProperty>
 #include <QVariant>
 #include "recipe.h"
@@ -57,6 +58,8 @@ protected:
 private:
    QImage glass;
    void showColor();
+   //! The glass filled with \b c. Kept in QPixmapCache, one per color
+   QPixmap swatch( QColor const& c ) const;
    
    Recipe* recObs;
 };
@@ -258,11 +258,25 @@ void BeerXMLElement::set( const char* prop_name, const char* col_name, QVariant
    }
 }
 
+void BeerXMLElement::set( int prop_id, const char* col_name, QVariant const& value, bool notify )
+{
+   if ( col_name != NULL )
+   {
+      QMetaProperty prop = metaObject()->property(metaObject()->propertyOffset() + prop_id);
+      Database::instance().updateEntry( _table, _key, col_name, value, prop, this, notify );
+   }
+}
+
 QVariant BeerXMLElement::get( const char* col_name ) const
 {
    return Database::instance().get( _table, _key, col_name );
 }
 
+QVector<QVariant> BeerXMLElement::get( QVector<const char*> const& col_names ) const
+{
+   return Database::instance().get( _table, _key, col_names );
+}
+
 void BeerXMLElement::setInventory( const char* prop_name, const char* col_name, QVariant const& value, bool notify )
 {
     // Get the meta property.
@@ -277,15 +291,21 @@ void BeerXMLElement::setInventory( const char* prop_name, const char* col_name,
     Database::instance().updateEntry( invtable, invkey, col_name, value, metaObject()->property(ndx), this, notify );
 }
 
-QVariant BeerXMLElement::getInventory( const char* col_name ) const
+void BeerXMLElement::setInventory( int prop_id, const char* col_name, QVariant const& value, bool notify )
 {
    int invkey = Database::instance().getInventoryID(_table, _key);
    Brewtarget::DBTable invtable = Database::instance().getInventoryTable(_table);
-   QVariant val = 0.0;
-   if(invkey != 0){
-      val = Database::instance().get( invtable , invkey, col_name );
+   if(invkey == 0){ //no inventory row in the database so lets make one
+     Database::instance().newInventory(_table,_key);
+     invkey = Database::instance().getInventoryID(_table, _key);
    }
-   return val;
+   QMetaProperty prop = metaObject()->property(metaObject()->propertyOffset() + prop_id);
+   Database::instance().updateEntry( invtable, invkey, col_name, value, prop, this, notify );
+}
+
+QVariant BeerXMLElement::getInventory( const char* col_name ) const
+{
+   return Database::instance().getInventory(_table, _key, col_name);
 }
 
 bool BeerXMLElement::isValid()
@@ -31,6 +31,7 @@
 #include <QMetaProperty>
 #include <QVariant>
 #include <QDateTime>
+#include <QVector>
 #include "brewtarget.h"
 // For uintptr_t.
 #if HAVE_STDINT_H
@@ -97,6 +98,18 @@ public:
    //! Convenience method to get a meta property by name.
    QMetaProperty metaProperty(QString const& name) const;
 
+   /*!
+    * \returns \c prop as one of T's PropertyIds, or -1 if \c prop isn't
+    * declared by T itself (inherited ones included). Lets the listeners
+    * switch on an int instead of comparing strings.
+    */
+   template<class T> static int propertyId( QMetaProperty const& prop )
+   {
+      int id = prop.propertyIndex() - T::staticMetaObject.propertyOffset();
+      int count = T::staticMetaObject.propertyCount() - T::staticMetaObject.propertyOffset();
+      return (id >= 0 && id < count) ? id : -1;
+   }
+
    // Some static helpers to convert to/from text.
    static double getDouble( const QDomText& textNode );
    static bool getBool( const QDomText& textNode );
@@ -156,14 +169,22 @@ protected:
     * 2) Call the NOTIFY method associated with \c prop_name if \c notify == true.
     */
    void set( const char* prop_name, const char* col_name, QVariant const& value, bool notify = true );
+   /*!
+    * Same as above, but \c prop_id is one of the generated PropertyIds of
+    * the most derived class, so there is no name lookup to do.
+    */
+   void set( int prop_id, const char* col_name, QVariant const& value, bool notify = true );
 
    /*!
     * \param col_name - The database column of the attribute we want to get.
     * Returns the value of the attribute specified by key/table/col_name.
     */
    QVariant get( const char* col_name ) const;
+   //! Several columns of our row in one go, in the order asked for
+   QVector<QVariant> get( QVector<const char*> const& col_names ) const;
 
    void setInventory( const char* prop_name, const char* col_name, QVariant const& value, bool notify = true );
+   void setInventory( int prop_id, const char* col_name, QVariant const& value, bool notify = true );
    QVariant getInventory( const char* col_name ) const;
 
 private:
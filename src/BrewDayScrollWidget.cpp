@@ -33,6 +33,7 @@
 #include "style.h"
 #include "equipment.h"
 #include "mash.h"
+#include "PropertyIds.h"
 
 BrewDayScrollWidget::BrewDayScrollWidget(QWidget* parent)
    : QWidget(parent), doc(new QTextBrowser())
@@ -157,17 +158,8 @@ void BrewDayScrollWidget::print(QPrinter *mainPrinter, QPrintDialog* dialog,
          return;
    }
 
-   // Start building the document to be printed.  The HTML doesn't work with
-   // the image since it is a compiled resource
-   pDoc = buildTitleTable( action != HTML );
-   pDoc += buildInstructionTable();
-   pDoc += buildFooterTable();
-
-   pDoc += tr("<h2>Notes</h2>");
-   if ( recObs->notes() != "" )
-      pDoc += QString("<div id=\"customNote\">%1</div>\n").arg(recObs->notes());
-
-   pDoc += "</body></html>";
+   // The HTML doesn't work with the image since it is a compiled resource
+   pDoc = html(recObs, action != HTML);
 
    doc->setHtml(pDoc);
    if ( action == PREVIEW )
@@ -184,6 +176,24 @@ void BrewDayScrollWidget::print(QPrinter *mainPrinter, QPrintDialog* dialog,
    }
 }
 
+QString BrewDayScrollWidget::html(Recipe* rec, bool includeImage)
+{
+   QString pDoc;
+
+   // Start building the document to be printed.
+   pDoc = buildTitleTable(rec, includeImage);
+   pDoc += buildInstructionTable(rec);
+   pDoc += buildFooterTable();
+
+   pDoc += tr("<h2>Notes</h2>");
+   if ( rec->notes() != "" )
+      pDoc += QString("<div id=\"customNote\">%1</div>\n").arg(rec->notes());
+
+   pDoc += "</body></html>";
+
+   return pDoc;
+}
+
 void BrewDayScrollWidget::setRecipe(Recipe* rec)
 {
    // Disconnect old notifier.
@@ -235,7 +245,7 @@ void BrewDayScrollWidget::insertInstruction()
 
 void BrewDayScrollWidget::acceptChanges(QMetaProperty prop, QVariant /*value*/)
 {
-   if( recObs && QString(prop.name()) == "instructions" )
+   if( recObs && BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::instructions )
    {
       // An instruction has been added or deleted, so update internal list.
       foreach( Instruction* ins, recIns )
@@ -249,15 +259,15 @@ void BrewDayScrollWidget::acceptChanges(QMetaProperty prop, QVariant /*value*/)
 
 void BrewDayScrollWidget::acceptInsChanges(QMetaProperty prop, QVariant /*value*/)
 {
-   QString propName = prop.name();
+   int propId = BeerXMLElement::propertyId<Instruction>(prop);
    
-   if( propName == "instructionNumber" )
+   if( propId == PropertyIds::Instruction::instructionNumber )
    {
       // The order changed, so resort our internal list.
       qSort( recIns.begin(), recIns.end(), insPtrLtByNumber );
       showChanges();
    }
-   else if( propName == "directions" )
+   else if( propId == PropertyIds::Instruction::directions )
    {
       // This will make the displayed text directions update.
       listWidget->setCurrentRow( listWidget->currentRow() );
@@ -298,11 +308,8 @@ void BrewDayScrollWidget::repopulateListWidget()
       listWidget->setCurrentRow(-1);
 }
 
-QString BrewDayScrollWidget::getCSS() 
+static QString readCSS(QString const& cssName)
 {
-   if ( cssName == NULL )
-       cssName = ":/css/brewday.css";
-
    QFile cssInput(cssName);
    QString css;
 
@@ -316,6 +323,13 @@ QString BrewDayScrollWidget::getCSS()
    return css;
 }
 
+QString BrewDayScrollWidget::getCSS() 
+{
+   // It's compiled in, so it isn't changing between sheets
+   static const QString css = readCSS(":/css/brewday.css");
+   return css;
+}
+
 static QString styleName(Style* style)
 {
    if ( ! style )
@@ -340,7 +354,7 @@ static QString boilTime(Equipment* equipment)
    }
 }
 
-QString BrewDayScrollWidget::buildTitleTable(bool includeImage)
+QString BrewDayScrollWidget::buildTitleTable(Recipe* rec, bool includeImage)
 {
    QString header;
    QString body;
@@ -351,7 +365,7 @@ QString BrewDayScrollWidget::buildTitleTable(bool includeImage)
    header += "</style></head>";
 
    body   = "<body>";
-   body += QString("<h1>%1</h1>").arg(recObs->name());
+   body += QString("<h1>%1</h1>").arg(rec->name());
    if ( includeImage )
       body += QString("<img src=\"%1\" />").arg("qrc:/images/title.svg");
 
@@ -361,7 +375,7 @@ QString BrewDayScrollWidget::buildTitleTable(bool includeImage)
    body += QString("<tr><td class=\"left\">%1</td>")
          .arg(tr("Style"));
    body += QString("<td class=\"value\">%1</td>")
-           .arg(styleName(recObs->style()));
+           .arg(styleName(rec->style()));
    body += QString("<td class=\"right\">%1</td>")
          .arg(tr("Date"));
    body += QString("<td class=\"value\">%1</td></tr>")
@@ -370,37 +384,37 @@ QString BrewDayScrollWidget::buildTitleTable(bool includeImage)
    // second row:  boil time and efficiency.  
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
             .arg(tr("Boil Time"))
-            .arg(boilTime(recObs->equipment()))
+            .arg(boilTime(rec->equipment()))
             .arg(tr("Efficiency"))
-            .arg(Brewtarget::displayAmount(recObs->efficiency_pct(),0,0));
+            .arg(Brewtarget::displayAmount(rec->efficiency_pct(),0,0));
 
    // third row: pre-Boil Volume and Preboil Gravity
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
             .arg(tr("Boil Volume"))
-            .arg(Brewtarget::displayAmount(recObs->boilVolume_l(), "tab_recipe", "boilVolume_l", Units::liters,2))
+            .arg(Brewtarget::displayAmount(rec->boilVolume_l(), "tab_recipe", "boilVolume_l", Units::liters,2))
             .arg(tr("Preboil Gravity"))
-            .arg(Brewtarget::displayAmount(recObs->boilGrav(), "tab_recipe", "og", Units::sp_grav, 3));
+            .arg(Brewtarget::displayAmount(rec->boilGrav(), "tab_recipe", "og", Units::sp_grav, 3));
 
    // fourth row: Final volume and starting gravity
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
             .arg(tr("Final Volume"))
-            .arg(Brewtarget::displayAmount(recObs->finalVolume_l(), "tab_recipe", "finalVolume_l", Units::liters,2))
+            .arg(Brewtarget::displayAmount(rec->finalVolume_l(), "tab_recipe", "finalVolume_l", Units::liters,2))
             .arg(tr("Starting Gravity"))
-            .arg(Brewtarget::displayAmount(recObs->og(), "tab_recipe", "og", Units::sp_grav, 3));
+            .arg(Brewtarget::displayAmount(rec->og(), "tab_recipe", "og", Units::sp_grav, 3));
 
    // fifth row: IBU and Final gravity
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</tr>")
             .arg(tr("IBU"))
-            .arg( Brewtarget::displayAmount(recObs->IBU(),0,1))
+            .arg( Brewtarget::displayAmount(rec->IBU(),0,1))
             .arg(tr("Final Gravity"))
-            .arg(Brewtarget::displayAmount(recObs->fg(), "tab_recipe", "fg", Units::sp_grav, 3));
+            .arg(Brewtarget::displayAmount(rec->fg(), "tab_recipe", "fg", Units::sp_grav, 3));
 
    // sixth row: ABV and estimate calories
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td><td class=\"right\">%3</td><td class=\"value\">%4</tr>")
             .arg(tr("ABV"))
-            .arg( Brewtarget::displayAmount(recObs->ABV_pct(),0,1) )
+            .arg( Brewtarget::displayAmount(rec->ABV_pct(),0,1) )
             .arg( Brewtarget::getVolumeUnitSystem() == SI ? tr("Estimated calories (per 33 cl)") : tr("Estimated calories (per 12 oz)"))
-            .arg( Brewtarget::displayAmount(Brewtarget::getVolumeUnitSystem() == SI ? recObs->calories33cl() : recObs->calories12oz(),0,0) );
+            .arg( Brewtarget::displayAmount(Brewtarget::getVolumeUnitSystem() == SI ? rec->calories33cl() : rec->calories12oz(),0,0) );
 
    body += "</table>";
 
@@ -408,7 +422,7 @@ QString BrewDayScrollWidget::buildTitleTable(bool includeImage)
 
 }
 
-QString BrewDayScrollWidget::buildInstructionTable()
+QString BrewDayScrollWidget::buildInstructionTable(Recipe* rec)
 {
    QString middle;
    int i, j, size;
@@ -420,8 +434,7 @@ QString BrewDayScrollWidget::buildInstructionTable()
          .arg(tr("Time"))
          .arg(tr("Step"));
 
-   QList<Instruction*> instructions = recObs->instructions();
-   QList<MashStep*> mashSteps = recObs->mash()->mashSteps();
+   QList<Instruction*> instructions = rec->instructions();
    size = instructions.size();
    for( i = 0; i < size; ++i )
    {
@@ -440,9 +453,9 @@ QString BrewDayScrollWidget::buildInstructionTable()
       // TODO: comparing ins->name() with these untranslated strings means this
       // doesn't work in other languages. Find a better way.
       if ( ins->name() == tr("Add grains") )
-         reagents = recObs->getReagents( recObs->fermentables() );
-      else if ( ins->name() == tr("Heat water") )
-         reagents = recObs->getReagents( recObs->mash()->mashSteps() );
+         reagents = rec->getReagents( rec->fermentables() );
+      else if ( ins->name() == tr("Heat water") && rec->mash() )
+         reagents = rec->getReagents( rec->mash()->mashSteps() );
       else 
          reagents = ins->reagents();
 
@@ -57,6 +57,11 @@ public:
     *  Should be moved to its own view class.
     */
    void print(QPrinter* mainPrinter, QPrintDialog *dialog, int action = PRINT, QFile* outFile = 0);
+   /*!
+    * \brief The brew sheet print() makes of \b rec. Doesn't need the widget,
+    * so PrintPipeline can make a week's worth without one.
+    */
+   static QString html(Recipe* rec, bool includeImage = true);
 
 public slots:
    //! Automatically generate a new list of instructions.
@@ -83,10 +88,10 @@ private:
    void repopulateListWidget();
    void clear();
    
-   QString buildTitleTable(bool includeImage = true);
-   QString buildInstructionTable();
-   QString buildFooterTable();
-   QString getCSS();
+   static QString buildTitleTable(Recipe* rec, bool includeImage = true);
+   static QString buildInstructionTable(Recipe* rec);
+   static QString buildFooterTable();
+   static QString getCSS();
    
    Recipe* recObs;
    QPrinter* printer;
@@ -94,8 +99,6 @@ private:
    //! Internal list of recipe instructions, always sorted by instruction number.
    QList<Instruction*> recIns;
 
-   QString cssName;
-
 private slots:
    bool loadComplete(bool ok);
    void showInstruction(int insNdx);
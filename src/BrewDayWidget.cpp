@@ -34,6 +34,7 @@
 #include "BrewDayWidget.h"
 #include "recipe.h"
 #include "style.h"
+#include "PropertyIds.h"
 
 // NOTE: QPrinter has no parent? Will it get destroyed properly?
 BrewDayWidget::BrewDayWidget(QWidget* parent) :
@@ -350,7 +351,7 @@ void BrewDayWidget::setRecipe(Recipe* rec)
 void BrewDayWidget::changed(QMetaProperty prop, QVariant /*val*/)
 {
    if( sender() == recObs &&
-       QString(prop.name()) == "instructions")
+       BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::instructions)
       showChanges();
 }
 
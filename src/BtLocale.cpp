@@ -0,0 +1,123 @@
+/*
+ * BtLocale.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BtLocale.h"
+#include <QByteArray>
+
+// Anything longer than this isn't somebody typing a number
+static const int maxPlainLength = 48;
+
+QThreadStorage<BtLocale::Cache*> BtLocale::caches;
+QAtomicInt BtLocale::generation(1);
+
+BtLocale::Cache const& BtLocale::cache()
+{
+   if ( ! caches.hasLocalData() ) {
+      Cache* fresh = new Cache;
+      fresh->generation = 0;
+      caches.setLocalData(fresh);
+   }
+
+   Cache* c = caches.localData();
+   int current = generation.load();
+   if ( c->generation != current ) {
+      c->locale = QLocale();
+      c->decimal = c->locale.decimalPoint();
+      c->plain = c->locale.zeroDigit() == QChar('0')
+                 && c->locale.negativeSign() == QChar('-')
+                 && c->locale.positiveSign() == QChar('+')
+                 && c->decimal.unicode() < 128;
+      c->generation = current;
+   }
+   return *c;
+}
+
+void BtLocale::localeChanged()
+{
+   generation.ref();
+}
+
+bool BtLocale::plainDecimal( QString const& text, QChar decimal, double* ret )
+{
+   int n = text.size();
+   char buf[maxPlainLength + 1];
+   bool digits = false;
+   bool point = false;
+   QChar const* ch = text.constData();
+
+   if ( n == 0 || n > maxPlainLength )
+      return false;
+
+   for ( int i = 0; i < n; ++i ) {
+      ushort u = ch[i].unicode();
+
+      if ( u >= '0' && u <= '9' ) {
+         buf[i] = static_cast<char>(u);
+         digits = true;
+      }
+      else if ( i == 0 && (u == '-' || u == '+') )
+         buf[i] = static_cast<char>(u);
+      // Digits on both sides. ".5" and "5." are QLocale's call
+      else if ( ch[i] == decimal && ! point && digits && i+1 < n ) {
+         buf[i] = '.';
+         point = true;
+      }
+      else // Group separators, exponents, spaces: QLocale knows best
+         return false;
+   }
+
+   if ( ! digits )
+      return false;
+
+   bool ok = false;
+   *ret = QByteArray::fromRawData(buf, n).toDouble(&ok);
+   return ok;
+}
+
+/* Qt5 changed how QString::toDouble() works in that it will always convert
+   in the C locale. We are instructed to use QLocale::toDouble instead, except
+   that will never fall back to the C locale. So we try both, in that order.
+*/
+double BtLocale::toDouble( QString const& text, bool* ok )
+{
+   Cache const& c = cache();
+   double ret = 0.0;
+   bool success = false;
+
+   // Whatever the locale's decimal point is, a plain number written with it
+   // means the same to QLocale as it does to us.
+   if ( c.plain && plainDecimal(text, c.decimal, &ret) )
+      success = true;
+   else {
+      ret = c.locale.toDouble(text, &success);
+
+      // If we failed, try C conversion
+      if ( ! success )
+         ret = text.toDouble(&success);
+   }
+
+   if ( ok != 0 )
+      *ok = success;
+
+   return ret;
+}
+
+QString BtLocale::toString( double value, char format, int precision )
+{
+   return cache().locale.toString(value, format, precision);
+}
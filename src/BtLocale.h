@@ -0,0 +1,75 @@
+/*
+ * BtLocale.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BTLOCALE_H
+#define _BTLOCALE_H
+
+#include <QString>
+#include <QChar>
+#include <QLocale>
+#include <QAtomicInt>
+#include <QThreadStorage>
+
+/*!
+ * \class BtLocale
+ *
+ * \brief Reads and writes numbers the way the user's locale likes them,
+ * without building a QLocale every time.
+ *
+ * Each thread keeps its own copy of the default QLocale and the few
+ * characters we care about. They are rebuilt when localeChanged() says so,
+ * which whoever changes the locale has to call.
+ */
+class BtLocale
+{
+public:
+   /*!
+    * \brief Same as Brewtarget::toDouble(QString,bool*): the locale's way
+    * first, then the C way.
+    *
+    * Plain "123", "-1.5" (or "-1,5", if that is the locale's decimal point)
+    * never go near QLocale.
+    */
+   static double toDouble( QString const& text, bool* ok = 0 );
+
+   //! \brief Same as QString("%L1").arg(value, 0, format, precision)
+   static QString toString( double value, char format = 'f', int precision = 3 );
+
+   //! \brief Throws away every thread's cached locale
+   static void localeChanged();
+
+private:
+   struct Cache
+   {
+      QLocale locale;
+      QChar decimal;
+      //! The fast path only knows ASCII digits and signs
+      bool plain;
+      int generation;
+   };
+
+   static QThreadStorage<Cache*> caches;
+   //! Bumped by localeChanged(). Stale caches have a different one
+   static QAtomicInt generation;
+
+   static Cache const& cache();
+   //! Parses optional sign, digits and one decimal point, or gives up
+   static bool plainDecimal( QString const& text, QChar decimal, double* ret );
+};
+
+#endif /* _BTLOCALE_H */
@@ -23,329 +23,244 @@
 #include "BtTreeFilterProxyModel.h"
 #include "BtTreeModel.h"
 #include "BtTreeItem.h"
+#include "MemoryAccounting.h"
 
 BtTreeFilterProxyModel::BtTreeFilterProxyModel(QObject *parent,BtTreeModel::TypeMasks mask ) 
 : QSortFilterProxyModel(parent),
    treeMask(mask)
 {
+   MemoryAccounting::addSource(this, [this]() {
+      qint64 bytes = 0;
+      foreach( QVector<QVariant> const& keys, sortKeys )
+         bytes += MemoryAccounting::hashNodeBytes< QObject*, QVector<QVariant> >() + keys.capacity() * sizeof(QVariant);
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Trees", "cached sort keys", sortKeys.size(), bytes );
+   });
+}
+
+BtTreeFilterProxyModel::~BtTreeFilterProxyModel()
+{
+   MemoryAccounting::removeSources(this);
 }
 
 bool BtTreeFilterProxyModel::lessThan(const QModelIndex &left, 
                                          const QModelIndex &right) const
 {
-
    BtTreeModel* model = qobject_cast<BtTreeModel*>(sourceModel());
-   switch( treeMask )
-   {
-      case BtTreeModel::RECIPEMASK:
-        return lessThanRecipe(model,left, right);
-      case BtTreeModel::EQUIPMASK:
-        return lessThanEquip(model,left, right);
-      case BtTreeModel::FERMENTMASK:
-        return lessThanFerment(model,left, right);
-      case BtTreeModel::HOPMASK:
-        return lessThanHop(model,left, right);
-      case BtTreeModel::MISCMASK:
-        return lessThanMisc(model,left, right);
-      case BtTreeModel::YEASTMASK:
-        return lessThanYeast(model,left, right);
-      case BtTreeModel::STYLEMASK:
-        return lessThanStyle(model,left, right);
-      default:
-        return lessThanRecipe(model,left, right);
 
-    }
-}
-
-bool BtTreeFilterProxyModel::lessThanRecipe(BtTreeModel* model, const QModelIndex &left, const QModelIndex &right) const
-{
    // This is a little awkward.
    if ( model->type(left) == BtTreeItem::BREWNOTE ||
         model->type(right) == BtTreeItem::BREWNOTE )
       return false;
 
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::RECIPE)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Recipe*  rightRecipe = model->recipe(right);
-
-      return leftFolder->fullPath() < rightRecipe->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::RECIPE)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      Recipe*  leftRecipe = model->recipe(left);
-      return leftRecipe->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
-   }
+   // As the models get more complex, so does the sort algorithm. Folders
+   // sort by path against anything, and things only sort by column against
+   // other things.
+   if ( model->type(left) == BtTreeItem::FOLDER || model->type(right) == BtTreeItem::FOLDER )
+      return nameKey(model,left) < nameKey(model,right);
 
+   BeerXMLElement* leftThing = model->thing(left);
+   BeerXMLElement* rightThing = model->thing(right);
+   if ( ! leftThing || ! rightThing )
+      return false;
 
-   Recipe* leftRecipe  = model->recipe(left);
-   Recipe* rightRecipe = model->recipe(right);
+   return lessThan( sortKey(leftThing, left.column()), sortKey(rightThing, left.column()) );
+}
 
-   switch(left.column())
+bool BtTreeFilterProxyModel::lessThan(QVariant const& left, QVariant const& right)
+{
+   // Both keys came from the same sortKey*() for the same column, so they
+   // have the same type.
+   switch( left.type() )
    {
-      case BtTreeItem::RECIPENAMECOL:
-         return leftRecipe->name() < rightRecipe->name();
-      case BtTreeItem::RECIPEBREWDATECOL:
-         return leftRecipe->date() < rightRecipe->date();
-      case BtTreeItem::RECIPESTYLECOL:
-         if ( ! leftRecipe->style() )
-            return true;
-         else if ( ! rightRecipe->style() )
-            return false;
-         else
-            return leftRecipe->style()->name() < rightRecipe->style()->name();
+      case QVariant::String:
+         return left.toString() < right.toString();
+      case QVariant::Date:
+         return left.toDate() < right.toDate();
+      default:
+         return left.toDouble() < right.toDouble();
    }
-   // Default will be to just do a name sort. This doesn't likely make sense,
-   // but it will prevent a lot of warnings.
-   return leftRecipe->name() < rightRecipe->name();
 }
 
-bool BtTreeFilterProxyModel::lessThanEquip(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+QString BtTreeFilterProxyModel::nameKey(BtTreeModel* model, const QModelIndex &index) const
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::EQUIPMENT)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Equipment*  rightEquipment = model->equipment(right);
+   // Folders cache their own path and things cache their own name, so there
+   // is nothing to be gained by putting these in sortKeys
+   if ( model->type(index) == BtTreeItem::FOLDER )
+      return model->folder(index)->fullPath();
 
-      return leftFolder->fullPath() < rightEquipment->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::EQUIPMENT)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      Equipment*  leftEquipment = model->equipment(left);
-      return leftEquipment->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
+   BeerXMLElement* thing = model->thing(index);
+   return thing ? thing->name() : QString();
+}
+
+QVariant BtTreeFilterProxyModel::sortKey(BeerXMLElement* thing, int column) const
+{
+   QHash< QObject*, QVector<QVariant> >::iterator keys = sortKeys.find(thing);
+
+   if ( keys == sortKeys.end() )
    {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
+      keys = sortKeys.insert(thing, QVector<QVariant>());
+      // set() emits changed() before anything else gets told, so the key is
+      // gone before the view asks us to resort.
+      connect( thing, SIGNAL(changed(QMetaProperty,QVariant)), this, SLOT(invalidateSortKeys()), Qt::UniqueConnection );
+      connect( thing, SIGNAL(destroyed()), this, SLOT(invalidateSortKeys()), Qt::UniqueConnection );
    }
 
-   Equipment* leftEquip = model->equipment(left);
-   Equipment* rightEquip = model->equipment(right);
+   if ( column < 0 )
+      column = 0;
 
+   if ( column < keys->size() && keys->at(column).isValid() )
+      return keys->at(column);
 
-   switch(left.column())
+   QVariant key;
+   switch( treeMask )
    {
-      case BtTreeItem::EQUIPMENTNAMECOL:
-         return leftEquip->name() < rightEquip->name();
-      case BtTreeItem::EQUIPMENTBOILTIMECOL:
-         return leftEquip->boilTime_min() < rightEquip->boilTime_min();
+      case BtTreeModel::EQUIPMASK:
+         key = sortKeyEquip(qobject_cast<Equipment*>(thing), column);
+         break;
+      case BtTreeModel::FERMENTMASK:
+         key = sortKeyFerment(qobject_cast<Fermentable*>(thing), column);
+         break;
+      case BtTreeModel::HOPMASK:
+         key = sortKeyHop(qobject_cast<Hop*>(thing), column);
+         break;
+      case BtTreeModel::MISCMASK:
+         key = sortKeyMisc(qobject_cast<Misc*>(thing), column);
+         break;
+      case BtTreeModel::YEASTMASK:
+         key = sortKeyYeast(qobject_cast<Yeast*>(thing), column);
+         break;
+      case BtTreeModel::STYLEMASK:
+         key = sortKeyStyle(qobject_cast<Style*>(thing), column);
+         break;
+      default:
+         key = sortKeyRecipe(qobject_cast<Recipe*>(thing), column);
    }
-   return leftEquip->name() < rightEquip->name();
+
+   // The sortKey*() methods fall back to the name for columns they don't
+   // understand, so an invalid key means we got handed the wrong thing.
+   if ( ! key.isValid() )
+      key = thing->name();
+
+   if ( column >= keys->size() )
+      keys->resize(column+1);
+   (*keys)[column] = key;
+
+   return key;
 }
 
-bool BtTreeFilterProxyModel::lessThanFerment(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+void BtTreeFilterProxyModel::invalidateSortKeys()
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::FERMENTABLE)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Fermentable*  rightFermentable = model->fermentable(right);
+   sortKeys.remove(sender());
+}
 
-      return leftFolder->fullPath() < rightFermentable->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FERMENTABLE)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      Fermentable*  leftFermentable = model->fermentable(left);
-      return leftFermentable->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
+QVariant BtTreeFilterProxyModel::sortKeyRecipe(Recipe* rec, int column) const
+{
+   if ( ! rec )
+      return QVariant();
+
+   switch(column)
    {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
+      case BtTreeItem::RECIPEBREWDATECOL:
+         return rec->date();
+      case BtTreeItem::RECIPESTYLECOL:
+         // No style sorts first
+         return rec->style() ? rec->style()->name() : QString();
    }
+   // Default will be to just do a name sort. This doesn't likely make sense,
+   // but it will prevent a lot of warnings.
+   return rec->name();
+}
 
-   Fermentable* leftFerment = model->fermentable(left);
-   Fermentable* rightFerment = model->fermentable(right);
+QVariant BtTreeFilterProxyModel::sortKeyEquip(Equipment* kit, int column) const
+{
+   if ( ! kit )
+      return QVariant();
 
-   switch(left.column())
+   switch(column)
    {
-      case BtTreeItem::FERMENTABLENAMECOL:
-         return leftFerment->name() < rightFerment->name();
-      case BtTreeItem::FERMENTABLETYPECOL:
-         return leftFerment->type() < rightFerment->type();
-      case BtTreeItem::FERMENTABLECOLORCOL:
-         return leftFerment->color_srm() < rightFerment->color_srm();
+      case BtTreeItem::EQUIPMENTBOILTIMECOL:
+         return kit->boilTime_min();
    }
-   return leftFerment->name() < rightFerment->name();
+   return kit->name();
 }
 
-bool BtTreeFilterProxyModel::lessThanHop(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+QVariant BtTreeFilterProxyModel::sortKeyFerment(Fermentable* ferm, int column) const
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::HOP)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Hop*  rightHop = model->hop(right);
+   if ( ! ferm )
+      return QVariant();
 
-      return leftFolder->fullPath() < rightHop->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::HOP)
+   switch(column)
    {
-      BtFolder* rightFolder = model->folder(right);
-      Hop*  leftHop = model->hop(left);
-      return leftHop->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
+      case BtTreeItem::FERMENTABLETYPECOL:
+         return static_cast<int>(ferm->type());
+      case BtTreeItem::FERMENTABLECOLORCOL:
+         return ferm->color_srm();
    }
+   return ferm->name();
+}
 
-   Hop* leftHop = model->hop(left);
-   Hop* rightHop = model->hop(right);
-
+QVariant BtTreeFilterProxyModel::sortKeyHop(Hop* hop, int column) const
+{
+   if ( ! hop )
+      return QVariant();
 
-   switch(left.column())
+   switch(column)
    {
-      case BtTreeItem::HOPNAMECOL:
-         return leftHop->name() < rightHop->name();
       case BtTreeItem::HOPFORMCOL:
-         return leftHop->form() < rightHop->form();
+         return static_cast<int>(hop->form());
       case BtTreeItem::HOPUSECOL:
-         return leftHop->use() < rightHop->use();
+         return static_cast<int>(hop->use());
    }
-   return leftHop->name() < rightHop->name();
+   return hop->name();
 }
 
-bool BtTreeFilterProxyModel::lessThanMisc(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+QVariant BtTreeFilterProxyModel::sortKeyMisc(Misc* misc, int column) const
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::MISC)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Misc*  rightMisc = model->misc(right);
+   if ( ! misc )
+      return QVariant();
 
-      return leftFolder->fullPath() < rightMisc->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::MISC)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      Misc*  leftMisc = model->misc(left);
-      return leftMisc->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
-   }
-
-   Misc* leftMisc = model->misc(left);
-   Misc* rightMisc = model->misc(right);
-
-   switch(left.column())
+   switch(column)
    {
-      case BtTreeItem::MISCNAMECOL:
-         return leftMisc->name() < rightMisc->name();
       case BtTreeItem::MISCTYPECOL:
-         return leftMisc->type() < rightMisc->type();
+         return static_cast<int>(misc->type());
       case BtTreeItem::MISCUSECOL:
-         return leftMisc->use() < rightMisc->use();
+         return static_cast<int>(misc->use());
    }
-   return leftMisc->name() < rightMisc->name();
+   return misc->name();
 }
 
-bool BtTreeFilterProxyModel::lessThanStyle(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+QVariant BtTreeFilterProxyModel::sortKeyStyle(Style* style, int column) const
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::STYLE)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Style*  rightStyle = model->style(right);
+   if ( ! style )
+      return QVariant();
 
-      return leftFolder->fullPath() < rightStyle->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::STYLE)
+   switch(column)
    {
-      BtFolder* rightFolder = model->folder(right);
-      Style*  leftStyle = model->style(left);
-      return leftStyle->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
-   }
-
-   Style* leftStyle = model->style(left);
-   Style* rightStyle = model->style(right);
-
-
-   switch(left.column())
-   {
-      case BtTreeItem::STYLENAMECOL:
-         return leftStyle->name() < rightStyle->name();
       case BtTreeItem::STYLECATEGORYCOL:
-         return leftStyle->category() < rightStyle->category();
+         return style->category();
       case BtTreeItem::STYLENUMBERCOL:
-         return leftStyle->categoryNumber() < rightStyle->categoryNumber();
+         return style->categoryNumber();
       case BtTreeItem::STYLELETTERCOL:
-         return leftStyle->styleLetter() < rightStyle->styleLetter();
+         return style->styleLetter();
       case BtTreeItem::STYLEGUIDECOL:
-         return leftStyle->styleGuide() < rightStyle->styleGuide();
+         return style->styleGuide();
    }
-   return leftStyle->name() < rightStyle->name();
+   return style->name();
 }
 
-bool BtTreeFilterProxyModel::lessThanYeast(BtTreeModel* model, const QModelIndex &left, 
-                                         const QModelIndex &right) const
+QVariant BtTreeFilterProxyModel::sortKeyYeast(Yeast* yeast, int column) const
 {
-   // As the models get more complex, so does the sort algorithm
-   if ( model->type(left) == BtTreeItem::FOLDER && model->type(right) == BtTreeItem::YEAST)
-   {
-      BtFolder* leftFolder = model->folder(left);
-      Yeast*  rightYeast = model->yeast(right);
-
-      return leftFolder->fullPath() < rightYeast->name();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::YEAST)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      Yeast*  leftYeast = model->yeast(left);
-      return leftYeast->name() < rightFolder->fullPath();
-   }
-   else if (model->type(right) == BtTreeItem::FOLDER && model->type(left) == BtTreeItem::FOLDER)
-   {
-      BtFolder* rightFolder = model->folder(right);
-      BtFolder* leftFolder = model->folder(left);
-      return leftFolder->fullPath() < rightFolder->fullPath();
-   }
-
-   Yeast* leftYeast = model->yeast(left);
-   Yeast* rightYeast = model->yeast(right);
-
+   if ( ! yeast )
+      return QVariant();
 
-   switch(left.column())
+   switch(column)
    {
-      case BtTreeItem::YEASTNAMECOL:
-         return leftYeast->name() < rightYeast->name();
       case BtTreeItem::YEASTTYPECOL:
-         return leftYeast->type() < rightYeast->type();
+         return static_cast<int>(yeast->type());
       case BtTreeItem::YEASTFORMCOL:
-         return leftYeast->form() < rightYeast->form();
+         return static_cast<int>(yeast->form());
    }
-   return leftYeast->name() < rightYeast->name();
+   return yeast->name();
 }
 
 bool BtTreeFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
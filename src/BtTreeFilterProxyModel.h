@@ -24,6 +24,9 @@
 class BtTreeFilterProxyModel;
 
 #include <QSortFilterProxyModel>
+#include <QHash>
+#include <QVector>
+#include <QVariant>
 
 #include "BtFolder.h"
 #include "BtTreeModel.h"
@@ -50,21 +53,36 @@ class BtTreeFilterProxyModel : public QSortFilterProxyModel
 
 public:
    BtTreeFilterProxyModel(QObject *parent, BtTreeModel::TypeMasks mask);
+   virtual ~BtTreeFilterProxyModel();
 
 protected:
    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
    bool filterAcceptsRow( int source_row, const QModelIndex &source_parent) const;
 
+private slots:
+   //! \brief drops the cached sort keys of whatever sent the signal
+   void invalidateSortKeys();
+
 private:
    BtTreeModel::TypeMasks treeMask;
+   //! \brief per-element sort keys, indexed by column. Filled on demand and
+   //  thrown away whenever the element says it changed.
+   mutable QHash< QObject*, QVector<QVariant> > sortKeys;
+
+   //! \brief returns the (cached) sort key for \c column of \c thing
+   QVariant sortKey(BeerXMLElement* thing, int column) const;
+   //! \brief full path of a folder, or name of a thing
+   QString nameKey(BtTreeModel* model, const QModelIndex &index) const;
+   //! \brief compares two keys built by sortKey()
+   static bool lessThan(QVariant const& left, QVariant const& right);
 
-   bool lessThanRecipe(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanEquip(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanFerment(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanMisc(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanHop(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanYeast(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanStyle(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
+   QVariant sortKeyRecipe(Recipe* rec, int column) const;
+   QVariant sortKeyEquip(Equipment* kit, int column) const;
+   QVariant sortKeyFerment(Fermentable* ferm, int column) const;
+   QVariant sortKeyMisc(Misc* misc, int column) const;
+   QVariant sortKeyHop(Hop* hop, int column) const;
+   QVariant sortKeyYeast(Yeast* yeast, int column) const;
+   QVariant sortKeyStyle(Style* style, int column) const;
 };
 
 #endif
@@ -185,6 +185,26 @@ bool BtTreeItem::removeChildren(int position, int count)
    return true;
 }
 
+BtTreeItem* BtTreeItem::takeChild(int position)
+{
+   if ( position < 0 || position >= childItems.count() )
+      return 0;
+
+   BtTreeItem* kid = childItems.takeAt(position);
+   kid->parentItem = 0;
+   return kid;
+}
+
+bool BtTreeItem::insertChild(int position, BtTreeItem* kid)
+{
+   if ( ! kid || position < 0 || position > childItems.size() )
+      return false;
+
+   childItems.insert(position, kid);
+   kid->parentItem = this;
+   return true;
+}
+
 QVariant BtTreeItem::dataRecipe( int column )
 {
    Recipe* recipe = qobject_cast<Recipe*>(_thing);
@@ -247,6 +247,11 @@ public:
    bool insertChildren(int position, int count, int _type = RECIPE);
    //! \brief removes \c count items starting at \c position
    bool removeChildren(int position, int count);
+   //! \brief removes the item at \c position without deleting it, and hands
+   // it back. The caller owns it until it is given to insertChild()
+   BtTreeItem* takeChild(int position);
+   //! \brief adopts \c kid as a child at \c position
+   bool insertChild(int position, BtTreeItem* kid);
 
    //! \brief returns the name. 
    QString name();
@@ -29,6 +29,7 @@
 
 #include "brewtarget.h"
 #include "BtTreeItem.h"
+#include "BtFolder.h"
 #include "BtTreeModel.h"
 #include "BtTreeView.h"
 #include "RecipeFormatter.h"
@@ -41,6 +42,9 @@
 #include "yeast.h"
 #include "brewnote.h"
 #include "style.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "ToolTipCache.h"
 
 // =========================================================================
 // ============================ CLASS STUFF ================================
@@ -113,11 +117,17 @@ BtTreeModel::BtTreeModel(BtTreeView *parent, TypeMasks type)
 
    treeMask = type;
    parentTree = parent;
-   loadTreeModel();
+   _loaded = false;
+   _toolTips = new ToolTipCache(this);
+   if ( ! (type & (FERMENTMASK|HOPMASK|MISCMASK|YEASTMASK)) )
+      ensureLoaded();
+
+   MemoryAccounting::addSource(this, [this]() { return memoryReport(); });
 }
 
 BtTreeModel::~BtTreeModel()
 {
+   MemoryAccounting::removeSources(this);
    delete rootItem;
    rootItem = NULL;
 }
@@ -215,11 +225,68 @@ QModelIndex BtTreeModel::parent(const QModelIndex &index) const
    return createIndex(pItem->childNumber(),0,pItem);
 }
 
+bool BtTreeModel::hasChildren(const QModelIndex &parent) const
+{
+   if ( canFetchMore(parent) )
+      return true;
+
+   return rowCount(parent) > 0;
+}
+
+bool BtTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+   return ! _loaded && parent.isValid() && item(parent) == rootItem->child(0);
+}
+
+void BtTreeModel::fetchMore(const QModelIndex &parent)
+{
+   if ( canFetchMore(parent) )
+      ensureLoaded();
+}
+
+void BtTreeModel::ensureLoaded()
+{
+   if ( _loaded )
+      return;
+
+   // set it first. Loading calls findFolder(), which calls us
+   _loaded = true;
+   loadTreeModel();
+}
+
+QList<MemoryAccounting::Entry> BtTreeModel::memoryReport() const
+{
+   qint64 items = 0;
+   qint64 folders = 0;
+   qint64 bytes = 0;
+
+   QList<BtTreeItem*> todo;
+   todo.append(rootItem);
+   while ( ! todo.isEmpty() ) {
+      BtTreeItem* here = todo.takeLast();
+      ++items;
+      // the item, and its slot in the parent's list
+      bytes += sizeof(BtTreeItem) + sizeof(void*);
+      if ( here->type() == BtTreeItem::FOLDER && here->folder() ) {
+         ++folders;
+         bytes += MemoryAccounting::objectBytes<BtFolder>() + MemoryAccounting::stringBytes(here->folder()->fullPath());
+      }
+      for ( int i = 0; i < here->childCount(); ++i )
+         todo.append(here->child(i));
+   }
+
+   return QList<MemoryAccounting::Entry>()
+      << MemoryAccounting::Entry( "Trees", QString("%1 items (%2 folders)").arg(_mimeType.section('-',-1)).arg(folders), items, bytes )
+      << MemoryAccounting::Entry( "Trees", QString("%1 tooltips").arg(_mimeType.section('-',-1)), _toolTips->size(), _toolTips->bytes() );
+}
+
 QModelIndex BtTreeModel::first()
 {
    QModelIndex parent;
    BtTreeItem* pItem; 
 
+   ensureLoaded();
+
    // get the first item in the list, which is the place holder
    pItem = rootItem->child(0);
    if ( pItem->childCount() > 0 )
@@ -286,24 +353,17 @@ QVariant BtTreeModel::data(const QModelIndex &index, int role) const
 
 QVariant BtTreeModel::toolTipData(const QModelIndex &index) const
 {
-   RecipeFormatter* whiskey = new RecipeFormatter();
-
    switch(treeMask)
    {
       case RECIPEMASK:
-         return whiskey->getToolTip(qobject_cast<Recipe*>(thing(index)));
       case STYLEMASK:
-         return whiskey->getToolTip( qobject_cast<Style*>(thing(index)));
       case EQUIPMASK:
-         return whiskey->getToolTip( qobject_cast<Equipment*>(thing(index)));
       case FERMENTMASK:
-         return whiskey->getToolTip( qobject_cast<Fermentable*>(thing(index)));
       case HOPMASK:
-         return whiskey->getToolTip( qobject_cast<Hop*>(thing(index)));
       case MISCMASK:
-         return whiskey->getToolTip( qobject_cast<Misc*>(thing(index)));
       case YEASTMASK:
-         return whiskey->getToolTip( qobject_cast<Yeast*>(thing(index)));
+         // Brewnotes and folders don't get one
+         return _toolTips->toolTip(thing(index));
       default:
          return item(index)->name();
    }
@@ -311,6 +371,25 @@ QVariant BtTreeModel::toolTipData(const QModelIndex &index) const
 
 }
 
+void BtTreeModel::prefetchToolTips(QModelIndexList const& indexes)
+{
+   QList<BeerXMLElement*> elems;
+
+   foreach( QModelIndex const& ndx, indexes )
+   {
+      BeerXMLElement* elem = thing(ndx);
+      if ( elem )
+         elems.append(elem);
+   }
+
+   _toolTips->prefetch(elems);
+}
+
+ToolTipCache* BtTreeModel::toolTips() const
+{
+   return _toolTips;
+}
+
 // This is much better, assuming the rest can be made to work
 QVariant BtTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
@@ -518,6 +597,8 @@ QModelIndex BtTreeModel::findElement(BeerXMLElement* thing, BtTreeItem* parent)
 
    int i;
 
+   ensureLoaded();
+
    if ( parent == NULL )
       pItem = rootItem->child(0);
    else
@@ -589,6 +670,7 @@ QList<BeerXMLElement*> BtTreeModel::elements()
 
 void BtTreeModel::loadTreeModel()
 {
+   TraceSpan span("BtTreeModel::loadTreeModel", "model", Trace::isEnabled() ? _mimeType : QString());
    int i;
 
    QModelIndex ndxLocal;
@@ -1014,61 +1096,160 @@ QModelIndexList BtTreeModel::allChildren(QModelIndex ndx)
 
 bool BtTreeModel::renameFolder(BtFolder* victim, QString newName)
 {
-   QModelIndex ndx = findFolder(victim->fullPath(), 0, false);
-   QModelIndex pInd; 
-   QString targetPath = newName % "/" % victim->name();
-   QPair<QString,BtTreeItem*> f;
-   QList<QPair<QString, BtTreeItem*> > folders;
-   // This space is important       ^
-   int i, kids,src;
+   QString oldPath = victim->fullPath();
+   QModelIndex ndx = findFolder(oldPath, 0, false);
+   // Normalize this, so the tree and the db agree on what the paths look like
+   QString targetPath = "/" % QString(newName % "/" % victim->name()).split("/", QString::SkipEmptyParts).join("/");
+   QString newParentPath = targetPath.section("/", 0, -2);
 
-   if ( ! ndx.isValid() )
+   if ( ! ndx.isValid() || ! parent(ndx).isValid() )
       return false;
 
-   pInd = parent(ndx);
-   if ( ! pInd.isValid() )
+   if ( targetPath == oldPath )
+      return true;
+
+   // A folder cannot be moved into itself
+   if ( targetPath.startsWith(oldPath % "/") )
       return false;
 
+   // Make sure where we are going exists before we touch anything. This may
+   // change the layout on its own, but only the first time
+   QModelIndex pNdx = findFolder(newParentPath, rootItem->child(0), true);
+   if ( ! pNdx.isValid() )
+      return false;
+
+   // One UPDATE moves everything in the db and in memory, without the
+   // changedFolder() signal per leaf the old way needed
+   try {
+      Database::instance().renameFolder(table(), oldPath, targetPath);
+   }
+   catch (QString e) {
+      Brewtarget::logW( QString("%1 %2").arg(Q_FUNC_INFO).arg(e) );
+      return false;
+   }
+
    BtTreeItem* start = item(ndx);
-   f.first  = targetPath;
-   f.second = start;
+   BtTreeItem* oldParent = start->parent();
+   BtTreeItem* newParent = item(pNdx);
+   BtTreeItem* existing = 0;
+   QList<BtTreeItem*> emptied;
+
+   for (int i = 0; i < newParent->childCount(); ++i )
+   {
+      BtTreeItem* kid = newParent->child(i);
+      if ( kid->type() == BtTreeItem::FOLDER && kid->folder()->isFolder(targetPath) )
+      {
+         existing = kid;
+         break;
+      }
+   }
+
+   // And the tree gets moved in one go
+   emit layoutAboutToBeChanged();
 
-   folders.append(f);
+   QModelIndexList before = persistentIndexList();
+   QList<BtTreeItem*> beforeItems;
+   foreach( QModelIndex pIdx, before )
+      beforeItems.append(item(pIdx));
 
+   oldParent->takeChild(start->childNumber());
+   retargetFolders(start, oldPath, targetPath);
+
+   if ( existing )
+   {
+      mergeFolders(start, existing, emptied);
+      emptied.append(start);
+   }
+   else
+      newParent->insertChild(newParent->childCount(), start);
+
+   QModelIndexList after;
+   for (int i = 0; i < before.size(); ++i )
+   {
+      BtTreeItem* was = beforeItems.at(i);
+      if ( emptied.contains(was) )
+         after.append(QModelIndex());
+      else
+         after.append(createIndex(was->childNumber(), before.at(i).column(), was));
+   }
+   changePersistentIndexList(before, after);
+
+   emit layoutChanged();
+
+   qDeleteAll(emptied);
+   return true;
+}
+
+Brewtarget::DBTable BtTreeModel::table() const
+{
+   switch(treeMask)
+   {
+      case EQUIPMASK:
+         return Brewtarget::EQUIPTABLE;
+      case FERMENTMASK:
+         return Brewtarget::FERMTABLE;
+      case HOPMASK:
+         return Brewtarget::HOPTABLE;
+      case MISCMASK:
+         return Brewtarget::MISCTABLE;
+      case STYLEMASK:
+         return Brewtarget::STYLETABLE;
+      case YEASTMASK:
+         return Brewtarget::YEASTTABLE;
+      default:
+         return Brewtarget::RECTABLE;
+   }
+}
+
+void BtTreeModel::retargetFolders(BtTreeItem* folder, QString const& oldPath, QString const& newPath)
+{
+   QList<BtTreeItem*> folders;
+   folders.append(folder);
+
+   // Same no recursion trick as findFolder()
    while ( ! folders.isEmpty() )
    {
-      // This looks weird, but it is needed for later
-      f = folders.takeFirst();
-      targetPath = f.first;
-      BtTreeItem* target = f.second;
-
-      // As we move things, childCount changes. This makes sure we loop
-      // through all of the kids
-      kids = target->childCount();
-      src = 0;
-      // Ok. We have a start and an index.
-      for (i=0; i < kids; ++i)
+      BtTreeItem* target = folders.takeFirst();
+      BtFolder* f = target->folder();
+
+      f->setfullPath(newPath % f->fullPath().mid(oldPath.length()));
+
+      for (int i = 0; i < target->childCount(); ++i )
       {
-         // This looks weird and it is. As we move children out, the 0 items
-         // changes to the next child. In the case of a folder, though, we
-         // don't move it, so we need to get the item beyond that.
-         BtTreeItem* next = target->child(src);
-         // If a folder, push it onto the folders stack for latter processing
-         if ( next->type() == BtTreeItem::FOLDER ) 
+         if ( target->child(i)->type() == BtTreeItem::FOLDER )
+            folders.append(target->child(i));
+      }
+   }
+}
+
+void BtTreeModel::mergeFolders(BtTreeItem* src, BtTreeItem* dst, QList<BtTreeItem*>& emptied)
+{
+   while ( src->childCount() )
+   {
+      BtTreeItem* kid = src->takeChild(0);
+      BtTreeItem* twin = 0;
+
+      if ( kid->type() == BtTreeItem::FOLDER )
+      {
+         for (int i = 0; i < dst->childCount(); ++i )
          {
-            QPair<QString,BtTreeItem*> newTarget;
-            newTarget.first = targetPath % "/" % next->name();
-            newTarget.second = next;
-            folders.append(newTarget);
-            src++;
+            BtTreeItem* candidate = dst->child(i);
+            if ( candidate->type() == BtTreeItem::FOLDER && candidate->folder()->isFolder(kid->folder()->fullPath()) )
+            {
+               twin = candidate;
+               break;
+            }
          }
-         else // Leafnode
-            next->thing()->setFolder(targetPath);
       }
+
+      if ( twin )
+      {
+         mergeFolders(kid, twin, emptied);
+         emptied.append(kid);
+      }
+      else
+         dst->insertChild(dst->childCount(), kid);
    }
-   // Last thing is to remove the victim. 
-   i = start->childNumber();
-   return removeRows(i, 1, pInd); 
 }
 
 QModelIndex BtTreeModel::createFolderTree( QStringList dirs, BtTreeItem* parent, QString pPath)
@@ -1130,6 +1311,7 @@ QModelIndex BtTreeModel::findFolder( QString name, BtTreeItem* parent, bool crea
    QString current, fullPath, targetPath;
    int i;
 
+   ensureLoaded();
    pItem = parent ? parent : rootItem->child(0);
 
    // Upstream interfaces should handle this for me, but I like belt and
@@ -1244,6 +1426,10 @@ void BtTreeModel::elementAdded(BeerXMLElement* victim)
    if ( ! victim->display() ) 
       return;
 
+   // Not loaded means nobody has looked yet. They will find it when they do
+   if ( ! _loaded )
+      return;
+
    if ( qobject_cast<BrewNote*>(victim) )
    {
       pIdx = findElement(Database::instance().getParentRecipe(qobject_cast<BrewNote*>(victim)));
@@ -1290,7 +1476,7 @@ void BtTreeModel::elementRemoved(BeerXMLElement* victim)
 {
    QModelIndex index,pIndex;
 
-   if ( ! victim )
+   if ( ! victim || ! _loaded )
       return;
 
    index = findElement(victim);
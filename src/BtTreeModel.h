@@ -30,6 +30,8 @@ class BtTreeModel;
 #include <QVariant>
 #include <QObject>
 #include <QSqlRelationalTableModel>
+#include "brewtarget.h"
+#include "MemoryAccounting.h"
 
 // Forward declarations
 class BeerXMLElement;
@@ -44,6 +46,7 @@ class Hop;
 class Misc;
 class Yeast;
 class Style;
+class ToolTipCache;
 
 /*!
  * \class BtTreeModel
@@ -101,6 +104,13 @@ public:
    virtual QModelIndex index( int row, int col, const QModelIndex &parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractItemModel
    virtual QModelIndex parent( const QModelIndex &index) const;
+   //! \brief Reimplemented from QAbstractItemModel. True for the top item
+   //! until the tree is loaded, so it can be expanded
+   virtual bool hasChildren( const QModelIndex &parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractItemModel
+   virtual bool canFetchMore( const QModelIndex &parent) const;
+   //! \brief Reimplemented from QAbstractItemModel. Loads the tree
+   virtual void fetchMore( const QModelIndex &parent);
 
    //! \brief Reimplemented from QAbstractItemModel
    bool insertRow(int row, const QModelIndex &parent = QModelIndex(), QObject* victim = 0, int victimType = -1);
@@ -163,6 +173,11 @@ public:
    BtFolder* folder(const QModelIndex &index) const;
    //! \brief Get BeerXMLElement at \c index.
    BeerXMLElement* thing(const QModelIndex &index) const;
+   //! \brief Starts on the tooltips of \c indexes, so they are ready
+   //! before anybody hovers over them
+   void prefetchToolTips(QModelIndexList const& indexes);
+   //! \brief The tooltips we've already made
+   ToolTipCache* toolTips() const;
 
    //! \brief one find method to find them all, and in darkness bind them
    QModelIndex findElement(BeerXMLElement* thing, BtTreeItem* parent = NULL);
@@ -219,6 +234,12 @@ signals:
 private:
    //! \brief Loads the tree. 
    void loadTreeModel();
+   //! \brief item and folder counts, for MemoryAccounting
+   QList<MemoryAccounting::Entry> memoryReport() const;
+   //! \brief Loads the tree, unless that has already happened. Ingredient
+   //! trees wait until somebody looks, so the catalog doesn't have to be
+   //! built into objects just to start the program
+   void ensureLoaded();
   
    //! \brief add and remove an element from the, respectively. All of the
    //slots actually call these two methods 
@@ -260,11 +281,23 @@ private:
    //! \brief convenience function to add brewnotes to a recipe as a subtree
    void addBrewNoteSubTree(Recipe* rec, int i, BtTreeItem* parent);
 
+   //! \brief the table holding whatever this tree shows
+   Brewtarget::DBTable table() const;
+   //! \brief rewrites the full path of \c folder and every folder below it
+   //! from \c oldPath to \c newPath
+   void retargetFolders(BtTreeItem* folder, QString const& oldPath, QString const& newPath);
+   //! \brief moves the children of \c src into \c dst, merging any folders
+   //! that exist in both. Emptied folders are put on \c emptied for the
+   //! caller to delete, once nobody is looking at them.
+   void mergeFolders(BtTreeItem* src, BtTreeItem* dst, QList<BtTreeItem*>& emptied);
+
    BtTreeItem* rootItem;
    BtTreeView *parentTree;
    TypeMasks treeMask;
    int _type;
    QString _mimeType;
+   bool _loaded;
+   ToolTipCache* _toolTips;
 
 };
 
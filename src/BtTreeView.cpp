@@ -23,6 +23,7 @@
 #include <QMenu>
 #include <QDebug>
 #include <QHeaderView>
+#include <QScrollBar>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QInputDialog>
@@ -73,6 +74,16 @@ BtTreeView::BtTreeView(QWidget *parent, BtTreeModel::TypeMasks type) :
 
    // and one wee connection
    connect( _model, SIGNAL(expandFolder(BtTreeModel::TypeMasks, QModelIndex)), this, SLOT(expandFolder(BtTreeModel::TypeMasks, QModelIndex)));
+
+   // Whenever different rows come into view, their tooltips get made ahead
+   // of time
+   _prefetchTimer.setSingleShot(true);
+   _prefetchTimer.setInterval(100);
+   connect( &_prefetchTimer, SIGNAL(timeout()), this, SLOT(prefetchToolTips()) );
+   connect( verticalScrollBar(), SIGNAL(valueChanged(int)), &_prefetchTimer, SLOT(start()) );
+   connect( this, SIGNAL(expanded(QModelIndex)), &_prefetchTimer, SLOT(start()) );
+   connect( filter, SIGNAL(layoutChanged()), &_prefetchTimer, SLOT(start()) );
+   connect( filter, SIGNAL(rowsInserted(QModelIndex,int,int)), &_prefetchTimer, SLOT(start()) );
 }
 
 BtTreeModel* BtTreeView::model()
@@ -342,22 +353,22 @@ void BtTreeView::newIngredient() {
 
    switch(_type) {
       case BtTreeModel::EQUIPMASK:
-         qobject_cast<EquipmentEditor*>(_editor)->newEquipment(folder);
+         qobject_cast<EquipmentEditor*>(_editor())->newEquipment(folder);
          break;
       case BtTreeModel::FERMENTMASK:
-         qobject_cast<FermentableDialog*>(_editor)->newFermentable(folder);
+         qobject_cast<FermentableDialog*>(_editor())->newFermentable(folder);
          break;
       case BtTreeModel::HOPMASK:
-         qobject_cast<HopDialog*>(_editor)->newHop(folder);
+         qobject_cast<HopDialog*>(_editor())->newHop(folder);
          break;
       case BtTreeModel::MISCMASK:
-         qobject_cast<MiscDialog*>(_editor)->newMisc(folder);
+         qobject_cast<MiscDialog*>(_editor())->newMisc(folder);
          break;
       case BtTreeModel::STYLEMASK:
-         qobject_cast<StyleEditor*>(_editor)->newStyle(folder);
+         qobject_cast<StyleEditor*>(_editor())->newStyle(folder);
          break;
       case BtTreeModel::YEASTMASK:
-         qobject_cast<YeastDialog*>(_editor)->newYeast(folder);
+         qobject_cast<YeastDialog*>(_editor())->newYeast(folder);
          break;
       default:
          Brewtarget::logW(QString("BtTreeView::setupContextMenu unrecognized mask %1").arg(_type));
@@ -365,7 +376,7 @@ void BtTreeView::newIngredient() {
 
 }
 
-void BtTreeView::setupContextMenu(QWidget* top, QWidget* editor)
+void BtTreeView::setupContextMenu(QWidget* top, std::function<QWidget*()> editor)
 {
    QMenu* _newMenu = new QMenu(this);
    QMenu* _exportMenu = new QMenu(this);
@@ -383,7 +394,7 @@ void BtTreeView::setupContextMenu(QWidget* top, QWidget* editor)
    {
       // the recipe case is a bit more complex, because we need to handle the brewnotes too
       case BtTreeModel::RECIPEMASK:
-         _newMenu->addAction(tr("Recipe"), editor, SLOT(newRecipe()));
+         _newMenu->addAction(tr("Recipe"), editor(), SLOT(newRecipe()));
 
          _contextMenu->addAction(tr("Brew It!"), top, SLOT(brewItHelper()));
          _contextMenu->addSeparator();
@@ -426,6 +437,9 @@ void BtTreeView::setupContextMenu(QWidget* top, QWidget* editor)
    _exportMenu->setTitle(tr("Export"));
    _exportMenu->addAction(tr("To XML"), top, SLOT(exportSelected()));
    _exportMenu->addAction(tr("To HTML"), top, SLOT(exportSelectedHtml()));
+   // Only recipes have brew days
+   if ( _type == BtTreeModel::RECIPEMASK )
+      _exportMenu->addAction(tr("Brew Sheets to PDF"), top, SLOT(exportSelectedBrewSheets()));
    _contextMenu->addMenu(_exportMenu);
    _contextMenu->addAction(tr("Import"), top, SLOT(importFiles()));
    
@@ -603,6 +617,30 @@ void BtTreeView::deleteSelected(QModelIndexList selected)
    _model->deleteSelected(translated);
 }
 
+void BtTreeView::enterEvent(QEvent* event)
+{
+   prefetchToolTips();
+   QTreeView::enterEvent(event);
+}
+
+void BtTreeView::prefetchToolTips()
+{
+   QModelIndexList onScreen;
+   QRect area = viewport()->rect();
+   QModelIndex ndx = indexAt(area.topLeft());
+
+   if ( ! isVisible() )
+      return;
+
+   // Walk down from the top row until we fall off the bottom
+   while ( ndx.isValid() && visualRect(ndx).top() <= area.bottom() ) {
+      onScreen.append( filter->mapToSource(ndx) );
+      ndx = indexBelow(ndx);
+   }
+
+   _model->prefetchToolTips(onScreen);
+}
+
 void BtTreeView::expandFolder(BtTreeModel::TypeMasks kindaThing, QModelIndex fIdx)
 {
    // FUN! I get to map from source this time.
@@ -26,6 +26,8 @@ class BtTreeView;
 #include <QWidget>
 #include <QPoint>
 #include <QMouseEvent>
+#include <QTimer>
+#include <functional>
 #include "BtTreeItem.h"
 #include "BtTreeFilterProxyModel.h"
 
@@ -112,9 +114,11 @@ public:
 
    //! \brief catches a key stroke in a tree
    void keyPressEvent(QKeyEvent* event);
+   //! \brief the mouse is coming, so get the tooltips ready
+   void enterEvent(QEvent* event);
 
    //! \brief creates a context menu based on the type of tree
-   void setupContextMenu(QWidget* top, QWidget* editor );
+   void setupContextMenu(QWidget* top, std::function<QWidget*()> editor );
 
    void deleteSelected(QModelIndexList selected);
    void copySelected(QModelIndexList selected);
@@ -133,6 +137,8 @@ public slots:
 
 private slots:
    void expandFolder(BtTreeModel::TypeMasks kindaThing, QModelIndex fIdx);
+   //! \brief asks the model for the tooltips of the rows on screen
+   void prefetchToolTips();
 
 private:
    BtTreeModel* _model;
@@ -140,9 +146,12 @@ private:
    BtTreeModel::TypeMasks _type;
    QMenu* _contextMenu, *subMenu;
    QPoint dragStart;
-   QWidget* _editor;
+   //! \brief hands back the editor for new things, which may not exist until asked for
+   std::function<QWidget*()> _editor;
 
    bool doubleClick;
+   //! \brief so a scroll is one prefetch, not one per pixel
+   QTimer _prefetchTimer;
 
    int verifyDelete(int confirmDelete, QString tag, QString name);
    QString verifyCopy(QString tag, QString name, bool *abort);
@@ -33,7 +33,12 @@ ColorMethods::~ColorMethods()
 
 double ColorMethods::mcuToSrm(double mcu)
 {
-   switch( Brewtarget::colorFormula )
+   return mcuToSrm(Brewtarget::colorFormula, mcu);
+}
+
+double ColorMethods::mcuToSrm(Brewtarget::ColorType formula, double mcu)
+{
+   switch( formula )
    {
       case Brewtarget::MOREY:
          return morey(mcu);
@@ -42,11 +47,39 @@ double ColorMethods::mcuToSrm(double mcu)
       case Brewtarget::MOSHER:
          return mosher(mcu);
       default:
-         Brewtarget::logE(QObject::tr("Invalid color formula type: %1").arg(Brewtarget::colorFormula) );
+         Brewtarget::logE(QObject::tr("Invalid color formula type: %1").arg(formula) );
          return morey(mcu);
    }
 }
 
+void ColorMethods::mcuToSrm(double const* mcu, int n, double* srm)
+{
+   mcuToSrm(Brewtarget::colorFormula, mcu, n, srm);
+}
+
+void ColorMethods::mcuToSrm(Brewtarget::ColorType formula, double const* mcu, int n, double* srm)
+{
+   if( n <= 0 )
+      return;
+
+   switch( formula )
+   {
+      case Brewtarget::MOREY:
+         morey(mcu, n, srm);
+         break;
+      case Brewtarget::DANIEL:
+         daniel(mcu, n, srm);
+         break;
+      case Brewtarget::MOSHER:
+         mosher(mcu, n, srm);
+         break;
+      default:
+         Brewtarget::logE(QObject::tr("Invalid color formula type: %1").arg(formula) );
+         morey(mcu, n, srm);
+         break;
+   }
+}
+
 // I don't know where this is from.
 double ColorMethods::morey(double mcu)
 {
@@ -64,3 +97,21 @@ double ColorMethods::mosher(double mcu)
 {
    return 0.3 * mcu + 4.7;
 }
+
+void ColorMethods::morey(double const* mcu, int n, double* srm)
+{
+   for( int i = 0; i < n; ++i )
+      srm[i] = 1.4922 * pow( mcu[i], 0.6859 );
+}
+
+void ColorMethods::daniel(double const* mcu, int n, double* srm)
+{
+   for( int i = 0; i < n; ++i )
+      srm[i] = 0.2 * mcu[i] + 8.4;
+}
+
+void ColorMethods::mosher(double const* mcu, int n, double* srm)
+{
+   for( int i = 0; i < n; ++i )
+      srm[i] = 0.3 * mcu[i] + 4.7;
+}
@@ -20,6 +20,8 @@
 #ifndef _COLORMETHODS_H
 #define _COLORMETHODS_H
 
+#include "brewtarget.h"
+
 class ColorMethods;
 
 /*!
@@ -36,10 +38,19 @@ public:
 
    //! Depending on selected algorithm, convert malt color units to SRM.
    static double mcuToSrm(double mcu);
+   //! mcuToSrm() for \c n values at once, picking the algorithm only once.
+   static void mcuToSrm(double const* mcu, int n, double* srm);
+   //! The same two, with \c formula instead of the one in the options
+   static double mcuToSrm(Brewtarget::ColorType formula, double mcu);
+   static void mcuToSrm(Brewtarget::ColorType formula, double const* mcu, int n, double* srm);
 private:
    static double morey(double mcu);
    static double daniel(double mcu);
    static double mosher(double mcu);
+
+   static void morey(double const* mcu, int n, double* srm);
+   static void daniel(double const* mcu, int n, double* srm);
+   static void mosher(double const* mcu, int n, double* srm);
 };
 
 #endif
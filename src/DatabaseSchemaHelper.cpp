@@ -27,7 +27,7 @@
 #include <QDebug>
 #include <QSqlError>
 
-const int DatabaseSchemaHelper::dbVersion = 6;
+const int DatabaseSchemaHelper::dbVersion = 7;
 
 // Commands and keywords
 QString DatabaseSchemaHelper::CREATETABLE("CREATE TABLE");
@@ -295,6 +295,7 @@ QString DatabaseSchemaHelper::colRecTasteRating("taste_rating");
 QString DatabaseSchemaHelper::colRecStyleId("style_id");
 QString DatabaseSchemaHelper::colRecMashId("mash_id");
 QString DatabaseSchemaHelper::colRecEquipId("equipment_id");
+QString DatabaseSchemaHelper::colRecCalcCache("calc_cache");
 
 QString DatabaseSchemaHelper::tableBtEquipment("bt_equipment");
 
@@ -459,6 +460,9 @@ bool DatabaseSchemaHelper::migrateNext(int oldVersion, QSqlDatabase db)
       case 5:
          ret &= migrate_to_6(q);
          break;
+      case 6:
+         ret &= migrate_to_7(q);
+         break;
       default:
          Brewtarget::logE(QString("Unknown version %1").arg(oldVersion));
          return false;
@@ -1157,6 +1161,8 @@ bool DatabaseSchemaHelper::create_recipe(QSqlQuery q)
       colRecStyleId      + SEP + TYPEINTEGER                                                             + COMMA +
       colRecMashId       + SEP + TYPEINTEGER                                                             + COMMA +
       colRecEquipId      + SEP + TYPEINTEGER                                                             + COMMA +
+      // Calculated values and the fingerprint they were calculated from-------
+      colRecCalcCache    + SEP + TYPETEXT     + SEP + DEFAULT + SEP + "''"                               + COMMA +
       // Metadata--------------------------------------------------------------
       deleted                                                                                            + COMMA +
       display                                                                                            + COMMA +
@@ -1557,3 +1563,16 @@ bool DatabaseSchemaHelper::migrate_to_6(QSqlQuery q) {
 
    return ret;
 }
+
+bool DatabaseSchemaHelper::migrate_to_7(QSqlQuery q) {
+   bool ret = true;
+
+   // Recipes remember their calculated values, so they don't have to
+   // recalculate them every time they are loaded
+   ret &= q.exec(
+      ALTERTABLE + SEP + tableRecipe + SEP +
+      ADDCOLUMN + SEP + colRecCalcCache + SEP + TYPETEXT + SEP + DEFAULT + SEP + "''"
+   );
+
+   return ret;
+}
@@ -0,0 +1,126 @@
+/*
+ * DatabaseSnapshot.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseSnapshot.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+// "BTSS", for brewtarget snapshot
+const quint32 DatabaseSnapshot::magic = 0x42545353;
+// Bump whenever the layout below changes. Old snapshots then just get ignored
+const quint32 DatabaseSnapshot::formatVersion = 1;
+
+static QDataStream& operator<<(QDataStream& out, DatabaseSnapshot::Row const& row)
+{
+   return out << qint32(row.key) << row.name << row.folder << row.display << row.deleted;
+}
+
+static QDataStream& operator>>(QDataStream& in, DatabaseSnapshot::Row& row)
+{
+   qint32 key;
+   in >> key >> row.name >> row.folder >> row.display >> row.deleted;
+   row.key = key;
+   return in;
+}
+
+QByteArray DatabaseSnapshot::stamp(QString const& dbFileName)
+{
+   QFile db(dbFileName);
+   if ( ! db.open(QIODevice::ReadOnly) )
+      return QByteArray();
+
+   // The file change counter is the big-endian int at offset 24 of the
+   // SQLite header. SQLite bumps it on every transaction that writes.
+   QByteArray header = db.read(28);
+   if ( header.size() < 28 || ! header.startsWith("SQLite format 3") )
+      return QByteArray();
+
+   QByteArray ret;
+   QDataStream out(&ret, QIODevice::WriteOnly);
+   out.writeRawData(header.constData() + 24, 4);
+   out << db.size() << QFileInfo(db).lastModified().toMSecsSinceEpoch();
+   return ret;
+}
+
+bool DatabaseSnapshot::save(QString const& fileName, QByteArray const& stamp) const
+{
+   if ( stamp.isEmpty() )
+      return false;
+
+   // QSaveFile so a crash halfway through leaves the old file, which the
+   // stamp then rejects, instead of half of a new one
+   QSaveFile file(fileName);
+   if ( ! file.open(QIODevice::WriteOnly) )
+      return false;
+
+   QDataStream out(&file);
+   out.setVersion(QDataStream::Qt_5_0);
+   out << magic << formatVersion << stamp;
+   out << rows << children << inventoryKeys << inventoryValues << calcCaches;
+
+   if ( out.status() != QDataStream::Ok ) {
+      file.cancelWriting();
+      return false;
+   }
+   return file.commit();
+}
+
+DatabaseSnapshot* DatabaseSnapshot::load(QString const& fileName, QByteArray const& stamp)
+{
+   if ( stamp.isEmpty() )
+      return 0;
+
+   QFile file(fileName);
+   if ( ! file.open(QIODevice::ReadOnly) || file.size() == 0 )
+      return 0;
+
+   // Map it rather than read it. QDataStream walks the pages in place and
+   // the only copies made are the ones we keep.
+   uchar* data = file.map(0, file.size());
+   if ( ! data )
+      return 0;
+
+   DatabaseSnapshot* ret = 0;
+   {
+      QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), file.size());
+      QDataStream in(bytes);
+      in.setVersion(QDataStream::Qt_5_0);
+
+      quint32 m, version;
+      QByteArray theirStamp;
+      in >> m >> version;
+      if ( m == magic && version == formatVersion ) {
+         in >> theirStamp;
+         if ( theirStamp == stamp ) {
+            ret = new DatabaseSnapshot();
+            in >> ret->rows >> ret->children >> ret->inventoryKeys >> ret->inventoryValues >> ret->calcCaches;
+            if ( in.status() != QDataStream::Ok ) {
+               delete ret;
+               ret = 0;
+            }
+         }
+      }
+   }
+
+   file.unmap(data);
+   return ret;
+}
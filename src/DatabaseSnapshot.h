@@ -0,0 +1,88 @@
+/*
+ * DatabaseSnapshot.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DATABASESNAPSHOT_H
+#define _DATABASESNAPSHOT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+/*!
+ * \class DatabaseSnapshot
+ *
+ * \brief What Database needs to know at startup, frozen to disk on a clean
+ * shutdown.
+ *
+ * Database fills one of these just before it closes the SQLite file and
+ * reads it back on the next start. The snapshot carries the stamp of the db
+ * file it was taken from. If the file has been written since (the change
+ * counter in the SQLite header moves on every commit), the snapshot is
+ * useless and load() says so.
+ */
+class DatabaseSnapshot
+{
+public:
+   //! \brief The columns every BeerXMLElement caches
+   struct Row
+   {
+      int key;
+      QString name;
+      QString folder;
+      //! -1 means the table has no such column, so leave it to get()
+      qint8 display;
+      qint8 deleted;
+   };
+
+   //! table -> every row in it
+   QHash< int, QVector<Row> > rows;
+   //! child table -> (parent key -> child keys, in the order the db gives them).
+   // Recipes are the parent of everything but mash steps, which hang off a mash
+   QHash< int, QHash< int, QVector<int> > > children;
+   //! ingredient table -> (ingredient key -> inventory key)
+   QHash< int, QHash<int,int> > inventoryKeys;
+   //! inventory table -> (inventory key -> amount or quanta)
+   QHash< int, QHash<int,QVariant> > inventoryValues;
+   //! recipe key -> calc_cache, the recipe's saved calculations
+   QHash< int, QString > calcCaches;
+
+   /*!
+    * \brief Identifies one state of the SQLite file at \c dbFileName: the
+    * header's change counter, the size and the modification time. Empty if
+    * the file can't be read.
+    */
+   static QByteArray stamp(QString const& dbFileName);
+
+   //! \brief Writes the snapshot, tagged with \c stamp. False on failure
+   bool save(QString const& fileName, QByteArray const& stamp) const;
+
+   /*!
+    * \brief Maps \c fileName and reads it back. Returns 0 if there is no
+    * snapshot, it is from some other version, or its stamp isn't \c stamp.
+    * The caller owns the result.
+    */
+   static DatabaseSnapshot* load(QString const& fileName, QByteArray const& stamp);
+
+private:
+   static const quint32 magic;
+   static const quint32 formatVersion;
+};
+
+#endif /* _DATABASESNAPSHOT_H */
@@ -0,0 +1,117 @@
+/*
+ * ElementStore.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ElementStore.h"
+
+#include <algorithm>
+
+static bool byKey(DatabaseSnapshot::Row const& a, DatabaseSnapshot::Row const& b)
+{
+   return a.key < b.key;
+}
+
+ElementStore::ElementStore()
+{
+}
+
+void ElementStore::assign(QVector<DatabaseSnapshot::Row> rows)
+{
+   clear();
+   std::sort(rows.begin(), rows.end(), byKey);
+
+   QHash<QString,int> pool;
+   keys.reserve(rows.size());
+   nameStarts.reserve(rows.size()+1);
+   folders.reserve(rows.size());
+   displays.reserve(rows.size());
+   deletes.reserve(rows.size());
+
+   foreach( DatabaseSnapshot::Row const& row, rows ) {
+      keys.append(row.key);
+      nameStarts.append(names.size());
+      names.append(row.name.toUtf8());
+
+      int f = pool.value(row.folder, -1);
+      if ( f < 0 ) {
+         f = folderPool.size();
+         folderPool.append(row.folder);
+         pool.insert(row.folder, f);
+      }
+      folders.append(f);
+
+      displays.append(row.display);
+      deletes.append(row.deleted);
+   }
+   nameStarts.append(names.size());
+
+   names.squeeze();
+}
+
+void ElementStore::clear()
+{
+   keys.clear();
+   names.clear();
+   nameStarts.clear();
+   folderPool.clear();
+   folders.clear();
+   displays.clear();
+   deletes.clear();
+}
+
+int ElementStore::indexOf(int key) const
+{
+   QVector<int>::const_iterator it = std::lower_bound(keys.constBegin(), keys.constEnd(), key);
+   if ( it == keys.constEnd() || *it != key )
+      return -1;
+   return it - keys.constBegin();
+}
+
+QString ElementStore::name(int row) const
+{
+   int start = nameStarts.at(row);
+   return QString::fromUtf8(names.constData() + start, nameStarts.at(row+1) - start);
+}
+
+QString ElementStore::folder(int row) const
+{
+   return folderPool.at(folders.at(row));
+}
+
+void ElementStore::renameFolder(QString const& oldPath, QString const& newPath)
+{
+   QString prefix = oldPath + "/";
+   for ( int i = 0; i < folderPool.size(); ++i ) {
+      if ( folderPool[i] == oldPath )
+         folderPool[i] = newPath;
+      else if ( folderPool[i].startsWith(prefix) )
+         folderPool[i] = newPath + folderPool[i].mid(oldPath.size());
+   }
+}
+
+qint64 ElementStore::bytes() const
+{
+   qint64 ret = sizeof(*this);
+   ret += keys.capacity() * sizeof(int);
+   ret += names.capacity();
+   ret += nameStarts.capacity() * sizeof(int);
+   ret += folders.capacity() * sizeof(int);
+   ret += displays.capacity() + deletes.capacity();
+   foreach( QString const& f, folderPool )
+      ret += sizeof(QString) + f.capacity() * sizeof(QChar);
+   return ret;
+}
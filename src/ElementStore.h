@@ -0,0 +1,80 @@
+/*
+ * ElementStore.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ELEMENTSTORE_H
+#define _ELEMENTSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "DatabaseSnapshot.h"
+
+/*!
+ * \class ElementStore
+ *
+ * \brief The rows of one table, stored by column instead of as objects.
+ *
+ * Most of the catalog never makes it into a recipe, and a Hop that nobody
+ * looks at is a QObject, a private, a hash node and a few strings for
+ * nothing. Database keeps those rows here and only builds the object when
+ * somebody asks for it. Keys are kept sorted so a lookup is a binary
+ * search, names are one UTF-8 blob and folders are interned, since there
+ * are a lot more hops than hop folders.
+ */
+class ElementStore
+{
+public:
+   ElementStore();
+
+   //! \brief Replaces the contents with \c rows, in any order
+   void assign(QVector<DatabaseSnapshot::Row> rows);
+   void clear();
+
+   int size() const { return keys.size(); }
+   //! \returns the row holding \c key, or -1
+   int indexOf(int key) const;
+
+   int key(int row) const { return keys.at(row); }
+   QString name(int row) const;
+   QString folder(int row) const;
+   //! -1 if unknown, else 0 or 1
+   qint8 display(int row) const { return displays.at(row); }
+   //! -1 if unknown, else 0 or 1
+   qint8 deleted(int row) const { return deletes.at(row); }
+
+   //! \brief renames \c oldPath and everything under it, like Database::renameFolder()
+   void renameFolder(QString const& oldPath, QString const& newPath);
+
+   //! \brief What this store costs, give or take the allocator
+   qint64 bytes() const;
+
+private:
+   QVector<int> keys;
+   //! name of row i is names[nameStarts[i], nameStarts[i+1])
+   QByteArray names;
+   QVector<int> nameStarts;
+   QStringList folderPool;
+   //! index into folderPool of row i
+   QVector<int> folders;
+   QVector<qint8> displays;
+   QVector<qint8> deletes;
+};
+
+#endif /* _ELEMENTSTORE_H */
@@ -84,7 +84,7 @@ double FermentableSortFilterProxyModel::toDouble(QVariant side) const
    double amt;
    bool ok = false;
 
-   amt = Brewtarget::toDouble(side.toString(), &ok);
+   amt = Brewtarget::variantToDouble(side, &ok);
    if ( ! ok )
       Brewtarget::logW( QString("FermentableSortFilterProxyModel::lessThan could not convert %1 to double").arg(side.toString()));
    return amt;
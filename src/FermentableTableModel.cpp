@@ -45,6 +45,9 @@
 #include "FermentableTableModel.h"
 #include "unit.h"
 #include "recipe.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "PropertyIds.h"
 
 //=====================CLASS FermentableTableModel==============================
 FermentableTableModel::FermentableTableModel(QTableView* parent, bool editable)
@@ -67,10 +70,21 @@ FermentableTableModel::FermentableTableModel(QTableView* parent, bool editable)
    parentTableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
    parentTableWidget->setWordWrap(false);
    connect(headerView, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(contextMenu(const QPoint&)));
+
+   MemoryAccounting::addSource(this, [this]() {
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Tables", objectName(), fermObs.size(), fermObs.size() * sizeof(void*) );
+   });
+}
+
+FermentableTableModel::~FermentableTableModel()
+{
+   MemoryAccounting::removeSources(this);
 }
 
 void FermentableTableModel::observeRecipe(Recipe* rec)
 {
+   TraceSpan span("FermentableTableModel::observeRecipe", "model");
+
    if( recObs )
    {
       disconnect( recObs, 0, this, 0 );
@@ -231,7 +245,7 @@ void FermentableTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 
    // See if our recipe gained or lost fermentables.
    Recipe* recSender = qobject_cast<Recipe*>(sender());
-   if( recSender && recSender == recObs && QString(prop.name()) == "fermentables" )
+   if( recSender && recSender == recObs && BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::fermentables )
    {
       removeAll();
       addFermentables( recObs->fermentables() );
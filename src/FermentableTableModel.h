@@ -55,7 +55,7 @@ class FermentableTableModel : public QAbstractTableModel
 
 public:
    FermentableTableModel(QTableView* parent=0, bool editable=true);
-   virtual ~FermentableTableModel() {}
+   virtual ~FermentableTableModel();
    //! \brief Observe a recipe's list of fermentables.
    void observeRecipe(Recipe* rec);
    //! \brief If true, we model the database's list of fermentables.
@@ -46,11 +46,11 @@ bool HopSortFilterProxyModel::lessThan(const QModelIndex &left,
    switch( left.column() )
    {
       case HOPALPHACOL:
-         lAlpha = Brewtarget::toDouble(leftHop.toString(), &ok );
+         lAlpha = Brewtarget::variantToDouble(leftHop, &ok );
          if ( ! ok )
             Brewtarget::logW( QString("HopSortFilterProxyModel::lessThan() could not convert %1 to double").arg(leftHop.toString()));
 
-         rAlpha = Brewtarget::toDouble(rightHop.toString(), &ok );
+         rAlpha = Brewtarget::variantToDouble(rightHop, &ok );
          if ( ! ok )
             Brewtarget::logW( QString("HopSortFilterProxyModel::lessThan() could not convert %1 to double").arg(rightHop.toString()));
 
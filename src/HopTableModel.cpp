@@ -40,6 +40,9 @@
 #include "HopTableModel.h"
 #include "unit.h"
 #include "brewtarget.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "PropertyIds.h"
 
 HopTableModel::HopTableModel(QTableView* parent, bool editable)
    : QAbstractTableModel(parent),
@@ -71,15 +74,22 @@ HopTableModel::HopTableModel(QTableView* parent, bool editable)
    parentTableWidget->setWordWrap(false);
 
    connect(headerView, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(contextMenu(const QPoint&)));
+
+   MemoryAccounting::addSource(this, [this]() {
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Tables", objectName(), hopObs.size(), hopObs.size() * sizeof(void*) );
+   });
 }
 
 HopTableModel::~HopTableModel()
 {
+   MemoryAccounting::removeSources(this);
    hopObs.clear();
 }
 
 void HopTableModel::observeRecipe(Recipe* rec)
 {
+   TraceSpan span("HopTableModel::observeRecipe", "model");
+
    if( recObs )
    {
       disconnect( recObs, 0, this, 0 );
@@ -217,7 +227,7 @@ void HopTableModel::changed(QMetaProperty prop, QVariant /*val*/)
    Recipe* recSender = qobject_cast<Recipe*>(sender());
    if( recSender && recSender == recObs )
    {
-      if( QString(prop.name()) == "hops" )
+      if( BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::hops )
       {
          removeAll();
          addHops( recObs->hops() );
@@ -34,7 +34,12 @@ IbuMethods::~IbuMethods()
 
 double IbuMethods::getIbus(double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes)
 {
-   switch( Brewtarget::ibuFormula )
+   return getIbus(Brewtarget::ibuFormula, AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
+}
+
+double IbuMethods::getIbus(Brewtarget::IbuType formula, double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes)
+{
+   switch( formula )
    {
       case Brewtarget::TINSETH:
          return tinseth(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
@@ -46,7 +51,7 @@ double IbuMethods::getIbus(double AArating, double hops_grams, double finalVolum
          return noonan(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
          break;
       default:
-         Brewtarget::logE( QObject::tr("Unrecognized IBU formula type. %1").arg(Brewtarget::ibuFormula) );
+         Brewtarget::logE( QObject::tr("Unrecognized IBU formula type. %1").arg(formula) );
          return tinseth(AArating, hops_grams, finalVolume_liters, wort_grav, minutes);
          break;
    }
@@ -72,8 +77,19 @@ double IbuMethods::noonan(double AArating, double hops_grams, double finalVolume
 {
     double volumeFactor = (Units::us_gallons->toSI(5.0))/ finalVolume_liters;
     double hopsFactor = hops_grams/ (Units::ounces->toSI(1.0) * 1000.0);
+    double utilizationFactor = noonanUtilizationFactor(wort_grav);
+
+    return(volumeFactor * ( hopsFactor * (100 * AArating) * noonanPolynomial().eval(minutes) ) * utilizationFactor);
+}
+
+Polynomial const& IbuMethods::noonanPolynomial()
+{
     static Polynomial p(Polynomial() << 0.7000029428 << -0.08868853463 << 0.02720809386 << -0.002340415323 << 0.00009925450081 << -0.000002102006144 << 0.00000002132644293 << -0.00000000008229488217);
+    return p;
+}
 
+double IbuMethods::noonanUtilizationFactor(double wort_grav)
+{
     //using 60 minutes as a general table
     double utilizationFactorTable[4][2] =  {
                      {1.050, 1},
@@ -101,5 +117,71 @@ double IbuMethods::noonan(double AArating, double hops_grams, double finalVolume
         utilizationFactor = utilizationFactorTable[3][1];
     }
 
-    return(volumeFactor * ( hopsFactor * (100 * AArating) * p.eval(minutes) ) * utilizationFactor);
+    return utilizationFactor;
+}
+
+void IbuMethods::getIbus(double const* AArating, double const* hops_grams, double const* minutes, int n,
+                         double finalVolume_liters, double wort_grav, double* ibus)
+{
+   getIbus(Brewtarget::ibuFormula, AArating, hops_grams, minutes, n, finalVolume_liters, wort_grav, ibus);
+}
+
+void IbuMethods::getIbus(Brewtarget::IbuType formula, double const* AArating, double const* hops_grams, double const* minutes, int n,
+                         double finalVolume_liters, double wort_grav, double* ibus)
+{
+   if( n <= 0 )
+      return;
+
+   switch( formula )
+   {
+      case Brewtarget::TINSETH:
+         tinseth(AArating, hops_grams, minutes, n, finalVolume_liters, wort_grav, ibus);
+         break;
+      case Brewtarget::RAGER:
+         rager(AArating, hops_grams, minutes, n, finalVolume_liters, wort_grav, ibus);
+         break;
+      case Brewtarget::NOONAN:
+         noonan(AArating, hops_grams, minutes, n, finalVolume_liters, wort_grav, ibus);
+         break;
+      default:
+         Brewtarget::logE( QObject::tr("Unrecognized IBU formula type. %1").arg(formula) );
+         tinseth(AArating, hops_grams, minutes, n, finalVolume_liters, wort_grav, ibus);
+         break;
+   }
+}
+
+// The batch versions below do the same operations in the same order as the
+// ones above; only the bits that don't change from hop to hop are hoisted.
+// Keep them in step, or Testing::ibuBatchTest will complain.
+
+void IbuMethods::tinseth(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus)
+{
+   double const bignessFactor = 1.65 * pow(0.000125, (wort_grav - 1));
+
+   for( int i = 0; i < n; ++i )
+      ibus[i] = ((AArating[i] * hops_grams[i] * 1000) / finalVolume_liters) * ((1.0 - exp(-0.04 * minutes[i]))/4.15) * bignessFactor;
+}
+
+void IbuMethods::rager(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus)
+{
+   double const gravityFactor = (wort_grav > 1.050)? (wort_grav - 1.050)/0.2 : 0.0;
+   double const denominator = finalVolume_liters*(1+gravityFactor);
+
+   for( int i = 0; i < n; ++i )
+   {
+      double utilization = (18.11 + 13.86*tanh((minutes[i]-31.32)/18.17)) / 100.0;
+      ibus[i] = (hops_grams[i]*utilization*AArating[i]*1000)/denominator;
+   }
+}
+
+void IbuMethods::noonan(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus)
+{
+   double const volumeFactor = (Units::us_gallons->toSI(5.0))/ finalVolume_liters;
+   double const ounceGrams = Units::ounces->toSI(1.0) * 1000.0;
+   double const utilizationFactor = noonanUtilizationFactor(wort_grav);
+
+   // Utilization straight into the output, then scale it in place.
+   noonanPolynomial().eval(minutes, n, ibus);
+   for( int i = 0; i < n; ++i )
+      ibus[i] = volumeFactor * ( (hops_grams[i]/ounceGrams) * (100 * AArating[i]) * ibus[i] ) * utilizationFactor;
 }
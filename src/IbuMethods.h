@@ -20,6 +20,10 @@
 #ifndef _IBUMETHODS_H
 #define _IBUMETHODS_H
 
+#include "brewtarget.h"
+
+class Polynomial;
+
 /*!
  * \class IbuMethods
  * \author Philip G. Lee
@@ -41,6 +45,21 @@ public:
     * \param minutes - minutes that the hops are in the boil
     */
    static double getIbus(double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
+   //! getIbus() with \c formula instead of the one in the options
+   static double getIbus(Brewtarget::IbuType formula, double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
+
+   /*!
+    * \brief getIbus() for \c n hops in the same wort at once.
+    *
+    * The formula is picked once, and everything that only depends on the
+    * wort is worked out once, so the loops are left with straight arithmetic.
+    * Each \c ibus[i] is exactly what the single-hop getIbus() would say.
+    * \c ibus must not overlap the inputs.
+    */
+   static void getIbus(double const* AArating, double const* hops_grams, double const* minutes, int n,
+                       double finalVolume_liters, double wort_grav, double* ibus);
+   static void getIbus(Brewtarget::IbuType formula, double const* AArating, double const* hops_grams, double const* minutes, int n,
+                       double finalVolume_liters, double wort_grav, double* ibus);
 private:
    static double tinseth(double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
    static double rager(double AArating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
@@ -51,6 +70,15 @@ private:
     * \brief Calculates the IBU by Greg Noonans formula
     */
    static double noonan(double AARating, double hops_grams, double finalVolume_liters, double wort_grav, double minutes);
+
+   static void tinseth(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus);
+   static void rager(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus);
+   static void noonan(double const* AArating, double const* hops_grams, double const* minutes, int n, double finalVolume_liters, double wort_grav, double* ibus);
+
+   //! Noonan's utilization curve
+   static Polynomial const& noonanPolynomial();
+   //! Noonan's gravity correction, from his 60 minute table
+   static double noonanUtilizationFactor(double wort_grav);
 };
 
 #endif
@@ -0,0 +1,219 @@
+/*
+ * LibraryRecalculator.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LibraryRecalculator.h"
+#include "brewtarget.h"
+#include "database.h"
+#include "recipe.h"
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QRunnable>
+#include <QThread>
+#include <QTimer>
+
+// Few enough that a batch saves in the blink of an eye, enough that there
+// aren't hundreds of commits for a big library
+static const int defaultBatchSize = 50;
+
+class LibraryRecalculator::Task : public QRunnable
+{
+public:
+   Task( LibraryRecalculator* job, Item* item ) : _job(job), _item(item)
+   {
+      setAutoDelete(true);
+   }
+
+   void run()
+   {
+      _item->results = RecipeCalculator::calculate(_item->snapshot);
+      // saveBatch() counts us in on the main thread
+      QMetaObject::invokeMethod(_job, "saveBatch", Qt::QueuedConnection);
+   }
+
+private:
+   LibraryRecalculator* _job;
+   Item* _item;
+};
+
+LibraryRecalculator::LibraryRecalculator( QObject* parent )
+   : QObject(parent),
+     _batchSize(defaultBatchSize),
+     _next(0),
+     _done(0),
+     _pending(0),
+     _cancelled(false),
+     _running(false),
+     _restart(false)
+{
+   _pool.setMaxThreadCount( qMax(1, QThread::idealThreadCount()) );
+}
+
+LibraryRecalculator::~LibraryRecalculator()
+{
+   // The tasks point into _batch
+   _pool.waitForDone();
+}
+
+void LibraryRecalculator::setBatchSize( int recipes )
+{
+   _batchSize = qMax(1, recipes);
+}
+
+int LibraryRecalculator::total() const
+{
+   return _recipes.size();
+}
+
+bool LibraryRecalculator::isRunning() const
+{
+   return _running;
+}
+
+void LibraryRecalculator::start()
+{
+   _cancelled = false;
+
+   // nextBatch() starts over once the pool is done with what it has
+   if( _running )
+   {
+      _restart = true;
+      return;
+   }
+
+   _running = true;
+   load();
+
+   QTimer::singleShot(0, this, SLOT(nextBatch()));
+}
+
+void LibraryRecalculator::load()
+{
+   _recipes.clear();
+   foreach( Recipe* rec, Database::instance().recipes() )
+   {
+      if( rec && !rec->deleted() )
+         _recipes.append(rec);
+   }
+
+   _next = 0;
+   _done = 0;
+
+   Brewtarget::log.info( QString("Recalculating %1 recipes").arg(_recipes.size()) );
+   emit progress(0, _recipes.size());
+}
+
+void LibraryRecalculator::cancel()
+{
+   _cancelled = true;
+}
+
+void LibraryRecalculator::nextBatch()
+{
+   if( _restart )
+   {
+      _restart = false;
+      load();
+   }
+
+   if( _cancelled || _next >= _recipes.size() )
+   {
+      finish();
+      return;
+   }
+
+   int end = qMin(_recipes.size(), _next + _batchSize);
+
+   // Snapshots talk to the database, so they have to happen here. The
+   // fingerprint has to be of what the snapshot saw.
+   _batch.clear();
+   _batch.reserve(end - _next);
+   for( ; _next < end; ++_next )
+   {
+      Recipe* rec = _recipes.at(_next);
+      if( rec == 0 )
+         continue;
+
+      Item item;
+      item.recipe = rec;
+      item.fingerprint = Database::instance().recipeFingerprint(rec);
+      item.snapshot = RecipeSnapshot::of(rec);
+      _batch.append(item);
+   }
+
+   // Everybody in it got deleted in the meantime
+   if( _batch.isEmpty() )
+   {
+      QTimer::singleShot(0, this, SLOT(nextBatch()));
+      return;
+   }
+
+   // Nothing appends to _batch from here until saveBatch() is done with it,
+   // so the tasks can hang on to their items.
+   _pending = _batch.size();
+   for( int i = 0; i < _batch.size(); ++i )
+      _pool.start( new Task(this, &_batch[i]) );
+}
+
+void LibraryRecalculator::saveBatch()
+{
+   // One call per task. Only the last one has anything to do.
+   if( --_pending > 0 )
+      return;
+
+   QElapsedTimer timer;
+   timer.start();
+
+   Database& db = Database::instance();
+   try {
+      db.beginBatch();
+      for( int i = 0; i < _batch.size(); ++i )
+      {
+         Item const& item = _batch.at(i);
+         // Deleted while we were busy
+         if( item.recipe.isNull() )
+            continue;
+         // Edited while we were busy. The recipe already recalculated
+         // itself, and these results would only undo that
+         if( db.recipeFingerprint(item.recipe) != item.fingerprint )
+            continue;
+         item.recipe->setCalcs(item.results, item.fingerprint);
+      }
+      db.commitBatch();
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e) );
+      db.rollbackBatch();
+      // Whatever went wrong will likely go wrong for the next batch too
+      _cancelled = true;
+   }
+
+   _done = _next;
+   Brewtarget::log.info( QString("Saved %1 recipes in %2 ms").arg(_batch.size()).arg(timer.elapsed()) );
+   _batch.clear();
+
+   emit progress(_done, _recipes.size());
+   QTimer::singleShot(0, this, SLOT(nextBatch()));
+}
+
+void LibraryRecalculator::finish()
+{
+   _running = false;
+   _restart = false;
+   _recipes.clear();
+   emit finished(_cancelled);
+}
@@ -0,0 +1,110 @@
+/*
+ * LibraryRecalculator.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LIBRARYRECALCULATOR_H
+#define _LIBRARYRECALCULATOR_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QPointer>
+#include <QString>
+#include <QThreadPool>
+#include "RecipeCalculator.h"
+
+class Recipe;
+
+/*!
+ * \class LibraryRecalculator
+ *
+ * \brief Recalculates every recipe in the database, for when something all
+ * of them depend on (the IBU or color formula, say) has changed.
+ *
+ * Recipes go through in batches. For each batch, the main thread takes the
+ * snapshots, a thread pool does the arithmetic, and the main thread saves
+ * the results in a single transaction. The event loop runs in between, so
+ * the window stays alive and cancel() gets heard. A cancelled job finishes
+ * the batch it is on; the rest simply recalculate the next time they load.
+ * A recipe edited while its batch was out is left alone, since what the
+ * pool worked out for it is already stale.
+ */
+class LibraryRecalculator : public QObject
+{
+   Q_OBJECT
+
+public:
+   LibraryRecalculator( QObject* parent = 0 );
+   virtual ~LibraryRecalculator();
+
+   //! How many recipes go to the pool, and to the database, at once
+   void setBatchSize( int recipes );
+   //! How many recipes there are to do, once start()ed
+   int total() const;
+   bool isRunning() const;
+
+public slots:
+   /*!
+    * Starts on the recipes in the database right now. If it is already
+    * running, it starts over once the current batch is saved, so nothing
+    * keeps what the old options said.
+    */
+   void start();
+   //! Stops after the current batch
+   void cancel();
+
+signals:
+   //! \c done of \c total recipes are saved
+   void progress( int done, int total );
+   //! Emitted exactly once, after the last batch is saved
+   void finished( bool cancelled );
+
+private slots:
+   void nextBatch();
+   void saveBatch();
+
+private:
+   //! \brief One recipe's worth of work
+   struct Item
+   {
+      QPointer<Recipe> recipe;
+      QString fingerprint;
+      RecipeSnapshot snapshot;
+      RecipeCalculator::Results results;
+   };
+
+   class Task;
+
+   //! Gathers up the recipes and starts counting from the first
+   void load();
+   void finish();
+
+   QList< QPointer<Recipe> > _recipes;
+   QVector<Item> _batch;
+   QThreadPool _pool;
+   int _batchSize;
+   int _next;
+   int _done;
+   //! Tasks of the current batch that are still out
+   int _pending;
+   bool _cancelled;
+   bool _running;
+   //! start() was called again while running
+   bool _restart;
+};
+
+#endif /* _LIBRARYRECALCULATOR_H */
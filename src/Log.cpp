@@ -19,29 +19,192 @@
 
 #include "Log.h"
 
+#include <atomic>
+#include <cstdint>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
 #include <QTime>
 
 const QString Log::filename = "brewtarget_log.txt";
 const QString Log::timeFormat = "hh:mm:ss.zzz";
 const QString Log::tmpl = "[%1] %2 : %3";
+const qint64 Log::maxFileSize = 4*1024*1024;
+const int Log::maxOldFiles = 3;
+const int Log::rateLimit[] = { 200, 200, 50, 50 };
+
+/*!
+ * \brief A bounded multi-producer queue that never takes a lock. It is
+ * Dmitry Vyukov's ring: each slot carries a sequence number that says
+ * whether it is free for the next producer or full for the consumer.
+ */
+class LogQueue
+{
+public:
+   LogQueue(int capacity)
+      : slots(new Slot[capacity]), mask(capacity-1), head(0), tail(0), dropped(0)
+   {
+      // capacity has to be a power of two for the mask to work
+      for( int i = 0; i < capacity; ++i )
+         slots[i].seq.store(i, std::memory_order_relaxed);
+   }
+
+   //! \brief false if the queue is full, in which case the entry is counted as dropped
+   bool push(QString const& entry)
+   {
+      size_t pos = head.load(std::memory_order_relaxed);
+      for(;;)
+      {
+         Slot& slot = slots[pos & mask];
+         size_t seq = slot.seq.load(std::memory_order_acquire);
+         intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+         if ( diff == 0 )
+         {
+            if ( head.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed) )
+            {
+               slot.entry = entry;
+               slot.seq.store(pos+1, std::memory_order_release);
+               return true;
+            }
+         }
+         else if ( diff < 0 )
+         {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+         }
+         else
+            pos = head.load(std::memory_order_relaxed);
+      }
+   }
+
+   //! \brief only ever called by one thread at a time
+   bool pop(QString& entry)
+   {
+      size_t pos = tail.load(std::memory_order_relaxed);
+      Slot& slot = slots[pos & mask];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      if ( static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos+1) < 0 )
+         return false;
+
+      entry = slot.entry;
+      slot.entry.clear();
+      tail.store(pos+1, std::memory_order_relaxed);
+      slot.seq.store(pos + mask + 1, std::memory_order_release);
+      return true;
+   }
+
+   ~LogQueue() { delete[] slots; }
+
+   bool isEmpty() const
+   {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+   }
+
+   int takeDropped() { return dropped.exchange(0); }
+
+private:
+   struct Slot
+   {
+      Slot() : seq(0) {}
+      std::atomic<size_t> seq;
+      QString entry;
+   };
+
+   Slot* slots;
+   const size_t mask;
+   std::atomic<size_t> head;
+   std::atomic<size_t> tail;
+   std::atomic<int> dropped;
+};
+
+/*!
+ * \brief Drains the queue into the file. It sleeps on Log::pending until
+ * somebody queues something.
+ */
+class LogWriter : public QThread
+{
+public:
+   LogWriter(Log* log) : QThread(), _log(log), _stop(false) {}
+
+   void stop()
+   {
+      _stop.store(true);
+      _log->pending.release();
+   }
+
+protected:
+   void run()
+   {
+      for(;;)
+      {
+         // One release per entry. Take them all and write them all
+         _log->pending.acquire(qMax(1, _log->pending.available()));
+         _log->drain();
+         if ( _stop.load() )
+            return;
+      }
+   }
+
+private:
+   Log* _log;
+   std::atomic<bool> _stop;
+};
+
+namespace {
+
+// One window per level. Plain atomics, so checking costs no more than the
+// message formatting already did
+struct RateWindow
+{
+   std::atomic<qint64> start_ms;
+   std::atomic<int> count;
+   std::atomic<int> suppressed;
+};
+
+RateWindow rateWindows[Log::LogType_ERROR+1];
+
+QElapsedTimer& logClock()
+{
+   static QElapsedTimer clock;
+   if ( ! clock.isValid() )
+      clock.start();
+   return clock;
+}
+
+}
 
 Log::Log(bool isLoggingToStderr)
    : errStream(stderr),
      file(),
      isLoggingToStderr(isLoggingToStderr),
-     stream(NULL) {
+     stream(NULL),
+     queue(new LogQueue(8192)),
+     writer(0) {
 }
 
 Log::~Log() {
+   // Whatever happens, what was logged gets written
+   LogWriter* w = writer.fetchAndStoreOrdered(0);
+   if ( w ) {
+      w->stop();
+      w->wait();
+      delete w;
+   }
+   drain();
+
    delete stream;
    stream = NULL;
    if( file.isOpen() )
       file.close();   
+   delete queue;
 }
 
 void Log::changeDirectory(const QDir defaultDir) {
+   QMutexLocker locker(&mutex);
+
    if (stream) {
+      locker.unlock();
       doLog(LogType_ERROR, "Cannot change logging directory after it is initialized.");
       return;
    }
@@ -56,10 +219,12 @@ void Log::changeDirectory(const QDir defaultDir) {
    file.setFileName(QDir::temp().filePath(filename));
    if( file.open(QFile::WriteOnly | QFile::Truncate) ) {
       stream = new QTextStream(&file);
+      locker.unlock();
       warn(QString("Log is in a temporary directory: %1").arg(file.fileName()));
       return;
    }
 
+   locker.unlock();
    warn(QString("Could not create a log file."));
 }
 
@@ -80,21 +245,124 @@ void Log::error(const QString message) {
 }
 
 void Log::doLog(const LogType lt, const QString message) {
+   if ( ! allowed(lt) )
+      return;
+
    QString logEntry = tmpl
          .arg(QTime::currentTime().toString(timeFormat))
          .arg(getTypeName(lt))
          .arg(message);
 
-   mutex.lock();
-   if (isLoggingToStderr)
-      errStream << logEntry << endl;
-   if (stream)
-      *stream << logEntry << endl;
-   mutex.unlock();
+   enqueue(logEntry);
+
+   // The writer gets started by whoever logs first. Two threads can both get
+   // here first, but only one of them gets to keep its writer, and the other
+   // one's never started
+   if ( writer.loadAcquire() == 0 ) {
+      LogWriter* w = new LogWriter(this);
+      if ( writer.testAndSetOrdered(0, w) )
+         w->start(QThread::LowPriority);
+      else
+         delete w;
+   }
 
    emit wroteEntry(logEntry);
 }
 
+void Log::enqueue(const QString& entry) {
+   // A full queue counts the entry as dropped, and drain() says so
+   queue->push(entry);
+   pending.release();
+}
+
+bool Log::allowed(const LogType lt) {
+   RateWindow& w = rateWindows[lt];
+   qint64 now = logClock().elapsed();
+   qint64 start = w.start_ms.load();
+
+   // New second. Whoever wins the exchange resets the window and owns up to
+   // what got thrown away in the last one.
+   if ( now - start >= 1000 && w.start_ms.compare_exchange_strong(start, now) ) {
+      w.count.store(0);
+      int suppressed = w.suppressed.exchange(0);
+      if ( suppressed > 0 )
+         enqueue(tmpl.arg(QTime::currentTime().toString(timeFormat))
+                         .arg(getTypeName(lt))
+                         .arg(QString("%1 messages suppressed").arg(suppressed)));
+   }
+
+   if ( w.count.fetch_add(1) < rateLimit[lt] )
+      return true;
+
+   w.suppressed.fetch_add(1);
+   return false;
+}
+
+void Log::drain() {
+   QString entry;
+   QMutexLocker locker(&mutex);
+
+   int dropped = queue->takeDropped();
+   if ( dropped > 0 ) {
+      QString note = tmpl.arg(QTime::currentTime().toString(timeFormat))
+                         .arg(getTypeName(LogType_WARNING))
+                         .arg(QString("log queue full, %1 messages dropped").arg(dropped));
+      if (isLoggingToStderr)
+         errStream << note << endl;
+      if (stream)
+         *stream << note << endl;
+   }
+
+   bool wrote = false;
+   while ( queue->pop(entry) ) {
+      if (isLoggingToStderr)
+         errStream << entry << '\n';
+      if (stream)
+         *stream << entry << '\n';
+      wrote = true;
+   }
+
+   if ( ! wrote )
+      return;
+
+   errStream.flush();
+   if ( stream ) {
+      stream->flush();
+      if ( file.size() > maxFileSize )
+         rotate();
+   }
+}
+
+void Log::rotate() {
+   QString name = file.fileName();
+   QFileInfo info(name);
+   QDir dir = info.absoluteDir();
+   QString base = info.completeBaseName();
+   QString suffix = info.suffix();
+
+   delete stream;
+   stream = NULL;
+   file.close();
+
+   // brewtarget_log.2.txt -> brewtarget_log.3.txt, and so on. The oldest
+   // falls off the end.
+   dir.remove(QString("%1.%2.%3").arg(base).arg(maxOldFiles).arg(suffix));
+   for( int i = maxOldFiles - 1; i >= 1; --i )
+      dir.rename(QString("%1.%2.%3").arg(base).arg(i).arg(suffix),
+                 QString("%1.%2.%3").arg(base).arg(i+1).arg(suffix));
+   dir.rename(info.fileName(), QString("%1.1.%2").arg(base).arg(suffix));
+
+   file.setFileName(name);
+   if ( file.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+      stream = new QTextStream(&file);
+}
+
+void Log::flush() {
+   // The writer may be halfway through a batch, so empty the queue ourselves
+   // and let the mutex sort out who writes what
+   drain();
+}
+
 QString Log::getTypeName(const LogType type) const {
    switch(type) {
       case LogType_DEBUG: return "DEBUG";
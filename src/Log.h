@@ -20,22 +20,34 @@
 #ifndef _LOG_H
 #define _LOG_H
 
+#include <QAtomicPointer>
 #include <QDir>
 #include <QObject>
 #include <QMutex>
+#include <QSemaphore>
 #include <QString>
 #include <QTextStream>
 
+class LogQueue;
+class LogWriter;
+
 /*!
  * \class Log
  *
  * \brief Provides a proxy to an OS agnostic Log file.
+ *
+ * Callers only format their message, push it on a lock-free queue and
+ * wake the writer up. A background thread does the actual writing, rotates the file when it gets
+ * too big, and everything still queued is written out before we exit. Each
+ * level is rate limited, so an error storm costs the caller next to nothing
+ * and leaves a "suppressed" note instead of a million lines.
  */
 class Log : public QObject
 {
    Q_OBJECT
 
    friend class Brewtarget;
+   friend class LogWriter;
    
 public:
    ~Log();
@@ -49,6 +61,9 @@ public:
    //! \brief Logs a severe error. This is a potential fatal error.
    void error(const QString message);
 
+   //! \brief Blocks until everything logged so far is on disk.
+   void flush();
+
    //! \brief The log level of a message.
    enum LogType {
       //! Meant for debugging only. If we see this in prod, we can safely remove.
@@ -69,18 +84,41 @@ private:
    QFile file;
    bool isLoggingToStderr;
    QTextStream* stream;
+   //! \brief guards the file and streams. drain() and changeDirectory()
+   //  take it, never doLog()
    QMutex mutex;
+   LogQueue* queue;
+   //! \brief started by whoever logs first, from whatever thread that is
+   QAtomicPointer<LogWriter> writer;
+   //! \brief one release per queued entry, so the writer sleeps until there is work
+   QSemaphore pending;
 
    static const QString filename;
    static const QString timeFormat;
    static const QString tmpl;
+   //! \brief rotate once the file gets this big
+   static const qint64 maxFileSize;
+   //! \brief how many old files to keep around
+   static const int maxOldFiles;
+   //! \brief messages of one level allowed per second, indexed by LogType
+   static const int rateLimit[];
+
    Log(bool isLoggingToStderr);
 
    //! \brief Sets the default directory of the log file
    //! \param defaultDir The directory which will host the log file.
    void changeDirectory(const QDir defaultDir);
    void doLog(const LogType lt, const QString message);
+   //! \brief puts \c entry on the queue and wakes the writer
+   void enqueue(const QString& entry);
    QString getTypeName(const LogType type) const;
+   //! \brief false if \c lt has used up its share for this second
+   bool allowed(const LogType lt);
+
+   //! \brief writes out whatever is queued. Writer thread, or us once it is gone
+   void drain();
+   //! \brief moves brewtarget_log.txt to brewtarget_log.1.txt and so on
+   void rotate();
 };
 
 #endif /* _LOG_H */
@@ -56,6 +56,7 @@
 #include <QBrush>
 #include <QPen>
 #include <QDesktopWidget>
+#include <QSignalMapper>
 
 #include "Algorithms.h"
 #include "MashStepEditor.h"
@@ -73,6 +74,7 @@
 #include "recipe.h"
 #include "MainWindow.h"
 #include "AboutDialog.h"
+#include "MemoryDialog.h"
 #include "database.h"
 #include "YeastDialog.h"
 #include "config.h"
@@ -116,15 +118,40 @@
 #include "StyleSortFilterProxyModel.h"
 #include "NamedMashEditor.h"
 #include "BtDatePopup.h"
+#include "PropertyIds.h"
+#include "LibraryRecalculator.h"
+#include "BtLocale.h"
+#include "PrintPipeline.h"
+#include "Trace.h"
+#include <QProgressDialog>
 #if defined(Q_OS_WIN)
    #include <windows.h>
 #endif
 
+namespace {
+
+// The constructor is one long run of phases, so rather than scoping each in
+// a TraceSpan, close the one that started at start_us and begin the next
+qint64 startupPhase(const char* name, qint64 start_us)
+{
+   if ( start_us < 0 )
+      return -1;
+
+   qint64 now = Trace::now_us();
+   Trace::complete(name, "startup", start_us, now - start_us);
+   return now;
+}
+
+}
+
 MainWindow::MainWindow(QWidget* parent)
         : QMainWindow(parent)
 {
+   qint64 phase = Trace::isEnabled() ? Trace::now_us() : -1;
+
    // Need to call this to get all the widgets added (I think).
    setupUi(this);
+   phase = startupPhase("MainWindow setupUi", phase);
 
    /* PLEASE DO NOT REMOVE. 
     This code is left here, commented out, intentionally. The only way I can
@@ -133,6 +160,7 @@ MainWindow::MainWindow(QWidget* parent)
     PLEASE DO NOT REMOVE.
    QLocale german(QLocale::German,QLocale::Germany);
    QLocale::setDefault(german);
+   BtLocale::localeChanged();
    */
 
    QDesktopWidget *desktop = QApplication::desktop();
@@ -158,35 +186,14 @@ MainWindow::MainWindow(QWidget* parent)
    // Null out the recipe
    recipeObs = 0;
 
-   dialog_about = new AboutDialog(this);
-   equipEditor = new EquipmentEditor(this);
-   singleEquipEditor = new EquipmentEditor(this, true);
-   fermDialog = new FermentableDialog(this);
-   fermEditor = new FermentableEditor(this);
-   hopDialog = new HopDialog(this);
-   hopEditor = new HopEditor(this);
-   mashEditor = new MashEditor(this);
-   mashStepEditor = new MashStepEditor(this);
-   mashWizard = new MashWizard(this);
-   miscDialog = new MiscDialog(this);
-   miscEditor = new MiscEditor(this);
-   styleEditor = new StyleEditor(this);
-   singleStyleEditor = new StyleEditor(this,true);
-   yeastDialog = new YeastDialog(this);
-   yeastEditor = new YeastEditor(this);
-   optionDialog = new OptionDialog(this);
-   recipeScaler = new ScaleRecipeTool(this);
+   // The dialogs and tools get built the first time somebody needs one. Most
+   // people open two or three of them a session, and several build models
+   // over the whole database.
    recipeFormatter = new RecipeFormatter(this);
-   ogAdjuster = new OgAdjuster(this);
-   converterTool = new ConverterTool(this);
-   hydrometerTool = new HydrometerTool(this);
-   timerMainDialog = new TimerMainDialog(this);
-   primingDialog = new PrimingDialog(this);
-   strikeWaterDialog = new StrikeWaterDialog(this);
-   refractoDialog = new RefractoDialog(this);
-   mashDesigner = new MashDesigner(this);
-   pitchDialog = new PitchDialog(this);
-   btDatePopup = new BtDatePopup(this);
+   toolShower = new QSignalMapper(this);
+   connect( toolShower, SIGNAL(mapped(QString)), this, SLOT(showTool(QString)) );
+   registerTools();
+   phase = startupPhase("MainWindow dialogs", phase);
 
    styleRangeWidget_og->setRange(1.000, 1.120);
    styleRangeWidget_og->setPrecision(3);
@@ -249,11 +256,6 @@ MainWindow::MainWindow(QWidget* parent)
    mashListModel =  new MashListModel(mashComboBox);
    mashComboBox->setModel(mashListModel);
 
-   // Nothing to say.
-   namedMashEditor = new NamedMashEditor(this, mashStepEditor);
-   // I don't think this is used yet
-   singleNamedMashEditor = new NamedMashEditor(this,mashStepEditor,true);
-
    // Set table models.
    // Fermentables
    fermTableModel = new FermentableTableModel(fermentableTable);
@@ -306,6 +308,8 @@ MainWindow::MainWindow(QWidget* parent)
    yeastTable->setSortingEnabled(true);
    yeastTableProxy->setDynamicSortFilter(true);
 
+   phase = startupPhase("MainWindow models", phase);
+
    // Create the keyboard shortcuts
    setupShortCuts();
 
@@ -313,19 +317,6 @@ MainWindow::MainWindow(QWidget* parent)
    printer = new QPrinter;
    printer->setPageSize(QPrinter::Letter);
 
-   // Set up the fileOpener dialog.
-   fileOpener = new QFileDialog(this, tr("Open"), QDir::homePath(), tr("BeerXML files (*.xml)"));
-   fileOpener->setAcceptMode(QFileDialog::AcceptOpen);
-   fileOpener->setFileMode(QFileDialog::ExistingFiles);
-   fileOpener->setViewMode(QFileDialog::List);
-
-   // Set up the fileSaver dialog.
-   fileSaver = new QFileDialog(this, tr("Save"), QDir::homePath(), tr("BeerXML files (*.xml)") );
-   fileSaver->setAcceptMode(QFileDialog::AcceptSave);
-   fileSaver->setFileMode(QFileDialog::AnyFile);
-   fileSaver->setViewMode(QFileDialog::List);
-   fileSaver->setDefaultSuffix(QString("xml"));
-
    // Do some magic on the splitter widget to keep the tree from expanding
    splitter_vertical->setStretchFactor(0,0);
    splitter_vertical->setStretchFactor(1,1);
@@ -348,6 +339,8 @@ MainWindow::MainWindow(QWidget* parent)
       this->resize(width/2,height/2);
    }
 
+   phase = startupPhase("MainWindow trees and menus", phase);
+
    // If we saved the selected recipe name the last time we ran, select it and show it.
    if (Brewtarget::hasOption("recipeKey"))
    {
@@ -365,6 +358,8 @@ MainWindow::MainWindow(QWidget* parent)
          setRecipe( recs[0] );
    }
 
+   phase = startupPhase("MainWindow first recipe", phase);
+
    //UI restore state
    if (Brewtarget::hasOption("MainWindow/splitter_vertical_State"))
       splitter_vertical->restoreState(Brewtarget::option("MainWindow/splitter_vertical_State").toByteArray());
@@ -390,31 +385,32 @@ MainWindow::MainWindow(QWidget* parent)
    // Connect signals.
    // actions
    connect( actionExit, SIGNAL( triggered() ), this, SLOT( close() ) );
-   connect( actionAbout_BrewTarget, SIGNAL( triggered() ), dialog_about, SLOT( show() ) );
+   showToolOn( actionAbout_BrewTarget, SIGNAL(triggered()), "dialog_about" );
+   showToolOn( actionMemory_Usage, SIGNAL(triggered()), "memoryDialog" );
    connect( actionNewRecipe, SIGNAL( triggered() ), this, SLOT( newRecipe() ) );
    connect( actionImport_Recipes, SIGNAL( triggered() ), this, SLOT( importFiles() ) );
    connect( actionExportRecipe, SIGNAL( triggered() ), this, SLOT( exportRecipe() ) );
-   connect( actionEquipments, SIGNAL( triggered() ), equipEditor, SLOT( show() ) );
-   connect( actionMashs, SIGNAL( triggered() ), namedMashEditor, SLOT( show() ) );
-   connect( actionStyles, SIGNAL( triggered() ), styleEditor, SLOT( show() ) );
-   connect( actionFermentables, SIGNAL( triggered() ), fermDialog, SLOT( show() ) );
-   connect( actionHops, SIGNAL( triggered() ), hopDialog, SLOT( show() ) );
-   connect( actionMiscs, SIGNAL( triggered() ), miscDialog, SLOT( show() ) );
-   connect( actionYeasts, SIGNAL( triggered() ), yeastDialog, SLOT( show() ) );
-   connect( actionOptions, SIGNAL( triggered() ), optionDialog, SLOT( show() ) );
+   showToolOn( actionEquipments, SIGNAL(triggered()), "equipEditor" );
+   showToolOn( actionMashs, SIGNAL(triggered()), "namedMashEditor" );
+   showToolOn( actionStyles, SIGNAL(triggered()), "styleEditor" );
+   showToolOn( actionFermentables, SIGNAL(triggered()), "fermDialog" );
+   showToolOn( actionHops, SIGNAL(triggered()), "hopDialog" );
+   showToolOn( actionMiscs, SIGNAL(triggered()), "miscDialog" );
+   showToolOn( actionYeasts, SIGNAL(triggered()), "yeastDialog" );
+   showToolOn( actionOptions, SIGNAL(triggered()), "optionDialog" );
    connect( actionManual, SIGNAL( triggered() ), this, SLOT( openManual() ) );
-   connect( actionScale_Recipe, SIGNAL( triggered() ), recipeScaler, SLOT( show() ) );
+   showToolOn( actionScale_Recipe, SIGNAL(triggered()), "recipeScaler" );
    connect( action_recipeToTextClipboard, SIGNAL( triggered() ), recipeFormatter, SLOT( toTextClipboard() ) );
-   connect( actionConvert_Units, SIGNAL( triggered() ), converterTool, SLOT( show() ) );
-   connect( actionHydrometer_Temp_Adjustment, SIGNAL( triggered() ), hydrometerTool, SLOT( show() ) );
-   connect( actionOG_Correction_Help, SIGNAL( triggered() ), ogAdjuster, SLOT( show() ) );
+   showToolOn( actionConvert_Units, SIGNAL(triggered()), "converterTool" );
+   showToolOn( actionHydrometer_Temp_Adjustment, SIGNAL(triggered()), "hydrometerTool" );
+   showToolOn( actionOG_Correction_Help, SIGNAL(triggered()), "ogAdjuster" );
    connect( actionCopy_Recipe, SIGNAL( triggered() ), this, SLOT( copyRecipe() ) );
-   connect( actionPriming_Calculator, SIGNAL( triggered() ), primingDialog, SLOT( show() ) );
-   connect( actionStrikeWater_Calculator, SIGNAL( triggered() ), strikeWaterDialog, SLOT( show() ) );
-   connect( actionRefractometer_Tools, SIGNAL( triggered() ), refractoDialog, SLOT( show() ) );
+   showToolOn( actionPriming_Calculator, SIGNAL(triggered()), "primingDialog" );
+   showToolOn( actionStrikeWater_Calculator, SIGNAL(triggered()), "strikeWaterDialog" );
+   showToolOn( actionRefractometer_Tools, SIGNAL(triggered()), "refractoDialog" );
    connect( actionPitch_Rate_Calculator, SIGNAL(triggered()), this, SLOT(showPitchDialog()));
    connect( actionMergeDatabases, SIGNAL(triggered()), this, SLOT(updateDatabase()) );
-   connect( actionTimers, SIGNAL(triggered()), timerMainDialog, SLOT(show()) );
+   showToolOn( actionTimers, SIGNAL(triggered()), "timerMainDialog" );
    connect( actionDeleteSelected, SIGNAL(triggered()), this, SLOT(deleteSelected()) );
 
    // postgresql cannot backup or restore yet. I would like to find some way
@@ -453,17 +449,17 @@ MainWindow::MainWindow(QWidget* parent)
    connect( styleButton, SIGNAL( clicked() ), this, SLOT(showStyleEditor()) );
 
    connect( mashComboBox, SIGNAL( activated(int) ), this, SLOT(updateRecipeMash()) );
-   connect( mashButton, SIGNAL( clicked() ), mashEditor, SLOT( showEditor() ) );
+   connect( mashButton, SIGNAL( clicked() ), this, SLOT( showMashEditor() ) );
 
    connect( lineEdit_name, SIGNAL( editingFinished() ), this, SLOT( updateRecipeName() ) );
    connect( lineEdit_batchSize, SIGNAL( textModified() ), this, SLOT( updateRecipeBatchSize() ) );
    connect( lineEdit_boilSize, SIGNAL( textModified() ), this, SLOT( updateRecipeBoilSize() ) );
    connect( lineEdit_boilTime, SIGNAL( textModified() ), this, SLOT( updateRecipeBoilTime() ) );
    connect( lineEdit_efficiency, SIGNAL( textModified() ), this, SLOT( updateRecipeEfficiency() ) );
-   connect( pushButton_addFerm, SIGNAL( clicked() ), fermDialog, SLOT( show() ) );
-   connect( pushButton_addHop, SIGNAL( clicked() ), hopDialog, SLOT( show() ) );
-   connect( pushButton_addMisc, SIGNAL( clicked() ), miscDialog, SLOT( show() ) );
-   connect( pushButton_addYeast, SIGNAL( clicked() ), yeastDialog, SLOT( show() ) );
+   showToolOn( pushButton_addFerm, SIGNAL(clicked()), "fermDialog" );
+   showToolOn( pushButton_addHop, SIGNAL(clicked()), "hopDialog" );
+   showToolOn( pushButton_addMisc, SIGNAL(clicked()), "miscDialog" );
+   showToolOn( pushButton_addYeast, SIGNAL(clicked()), "yeastDialog" );
    connect( pushButton_removeFerm, SIGNAL( clicked() ), this, SLOT( removeSelectedFermentable() ) );
    connect( pushButton_removeHop, SIGNAL( clicked() ), this, SLOT( removeSelectedHop() ) );
    connect( pushButton_removeMisc, SIGNAL( clicked() ), this, SLOT( removeSelectedMisc() ) );
@@ -472,13 +468,13 @@ MainWindow::MainWindow(QWidget* parent)
    connect( pushButton_editMisc, SIGNAL( clicked() ), this, SLOT( editSelectedMisc() ) );
    connect( pushButton_editHop, SIGNAL( clicked() ), this, SLOT( editSelectedHop() ) );
    connect( pushButton_editYeast, SIGNAL( clicked() ), this, SLOT( editSelectedYeast() ) );
-   connect( pushButton_editMash, SIGNAL( clicked() ), mashEditor, SLOT( showEditor() ) );
+   connect( pushButton_editMash, SIGNAL( clicked() ), this, SLOT( showMashEditor() ) );
    connect( pushButton_addMashStep, SIGNAL( clicked() ), this, SLOT(addMashStep()) );
    connect( pushButton_removeMashStep, SIGNAL( clicked() ), this, SLOT(removeSelectedMashStep()) );
    connect( pushButton_editMashStep, SIGNAL( clicked() ), this, SLOT(editSelectedMashStep()) );
-   connect( pushButton_mashWizard, SIGNAL( clicked() ), mashWizard, SLOT( show() ) );
+   showToolOn( pushButton_mashWizard, SIGNAL(clicked()), "mashWizard" );
    connect( pushButton_saveMash, SIGNAL( clicked() ), this, SLOT( saveMash() ) );
-   connect( pushButton_mashDes, SIGNAL( clicked() ), mashDesigner, SLOT( show() ) );
+   showToolOn( pushButton_mashDes, SIGNAL(clicked()), "mashDesigner" );
    connect( pushButton_mashUp, SIGNAL( clicked() ), this, SLOT( moveSelectedMashStepUp() ) );
    connect( pushButton_mashDown, SIGNAL( clicked() ), this, SLOT( moveSelectedMashStepDown() ) );
    connect( pushButton_mashRemove, SIGNAL( clicked() ), this, SLOT( removeMash() ) );
@@ -495,6 +491,135 @@ MainWindow::MainWindow(QWidget* parent)
    // No connections from the database yet? Oh FSM, that probably means I'm
    // doing it wrong again.
    connect( &(Database::instance()), SIGNAL( deletedSignal(BrewNote*)), this, SLOT( closeBrewNote(BrewNote*)));
+
+}
+
+void MainWindow::registerTools()
+{
+   // Anything that follows the current recipe gets caught up with it when it
+   // is built. After that, setRecipe() and friends keep it current.
+   toolFactories["dialog_about"]      = [this]() -> QWidget* { return new AboutDialog(this); };
+   toolFactories["memoryDialog"]      = [this]() -> QWidget* { return new MemoryDialog(this); };
+   toolFactories["equipEditor"]       = [this]() -> QWidget* { return new EquipmentEditor(this); };
+   toolFactories["singleEquipEditor"] = [this]() -> QWidget* {
+      EquipmentEditor* e = new EquipmentEditor(this, true);
+      if ( recipeObs )
+         e->setEquipment(recEquip);
+      return e;
+   };
+   toolFactories["fermDialog"]        = [this]() -> QWidget* { return new FermentableDialog(this); };
+   toolFactories["fermEditor"]        = [this]() -> QWidget* { return new FermentableEditor(this); };
+   toolFactories["hopDialog"]         = [this]() -> QWidget* { return new HopDialog(this); };
+   toolFactories["hopEditor"]         = [this]() -> QWidget* { return new HopEditor(this); };
+   toolFactories["mashEditor"]        = [this]() -> QWidget* {
+      MashEditor* e = new MashEditor(this);
+      if ( recipeObs )
+      {
+         e->setMash(recipeObs->mash());
+         e->setEquipment(recEquip);
+      }
+      return e;
+   };
+   toolFactories["mashStepEditor"]    = [this]() -> QWidget* { return new MashStepEditor(this); };
+   toolFactories["mashWizard"]        = [this]() -> QWidget* {
+      MashWizard* w = new MashWizard(this);
+      w->setRecipe(recipeObs);
+      return w;
+   };
+   toolFactories["miscDialog"]        = [this]() -> QWidget* { return new MiscDialog(this); };
+   toolFactories["miscEditor"]        = [this]() -> QWidget* { return new MiscEditor(this); };
+   toolFactories["styleEditor"]       = [this]() -> QWidget* { return new StyleEditor(this); };
+   toolFactories["singleStyleEditor"] = [this]() -> QWidget* {
+      StyleEditor* e = new StyleEditor(this, true);
+      if ( recipeObs )
+         e->setStyle(recStyle);
+      return e;
+   };
+   toolFactories["yeastDialog"]       = [this]() -> QWidget* { return new YeastDialog(this); };
+   toolFactories["yeastEditor"]       = [this]() -> QWidget* { return new YeastEditor(this); };
+   toolFactories["optionDialog"]      = [this]() -> QWidget* { return new OptionDialog(this); };
+   toolFactories["recipeScaler"]      = [this]() -> QWidget* {
+      ScaleRecipeTool* t = new ScaleRecipeTool(this);
+      t->setRecipe(recipeObs);
+      return t;
+   };
+   toolFactories["ogAdjuster"]        = [this]() -> QWidget* {
+      OgAdjuster* t = new OgAdjuster(this);
+      t->setRecipe(recipeObs);
+      return t;
+   };
+   toolFactories["converterTool"]     = [this]() -> QWidget* { return new ConverterTool(this); };
+   toolFactories["hydrometerTool"]    = [this]() -> QWidget* { return new HydrometerTool(this); };
+   toolFactories["timerMainDialog"]   = [this]() -> QWidget* { return new TimerMainDialog(this); };
+   toolFactories["primingDialog"]     = [this]() -> QWidget* { return new PrimingDialog(this); };
+   toolFactories["strikeWaterDialog"] = [this]() -> QWidget* { return new StrikeWaterDialog(this); };
+   toolFactories["refractoDialog"]    = [this]() -> QWidget* { return new RefractoDialog(this); };
+   toolFactories["mashDesigner"]      = [this]() -> QWidget* {
+      MashDesigner* d = new MashDesigner(this);
+      d->setRecipe(recipeObs);
+      return d;
+   };
+   toolFactories["pitchDialog"]       = [this]() -> QWidget* { return new PitchDialog(this); };
+   toolFactories["btDatePopup"]       = [this]() -> QWidget* { return new BtDatePopup(this); };
+   toolFactories["namedMashEditor"]   = [this]() -> QWidget* {
+      return new NamedMashEditor(this, tool<MashStepEditor>("mashStepEditor"));
+   };
+   // I don't think this is used yet
+   toolFactories["singleNamedMashEditor"] = [this]() -> QWidget* {
+      return new NamedMashEditor(this, tool<MashStepEditor>("mashStepEditor"), true);
+   };
+   toolFactories["fileOpener"]        = [this]() -> QWidget* {
+      QFileDialog* d = new QFileDialog(this, tr("Open"), QDir::homePath(), tr("BeerXML files (*.xml)"));
+      d->setAcceptMode(QFileDialog::AcceptOpen);
+      d->setFileMode(QFileDialog::ExistingFiles);
+      d->setViewMode(QFileDialog::List);
+      return d;
+   };
+   toolFactories["fileSaver"]         = [this]() -> QWidget* {
+      QFileDialog* d = new QFileDialog(this, tr("Save"), QDir::homePath(), tr("BeerXML files (*.xml)") );
+      d->setAcceptMode(QFileDialog::AcceptSave);
+      d->setFileMode(QFileDialog::AnyFile);
+      d->setViewMode(QFileDialog::List);
+      d->setDefaultSuffix(QString("xml"));
+      return d;
+   };
+}
+
+QWidget* MainWindow::tool(QString const& name)
+{
+   QWidget* ret = tools.value(name, 0);
+   if ( ret )
+      return ret;
+
+   if ( ! toolFactories.contains(name) )
+   {
+      Brewtarget::logE( QString("%1 nobody knows how to build %2").arg(Q_FUNC_INFO).arg(name) );
+      return 0;
+   }
+
+   TraceSpan span("MainWindow::tool", "ui", Trace::isEnabled() ? name : QString());
+   ret = toolFactories[name]();
+   tools.insert(name, ret);
+
+   return ret;
+}
+
+void MainWindow::showToolOn(QObject* sender, const char* signal, QString const& name)
+{
+   toolShower->setMapping(sender, name);
+   connect( sender, signal, toolShower, SLOT(map()) );
+}
+
+void MainWindow::showTool(QString const& name)
+{
+   QWidget* t = tool(name);
+   if ( t )
+      t->show();
+}
+
+void MainWindow::showMashEditor()
+{
+   tool<MashEditor>("mashEditor")->showEditor();
 }
 
 void MainWindow::setupShortCuts()
@@ -557,6 +682,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          kit = active->equipment(index);
          if ( kit )
          {
+            EquipmentEditor* singleEquipEditor = tool<EquipmentEditor>("singleEquipEditor");
             singleEquipEditor->setEquipment(kit);
             singleEquipEditor->show();
          }
@@ -565,6 +691,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          ferm = active->fermentable(index);
          if ( ferm )
          {
+            FermentableEditor* fermEditor = tool<FermentableEditor>("fermEditor");
             fermEditor->setFermentable(ferm);
             fermEditor->show();
          }
@@ -573,6 +700,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          h = active->hop(index);
          if (h)
          {
+            HopEditor* hopEditor = tool<HopEditor>("hopEditor");
             hopEditor->setHop(h);
             hopEditor->show();
          }
@@ -581,6 +709,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          m = active->misc(index);
          if (m)
          {
+            MiscEditor* miscEditor = tool<MiscEditor>("miscEditor");
             miscEditor->setMisc(m);
             miscEditor->show();
          }
@@ -589,6 +718,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          s = active->style(index);
          if ( s )
          {
+            StyleEditor* singleStyleEditor = tool<StyleEditor>("singleStyleEditor");
             singleStyleEditor->setStyle(s);
             singleStyleEditor->show();
          }
@@ -597,6 +727,7 @@ void MainWindow::treeActivated(const QModelIndex &index)
          y = active->yeast(index);
          if (y)
          {
+            YeastEditor* yeastEditor = tool<YeastEditor>("yeastEditor");
             yeastEditor->setYeast(y);
             yeastEditor->show();
          }
@@ -736,24 +867,34 @@ void MainWindow::setRecipe(Recipe* recipe)
          tabWidget_recipeView->removeTab(i);
    }
 
-   // Tell some of our other widgets to observe the new recipe.
-   mashWizard->setRecipe(recipe);
+   // Tell some of our other widgets to observe the new recipe. The tools
+   // nobody has opened yet pick it up when they get built.
+   if ( MashWizard* mashWizard = builtTool<MashWizard>("mashWizard") )
+      mashWizard->setRecipe(recipe);
    brewDayScrollWidget->setRecipe(recipe);
    equipmentListModel->observeRecipe(recipe);
    recipeFormatter->setRecipe(recipe);
-   ogAdjuster->setRecipe(recipe);
+   if ( OgAdjuster* ogAdjuster = builtTool<OgAdjuster>("ogAdjuster") )
+      ogAdjuster->setRecipe(recipe);
    recipeExtrasWidget->setRecipe(recipe);
-   mashDesigner->setRecipe(recipe);
+   if ( MashDesigner* mashDesigner = builtTool<MashDesigner>("mashDesigner") )
+      mashDesigner->setRecipe(recipe);
    equipmentButton->setRecipe(recipe);
-   singleEquipEditor->setEquipment(recEquip);
+   if ( EquipmentEditor* singleEquipEditor = builtTool<EquipmentEditor>("singleEquipEditor") )
+      singleEquipEditor->setEquipment(recEquip);
    styleButton->setRecipe(recipe);
-   singleStyleEditor->setStyle(recStyle);
+   if ( StyleEditor* singleStyleEditor = builtTool<StyleEditor>("singleStyleEditor") )
+      singleStyleEditor->setStyle(recStyle);
 
-   mashEditor->setMash(recipeObs->mash());
-   mashEditor->setEquipment(recEquip);
+   if ( MashEditor* mashEditor = builtTool<MashEditor>("mashEditor") )
+   {
+      mashEditor->setMash(recipeObs->mash());
+      mashEditor->setEquipment(recEquip);
+   }
 
    mashButton->setMash(recipeObs->mash());
-   recipeScaler->setRecipe(recipeObs);
+   if ( ScaleRecipeTool* recipeScaler = builtTool<ScaleRecipeTool>("recipeScaler") )
+      recipeScaler->setRecipe(recipeObs);
 
    // If you don't connect this late, every previous set of an attribute
    // causes this signal to be slotted, which then causes showChanges() to be
@@ -764,20 +905,22 @@ void MainWindow::setRecipe(Recipe* recipe)
 
 void MainWindow::changed(QMetaProperty prop, QVariant value)
 {
-   QString propName(prop.name());
+   int propId = BeerXMLElement::propertyId<Recipe>(prop);
 
-   if( propName == "equipment" )
+   if( propId == PropertyIds::Recipe::equipment )
    {
       Equipment* newRecEquip = qobject_cast<Equipment*>(BeerXMLElement::extractPtr(value));
       recEquip = newRecEquip;
 
-      singleEquipEditor->setEquipment(recEquip);
+      if ( EquipmentEditor* singleEquipEditor = builtTool<EquipmentEditor>("singleEquipEditor") )
+         singleEquipEditor->setEquipment(recEquip);
    }
-   else if( propName == "style" )
+   else if( propId == PropertyIds::Recipe::style )
    {
       //recStyle = recipeObs->style();
       recStyle = qobject_cast<Style*>(BeerXMLElement::extractPtr(value));
-      singleStyleEditor->setStyle(recStyle);
+      if ( StyleEditor* singleStyleEditor = builtTool<StyleEditor>("singleStyleEditor") )
+         singleStyleEditor->setStyle(recStyle);
 
    }
 
@@ -825,12 +968,7 @@ void MainWindow::showChanges(QMetaProperty* prop)
       return;
 
    bool updateAll = (prop == 0);
-   QString propName;
-
-   if( prop )
-   {
-      propName = prop->name();
-   }
+   int propId = prop ? BeerXMLElement::propertyId<Recipe>(*prop) : -1;
 
    // May St. Stevens preserve me
    lineEdit_name->setText(recipeObs->name());
@@ -884,7 +1022,7 @@ void MainWindow::showChanges(QMetaProperty* prop)
 
    // See if we need to change the mash in the table.
    if( (updateAll && recipeObs->mash()) ||
-       (propName == "mash" && recipeObs->mash()) )
+       (propId == PropertyIds::Recipe::mash && recipeObs->mash()) )
    {
       mashStepTableModel->setMash(recipeObs->mash());
    }
@@ -935,7 +1073,8 @@ void MainWindow::updateRecipeMash()
    if( selected )
    {
       Database::instance().addToRecipe( recipeObs, selected );
-      mashEditor->setMash(recipeObs->mash());
+      if ( MashEditor* mashEditor = builtTool<MashEditor>("mashEditor") )
+         mashEditor->setMash(recipeObs->mash());
       mashButton->setMash(recipeObs->mash());
    }
 }
@@ -977,7 +1116,8 @@ void MainWindow::droppedRecipeEquipment(Equipment *kit)
       recipeObs->setBatchSize_l( kit->batchSize_l() );
       recipeObs->setBoilSize_l( kit->boilSize_l() );
       recipeObs->setBoilTime_min( kit->boilTime_min() );
-      mashEditor->setEquipment(kit);
+      if ( MashEditor* mashEditor = builtTool<MashEditor>("mashEditor") )
+         mashEditor->setEquipment(kit);
    }
 }
 
@@ -1276,6 +1416,7 @@ void MainWindow::editSelectedFermentable()
    if( f == 0 )
       return;
 
+   FermentableEditor* fermEditor = tool<FermentableEditor>("fermEditor");
    fermEditor->setFermentable(f);
    fermEditor->show();
 }
@@ -1286,6 +1427,7 @@ void MainWindow::editSelectedMisc()
    if( m == 0 )
       return;
 
+   MiscEditor* miscEditor = tool<MiscEditor>("miscEditor");
    miscEditor->setMisc(m);
    miscEditor->show();
 }
@@ -1296,6 +1438,7 @@ void MainWindow::editSelectedHop()
    if( h == 0 )
       return;
 
+   HopEditor* hopEditor = tool<HopEditor>("hopEditor");
    hopEditor->setHop(h);
    hopEditor->show();
 }
@@ -1306,6 +1449,7 @@ void MainWindow::editSelectedYeast()
    if( y == 0 )
       return;
 
+   YeastEditor* yeastEditor = tool<YeastEditor>("yeastEditor");
    yeastEditor->setYeast(y);
    yeastEditor->show();
 }
@@ -1746,6 +1890,8 @@ void MainWindow::restoreFromBackup()
 // Imports all the recipes from a file into the database.
 void MainWindow::importFiles()
 {
+   QFileDialog* fileOpener = tool<QFileDialog>("fileOpener");
+
    if ( ! fileOpener->exec() )
       return;
 
@@ -1778,8 +1924,9 @@ void MainWindow::addMashStep()
    }
 
    MashStep* step = Database::instance().newMashStep(mash);
+   MashStepEditor* mashStepEditor = tool<MashStepEditor>("mashStepEditor");
    mashStepEditor->setMashStep(step);
-   mashStepEditor->setVisible(true);
+   mashStepEditor->show();
 }
 
 void MainWindow::removeSelectedMashStep()
@@ -1880,8 +2027,9 @@ void MainWindow::editSelectedMashStep()
    }
 
    MashStep* step = mashStepTableModel->getMashStep(row);
+   MashStepEditor* mashStepEditor = tool<MashStepEditor>("mashStepEditor");
    mashStepEditor->setMashStep(step);
-   mashStepEditor->setVisible(true);
+   mashStepEditor->show();
 }
 
 void MainWindow::removeMash()
@@ -1906,6 +2054,13 @@ void MainWindow::removeMash()
 
 }
 
+void MainWindow::changeEvent(QEvent* event)
+{
+   if( event->type() == QEvent::LocaleChange )
+      BtLocale::localeChanged();
+   QMainWindow::changeEvent(event);
+}
+
 void MainWindow::closeEvent(QCloseEvent* /*event*/)
 {
    Brewtarget::saveSystemOptions();
@@ -2053,14 +2208,15 @@ void MainWindow::contextMenu(const QPoint &point)
 void MainWindow::setupContextMenu()
 {
 
-   treeView_recipe->setupContextMenu(this,this);
-   treeView_equip->setupContextMenu(this,equipEditor);
+   // The trees only need their editors when somebody asks for something new
+   treeView_recipe->setupContextMenu(this,[this]() -> QWidget* { return this; });
+   treeView_equip->setupContextMenu(this,[this]() { return tool("equipEditor"); });
 
-   treeView_ferm->setupContextMenu(this,fermDialog);
-   treeView_hops->setupContextMenu(this,hopDialog);
-   treeView_misc->setupContextMenu(this,miscDialog);
-   treeView_style->setupContextMenu(this,singleStyleEditor);
-   treeView_yeast->setupContextMenu(this,yeastDialog);
+   treeView_ferm->setupContextMenu(this,[this]() { return tool("fermDialog"); });
+   treeView_hops->setupContextMenu(this,[this]() { return tool("hopDialog"); });
+   treeView_misc->setupContextMenu(this,[this]() { return tool("miscDialog"); });
+   treeView_style->setupContextMenu(this,[this]() { return tool("singleStyleEditor"); });
+   treeView_yeast->setupContextMenu(this,[this]() { return tool("yeastDialog"); });
 
    // TreeView for clicks, both double and right
    connect( treeView_recipe, SIGNAL(doubleClicked(const QModelIndex &)), this, SLOT(treeActivated(const QModelIndex &)));
@@ -2098,6 +2254,8 @@ QFile* MainWindow::openForWrite( QString filterStr, QString defaultSuff)
 {
    QFile* outFile = new QFile();
 
+   QFileDialog* fileSaver = tool<QFileDialog>("fileSaver");
+
    fileSaver->setNameFilter( filterStr );
    fileSaver->setDefaultSuffix( defaultSuff );
 
@@ -2151,6 +2309,52 @@ void MainWindow::exportSelectedHtml() {
    outFile->close();
 }
 
+void MainWindow::exportSelectedBrewSheets()
+{
+   BtTreeView* active = qobject_cast<BtTreeView*>(tabWidget_Trees->currentWidget()->focusWidget());
+   QList<Recipe*> targets;
+   QFile* outFile;
+   QString fileName;
+
+   // this only works for recipes
+   if ( active == 0 || active != treeView_recipe )
+      return;
+
+   foreach( QModelIndex ndx, active->selectionModel()->selectedRows() )
+   {
+      Recipe* rec = treeView_recipe->recipe(ndx);
+      if( rec )
+         targets.append(rec);
+   }
+   if( targets.isEmpty() )
+      return;
+
+   outFile = openForWrite(tr("PDF files (*.pdf)"), QString("pdf"));
+   if ( !outFile )
+      return;
+   // The printer wants the name, not the file
+   fileName = outFile->fileName();
+   outFile->close();
+   delete outFile;
+
+   QPrinter pdf(QPrinter::HighResolution);
+   pdf.setOutputFormat(QPrinter::PdfFormat);
+   pdf.setOutputFileName(fileName);
+
+   PrintPipeline pipeline;
+   QProgressDialog dialog( tr("Printing brew sheets..."), tr("Cancel"), 0, targets.size(), this );
+   dialog.setWindowTitle(tr("Print Brew Sheets"));
+   dialog.setWindowModality(Qt::WindowModal);
+   // Quick jobs shouldn't flash a dialog at anyone
+   dialog.setMinimumDuration(500);
+
+   connect( &pipeline, SIGNAL(progress(int,int)), &dialog, SLOT(setValue(int)) );
+   connect( &dialog, SIGNAL(canceled()), &pipeline, SLOT(cancel()) );
+
+   if( ! pipeline.exec(targets, &pdf, PrintPipeline::BREWDAY) && ! dialog.wasCanceled() )
+      QMessageBox::warning(this, tr("Print Failed"), tr("Could not print the brew sheets into %1.").arg(fileName));
+}
+
 void MainWindow::exportSelected()
 {
    BtTreeView* active = qobject_cast<BtTreeView*>(tabWidget_Trees->currentWidget()->focusWidget());
@@ -2260,6 +2464,44 @@ void MainWindow::updateDatabase()
    Database::instance().updateDatabase( otherDb );
 }
 
+void MainWindow::recalculateLibrary()
+{
+   // One at a time is plenty. A running one starts over, so the recipes it
+   // already did get the new options too
+   LibraryRecalculator* job = findChild<LibraryRecalculator*>();
+   if( job && job->isRunning() )
+   {
+      job->start();
+      return;
+   }
+
+   job = new LibraryRecalculator(this);
+   QProgressDialog* dialog = new QProgressDialog( tr("Recalculating recipes..."), tr("Cancel"), 0, 0, this );
+
+   dialog->setObjectName("recalcProgress");
+   dialog->setWindowTitle(tr("Recalculate Recipes"));
+   dialog->setAttribute(Qt::WA_DeleteOnClose);
+   // Quick jobs shouldn't flash a dialog at anyone
+   dialog->setMinimumDuration(500);
+
+   connect( job, SIGNAL(progress(int,int)), this, SLOT(showRecalcProgress(int,int)) );
+   connect( dialog, SIGNAL(canceled()), job, SLOT(cancel()) );
+   connect( job, SIGNAL(finished(bool)), dialog, SLOT(close()) );
+   connect( job, SIGNAL(finished(bool)), job, SLOT(deleteLater()) );
+
+   job->start();
+}
+
+void MainWindow::showRecalcProgress(int done, int total)
+{
+   QProgressDialog* dialog = findChild<QProgressDialog*>("recalcProgress");
+   if( dialog == 0 )
+      return;
+
+   dialog->setMaximum(total);
+   dialog->setValue(done);
+}
+
 void MainWindow::finishCheckingVersion()
 {
    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
@@ -2317,6 +2559,8 @@ void MainWindow::redisplayLabel(Unit::unitDisplay oldUnit, Unit::unitScale oldSc
 
 void MainWindow::showPitchDialog()
 {
+   PitchDialog* pitchDialog = tool<PitchDialog>("pitchDialog");
+
    // First, copy the current recipe og and volume.
    if( recipeObs )
    {
@@ -2336,7 +2580,7 @@ void MainWindow::showEquipmentEditor()
    }
    else
    {
-      singleEquipEditor->show();
+      tool<EquipmentEditor>("singleEquipEditor")->show();
    }
 }
 
@@ -2348,7 +2592,7 @@ void MainWindow::showStyleEditor()
    }
    else
    {
-      singleStyleEditor->show();
+      tool<StyleEditor>("singleStyleEditor")->show();
    }
 }
 
@@ -2383,6 +2627,7 @@ void MainWindow::changeBrewDate()
          continue;
 
       // Pop the calendar, get the date.
+      BtDatePopup* btDatePopup = tool<BtDatePopup>("btDatePopup");
       if ( btDatePopup->exec() == QDialog::Accepted )
       {
          newDate = btDatePopup->selectedDate();
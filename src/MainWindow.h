@@ -38,6 +38,8 @@ class MainWindow;
 #include <QPrinter>
 #include <QPrintDialog>
 #include <QTimer>
+#include <QHash>
+#include <functional>
 #include "ui_mainWindow.h"
 
 // Forward Declarations
@@ -88,6 +90,7 @@ class StyleListModel;
 class StyleSortFilterProxyModel;
 class NamedMashEditor;
 class BtDatePopup;
+class QSignalMapper;
 
 /*!
  * \class MainWindow
@@ -213,6 +216,8 @@ public slots:
    void copySelected();
    void exportSelected();
    void exportSelectedHtml();
+   //! \brief Prints the brew day sheets of the selected recipes into one PDF
+   void exportSelectedBrewSheets();
 
    //! \brief Prints the right thing, depending on the signal sender.
    void print();
@@ -240,6 +245,10 @@ public slots:
    //! \brief Merges two database files.
    void updateDatabase();
 
+   //! \brief Recalculates every recipe in the background, with a progress
+   //  dialog that can cancel it. For after the formulas change.
+   void recalculateLibrary();
+
    //! \brief Catches a QNetworkReply signal and gets info about any new version available.
    void finishCheckingVersion();
 
@@ -258,6 +267,8 @@ public slots:
 
 protected:
    virtual void closeEvent(QCloseEvent* event);
+   //! \brief Tells BtLocale when the system locale moves under us
+   virtual void changeEvent(QEvent* event);
 
 private slots:
    /*!
@@ -270,6 +281,12 @@ private slots:
     */
    void showChanges(QMetaProperty* prop = 0);
 
+   //! \brief Shows the tool called \c name, building it first if need be
+   void showTool(QString const& name);
+   void showMashEditor();
+   //! \brief Moves recalculateLibrary()'s progress dialog along
+   void showRecalcProgress(int done, int total);
+
 private:
    Recipe* recipeObs;
    Style* recStyle;
@@ -277,38 +294,9 @@ private:
 
    QString highSS, lowSS, goodSS, boldSS; // Palette replacements
 
-   AboutDialog* dialog_about;
-   QFileDialog* fileOpener;
-   QFileDialog* fileSaver;
    QList<QMenu*> contextMenus;
-   EquipmentEditor* equipEditor;
-   EquipmentEditor* singleEquipEditor;
-   FermentableDialog* fermDialog;
-   FermentableEditor* fermEditor;
-   HopDialog* hopDialog;
-   HopEditor* hopEditor;
-   MashEditor* mashEditor;
-   MashStepEditor* mashStepEditor;
-   MashWizard* mashWizard;
-   MiscDialog* miscDialog;
-   MiscEditor* miscEditor;
-   StyleEditor* styleEditor;
-   StyleEditor* singleStyleEditor;
-   YeastDialog* yeastDialog;
-   YeastEditor* yeastEditor;
-   OptionDialog* optionDialog;
    QDialog* brewDayDialog;
-   ScaleRecipeTool* recipeScaler;
    RecipeFormatter* recipeFormatter;
-   OgAdjuster* ogAdjuster;
-   ConverterTool* converterTool;
-   HydrometerTool* hydrometerTool;
-   TimerMainDialog* timerMainDialog;
-   PrimingDialog* primingDialog;
-   StrikeWaterDialog* strikeWaterDialog;
-   RefractoDialog* refractoDialog;
-   MashDesigner* mashDesigner;
-   PitchDialog* pitchDialog;
    QPrinter *printer;
 
    FermentableTableModel* fermTableModel;
@@ -325,12 +313,25 @@ private:
    StyleListModel* styleListModel;
    StyleSortFilterProxyModel* styleProxyModel;
 
-   NamedMashEditor* namedMashEditor;
-   NamedMashEditor* singleNamedMashEditor;
-
-   BtDatePopup* btDatePopup;
    int confirmDelete;
 
+   //! \brief How to build each dialog and tool, by name. See registerTools()
+   QHash< QString, std::function<QWidget*()> > toolFactories;
+   //! \brief The dialogs and tools somebody has needed so far
+   QHash< QString, QWidget* > tools;
+   //! \brief Sends the signals that just show a tool to showTool()
+   QSignalMapper* toolShower;
+
+   //! \brief Fills toolFactories. Nothing gets built here
+   void registerTools();
+   //! \brief Returns the tool called \c name, building it the first time
+   QWidget* tool(QString const& name);
+   template<class T> T* tool(QString const& name) { return qobject_cast<T*>(tool(name)); }
+   //! \brief Returns the tool called \c name only if it has already been built
+   template<class T> T* builtTool(QString const& name) const { return qobject_cast<T*>(tools.value(name, 0)); }
+   //! \brief Shows the tool called \c name whenever \c sender emits \c signal
+   void showToolOn(QObject* sender, const char* signal, QString const& name);
+
    //! \brief Currently highlighted fermentable in the fermentable table.
    Fermentable* selectedFermentable();
    //! \brief Currently highlighted hop in the hop table.
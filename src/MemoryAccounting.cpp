@@ -0,0 +1,126 @@
+/*
+ * MemoryAccounting.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryAccounting.h"
+
+#include <QDomDocument>
+#include <QDomNode>
+#include <QMultiHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+
+const qint64 MemoryAccounting::qobjectPrivateBytes = 12 * sizeof(void*);
+
+namespace {
+
+// Function local, so nobody registering from a static constructor gets
+// here before the hash does
+QMutex& sourceMutex()
+{
+   static QMutex mutex;
+   return mutex;
+}
+
+QMultiHash< void const*, MemoryAccounting::Source >& sources()
+{
+   static QMultiHash< void const*, MemoryAccounting::Source > hash;
+   return hash;
+}
+
+bool dumpIt = false;
+
+}
+
+void MemoryAccounting::addSource(void const* owner, Source source)
+{
+   QMutexLocker locker(&sourceMutex());
+   sources().insert(owner, source);
+}
+
+void MemoryAccounting::removeSources(void const* owner)
+{
+   QMutexLocker locker(&sourceMutex());
+   sources().remove(owner);
+}
+
+QList<MemoryAccounting::Entry> MemoryAccounting::report()
+{
+   // Copy them out. A source may well want to register somebody else
+   QList<Source> todo;
+   {
+      QMutexLocker locker(&sourceMutex());
+      todo = sources().values();
+   }
+
+   QList<Entry> ret;
+   foreach( Source const& source, todo )
+      ret.append( source() );
+   return ret;
+}
+
+QString MemoryAccounting::text()
+{
+   QList<Entry> entries = report();
+   QStringList lines;
+   qint64 total = 0;
+
+   lines << QString("%1 %2 %3 %4").arg("Subsystem", -12).arg("What", -32).arg("Count", 10).arg("KiB", 10);
+   foreach( Entry const& e, entries ) {
+      lines << QString("%1 %2 %3 %4").arg(e.subsystem, -12).arg(e.what, -32).arg(e.count, 10).arg(e.bytes/1024, 10);
+      total += e.bytes;
+   }
+   lines << QString("%1 %2 %3 %4").arg("Total", -12).arg("", -32).arg("", 10).arg(total/1024, 10);
+
+   return lines.join("\n");
+}
+
+void MemoryAccounting::setDumpAtExit(bool dump) { dumpIt = dump; }
+bool MemoryAccounting::dumpAtExit() { return dumpIt; }
+
+qint64 MemoryAccounting::stringBytes(QString const& str)
+{
+   // QArrayData header plus the characters, when there are any
+   return str.isNull() ? 0 : 3 * sizeof(int) + sizeof(qptrdiff) + (str.capacity() + 1) * sizeof(QChar);
+}
+
+qint64 MemoryAccounting::domBytes(QDomDocument const& doc, qint64* nodes)
+{
+   qint64 count = 0;
+   qint64 bytes = 0;
+
+   // QDomNodePrivate is about ten pointers, plus what the node holds
+   QDomNode n = doc.documentElement();
+   while ( ! n.isNull() ) {
+      ++count;
+      bytes += 10 * sizeof(void*) + stringBytes(n.nodeName()) + stringBytes(n.nodeValue());
+
+      if ( n.hasChildNodes() )
+         n = n.firstChild();
+      else {
+         while ( ! n.isNull() && n.nextSibling().isNull() )
+            n = n.parentNode();
+         if ( ! n.isNull() )
+            n = n.nextSibling();
+      }
+   }
+
+   if ( nodes )
+      *nodes = count;
+   return bytes;
+}
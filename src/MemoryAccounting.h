@@ -0,0 +1,97 @@
+/*
+ * MemoryAccounting.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MEMORYACCOUNTING_H
+#define _MEMORYACCOUNTING_H
+
+#include <functional>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+class QDomDocument;
+
+/*!
+ * \class MemoryAccounting
+ *
+ * \brief Who is holding how much memory.
+ *
+ * Anything big registers a source, which is asked for its numbers only when
+ * somebody wants a report. The numbers are estimates: sizeof() what we can,
+ * a fair guess for what Qt keeps private. They are good enough to size a
+ * machine, or to notice something that only ever grows.
+ */
+class MemoryAccounting
+{
+public:
+   //! \brief One line of the report
+   struct Entry
+   {
+      Entry(QString const& subsystem = QString(), QString const& what = QString(), qint64 count = 0, qint64 bytes = 0)
+         : subsystem(subsystem), what(what), count(count), bytes(bytes) {}
+
+      QString subsystem;
+      QString what;
+      qint64 count;
+      qint64 bytes;
+   };
+   typedef std::function< QList<Entry>() > Source;
+
+   //! \brief Adds \c source, filed under \c owner. One owner can have several
+   static void addSource(void const* owner, Source source);
+   //! \brief Drops every source \c owner added. Call it before you go away
+   static void removeSources(void const* owner);
+
+   //! \brief Asks every source, right now
+   static QList<Entry> report();
+   //! \brief report() as a plain text table, with a total
+   static QString text();
+
+   //! \brief Prints text() to stdout when the program exits. Set by --memory-report
+   static void setDumpAtExit(bool dump);
+   static bool dumpAtExit();
+
+   //! \brief Our guess at a QObject we can't see inside of: the object, its
+   // private and a bit of connection list
+   template<class T> static qint64 objectBytes() { return sizeof(T) + qobjectPrivateBytes; }
+   //! \brief A QString's heap part
+   static qint64 stringBytes(QString const& str);
+   //! \brief A node in a QHash, not counting what the key and value point to
+   template<class K, class V> static qint64 hashNodeBytes() { return sizeof(void*) + sizeof(uint) + sizeof(K) + sizeof(V); }
+   //! \brief Walks \c doc and guesses what its nodes cost
+   static qint64 domBytes(QDomDocument const& doc, qint64* nodes = 0);
+
+   /*!
+    * \brief Adds a source for as long as it lives. For things that live on
+    * the stack, like the QDomDocument of an import.
+    */
+   class Scope
+   {
+   public:
+      Scope(Source source) { addSource(this, source); }
+      ~Scope() { removeSources(this); }
+   private:
+      Q_DISABLE_COPY(Scope)
+   };
+
+private:
+   //! There is no sizeof(QObjectPrivate) to be had. Call it a dozen pointers
+   static const qint64 qobjectPrivateBytes;
+};
+
+#endif /* _MEMORYACCOUNTING_H */
@@ -0,0 +1,100 @@
+/*
+ * MemoryDialog.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryDialog.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpacerItem>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include "MemoryAccounting.h"
+
+MemoryDialog::MemoryDialog(QWidget* parent)
+   : QDialog(parent),
+     table(0),
+     total(0)
+{
+   setObjectName("memoryDialog");
+   doLayout();
+}
+
+void MemoryDialog::doLayout()
+{
+   QVBoxLayout* verticalLayout = new QVBoxLayout(this);
+      table = new QTableWidget(0, 4, this);
+      table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+      table->setSortingEnabled(true);
+      table->verticalHeader()->hide();
+      table->horizontalHeader()->setStretchLastSection(true);
+      QHBoxLayout* horizontalLayout = new QHBoxLayout;
+         total = new QLabel(this);
+         QSpacerItem* horizontalSpacer = new QSpacerItem(40, 20, QSizePolicy::Expanding, QSizePolicy::Minimum);
+         QPushButton* refreshButton = new QPushButton(tr("Refresh"), this);
+         horizontalLayout->addWidget(total);
+         horizontalLayout->addItem(horizontalSpacer);
+         horizontalLayout->addWidget(refreshButton);
+      verticalLayout->addWidget(table);
+      verticalLayout->addLayout(horizontalLayout);
+
+   connect( refreshButton, SIGNAL(clicked()), this, SLOT(refresh()) );
+   resize(600, 400);
+   retranslateUi();
+}
+
+void MemoryDialog::retranslateUi()
+{
+   setWindowTitle(tr("Memory usage"));
+   table->setHorizontalHeaderLabels( QStringList() << tr("Subsystem") << tr("What") << tr("Count") << tr("KiB") );
+}
+
+void MemoryDialog::showEvent(QShowEvent* event)
+{
+   refresh();
+   QDialog::showEvent(event);
+}
+
+void MemoryDialog::refresh()
+{
+   QList<MemoryAccounting::Entry> entries = MemoryAccounting::report();
+   qint64 sum = 0;
+
+   // Sorting while we fill it moves rows out from under us
+   table->setSortingEnabled(false);
+   table->setRowCount(entries.size());
+   for ( int i = 0; i < entries.size(); ++i ) {
+      MemoryAccounting::Entry const& e = entries.at(i);
+      QTableWidgetItem* count = new QTableWidgetItem;
+      QTableWidgetItem* kib = new QTableWidgetItem;
+      // Numbers as numbers, or 9 sorts after 10
+      count->setData(Qt::DisplayRole, e.count);
+      kib->setData(Qt::DisplayRole, e.bytes / 1024);
+
+      table->setItem(i, 0, new QTableWidgetItem(e.subsystem));
+      table->setItem(i, 1, new QTableWidgetItem(e.what));
+      table->setItem(i, 2, count);
+      table->setItem(i, 3, kib);
+      sum += e.bytes;
+   }
+   table->setSortingEnabled(true);
+   table->resizeColumnsToContents();
+
+   total->setText(tr("Total: %1 KiB").arg(sum / 1024));
+}
@@ -0,0 +1,56 @@
+/*
+ * MemoryDialog.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MEMORYDIALOG_H
+#define _MEMORYDIALOG_H
+
+#include <QDialog>
+#include <QWidget>
+
+class QLabel;
+class QTableWidget;
+
+/*!
+ * \class MemoryDialog
+ *
+ * \brief Shows the MemoryAccounting report. It's a debugging aid, so it is
+ * a plain table and a refresh button.
+ */
+class MemoryDialog : public QDialog
+{
+   Q_OBJECT
+
+public:
+   MemoryDialog(QWidget* parent=0);
+
+public slots:
+   //! \brief asks everybody again
+   void refresh();
+
+protected:
+   virtual void showEvent(QShowEvent* event);
+
+private:
+   void doLayout();
+   void retranslateUi();
+
+   QTableWidget* table;
+   QLabel* total;
+};
+
+#endif   /* _MEMORYDIALOG_H */
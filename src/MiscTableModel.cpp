@@ -29,6 +29,9 @@
 #include "unit.h"
 #include "brewtarget.h"
 #include "recipe.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "PropertyIds.h"
 
 MiscTableModel::MiscTableModel(QTableView* parent, bool editable)
    : QAbstractTableModel(parent),
@@ -47,10 +50,21 @@ MiscTableModel::MiscTableModel(QTableView* parent, bool editable)
     parentTableWidget->setWordWrap(false);
 
    connect(headerView, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(contextMenu(const QPoint&)));
+
+   MemoryAccounting::addSource(this, [this]() {
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Tables", objectName(), miscObs.size(), miscObs.size() * sizeof(void*) );
+   });
+}
+
+MiscTableModel::~MiscTableModel()
+{
+   MemoryAccounting::removeSources(this);
 }
 
 void MiscTableModel::observeRecipe(Recipe* rec)
 {
+   TraceSpan span("MiscTableModel::observeRecipe", "model");
+
    if( recObs )
    {
       disconnect( recObs, 0, this, 0 );
@@ -375,7 +389,7 @@ void MiscTableModel::changed(QMetaProperty prop, QVariant /*val*/)
    Recipe* recSender = qobject_cast<Recipe*>(sender());
    if( recSender && recSender == recObs )
    {
-      if( QString(prop.name()) == "miscs" )
+      if( BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::miscs )
       {
          removeAll();
          addMiscs( recObs->miscs() );
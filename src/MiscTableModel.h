@@ -58,7 +58,7 @@ class MiscTableModel : public QAbstractTableModel
    
 public:
    MiscTableModel(QTableView* parent=0, bool editable=true);
-   virtual ~MiscTableModel() {}
+   virtual ~MiscTableModel();
    //! \brief Observe a recipe's list of miscs.
    void observeRecipe(Recipe* rec);
    //! \brief If true, we model the database's list of miscs.
@@ -38,6 +38,8 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include "MainWindow.h"
+#include "ToolTipCache.h"
+#include "RecipeFormatter.h"
 
 OptionDialog::OptionDialog(QWidget* parent)
 {
@@ -388,6 +390,12 @@ void OptionDialog::saveAndClose()
          break;
    }
 
+   // Everything every recipe's numbers hang on, as it was
+   QStringList oldFormulas;
+   oldFormulas << Brewtarget::ibuFormulaName() << Brewtarget::colorFormulaName()
+               << Brewtarget::option("mashHopAdjustment", 0).toString()
+               << Brewtarget::option("firstWortHopAdjustment", 1.1).toString();
+
    int ndx = ibuFormulaComboBox->itemData(ibuFormulaComboBox->currentIndex()).toInt(&okay);
    Brewtarget::ibuFormula = static_cast<Brewtarget::IbuType>(ndx);
    ndx = colorFormulaComboBox->itemData(colorFormulaComboBox->currentIndex()).toInt(&okay);
@@ -434,9 +442,23 @@ void OptionDialog::saveAndClose()
    Brewtarget::setOption("mashHopAdjustment", ibuAdjustmentMashHopDoubleSpinBox->value() / 100);
    Brewtarget::setOption("firstWortHopAdjustment", ibuAdjustmentFirstWortDoubleSpinBox->value() / 100);
 
+   QStringList newFormulas;
+   newFormulas << Brewtarget::ibuFormulaName() << Brewtarget::colorFormulaName()
+               << Brewtarget::option("mashHopAdjustment", 0).toString()
+               << Brewtarget::option("firstWortHopAdjustment", 1.1).toString();
+
+   // Units, formulae and language all show up in tooltips and printouts
+   ToolTipCache::invalidateAll();
+   RecipeFormatter::invalidateAll();
+
    // Make sure the main window updates.
    if( Brewtarget::mainWindow() )
+   {
       Brewtarget::mainWindow()->showChanges();
+      // Every recipe is now wrong, not just the one on the screen
+      if( newFormulas != oldFormulas )
+         Brewtarget::mainWindow()->recalculateLibrary();
+   }
 
    setVisible(false);
 }
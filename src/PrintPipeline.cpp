@@ -0,0 +1,314 @@
+/*
+ * PrintPipeline.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrintPipeline.h"
+#include "brewtarget.h"
+#include "recipe.h"
+#include "RecipeFormatter.h"
+#include "BrewDayScrollWidget.h"
+#include <QAbstractTextDocumentLayout>
+#include <QEventLoop>
+#include <QImage>
+#include <QMetaObject>
+#include <QPainter>
+#include <QPrinter>
+#include <QRunnable>
+#include <QTextDocument>
+#include <QTextFrame>
+
+class PrintPipeline::Task : public QRunnable
+{
+public:
+   Task( PrintPipeline* pipeline, Document* out, QString const& html, int run, int index,
+         QSizeF const& body, int margin, int resolution )
+      : _pipeline(pipeline), _out(out), _html(html), _run(run), _index(index),
+        _body(body), _margin(margin), _resolution(resolution)
+   {
+      setAutoDelete(true);
+   }
+
+   void run()
+   {
+      QImage* device = new QImage(1, 1, QImage::Format_RGB32);
+      QTextDocument* doc = new QTextDocument();
+      int dotsPerMeter = qRound(_resolution / 0.0254);
+
+      // What QTextDocument::print() does, except the printer belongs to the
+      // GUI thread. An image with the printer's resolution measures the same
+      device->setDotsPerMeterX(dotsPerMeter);
+      device->setDotsPerMeterY(dotsPerMeter);
+      doc->documentLayout()->setPaintDevice(device);
+      doc->setHtml(_html);
+
+      QTextFrameFormat fmt = doc->rootFrame()->frameFormat();
+      fmt.setMargin(_margin);
+      doc->rootFrame()->setFrameFormat(fmt);
+      doc->setPageSize(_body);
+      // Counting the pages lays them all out
+      doc->pageCount();
+
+      // It gets painted and deleted over there. Nothing reads _out until
+      // laidOut() says so, so no locks
+      doc->moveToThread(_pipeline->thread());
+      _out->doc = doc;
+      _out->device = device;
+      QMetaObject::invokeMethod(_pipeline, "laidOut", Qt::QueuedConnection, Q_ARG(int, _run), Q_ARG(int, _index));
+   }
+
+private:
+   PrintPipeline* _pipeline;
+   Document* _out;
+   QString _html;
+   int _run;
+   int _index;
+   QSizeF _body;
+   int _margin;
+   int _resolution;
+};
+
+PrintPipeline::PrintPipeline( QObject* parent )
+   : QObject(parent),
+     _printer(0),
+     _painter(0),
+     _formatter(0),
+     _kind(RECIPE),
+     _run(0),
+     _fed(0),
+     _painted(0),
+     _running(false),
+     _ok(false),
+     _firstPage(true),
+     _feedQueued(false),
+     _margin(0),
+     _resolution(0)
+{
+}
+
+PrintPipeline::~PrintPipeline()
+{
+   cancel();
+   // The tasks write into _documents
+   _pool.waitForDone();
+   clear();
+}
+
+void PrintPipeline::setMaxThreadCount( int count )
+{
+   _pool.setMaxThreadCount(count);
+}
+
+bool PrintPipeline::isRunning() const
+{
+   return _running;
+}
+
+void PrintPipeline::start( QList<Recipe*> const& recipes, QPrinter* printer, Kind kind )
+{
+   cancel();
+   _pool.waitForDone();
+   clear();
+
+   ++_run;
+   _printer = printer;
+   _kind = kind;
+   _fed = 0;
+   _painted = 0;
+   _ok = false;
+   _firstPage = true;
+
+   foreach( Recipe* rec, recipes )
+   {
+      Document* next = new Document;
+      next->recipe = rec;
+      _documents.append(next);
+   }
+
+   _resolution = printer->resolution();
+   _body = QSizeF(printer->pageRect().size());
+   // 2 cm, same as QTextDocument::print()
+   _margin = qRound((2/2.54) * _resolution);
+
+   _painter = new QPainter();
+   if( ! _painter->begin(printer) )
+   {
+      Brewtarget::logE(QString("%1 could not print to %2").arg(Q_FUNC_INFO).arg(printer->outputFileName()));
+      delete _painter;
+      _painter = 0;
+      emit finished(false);
+      return;
+   }
+
+   _running = true;
+   if( _documents.isEmpty() )
+      finish(true);
+   else
+      queueFeed();
+}
+
+bool PrintPipeline::exec( QList<Recipe*> const& recipes, QPrinter* printer, Kind kind )
+{
+   QEventLoop loop;
+
+   connect( this, SIGNAL(finished(bool)), &loop, SLOT(quit()) );
+   start(recipes, printer, kind);
+   if( _running )
+      loop.exec();
+
+   return _ok;
+}
+
+void PrintPipeline::cancel()
+{
+   if( ! _running )
+      return;
+
+   // The ones already laying out finish, and laidOut() drops them
+   _pool.clear();
+   finish(false);
+}
+
+void PrintPipeline::queueFeed()
+{
+   if( _feedQueued )
+      return;
+
+   _feedQueued = true;
+   QMetaObject::invokeMethod(this, "feed", Qt::QueuedConnection);
+}
+
+void PrintPipeline::feed()
+{
+   // Only so far ahead of the printer, so one slow recipe doesn't leave the
+   // rest of the week piling up in memory behind it
+   int ahead = qMax(2, 2 * _pool.maxThreadCount());
+
+   _feedQueued = false;
+   if( ! _running || _fed >= _documents.size() || _fed - _painted >= ahead )
+      return;
+
+   Document* next = _documents[_fed];
+   int index = _fed++;
+
+   if( next->recipe.isNull() )
+   {
+      // Deleted while it waited its turn. Nothing to print
+      next->ready = true;
+      paintReady();
+   }
+   else
+      _pool.start( new Task(this, next, html(next->recipe.data()), _run, index, _body, _margin, _resolution) );
+
+   // One recipe per trip through the event loop, so the window keeps up
+   if( _running )
+      queueFeed();
+}
+
+void PrintPipeline::laidOut( int run, int index )
+{
+   // Left over from something cancelled
+   if( run != _run || ! _running )
+      return;
+
+   _documents[index]->ready = true;
+   paintReady();
+
+   // There's room ahead of the printer again
+   if( _running )
+      queueFeed();
+}
+
+void PrintPipeline::paintReady()
+{
+   while( _running && _painted < _fed && _documents[_painted]->ready )
+   {
+      Document* done = _documents[_painted];
+
+      if( done->doc )
+         paint(done->doc);
+
+      // It's in the printer, so we can let go of it
+      delete done->doc;
+      delete done->device;
+      done->doc = 0;
+      done->device = 0;
+
+      ++_painted;
+      emit progress(_painted, _documents.size());
+   }
+
+   if( _running && _painted == _documents.size() )
+      finish(true);
+}
+
+void PrintPipeline::paint( QTextDocument* doc )
+{
+   int pages = doc->pageCount();
+   int page;
+
+   for( page = 0; page < pages; ++page )
+   {
+      if( ! _firstPage )
+         _printer->newPage();
+      _firstPage = false;
+
+      // Slide the page we want under the printer's, like print() does
+      QRectF view(0, page * _body.height(), _body.width(), _body.height());
+      _painter->save();
+      _painter->translate(0, -view.top());
+      doc->drawContents(_painter, view);
+      _painter->restore();
+   }
+}
+
+void PrintPipeline::finish( bool ok )
+{
+   if( _painter )
+   {
+      _painter->end();
+      delete _painter;
+      _painter = 0;
+   }
+
+   _running = false;
+   _ok = ok;
+   emit finished(ok);
+}
+
+void PrintPipeline::clear()
+{
+   foreach( Document* doc, _documents )
+   {
+      delete doc->doc;
+      delete doc->device;
+      delete doc;
+   }
+   _documents.clear();
+}
+
+QString PrintPipeline::html( Recipe* rec )
+{
+   if( _kind == BREWDAY )
+      return BrewDayScrollWidget::html(rec);
+
+   // Made when first wanted, since brew sheets don't need one
+   if( _formatter == 0 )
+      _formatter = new RecipeFormatter(this);
+
+   _formatter->setRecipe(rec);
+   return _formatter->getHTMLFormat();
+}
@@ -0,0 +1,131 @@
+/*
+ * PrintPipeline.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PRINTPIPELINE_H
+#define _PRINTPIPELINE_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QSizeF>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+class QImage;
+class QPainter;
+class QPrinter;
+class QTextDocument;
+class Recipe;
+class RecipeFormatter;
+
+/*!
+ * \class PrintPipeline
+ *
+ * \brief Prints a whole pile of recipes, or their brew day sheets, into one
+ * printer (usually a PDF) without sitting on the GUI thread for all of it.
+ *
+ * The html is made here, where the recipes live, one recipe per trip
+ * through the event loop. Turning it into pages is the slow part, so that
+ * happens in a pool, a few recipes at a time. The pages are painted into
+ * the printer here, in order, as soon as the next one is ready, so the
+ * first sheets are in the file long before the last are laid out.
+ */
+class PrintPipeline : public QObject
+{
+   Q_OBJECT
+
+public:
+   //! \brief What each recipe turns into
+   enum Kind { RECIPE, BREWDAY };
+
+   PrintPipeline( QObject* parent = 0 );
+   virtual ~PrintPipeline();
+
+   /*!
+    * \brief Starts printing \b recipes into \b printer, each one starting on
+    * a new page. Comes straight back; finished() says when it's done.
+    */
+   void start( QList<Recipe*> const& recipes, QPrinter* printer, Kind kind = RECIPE );
+   //! \brief start(), and wait for it. For the command line and the like
+   bool exec( QList<Recipe*> const& recipes, QPrinter* printer, Kind kind = RECIPE );
+   bool isRunning() const;
+   //! \brief How many recipes get laid out at once. Defaults to one per core
+   void setMaxThreadCount( int count );
+
+signals:
+   //! \brief \b done of the \b total recipes are in the printer
+   void progress( int done, int total );
+   //! \brief They all went in, or \b ok is false and some didn't
+   void finished( bool ok );
+
+public slots:
+   //! \brief Leaves out whatever hasn't been painted yet
+   void cancel();
+
+private slots:
+   //! Makes the html of the next recipe and hands it to the pool
+   void feed();
+   //! The pool is done with recipe \b index of run \b run
+   void laidOut( int run, int index );
+
+private:
+   //! \brief One recipe on its way through
+   struct Document
+   {
+      Document() : doc(0), device(0), ready(false) {}
+
+      QPointer<Recipe> recipe;
+      QTextDocument* doc;
+      //! What \c doc was laid out for. It has the printer's resolution
+      QImage* device;
+      bool ready;
+   };
+
+   class Task;
+
+   //! \brief Has feed() called, unless it already is going to be
+   void queueFeed();
+   //! \brief Paints every ready document from the next one on, in order
+   void paintReady();
+   void paint( QTextDocument* doc );
+   void finish( bool ok );
+   void clear();
+   QString html( Recipe* rec );
+
+   QVector<Document*> _documents;
+   QPrinter* _printer;
+   QPainter* _painter;
+   RecipeFormatter* _formatter;
+   Kind _kind;
+   //! Bumped by every start(), so a late document from a cancelled run is dropped
+   int _run;
+   int _fed;
+   int _painted;
+   bool _running;
+   bool _ok;
+   bool _firstPage;
+   bool _feedQueued;
+   //! The printer's page, in its own pixels. The margins go inside
+   QSizeF _body;
+   int _margin;
+   int _resolution;
+   QThreadPool _pool;
+};
+
+#endif /* _PRINTPIPELINE_H */
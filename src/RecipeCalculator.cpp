@@ -0,0 +1,458 @@
+/*
+ * RecipeCalculator.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RecipeCalculator.h"
+#include "Algorithms.h"
+#include "IbuMethods.h"
+#include "ColorMethods.h"
+#include "PhysicalConstants.h"
+#include <QVarLengthArray>
+
+// NOTE: the arithmetic in here is written exactly the way Recipe used to
+// write it, down to the order of the operands. Testing::recipeCalculatorTest
+// holds us to the same bits, so think twice before tidying it up.
+
+RecipeCalculator::Results RecipeCalculator::calculate( RecipeSnapshot const& snap )
+{
+   Results r;
+
+   r.grainsInMash_kg = grainsInMash_kg(snap);
+   r.grains_kg = grains_kg(snap);
+
+   r.volumes = volumes(snap, r.grainsInMash_kg);
+   r.color_srm = color_srm(snap, r.volumes.finalVolumeNoLosses_l);
+   r.gravities = ogFg(snap, r.volumes.wortFromMash_l, r.volumes.finalVolumeNoLosses_l);
+
+   r.ABV_pct  = ABV_pct(r.gravities.og_fermentable, r.gravities.fg_fermentable);
+   r.boilGrav = boilGrav(snap);
+   r.IBU      = IBU(snap, r.gravities.og, r.volumes.finalVolumeNoLosses_l, &r.ibus);
+   r.calories = calories(r.gravities.og, r.gravities.fg);
+
+   return r;
+}
+
+double RecipeCalculator::grainsInMash_kg( RecipeSnapshot const& snap )
+{
+   double ret = 0.0;
+
+   foreach( RecipeSnapshot::Fermentable const& ferm, snap.fermentables )
+   {
+      if( ferm.type == Fermentable::Grain && ferm.isMashed )
+         ret += ferm.amount_kg;
+   }
+
+   return ret;
+}
+
+double RecipeCalculator::grains_kg( RecipeSnapshot const& snap )
+{
+   double ret = 0.0;
+
+   foreach( RecipeSnapshot::Fermentable const& ferm, snap.fermentables )
+      ret += ferm.amount_kg;
+
+   return ret;
+}
+
+RecipeCalculator::Volumes RecipeCalculator::volumes( RecipeSnapshot const& snap, double grainsInMash_kg )
+{
+   Volumes ret;
+   double waterAdded_l = 0.0;
+   double absorption_lKg;
+   double tmp = 0.0;
+   double tmp_wfm = 0.0;
+   RecipeSnapshot::Equipment const& equip = snap.equipment;
+
+   // wortFromMash_l ==========================
+   if( snap.hasMash )
+   {
+      foreach( RecipeSnapshot::MashStep const& step, snap.mashSteps )
+      {
+         if( step.infusion )
+            waterAdded_l += step.infuseAmount_l;
+      }
+
+      if( snap.hasEquipment )
+         absorption_lKg = equip.grainAbsorption_LKg;
+      else
+         absorption_lKg = PhysicalConstants::grainAbsorption_Lkg;
+
+      tmp_wfm = (waterAdded_l - absorption_lKg * grainsInMash_kg);
+   }
+   ret.wortFromMash_l = tmp_wfm;
+
+   // boilVolume_l ==============================
+   if( snap.hasEquipment )
+      tmp = tmp_wfm - equip.lauterDeadspace_l + equip.topUpKettle_l;
+   else
+      tmp = tmp_wfm;
+
+   // Need to account for extract/sugar volume also.
+   foreach( RecipeSnapshot::Fermentable const& f, snap.fermentables )
+   {
+      if( f.type == Fermentable::Extract )
+         tmp += f.amount_kg / PhysicalConstants::liquidExtractDensity_kgL;
+      else if( f.type == Fermentable::Sugar )
+         tmp += f.amount_kg / PhysicalConstants::sucroseDensity_kgL;
+      else if( f.type == Fermentable::Dry_Extract )
+         tmp += f.amount_kg / PhysicalConstants::dryExtractDensity_kgL;
+   }
+
+   if( tmp <= 0.0 )
+      tmp = snap.boilSize_l; // Give up.
+
+   ret.boilVolume_l = tmp;
+
+   // finalVolume_l ==============================
+
+   // NOTE: this one is not based on the other volume estimates since we want
+   // to show og,fg,ibus,etc. as if the collected wort is correct.
+   ret.finalVolumeNoLosses_l = snap.batchSize_l;
+   if( snap.hasEquipment )
+      ret.finalVolumeNoLosses_l += equip.trubChillerLoss_l;
+
+   // Without an equipment, Recipe always meant to shoot in the dark with
+   // boilVolume_l - 4, but then overwrote it with 0. 0 it stays.
+   if( snap.hasEquipment )
+      ret.finalVolume_l = equip.wortEndOfBoil_l(ret.boilVolume_l) + equip.topUpWater_l - equip.trubChillerLoss_l;
+   else
+      ret.finalVolume_l = 0.0;
+
+   // postBoilVolume_l ===========================
+   if( snap.hasEquipment )
+      ret.postBoilVolume_l = equip.wortEndOfBoil_l( ret.boilVolume_l );
+   else
+      ret.postBoilVolume_l = snap.batchSize_l; // Give up.
+
+   return ret;
+}
+
+double RecipeCalculator::color_srm( RecipeSnapshot const& snap, double finalVolumeNoLosses_l )
+{
+   double mcu = 0.0;
+
+   foreach( RecipeSnapshot::Fermentable const& ferm, snap.fermentables )
+   {
+      // Conversion factor for lb/gal to kg/l = 8.34538.
+      mcu += ferm.color_srm*8.34538 * ferm.amount_kg/finalVolumeNoLosses_l;
+   }
+
+   return ColorMethods::mcuToSrm(snap.colorFormula, mcu);
+}
+
+RecipeCalculator::Points RecipeCalculator::totalPoints( RecipeSnapshot const& snap )
+{
+   Points ret;
+   ret.sugar_kg                  = 0.0;
+   ret.nonFermetableSugars_kg    = 0.0;
+   ret.sugar_kg_ignoreEfficiency = 0.0;
+   ret.lateAddition_kg           = 0.0;
+   ret.lateAddition_kg_ignoreEff = 0.0;
+
+   foreach( RecipeSnapshot::Fermentable const& ferm, snap.fermentables )
+   {
+      // If we have some sort of non-grain, we have to ignore efficiency.
+      if( ferm.isSugar() || ferm.isExtract() )
+      {
+         ret.sugar_kg_ignoreEfficiency += ferm.equivSucrose_kg();
+
+         if( ferm.addAfterBoil )
+            ret.lateAddition_kg_ignoreEff += ferm.equivSucrose_kg();
+
+         if( !ferm.fermentableSugar )
+            ret.nonFermetableSugars_kg += ferm.equivSucrose_kg();
+      }
+      else
+      {
+         ret.sugar_kg += ferm.equivSucrose_kg();
+
+         if( ferm.addAfterBoil )
+            ret.lateAddition_kg += ferm.equivSucrose_kg();
+      }
+   }
+
+   return ret;
+}
+
+RecipeCalculator::Gravities RecipeCalculator::ogFg( RecipeSnapshot const& snap, double wortFromMash_l, double finalVolumeNoLosses_l )
+{
+   Gravities ret;
+   double plato;
+   double sugar_kg;
+   double sugar_kg_ignoreEfficiency;
+   double nonFermetableSugars_kg;
+   double kettleWort_l = 0.0;
+   double postBoilWort_l = 0.0;
+   double ratio = 0.0;
+   double ferm_kg = 0.0;
+   double attenuation_pct = 0.0;
+   double tmp_pnts, tmp_ferm_pnts;
+   RecipeSnapshot::Equipment const& equip = snap.equipment;
+
+   // Find out how much sugar we have.
+   Points sugars = totalPoints(snap);
+   sugar_kg                  = sugars.sugar_kg;
+   sugar_kg_ignoreEfficiency = sugars.sugar_kg_ignoreEfficiency;
+   nonFermetableSugars_kg    = sugars.nonFermetableSugars_kg;
+
+   // We might lose some sugar in the form of Trub/Chiller loss and lauter deadspace.
+   if( snap.hasEquipment )
+   {
+      kettleWort_l = (wortFromMash_l - equip.lauterDeadspace_l) + equip.topUpKettle_l;
+      postBoilWort_l = equip.wortEndOfBoil_l(kettleWort_l);
+      ratio = (postBoilWort_l - equip.trubChillerLoss_l) / postBoilWort_l;
+      if( ratio > 1.0 ) // Usually happens when we don't have a mash yet.
+         ratio = 1.0;
+      else if( ratio < 0.0 )
+         ratio = 0.0;
+      else if( Algorithms::isNan(ratio) )
+         ratio = 1.0;
+      // Ignore this again since it should be included in efficiency.
+      //sugar_kg *= ratio;
+      sugar_kg_ignoreEfficiency *= ratio;
+      if ( nonFermetableSugars_kg != 0.0 )
+         nonFermetableSugars_kg *= ratio;
+   }
+
+   sugar_kg = sugar_kg * snap.efficiency_pct/100.0 + sugar_kg_ignoreEfficiency;
+   plato = Algorithms::getPlato( sugar_kg, finalVolumeNoLosses_l);
+
+   ret.og = Algorithms::PlatoToSG_20C20C( plato );
+   tmp_pnts = (ret.og-1)*1000.0;
+   if ( nonFermetableSugars_kg != 0.0 )
+   {
+      ferm_kg = sugar_kg - nonFermetableSugars_kg;
+      plato = Algorithms::getPlato( ferm_kg, finalVolumeNoLosses_l);
+      ret.og_fermentable = Algorithms::PlatoToSG_20C20C( plato );
+      plato = Algorithms::getPlato( nonFermetableSugars_kg, finalVolumeNoLosses_l);
+      tmp_ferm_pnts = ((Algorithms::PlatoToSG_20C20C( plato ))-1)*1000.0;
+   }
+   else
+   {
+      ret.og_fermentable = ret.og;
+      tmp_ferm_pnts = 0;
+   }
+
+   // Calculate FG. Go by the yeast with the greatest attenuation.
+   foreach( double yeastAttenuation_pct, snap.yeastAttenuations_pct )
+   {
+      if( yeastAttenuation_pct > attenuation_pct )
+         attenuation_pct = yeastAttenuation_pct;
+   }
+   if( snap.yeastAttenuations_pct.size() > 0 && attenuation_pct <= 0.0 ) // This means we have yeast, but they neglected to provide attenuation percentages.
+      attenuation_pct = 75.0; // 75% is an average attenuation.
+
+   if ( nonFermetableSugars_kg != 0.0 )
+   {
+      tmp_ferm_pnts = (tmp_pnts-tmp_ferm_pnts) * (1.0 - attenuation_pct/100.0);
+      tmp_pnts *= (1.0 - attenuation_pct/100.0);
+      ret.fg =  1 + tmp_pnts/1000.0;
+      ret.fg_fermentable =  1 + tmp_ferm_pnts/1000.0;
+   }
+   else
+   {
+      tmp_pnts *= (1.0 - attenuation_pct/100.0);
+      ret.fg =  1 + tmp_pnts/1000.0;
+      ret.fg_fermentable = ret.fg;
+   }
+
+   return ret;
+}
+
+double RecipeCalculator::ABV_pct( double og_fermentable, double fg_fermentable )
+{
+   // The complex formula, and variations comes from Ritchie Products Ltd, (Zymurgy, Summer 1995, vol. 18, no. 2)
+   // Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and Designing Great Beers by Daniels.
+   return (76.08 * (og_fermentable - fg_fermentable) / (1.775 - og_fermentable)) * (fg_fermentable / 0.794);
+}
+
+double RecipeCalculator::boilGrav( RecipeSnapshot const& snap )
+{
+   Points sugars = totalPoints(snap);
+
+   // Since the efficiency refers to how much sugar we get into the fermenter,
+   // we need to adjust for that here.
+   double sugar_kg = (snap.efficiency_pct/100.0 * (sugars.sugar_kg - sugars.lateAddition_kg) + sugars.sugar_kg_ignoreEfficiency - sugars.lateAddition_kg_ignoreEff);
+
+   return Algorithms::PlatoToSG_20C20C( Algorithms::getPlato(sugar_kg, snap.boilSize_l) );
+}
+
+double RecipeCalculator::IBU( RecipeSnapshot const& snap, double og, double finalVolumeNoLosses_l, QVector<double>* ibus )
+{
+   double ret = 0.0;
+   double tmp;
+   int i, nHops = snap.hops.size();
+   // Assume 100% utilization and a 60 min boil until further notice
+   double hopUtilization = 1.0;
+   int boilTime = 60;
+
+   if( ibus )
+   {
+      ibus->clear();
+      ibus->reserve(nHops);
+   }
+
+   if( snap.hasEquipment )
+   {
+      hopUtilization = snap.equipment.hopUtilization_pct / 100.0;
+      boilTime = snap.equipment.boilTime_min;
+   }
+
+   // Line up the hops that bitter the wort and do them in one go. Each one
+   // gets exactly what ibuFromHop() would have given it.
+   QVarLengthArray<double,32> AArating(nHops), grams(nHops), minutes(nHops), adjust(nHops), raw(nHops);
+   QVarLengthArray<int,32> slot(nHops);
+   int nBitter = 0;
+   for( i = 0; i < nHops; ++i )
+   {
+      RecipeSnapshot::Hop const& hop = snap.hops.at(i);
+
+      slot[i] = -1;
+      if( hop.use == Hop::Boil )
+      {
+         minutes[nBitter] = hop.time_min;
+         adjust[nBitter] = 1.0;
+      }
+      else if( hop.use == Hop::First_Wort )
+      {
+         minutes[nBitter] = boilTime;
+         adjust[nBitter] = snap.firstWortHopAdjust;
+      }
+      else if( hop.use == Hop::Mash && snap.mashHopAdjust > 0.0 )
+      {
+         minutes[nBitter] = boilTime;
+         adjust[nBitter] = snap.mashHopAdjust;
+      }
+      else
+         continue;
+
+      AArating[nBitter] = hop.alpha_pct/100.0;
+      grams[nBitter] = hop.amount_kg*1000.0;
+      slot[i] = nBitter++;
+   }
+   IbuMethods::getIbus( snap.ibuFormula, AArating.constData(), grams.constData(), minutes.constData(), nBitter,
+                        finalVolumeNoLosses_l, og, raw.data() );
+
+   // Bitterness due to hops...
+   for( i = 0; i < nHops; ++i )
+   {
+      tmp = (slot[i] < 0) ? 0.0 : adjust[slot[i]] * raw[slot[i]];
+      tmp *= hopUtilization * formFactor(snap.hops.at(i).form);
+      if( ibus )
+         ibus->append(tmp);
+      ret += tmp;
+   }
+
+   // Bitterness due to hopped extracts...
+   foreach( RecipeSnapshot::Fermentable const& ferm, snap.fermentables )
+   {
+      // Conversion factor for lb/gal to kg/l = 8.34538.
+      ret +=
+              ferm.ibuGalPerLb *
+              (ferm.amount_kg / snap.batchSize_l) / 8.34538;
+   }
+
+   return ret;
+}
+
+double RecipeCalculator::ibuFromHop( RecipeSnapshot const& snap, RecipeSnapshot::Hop const& hop, double og, double finalVolumeNoLosses_l )
+{
+   double ibus = 0.0;
+   double AArating = hop.alpha_pct/100.0;
+   double grams = hop.amount_kg*1000.0;
+   double minutes = hop.time_min;
+   // Assume 100% utilization until further notice
+   double hopUtilization = 1.0;
+   // Assume 60 min boil until further notice
+   int boilTime = 60;
+
+   // NOTE: we used to carefully calculate the average boil gravity and use it in the
+   // IBU calculations. However, due to John Palmer
+   // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hop-utilization),
+   // it seems more appropriate to just use the OG directly, since it is the total
+   // amount of break material that truly affects the IBUs.
+
+   if( snap.hasEquipment )
+   {
+      hopUtilization = snap.equipment.hopUtilization_pct / 100.0;
+      boilTime = snap.equipment.boilTime_min;
+   }
+
+   if( hop.use == Hop::Boil)
+      ibus = IbuMethods::getIbus( snap.ibuFormula, AArating, grams, finalVolumeNoLosses_l, og, minutes );
+   else if( hop.use == Hop::First_Wort )
+      ibus = snap.firstWortHopAdjust * IbuMethods::getIbus( snap.ibuFormula, AArating, grams, finalVolumeNoLosses_l, og, boilTime );
+   else if( hop.use == Hop::Mash && snap.mashHopAdjust > 0.0 )
+      ibus = snap.mashHopAdjust * IbuMethods::getIbus( snap.ibuFormula, AArating, grams, finalVolumeNoLosses_l, og, boilTime );
+
+   // Adjust for hop utilization.
+   ibus *= hopUtilization * formFactor(hop.form);
+
+   return ibus;
+}
+
+double RecipeCalculator::formFactor( Hop::Form form )
+{
+   // Adjust for hop form. Tinseth's table was created from whole cone data,
+   // and it seems other formulae are optimized that way as well. So, the
+   // utilization is considered unadjusted for whole cones, and adjusted
+   // up for plugs and pellets.
+   //
+   // - http://www.realbeer.com/hops/FAQ.html
+   // - https://groups.google.com/forum/#!topic/brewtarget-help/mv2qvWBC4sU
+   switch( form ) {
+   case Hop::Plug:
+      return 1.02;
+   case Hop::Pellet:
+      return 1.10;
+   default:
+      return 1.0;
+   }
+}
+
+// the formula in here are taken from http://hbd.org/ensmingr/
+double RecipeCalculator::calories( double og, double fg )
+{
+   double startPlato, finishPlato, RE, abw, oog, ffg, tmp;
+
+   oog = og;
+   ffg = fg;
+
+   // Need to translate OG and FG into plato
+   startPlato  = -463.37 + ( 668.72 * oog ) - (205.35 * oog * oog);
+   finishPlato = -463.37 + ( 668.72 * ffg ) - (205.35 * ffg * ffg);
+
+   // RE (real extract)
+   RE = (0.1808 * startPlato) + (0.8192 * finishPlato);
+
+   // Alcohol by weight?
+   abw = (startPlato-RE)/(2.0665 - (0.010665 * startPlato));
+
+   // The final results of this formular are calories per 100 ml.
+   // The 3.55 puts it in terms of 12 oz. I really should have stored it
+   // without that adjust.
+   tmp = ((6.9*abw) + 4.0 * (RE-0.1)) * ffg * 3.55;
+
+   //! If there are no fermentables in the recipe, if there is no mash, etc.,
+   //  then the calories/12 oz ends up negative. Since negative doesn't make
+   //  sense, set it to 0
+   if ( tmp < 0 )
+      tmp = 0;
+
+   return tmp;
+}
@@ -0,0 +1,108 @@
+/*
+ * RecipeCalculator.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RECIPECALCULATOR_H
+#define _RECIPECALCULATOR_H
+
+#include <QVector>
+#include "RecipeSnapshot.h"
+
+/*!
+ * \class RecipeCalculator
+ *
+ * \brief The numbers Recipe shows, worked out from a RecipeSnapshot.
+ *
+ * Nothing in here touches the database, a QObject or a signal, so it is
+ * safe from any thread. Each piece takes what it depends on as arguments;
+ * calculate() strings them together in the order Recipe::recalcAll() needs.
+ */
+class RecipeCalculator
+{
+public:
+   struct Volumes
+   {
+      double wortFromMash_l;
+      double boilVolume_l;
+      double finalVolume_l;
+      double postBoilVolume_l;
+      //! Final volume before any losses out of the kettle, which og, ibu etc. go by
+      double finalVolumeNoLosses_l;
+   };
+
+   //! \brief The sugars, in kg of sucrose
+   struct Points
+   {
+      double sugar_kg;
+      double nonFermetableSugars_kg;
+      double sugar_kg_ignoreEfficiency;
+      double lateAddition_kg;
+      double lateAddition_kg_ignoreEff;
+   };
+
+   struct Gravities
+   {
+      double og;
+      double fg;
+      double og_fermentable;
+      double fg_fermentable;
+   };
+
+   //! \brief Everything calculate() works out
+   struct Results
+   {
+      double grainsInMash_kg;
+      double grains_kg;
+      Volumes volumes;
+      double color_srm;
+      Gravities gravities;
+      double ABV_pct;
+      double boilGrav;
+      double IBU;
+      //! One per hop, in the snapshot's order
+      QVector<double> ibus;
+      double calories;
+   };
+
+   //! \brief All of the below, in dependency order
+   static Results calculate( RecipeSnapshot const& snap );
+
+   static double grainsInMash_kg( RecipeSnapshot const& snap );
+   static double grains_kg( RecipeSnapshot const& snap );
+   //! Needs Basics, Equip, MashSteps and Fermentables
+   static Volumes volumes( RecipeSnapshot const& snap, double grainsInMash_kg );
+   static double color_srm( RecipeSnapshot const& snap, double finalVolumeNoLosses_l );
+   static Points totalPoints( RecipeSnapshot const& snap );
+   //! Needs Basics, Equip, Fermentables and Yeasts
+   static Gravities ogFg( RecipeSnapshot const& snap, double wortFromMash_l, double finalVolumeNoLosses_l );
+   static double ABV_pct( double og_fermentable, double fg_fermentable );
+   static double boilGrav( RecipeSnapshot const& snap );
+   /*!
+    * Needs Basics, Equip, Fermentables and Hops. Each hop's share goes in
+    * \c ibus, if you want it.
+    */
+   static double IBU( RecipeSnapshot const& snap, double og, double finalVolumeNoLosses_l, QVector<double>* ibus = 0 );
+   static double ibuFromHop( RecipeSnapshot const& snap, RecipeSnapshot::Hop const& hop, double og, double finalVolumeNoLosses_l );
+   //! Per 12 oz, never negative
+   static double calories( double og, double fg );
+
+private:
+   //! How much better than whole cones a hop of \c form does
+   static double formFactor( Hop::Form form );
+};
+
+#endif /* _RECIPECALCULATOR_H */
@@ -31,7 +31,9 @@
 #include "mashstep.h"
 #include "unit.h"
 #include "brewtarget.h"
+#include "database.h"
 #include "MainWindow.h"
+#include "PropertyIds.h"
 #include <QClipboard>
 #include <QObject>
 #include <QPrinter>
@@ -41,12 +43,17 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 
+QAtomicInt RecipeFormatter::generation(1);
+
 RecipeFormatter::RecipeFormatter(QObject* parent)
    : QObject(parent)
 {
    textSeparator = 0;
    rec = 0;
 
+   // New brew notes don't tell their recipe
+   connect( &(Database::instance()), SIGNAL(newBrewNoteSignal(BrewNote*)), this, SLOT(brewNoteAdded(BrewNote*)) );
+
    //===Construct a print-preview dialog.===
    docDialog = new QDialog(Brewtarget::mainWindow());
    docDialog->setWindowTitle("Print Preview");
@@ -152,6 +159,8 @@ QString RecipeFormatter::getTextSeparator()
 
 QString RecipeFormatter::buildHTMLHeader() {
     QString header;
+    // It's in the resources, so it isn't changing on us
+    static const QString css = getCSS(":css/recipe.css");
 
    header = "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0//EN\" \"http://www.w3.org/TR/1998/REC-html40-19980424/strict.dtd\">"
             "<html>";
@@ -163,7 +172,7 @@ QString RecipeFormatter::buildHTMLHeader() {
    header += "<title></title>";
 
    header += "<style type=\"text/css\">";
-   header += getCSS(":css/recipe.css");
+   header += css;
    header += "</style></head>";
 
    header += "<body>";
@@ -177,32 +186,40 @@ QString RecipeFormatter::buildHTMLFooter() {
 
 QString RecipeFormatter::getHTMLFormat( QList<Recipe*> recipes ) {
    Recipe *current = rec;
+   QString header = buildHTMLHeader();
+   QString footer = buildHTMLFooter();
+   QString toc;
    QString hDoc;
-
-   hDoc = buildHTMLHeader();
+   QStringList anchors;
+   int size, i, j;
 
    // build a toc -- why do I do this to myself?
-   hDoc += "<ul>";
+   toc = "<ul>";
    foreach ( Recipe* foo, recipes ) {
-       hDoc += QString("<li><a href=\"#%1\">%1</a></li>").arg(foo->name());
+       toc += QString("<li><a href=\"#%1\">%1</a></li>").arg(foo->name());
    }
-   hDoc += "</ul>";
+   toc += "</ul>";
 
+   // Bring everybody up to date first, so we know how much room it takes
+   size = header.size() + toc.size() + footer.size();
    foreach (Recipe* foo, recipes) {
       rec = foo;
-      hDoc += QString("<a name=\"%1\"></a>").arg(foo->name());
-      hDoc += buildStatTableHtml();
-      hDoc += buildFermentableTableHtml();
-      hDoc += buildHopsTableHtml();
-      hDoc += buildMiscTableHtml();
-      hDoc += buildYeastTableHtml();
-      hDoc += buildMashTableHtml();
-      hDoc += buildNotesHtml();
-      hDoc += buildInstructionTableHtml();
-      hDoc += buildBrewNotesHtml();
+      anchors.append( QString("<a name=\"%1\"></a>").arg(foo->name()) );
+      size += anchors.last().size() + length(sections()) + 7;
+   }
+
+   hDoc.reserve(size);
+   hDoc += header;
+   hDoc += toc;
+   for( i = 0; i < recipes.size(); ++i ) {
+      Sections const& cached = _sections[recipes.at(i)];
+
+      hDoc += anchors.at(i);
+      for( j = 0; j < NUMSECTIONS; ++j )
+         hDoc += cached.html[j];
       hDoc += "<p></p>";
    }
-   hDoc += buildHTMLFooter();
+   hDoc += footer;
 
    rec = current;
    return hDoc;
@@ -210,24 +227,246 @@ QString RecipeFormatter::getHTMLFormat( QList<Recipe*> recipes ) {
 
 QString RecipeFormatter::getHTMLFormat()
 {
+   QString header = buildHTMLHeader();
+   QString footer = buildHTMLFooter();
    QString pDoc;
+   int i;
+
+   if( rec == 0 )
+      return header + footer;
 
-   pDoc = buildHTMLHeader();
-   pDoc += buildStatTableHtml();
-   pDoc += buildFermentableTableHtml();
-   pDoc += buildHopsTableHtml();
-   pDoc += buildMiscTableHtml();
-   pDoc += buildYeastTableHtml();
-   pDoc += buildMashTableHtml();
-   pDoc += buildNotesHtml();
-   pDoc += buildInstructionTableHtml();
-   pDoc += buildBrewNotesHtml();
+   Sections const& cached = sections();
 
-   pDoc += buildHTMLFooter();
+   // One allocation, instead of one per +=
+   pDoc.reserve( header.size() + length(cached) + footer.size() );
+   pDoc += header;
+   for( i = 0; i < NUMSECTIONS; ++i )
+      pDoc += cached.html[i];
+   pDoc += footer;
 
    return pDoc;
 }
 
+void RecipeFormatter::invalidateAll()
+{
+   generation.ref();
+}
+
+RecipeFormatter::Sections& RecipeFormatter::sections()
+{
+   bool fresh = ! _sections.contains(rec);
+   Sections& cached = _sections[rec];
+   int current = generation.load();
+   int i;
+
+   if( fresh )
+   {
+      connect( rec, SIGNAL(changed(QMetaProperty,QVariant)), this, SLOT(recipeChanged(QMetaProperty,QVariant)) );
+      connect( rec, SIGNAL(destroyed(QObject*)), this, SLOT(forgetRecipe(QObject*)) );
+   }
+
+   if( cached.generation != current )
+   {
+      cached.dirty = (1 << NUMSECTIONS) - 1;
+      cached.brewNotes.clear();
+      cached.generation = current;
+   }
+
+   for( i = 0; i < NUMSECTIONS; ++i )
+   {
+      if( ! (cached.dirty & (1 << i)) )
+         continue;
+
+      // Cleared first. A getter that recalculates while we build says so
+      // through recipeChanged(), and that has to stick
+      cached.dirty &= ~(1 << i);
+      cached.html[i] = buildSection(i, cached);
+   }
+
+   return cached;
+}
+
+int RecipeFormatter::length( Sections const& cached )
+{
+   int ret = 0;
+   int i;
+
+   for( i = 0; i < NUMSECTIONS; ++i )
+      ret += cached.html[i].size();
+   return ret;
+}
+
+QString RecipeFormatter::buildSection( int section, Sections& cached )
+{
+   switch( section )
+   {
+      case STATS:        return buildStatTableHtml();
+      case FERMENTABLES: return buildFermentableTableHtml();
+      case HOPS:         return buildHopsTableHtml();
+      case MISCS:        return buildMiscTableHtml();
+      case YEASTS:       return buildYeastTableHtml();
+      case MASH:         return buildMashTableHtml();
+      case NOTES:        return buildNotesHtml();
+      case INSTRUCTIONS: return buildInstructionTableHtml();
+      case BREWNOTES:    return buildBrewNotesHtml(cached);
+      default:           return "";
+   }
+}
+
+void RecipeFormatter::watch( BeerXMLElement* elem, Recipe* recipe )
+{
+   if( elem == 0 || _shownIn.contains(elem, recipe) )
+      return;
+
+   if( ! _shownIn.contains(elem) )
+   {
+      connect( elem, SIGNAL(changed(QMetaProperty,QVariant)), this, SLOT(elementChanged()) );
+      connect( elem, SIGNAL(destroyed(QObject*)), this, SLOT(forgetElement(QObject*)) );
+      if( qobject_cast<Mash*>(elem) )
+         connect( elem, SIGNAL(mashStepsChanged()), this, SLOT(elementChanged()) );
+   }
+   _shownIn.insert(elem, recipe);
+}
+
+int RecipeFormatter::sectionOf( BeerXMLElement* elem )
+{
+   if( qobject_cast<Fermentable*>(elem) )
+      return FERMENTABLES;
+   if( qobject_cast<Hop*>(elem) )
+      return HOPS;
+   if( qobject_cast<Misc*>(elem) )
+      return MISCS;
+   if( qobject_cast<Yeast*>(elem) )
+      return YEASTS;
+   if( qobject_cast<Mash*>(elem) || qobject_cast<MashStep*>(elem) )
+      return MASH;
+   if( qobject_cast<Instruction*>(elem) )
+      return INSTRUCTIONS;
+   if( qobject_cast<BrewNote*>(elem) )
+      return BREWNOTES;
+
+   // Styles and equipment show up in the stats
+   return STATS;
+}
+
+void RecipeFormatter::recipeChanged( QMetaProperty prop, QVariant /*val*/ )
+{
+   QHash<Recipe*, Sections>::iterator it = _sections.find( qobject_cast<Recipe*>(sender()) );
+   if( it == _sections.end() )
+      return;
+
+   switch( BeerXMLElement::propertyId<Recipe>(prop) )
+   {
+      case PropertyIds::Recipe::fermentables:
+         it->dirty |= 1 << FERMENTABLES;
+         break;
+      case PropertyIds::Recipe::hops:
+         it->dirty |= 1 << HOPS;
+         break;
+      case PropertyIds::Recipe::miscs:
+         it->dirty |= 1 << MISCS;
+         break;
+      case PropertyIds::Recipe::yeasts:
+         it->dirty |= 1 << YEASTS;
+         break;
+      case PropertyIds::Recipe::mash:
+         it->dirty |= 1 << MASH;
+         break;
+      case PropertyIds::Recipe::notes:
+         it->dirty |= 1 << NOTES;
+         break;
+      case PropertyIds::Recipe::instructions:
+         it->dirty |= 1 << INSTRUCTIONS;
+         break;
+      case PropertyIds::Recipe::brewNotes:
+         it->dirty |= 1 << BREWNOTES;
+         break;
+      // Each hop's IBUs come from the gravity, the volumes and the kit, so
+      // the hop table goes stale with the stats
+      case PropertyIds::Recipe::og:
+      case PropertyIds::Recipe::IBU:
+      case PropertyIds::Recipe::batchSize_l:
+      case PropertyIds::Recipe::boilSize_l:
+      case PropertyIds::Recipe::boilTime_min:
+      case PropertyIds::Recipe::efficiency_pct:
+      case PropertyIds::Recipe::boilVolume_l:
+      case PropertyIds::Recipe::postBoilVolume_l:
+      case PropertyIds::Recipe::finalVolume_l:
+      case PropertyIds::Recipe::equipment:
+         it->dirty |= (1 << STATS) | (1 << HOPS);
+         break;
+      default:
+         // Everything else the recipe has to say is in the stats somewhere
+         it->dirty |= 1 << STATS;
+   }
+}
+
+void RecipeFormatter::elementChanged()
+{
+   BeerXMLElement* elem = qobject_cast<BeerXMLElement*>(sender());
+   if( elem == 0 )
+      return;
+
+   int section = sectionOf(elem);
+   int dirty = 1 << section;
+   // The kit's losses and utilization go into each hop's IBUs too
+   if( qobject_cast<Equipment*>(elem) )
+      dirty |= 1 << HOPS;
+
+   foreach( Recipe* recipe, _shownIn.values(elem) )
+   {
+      QHash<Recipe*, Sections>::iterator it = _sections.find(recipe);
+      if( it == _sections.end() )
+         continue;
+
+      it->dirty |= dirty;
+      // The other notes can stay as they are
+      if( section == BREWNOTES )
+         it->brewNotes.remove( static_cast<BrewNote*>(elem) );
+   }
+}
+
+void RecipeFormatter::brewNoteAdded( BrewNote* /*note*/ )
+{
+   QHash<Recipe*, Sections>::iterator it;
+
+   // Finding out whose it is costs a query. Putting the kept notes back
+   // together costs next to nothing
+   for( it = _sections.begin(); it != _sections.end(); ++it )
+      it->dirty |= 1 << BREWNOTES;
+}
+
+void RecipeFormatter::forgetRecipe( QObject* obj )
+{
+   // Half gone already, so no qobject_cast. We only want the address
+   Recipe* recipe = static_cast<Recipe*>(obj);
+   QMultiHash<BeerXMLElement*, Recipe*>::iterator it = _shownIn.begin();
+
+   _sections.remove(recipe);
+   while( it != _shownIn.end() )
+   {
+      if( it.value() == recipe )
+         it = _shownIn.erase(it);
+      else
+         ++it;
+   }
+}
+
+void RecipeFormatter::forgetElement( QObject* obj )
+{
+   BeerXMLElement* elem = static_cast<BeerXMLElement*>(obj);
+   QHash<Recipe*, Sections>::iterator it;
+
+   _shownIn.remove(elem);
+
+   // The next brew note could well get the same address
+   for( it = _sections.begin(); it != _sections.end(); ++it )
+   {
+      if( it->brewNotes.remove( static_cast<BrewNote*>(elem) ) > 0 )
+         it->dirty |= 1 << BREWNOTES;
+   }
+}
+
 QString RecipeFormatter::getBBCodeFormat()
 {
    QString ret = "";
@@ -292,19 +531,49 @@ QString RecipeFormatter::getBBCodeFormat()
 
 QString RecipeFormatter::getToolTip(Recipe* rec)
 {
-   QString header;
-   QString body;
-
+   RecipeToolTip data;
    Style* style = 0;
 
    if ( rec == 0 )
       return "";
 
    style = rec->style();
+   data.hasStyle = style != 0;
+   if ( style )
+   {
+      data.style = style->name();
+      data.categoryNumber = style->categoryNumber();
+      data.styleLetter = style->styleLetter();
+   }
+   data.og = rec->og();
+   data.fg = rec->fg();
+   data.color_srm = rec->color_srm();
+   data.IBU = rec->IBU();
+
+   return getToolTip(data);
+}
+
+bool RecipeFormatter::recipeToolTipNumbers(Recipe* rec, RecipeToolTip& data)
+{
+   // Asking for them would mean a recalculation, and that needs doing here
+   if ( rec == 0 || rec->_uninitializedCalcs )
+      return false;
+
+   data.og = rec->_og;
+   data.fg = rec->_fg;
+   data.color_srm = rec->_color_srm;
+   data.IBU = rec->_IBU;
+   return true;
+}
+
+QString RecipeFormatter::getToolTip(RecipeToolTip const& data)
+{
+   QString header;
+   QString body;
 
    // Do the style sheet first
    header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
+   header += toolTipCSS();
    header += "</style></head>";
 
    body   = "<body>";
@@ -312,26 +581,26 @@ QString RecipeFormatter::getToolTip(Recipe* rec)
    body += QString("<div id=\"headerdiv\">");
    body += QString("<table id=\"tooltip\">");
    body += QString("<caption>%1 (%2%3)</caption>")
-         .arg( style ? style->name() : tr("unknown style"))
-         .arg( style ? style->categoryNumber() : tr("N/A") )
-         .arg( style ? style->styleLetter() : "" );
+         .arg( data.hasStyle ? data.style : tr("unknown style"))
+         .arg( data.hasStyle ? data.categoryNumber : tr("N/A") )
+         .arg( data.hasStyle ? data.styleLetter : "" );
 
    // Third row: OG and FG
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
            .arg(tr("OG"))
-           .arg(Brewtarget::displayAmount(rec->og(), Units::sp_grav, 3));
+           .arg(Brewtarget::displayAmount(data.og, Units::sp_grav, 3));
    body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
            .arg(tr("FG"))
-           .arg(Brewtarget::displayAmount(rec->fg(), Units::sp_grav, 3));
+           .arg(Brewtarget::displayAmount(data.fg, Units::sp_grav, 3));
 
    // Fourth row: Color and Bitterness.  
    body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2 (%3)</td>")
            .arg(tr("Color"))
-           .arg(Brewtarget::displayAmount(rec->color_srm(),Units::srm, 1))
+           .arg(Brewtarget::displayAmount(data.color_srm,Units::srm, 1))
            .arg(Brewtarget::colorFormulaName());
    body += QString("<td class=\"left\">%1</td><td class=\"value\">%2 (%3)</td></tr>")
            .arg(tr("IBU"))
-           .arg(Brewtarget::displayAmount(rec->IBU(), 0, 1))
+           .arg(Brewtarget::displayAmount(data.IBU, 0, 1))
            .arg(Brewtarget::ibuFormulaName() );
 
    body += "</table></body></html>";
@@ -340,95 +609,83 @@ QString RecipeFormatter::getToolTip(Recipe* rec)
 
 }
 
-QString RecipeFormatter::getToolTip(Style* style)
+//! What each kind of tooltip shows, in the order getToolTip(ElementToolTip) reads it
+static QVector<const char*> toolTipColumns( Brewtarget::DBTable table )
 {
-   QString header;
-   QString body;
-
-   if ( style == 0 )
-      return "";
-
-   // Do the style sheet first
-   header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
-   header += "</style></head>";
-
-   body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( style->name() );
-
-   // First row -- category and number (letter)
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Category"))
-           .arg(style->category());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2%3</td></tr>")
-           .arg(tr("Code"))
-           .arg(style->categoryNumber())
-           .arg(style->styleLetter());
-
-   // Second row: guide and type
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Guide"))
-           .arg(style->styleGuide());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Type"))
-           .arg(style->typeString());
-
-   body += "</table></body></html>";
-
-   return header + body;
-
+   switch( table )
+   {
+      case Brewtarget::STYLETABLE:
+         return QVector<const char*>() << "name" << "category" << "category_number" << "style_letter" << "style_guide" << "s_type";
+      case Brewtarget::EQUIPTABLE:
+         return QVector<const char*>() << "name" << "boil_size" << "boil_time";
+      case Brewtarget::FERMTABLE:
+         return QVector<const char*>() << "name" << "ftype" << "color" << "is_mashed" << "yield";
+      case Brewtarget::HOPTABLE:
+         return QVector<const char*>() << "name" << "alpha" << "beta" << "form" << "use";
+      case Brewtarget::MISCTABLE:
+         return QVector<const char*>() << "name" << "mtype" << "use";
+      case Brewtarget::YEASTTABLE:
+         return QVector<const char*>() << "name" << "ytype" << "form" << "laboratory" << "attenuation" << "product_id" << "flocculation";
+      default:
+         return QVector<const char*>();
+   }
 }
 
-QString RecipeFormatter::getToolTip(Equipment* kit)
+bool RecipeFormatter::recipeToolTipStyle(Recipe* rec, RecipeToolTip& data)
 {
-   QString header;
-   QString body;
+   static QVector<const char*> const columns = QVector<const char*>()
+      << "name" << "category_number" << "style_letter";
+   Database& db = Database::instance();
 
-   if ( kit == 0 )
-      return "";
+   if ( rec == 0 )
+      return false;
 
-   // Do the style sheet first
-   header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
-   header += "</style></head>";
+   // Same as Recipe::style(), minus the Style
+   QVariant styleKey = db.get(Brewtarget::RECTABLE, rec->key(), "style_id");
+   if ( ! styleKey.isValid() )
+      return false;
 
-   body   = "<body>";
+   data.hasStyle = styleKey.toInt() > 0;
+   if ( ! data.hasStyle )
+      return true;
 
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( kit->name() );
+   QVector<QVariant> row = db.get(Brewtarget::STYLETABLE, styleKey.toInt(), columns);
+   if ( ! row.at(0).isValid() )
+      return false;
 
-   // First row -- batchsize and boil time
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Preboil"))
-           .arg(Brewtarget::displayAmount(kit->boilSize_l(), Units::liters) );
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("BoilTime"))
-           .arg(Brewtarget::displayAmount(kit->boilTime_min(), Units::minutes) );
+   data.style = row.at(0).toString();
+   data.categoryNumber = row.at(1).toString();
+   data.styleLetter = row.at(2).toString();
+   return true;
+}
 
-   body += "</table></body></html>";
+bool RecipeFormatter::elementToolTipData(BeerXMLElement* elem, ElementToolTip& data)
+{
+   if ( elem == 0 )
+      return false;
 
-   return header + body;
+   QVector<const char*> columns = toolTipColumns(elem->table());
+   if ( columns.isEmpty() )
+      return false;
 
+   data.table = elem->table();
+   data.row = Database::instance().get(data.table, elem->key(), columns);
+   // Database::get() leaves every one invalid when it couldn't read the row
+   return data.row.at(0).isValid();
 }
 
-// Once we do inventory, this needs to be fixed to show amount on hand
-QString RecipeFormatter::getToolTip(Fermentable* ferm)
+QString RecipeFormatter::getToolTip(ElementToolTip const& data)
 {
+   QVector<QVariant> const& row = data.row;
    QString header;
    QString body;
 
-   if ( ferm == 0 )
+   if ( row.isEmpty() )
       return "";
 
    // Do the style sheet first
    header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
+   header += toolTipCSS();
    header += "</style></head>";
 
    body   = "<body>";
@@ -436,153 +693,153 @@ QString RecipeFormatter::getToolTip(Fermentable* ferm)
    body += QString("<div id=\"headerdiv\">");
    body += QString("<table id=\"tooltip\">");
    body += QString("<caption>%1</caption>")
-         .arg( ferm->name() );
+         .arg( row.at(0).toString() );
 
-   // First row -- type and color
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(ferm->typeStringTr());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Color"))
-           .arg(Brewtarget::displayAmount(ferm->color_srm(), Units::srm, 1));
-   // Second row -- isMashed and yield?
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Mashed"))
-           .arg( ferm->isMashed() ? tr("Yes") : tr("No") );
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Yield"))
-           .arg(Brewtarget::displayAmount(ferm->yield_pct(), 0));
+   switch( data.table )
+   {
+      case Brewtarget::STYLETABLE:
+         // First row -- category and number (letter)
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Category"))
+                 .arg(row.at(1).toString());
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2%3</td></tr>")
+                 .arg(tr("Code"))
+                 .arg(row.at(2).toString())
+                 .arg(row.at(3).toString());
+
+         // Second row: guide and type
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Guide"))
+                 .arg(row.at(4).toString());
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Type"))
+                 .arg(row.at(5).toString());
+         break;
+
+      case Brewtarget::EQUIPTABLE:
+         // First row -- batchsize and boil time
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Preboil"))
+                 .arg(Brewtarget::displayAmount(row.at(1).toDouble(), Units::liters) );
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("BoilTime"))
+                 .arg(Brewtarget::displayAmount(row.at(2).toDouble(), Units::minutes) );
+         break;
+
+      // Once we do inventory, this needs to be fixed to show amount on hand
+      case Brewtarget::FERMTABLE:
+         // First row -- type and color
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Type"))
+                 .arg(Fermentable::typeStringTr(row.at(1).toString()));
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Color"))
+                 .arg(Brewtarget::displayAmount(row.at(2).toDouble(), Units::srm, 1));
+         // Second row -- isMashed and yield?
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Mashed"))
+                 .arg( row.at(3).toBool() ? tr("Yes") : tr("No") );
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Yield"))
+                 .arg(Brewtarget::displayAmount(row.at(4).toDouble(), 0));
+         break;
+
+      case Brewtarget::HOPTABLE:
+         // First row -- alpha and beta
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Alpha"))
+                 .arg(Brewtarget::displayAmount(row.at(1).toDouble(), 0));
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Beta"))
+                 .arg(Brewtarget::displayAmount(row.at(2).toDouble(), 0));
+
+         // Second row -- form and use
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Form"))
+                 .arg( Hop::formStringTr(row.at(3).toString()) );
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Use"))
+                 .arg( Hop::useStringTr(row.at(4).toString()) );
+         break;
+
+      case Brewtarget::MISCTABLE:
+         // First row -- type and use
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Type"))
+                 .arg(Misc::typeStringTr(row.at(1).toString()));
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Use"))
+                 .arg(Misc::useStringTr(row.at(2).toString()));
+         break;
+
+      case Brewtarget::YEASTTABLE:
+         // First row -- type and form
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Type"))
+                 .arg(Yeast::typeStringTr(row.at(1).toString()));
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Form"))
+                 .arg(Yeast::formStringTr(row.at(2).toString()));
+         // Second row -- lab and prod id
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Lab"))
+                 .arg(row.at(3).toString());
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Attenuation"))
+                 .arg(Brewtarget::displayAmount(row.at(4).toDouble(), 0));
+
+         // third row -- atten and floc
+         body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
+                 .arg(tr("Id"))
+                 .arg(row.at(5).toString());
+         body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
+                 .arg(tr("Flocculation"))
+                 .arg( Yeast::flocculationStringTr(row.at(6).toString()));
+         break;
+
+      default:
+         return "";
+   }
 
    body += "</table></body></html>";
 
    return header + body;
-
 }
 
-QString RecipeFormatter::getToolTip(Hop* hop)
+QString RecipeFormatter::getToolTip(Style* style)
 {
-   QString header;
-   QString body;
-
-   if ( hop == 0 )
-      return "";
-
-   // Do the style sheet first
-   header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
-   header += "</style></head>";
-
-   body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( hop->name() );
-
-   // First row -- alpha and beta
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Alpha"))
-           .arg(Brewtarget::displayAmount(hop->alpha_pct(), 0));
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Beta"))
-           .arg(Brewtarget::displayAmount(hop->beta_pct(), 0));
-
-   // Second row -- form and use
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Form"))
-           .arg( hop->formStringTr() );
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Use"))
-           .arg( hop->useStringTr() );
+   ElementToolTip data;
+   return elementToolTipData(style, data) ? getToolTip(data) : "";
+}
 
-   body += "</table></body></html>";
+QString RecipeFormatter::getToolTip(Equipment* kit)
+{
+   ElementToolTip data;
+   return elementToolTipData(kit, data) ? getToolTip(data) : "";
+}
 
-   return header + body;
+QString RecipeFormatter::getToolTip(Fermentable* ferm)
+{
+   ElementToolTip data;
+   return elementToolTipData(ferm, data) ? getToolTip(data) : "";
+}
 
+QString RecipeFormatter::getToolTip(Hop* hop)
+{
+   ElementToolTip data;
+   return elementToolTipData(hop, data) ? getToolTip(data) : "";
 }
 
 QString RecipeFormatter::getToolTip(Misc* misc)
 {
-   QString header;
-   QString body;
-
-   if ( misc == 0 )
-      return "";
-
-   // Do the style sheet first
-   header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
-   header += "</style></head>";
-
-   body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( misc->name() );
-
-   // First row -- type and use
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(misc->typeStringTr());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Use"))
-           .arg(misc->useStringTr());
-
-   body += "</table></body></html>";
-
-   return header + body;
-
+   ElementToolTip data;
+   return elementToolTipData(misc, data) ? getToolTip(data) : "";
 }
 
 QString RecipeFormatter::getToolTip(Yeast* yeast)
 {
-   QString header;
-   QString body;
-
-   if ( yeast == 0 )
-      return "";
-
-   // Do the style sheet first
-   header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
-   header += "</style></head>";
-
-   body   = "<body>";
-
-   body += QString("<div id=\"headerdiv\">");
-   body += QString("<table id=\"tooltip\">");
-   body += QString("<caption>%1</caption>")
-         .arg( yeast->name() );
-
-   // First row -- type and form
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Type"))
-           .arg(yeast->typeStringTr());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Form"))
-           .arg(yeast->formStringTr());
-   // Second row -- lab and prod id
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Lab"))
-           .arg(yeast->laboratory());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Attenuation"))
-           .arg(Brewtarget::displayAmount(yeast->attenuation_pct(), 0));
-
-   // third row -- atten and floc
-   body += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td>")
-           .arg(tr("Id"))
-           .arg(yeast->productID());
-   body += QString("<td class=\"left\">%1</td><td class=\"value\">%2</td></tr>")
-           .arg(tr("Flocculation"))
-           .arg( yeast->flocculationStringTr());
-
-
-   body += "</table></body></html>";
-
-   return header + body;
-
+   ElementToolTip data;
+   return elementToolTipData(yeast, data) ? getToolTip(data) : "";
 }
 
 void RecipeFormatter::toTextClipboard()
@@ -660,6 +917,13 @@ QString RecipeFormatter::wrapText( const QString &text, int wrapLength )
    return wrappedText;
 }
 
+QString RecipeFormatter::toolTipCSS()
+{
+   // Every tooltip wants it, and it isn't going anywhere
+   static const QString css = getCSS(":/css/tooltip.css");
+   return css;
+}
+
 QString RecipeFormatter::getCSS(QString resourceName)
 {
 
@@ -681,11 +945,15 @@ QString RecipeFormatter::buildStatTableHtml()
    QString header;
    QString body;
    Style* style = 0;
+   Equipment* kit = 0;
 
    if ( rec == 0 )
       return "";
 
    style = rec->style();
+   kit = rec->equipment();
+   watch(style, rec);
+   watch(kit, rec);
 
    body += QString("<div id=\"headerdiv\">");
    // NOTE: QTextBrowser does not support the caption tag
@@ -732,9 +1000,9 @@ QString RecipeFormatter::buildStatTableHtml()
                    "<td align=\"left\" class=\"left\">%1</td>"
                    "<td class=\"value\">%2</td>")
            .arg(tr("Boil Time"))
-           .arg( (rec->equipment() == 0)?
+           .arg( (kit == 0)?
                    Brewtarget::displayAmount(0, "tab_recipe", "boilTime_min", Units::minutes)
-                 : Brewtarget::displayAmount( (rec->equipment())->boilTime_min(), "tab_recipe", "boilTime_min", Units::minutes));
+                 : Brewtarget::displayAmount( kit->boilTime_min(), "tab_recipe", "boilTime_min", Units::minutes));
    body += QString("<td align=\"right\" class=\"right\">%1</td>"
                    "<td class=\"value\">%2</td></tr>")
            .arg(tr("Efficiency"))
@@ -862,6 +1130,7 @@ QString RecipeFormatter::buildFermentableTableHtml()
    for(i=0; i < size; ++i)
    {
       Fermentable* ferm = ferms[i];
+      watch(ferm, rec);
       ftable += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6%</td><td>%7</td></tr>")
             .arg( ferm->name())
             .arg( ferm->typeStringTr())
@@ -970,6 +1239,7 @@ QString RecipeFormatter::buildHopsTableHtml()
    for( i = 0; i < size; ++i)
    {
       Hop *hop = hops[i];
+      watch(hop, rec);
       hTable += QString("<tr><td>%1</td><td>%2%</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td></tr>")
             .arg( hop->name())
             .arg( Brewtarget::displayAmount(hop->alpha_pct(),0,1) )
@@ -1064,6 +1334,7 @@ QString RecipeFormatter::buildMiscTableHtml()
    for( i = 0; i < size; ++i)
    {
       Misc *misc = miscs[i];
+      watch(misc, rec);
       kindOf = misc->amountIsWeight() ? (Unit*)Units::kilograms : (Unit*)Units::liters;
 
       mtable += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>")
@@ -1153,6 +1424,7 @@ QString RecipeFormatter::buildYeastTableHtml()
    for( i = 0; i < size; ++i)
    {
       Yeast* y = yeasts[i];
+      watch(y, rec);
       kindOf = y->amountIsWeight() ? (Unit*)Units::kilograms : (Unit*)Units::liters;
 
       ytable += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td></tr>")
@@ -1221,6 +1493,7 @@ QString RecipeFormatter::buildMashTableHtml()
    int i, size;
    Mash* m = rec->mash();
    QList<MashStep*> mashSteps = m->mashSteps();
+   watch(m, rec);
    size = mashSteps.size();
    
    if( size <= 0 )
@@ -1248,6 +1521,7 @@ QString RecipeFormatter::buildMashTableHtml()
    {
       QString tmp = "<tr>";
       ms = mashSteps[i];
+      watch(ms, rec);
       tmp += QString("<td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td>")
              .arg(ms->name())
              .arg(ms->typeStringTr());
@@ -1372,6 +1646,7 @@ QString RecipeFormatter::buildInstructionTableHtml()
    for( i = 0; i < size; ++i )
    {
       Instruction* ins = instructions[i];
+      watch(ins, rec);
       itable += QString("<li>%1</li>").arg( ins->directions());
    }
 
@@ -1415,87 +1690,116 @@ QString RecipeFormatter::buildInstructionTableTxt()
    return ret;
 }
 
-QString RecipeFormatter::buildBrewNotesHtml()
+QString RecipeFormatter::buildBrewNotesHtml( Sections& cached )
 {
    if( rec == 0 )
       return "";
    
    QString bnTable = "";
-   int i, size;
+   QHash<BrewNote*, QString> kept;
+   QStringList notes;
+   int i, size, length = 0;
    QList<BrewNote*> brewNotes = rec->brewNotes();
    size = brewNotes.size();
    
    if ( size < 1 )
+   {
+      cached.brewNotes.clear();
       return bnTable;
+   }
 
+   // Only the new and changed ones get made. The rest we have
    for( i = 0; i < size; ++i )
    {
       BrewNote* note = brewNotes[i];
-      QString section;
-
-      bnTable += QString("<h2>%1 %2</h2>").arg(tr("Brew Date")).arg(note->brewDate_short());
-      
-      // PREBOIL, done two-by-two
-      section = "page_preboil";
-      bnTable += "<table id=\"brewnote\">";
-      bnTable += QString("<caption>%1</caption>").arg(tr("Preboil"));
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("SG"))
-                 .arg(Brewtarget::displayAmount(note->sg(), section, "sg", Units::sp_grav, 3))
-                 .arg(tr("Volume into BK"))
-                 .arg(Brewtarget::displayAmount(note->volumeIntoBK_l(), section, "volumeIntoBK_l", Units::liters));
-
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("Strike Temp"))
-                 .arg(Brewtarget::displayAmount(note->strikeTemp_c(), section, "strikeTemp_c", Units::celsius))
-                 .arg(tr("Final Temp"))
-                 .arg(Brewtarget::displayAmount(note->mashFinTemp_c(), section, "mashFinTemp_c", Units::celsius));
-
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("Eff into BK"))
-                 .arg(Brewtarget::displayAmount(note->calculateEffIntoBK_pct(), 0, 2))
-                 .arg(tr("Projected OG"))
-                 .arg(Brewtarget::displayAmount(note->calculateOg(), section, "projOg", Units::sp_grav, 3));
-      bnTable += "</table>";
-
-      // POSTBOIL
-      section = "page_postboil";
-      bnTable += "<table id=\"brewnote\">";
-      bnTable += QString("<caption>%1</caption>").arg(tr("Postboil"));
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("OG"))
-                 .arg(Brewtarget::displayAmount(note->og(),section, "og", Units::sp_grav, 3))
-                 .arg(tr("Postboil Volume"))
-                 .arg(Brewtarget::displayAmount(note->postBoilVolume_l(), section, "postBoilVolume_l", Units::liters));
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("Volume Into Fermenter"))
-                 .arg(Brewtarget::displayAmount(note->volumeIntoFerm_l(), section, "volumeIntoFerm_l", Units::liters))
-                 .arg(tr("Brewhouse Eff"))
-                 .arg(Brewtarget::displayAmount(note->calculateBrewHouseEff_pct(), 0, 2));
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td></tr>")
-                 .arg(tr("Projected ABV"))
-                 .arg(Brewtarget::displayAmount(note->calculateABV_pct(), 0, 2));
-      bnTable += "</table>";
-
-
-      // POSTFERMENT
-      section = "page_postferment";
-      bnTable += "<table id=\"brewnote\">";
-      bnTable += QString("<caption>%1</caption>").arg(tr("Postferment"));
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("FG"))
-                 .arg(Brewtarget::displayAmount(note->fg(),section,"fg",Units::sp_grav, 3))
-                 .arg(tr("Volume"))
-                 .arg(Brewtarget::displayAmount(note->finalVolume_l(), section, "finalVolume_l", Units::liters));
-
-      bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
-                 .arg(tr("Date"))
-                 .arg(note->fermentDate_short())
-                 .arg(tr("ABV"))
-                 .arg(Brewtarget::displayAmount(note->calculateActualABV_pct(), 0, 2));
-      bnTable += "</table>";
+      QHash<BrewNote*, QString>::const_iterator it = cached.brewNotes.constFind(note);
 
+      if( it != cached.brewNotes.constEnd() )
+         notes.append(it.value());
+      else
+      {
+         watch(note, rec);
+         notes.append(buildBrewNoteHtml(note));
+      }
+      kept.insert(note, notes.last());
+      length += notes.last().size();
    }
+   // Deleted ones fall out here
+   cached.brewNotes = kept;
+
+   bnTable.reserve(length);
+   foreach( QString const& note, notes )
+      bnTable += note;
+
+   return bnTable;
+}
+
+QString RecipeFormatter::buildBrewNoteHtml( BrewNote* note )
+{
+   QString bnTable;
+   QString section;
+
+   bnTable += QString("<h2>%1 %2</h2>").arg(tr("Brew Date")).arg(note->brewDate_short());
+   
+   // PREBOIL, done two-by-two
+   section = "page_preboil";
+   bnTable += "<table id=\"brewnote\">";
+   bnTable += QString("<caption>%1</caption>").arg(tr("Preboil"));
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("SG"))
+              .arg(Brewtarget::displayAmount(note->sg(), section, "sg", Units::sp_grav, 3))
+              .arg(tr("Volume into BK"))
+              .arg(Brewtarget::displayAmount(note->volumeIntoBK_l(), section, "volumeIntoBK_l", Units::liters));
+
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("Strike Temp"))
+              .arg(Brewtarget::displayAmount(note->strikeTemp_c(), section, "strikeTemp_c", Units::celsius))
+              .arg(tr("Final Temp"))
+              .arg(Brewtarget::displayAmount(note->mashFinTemp_c(), section, "mashFinTemp_c", Units::celsius));
+
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("Eff into BK"))
+              .arg(Brewtarget::displayAmount(note->calculateEffIntoBK_pct(), 0, 2))
+              .arg(tr("Projected OG"))
+              .arg(Brewtarget::displayAmount(note->calculateOg(), section, "projOg", Units::sp_grav, 3));
+   bnTable += "</table>";
+
+   // POSTBOIL
+   section = "page_postboil";
+   bnTable += "<table id=\"brewnote\">";
+   bnTable += QString("<caption>%1</caption>").arg(tr("Postboil"));
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("OG"))
+              .arg(Brewtarget::displayAmount(note->og(),section, "og", Units::sp_grav, 3))
+              .arg(tr("Postboil Volume"))
+              .arg(Brewtarget::displayAmount(note->postBoilVolume_l(), section, "postBoilVolume_l", Units::liters));
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("Volume Into Fermenter"))
+              .arg(Brewtarget::displayAmount(note->volumeIntoFerm_l(), section, "volumeIntoFerm_l", Units::liters))
+              .arg(tr("Brewhouse Eff"))
+              .arg(Brewtarget::displayAmount(note->calculateBrewHouseEff_pct(), 0, 2));
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2%</td></tr>")
+              .arg(tr("Projected ABV"))
+              .arg(Brewtarget::displayAmount(note->calculateABV_pct(), 0, 2));
+   bnTable += "</table>";
+
+
+   // POSTFERMENT
+   section = "page_postferment";
+   bnTable += "<table id=\"brewnote\">";
+   bnTable += QString("<caption>%1</caption>").arg(tr("Postferment"));
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("FG"))
+              .arg(Brewtarget::displayAmount(note->fg(),section,"fg",Units::sp_grav, 3))
+              .arg(tr("Volume"))
+              .arg(Brewtarget::displayAmount(note->finalVolume_l(), section, "finalVolume_l", Units::liters));
+
+   bnTable += QString("<tr><td class=\"left\">%1</td><td class=\"value\">%2</td><td class=\"right\">%3</td><td class=\"value\">%4</td></tr>")
+              .arg(tr("Date"))
+              .arg(note->fermentDate_short())
+              .arg(tr("ABV"))
+              .arg(Brewtarget::displayAmount(note->calculateActualABV_pct(), 0, 2));
+   bnTable += "</table>";
 
    return bnTable;
 }
@@ -1506,7 +1810,7 @@ QString RecipeFormatter::getLabelToolTip() {
 
    // Do the style sheet first
    header = "<html><head><style type=\"text/css\">";
-   header += getCSS(":/css/tooltip.css");
+   header += toolTipCSS();
    header += "</style></head>";
 
    body   = "<body>";
@@ -31,6 +31,9 @@ class RecipeFormatter;
 #include <QTextBrowser>
 #include <QDialog>
 #include <QFile>
+#include <QHash>
+#include <QAtomicInt>
+#include <QVector>
 #include "recipe.h"
 
 /*!
@@ -56,16 +59,64 @@ public:
    QString getHTMLFormat();
    //! Get a whole mess of html views
    QString getHTMLFormat( QList<Recipe*> recipes );
+   /*!
+    * \brief Makes every formatter forget the html it made, since the units,
+    * scales or language it was made in have changed.
+    */
+   static void invalidateAll();
    //! Get a BBCode view. Why is this here?
    QString getBBCodeFormat();
-   //! Generate a tooltip for a recipe
-   QString getToolTip(Recipe* rec);
-   QString getToolTip(Style* style);
-   QString getToolTip(Equipment* kit);
-   QString getToolTip(Fermentable* ferm);
-   QString getToolTip(Hop* hop);
-   QString getToolTip(Misc* misc);
-   QString getToolTip(Yeast* yeast);
+   //! \brief What goes into a recipe's tooltip, without the recipe
+   struct RecipeToolTip
+   {
+      RecipeToolTip() : hasStyle(false), og(0.0), fg(0.0), color_srm(0.0), IBU(0.0) {}
+
+      bool hasStyle;
+      QString style;
+      QString categoryNumber;
+      QString styleLetter;
+      double og;
+      double fg;
+      double color_srm;
+      double IBU;
+   };
+   //! \brief What goes into a style's, equipment's or ingredient's tooltip,
+   //  without the element
+   struct ElementToolTip
+   {
+      ElementToolTip() : table(Brewtarget::NOTABLE) {}
+
+      Brewtarget::DBTable table;
+      //! The columns the tooltip shows, all read with one query
+      QVector<QVariant> row;
+   };
+
+   /*!
+    * Generate a tooltip. These don't need a RecipeFormatter. The ones that
+    * take a RecipeToolTip or an ElementToolTip don't touch the database
+    * either, so they can be made on another thread.
+    */
+   static QString getToolTip(Recipe* rec);
+   static QString getToolTip(RecipeToolTip const& data);
+   static QString getToolTip(ElementToolTip const& data);
+   static QString getToolTip(Style* style);
+   static QString getToolTip(Equipment* kit);
+   static QString getToolTip(Fermentable* ferm);
+   static QString getToolTip(Hop* hop);
+   static QString getToolTip(Misc* misc);
+   static QString getToolTip(Yeast* yeast);
+   /*!
+    * \brief Fills in the numbers of \b rec's tooltip, but not the style.
+    * \returns false if \b rec hasn't worked them out yet
+    */
+   static bool recipeToolTipNumbers(Recipe* rec, RecipeToolTip& data);
+   //! \brief Fills in the style of \b rec's tooltip. False if the read failed
+   static bool recipeToolTipStyle(Recipe* rec, RecipeToolTip& data);
+   /*!
+    * \brief Reads what \b elem's tooltip shows. False if it's not a style,
+    * equipment or ingredient, or the read failed
+    */
+   static bool elementToolTipData(BeerXMLElement* elem, ElementToolTip& data);
    QString getLabelToolTip();
    //! Get the maximum number of characters in a list of strings.
    unsigned int getMaxLength( QStringList* list );
@@ -84,8 +135,39 @@ public slots:
    void toTextClipboard();
    
 private:
+   /*!
+    * The parts of the html view, in the order they go. Each one is kept
+    * until something it shows changes, so a preview of a recipe that got a
+    * new hop only makes the hop table again.
+    */
+   enum Section { STATS, FERMENTABLES, HOPS, MISCS, YEASTS, MASH, NOTES, INSTRUCTIONS, BREWNOTES, NUMSECTIONS };
+
+   //! \brief What we have made of one recipe so far
+   struct Sections
+   {
+      Sections() : dirty((1 << NUMSECTIONS) - 1), generation(0) {}
+
+      QString html[NUMSECTIONS];
+      //! One bit per Section that has to be made again
+      int dirty;
+      int generation;
+      //! Brew notes pile up by the hundred, so they are kept one by one
+      QHash<BrewNote*, QString> brewNotes;
+   };
+
    QString getTextSeparator();
 
+   //! \brief The sections of \c rec, with the ones that changed made again
+   Sections& sections();
+   //! \brief How long \b cached is, all together
+   static int length( Sections const& cached );
+   //! \brief Makes \b section of \c rec, and watches what it was made from
+   QString buildSection( int section, Sections& cached );
+   //! \brief Tells us when \b elem changes, since \b recipe shows it
+   void watch( BeerXMLElement* elem, Recipe* recipe );
+   //! \brief Which section shows elements like \b elem
+   static int sectionOf( BeerXMLElement* elem );
+
    QString buildHTMLHeader();
    QString buildStatTableHtml();
    QString buildStatTableTxt();
@@ -102,10 +184,13 @@ private:
    QString buildNotesHtml();
    QString buildInstructionTableHtml();
    QString buildInstructionTableTxt();
-   QString buildBrewNotesHtml();
+   QString buildBrewNotesHtml( Sections& cached );
+   QString buildBrewNoteHtml( BrewNote* note );
    QString buildBrewNotesTxt();
    QString buildHTMLFooter();
-   QString getCSS(QString resourceName);
+   static QString getCSS(QString resourceName);
+   //! \brief tooltip.css, read the once
+   static QString toolTipCSS();
 
    QList<Hop*> sortHopsByTime(Recipe* rec);
    QList<Fermentable*> sortFermentablesByWeight(Recipe* rec);
@@ -117,8 +202,21 @@ private:
    QTextBrowser* doc;
    QDialog* docDialog;
 
+   QHash<Recipe*, Sections> _sections;
+   //! Every recipe whose sections show an element
+   QMultiHash<BeerXMLElement*, Recipe*> _shownIn;
+
+   static QAtomicInt generation;
+
 private slots:
    bool loadComplete(bool ok);
+   //! A recipe we have sections of has changed
+   void recipeChanged( QMetaProperty prop, QVariant val );
+   //! Something a recipe shows has changed
+   void elementChanged();
+   void brewNoteAdded( BrewNote* note );
+   void forgetRecipe( QObject* recipe );
+   void forgetElement( QObject* elem );
 };
 
 #endif /*RECIPE_FORMATTER_H*/
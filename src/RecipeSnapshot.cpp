@@ -0,0 +1,171 @@
+/*
+ * RecipeSnapshot.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RecipeSnapshot.h"
+#include "brewtarget.h"
+#include "recipe.h"
+#include "equipment.h"
+#include "mash.h"
+#include "mashstep.h"
+#include "yeast.h"
+
+RecipeSnapshot::RecipeSnapshot()
+   : batchSize_l(0.0),
+     boilSize_l(0.0),
+     efficiency_pct(0.0),
+     hasEquipment(false),
+     hasMash(false),
+     firstWortHopAdjust(1.1),
+     mashHopAdjust(0.0),
+     ibuFormula(Brewtarget::ibuFormula),
+     colorFormula(Brewtarget::colorFormula)
+{
+   equipment.boilTime_min = 0.0;
+   equipment.evapRate_lHr = 0.0;
+   equipment.topUpWater_l = 0.0;
+   equipment.topUpKettle_l = 0.0;
+   equipment.trubChillerLoss_l = 0.0;
+   equipment.lauterDeadspace_l = 0.0;
+   equipment.grainAbsorption_LKg = 0.0;
+   equipment.hopUtilization_pct = 100.0;
+}
+
+RecipeSnapshot RecipeSnapshot::of( Recipe* rec, int parts )
+{
+   RecipeSnapshot ret;
+
+   if( rec == 0 )
+      return ret;
+
+   if( parts & Basics )
+   {
+      ret.batchSize_l    = rec->batchSize_l();
+      ret.boilSize_l     = rec->boilSize_l();
+      ret.efficiency_pct = rec->efficiency_pct();
+   }
+
+   if( parts & Equip )
+   {
+      ::Equipment* e = rec->equipment();
+      ret.hasEquipment = (e != 0);
+      if( e )
+         ret.equipment = of(e);
+   }
+
+   if( parts & MashSteps )
+   {
+      Mash* m = rec->mash();
+      ret.hasMash = (m != 0);
+      if( m )
+      {
+         foreach( ::MashStep* step, m->mashSteps() )
+         {
+            MashStep s;
+            s.infusion = step->isInfusion();
+            s.infuseAmount_l = s.infusion ? step->infuseAmount_l() : 0.0;
+            ret.mashSteps.append(s);
+         }
+      }
+   }
+
+   if( parts & Fermentables )
+   {
+      QList< ::Fermentable*> ferms = rec->fermentables();
+      ret.fermentables.reserve(ferms.size());
+      foreach( ::Fermentable* ferm, ferms )
+      {
+         Fermentable f;
+         f.type             = ferm->type();
+         f.amount_kg        = ferm->amount_kg();
+         f.yield_pct        = ferm->yield_pct();
+         f.moisture_pct     = ferm->moisture_pct();
+         f.color_srm        = ferm->color_srm();
+         f.ibuGalPerLb      = ferm->ibuGalPerLb();
+         f.isMashed         = ferm->isMashed();
+         f.addAfterBoil     = ferm->addAfterBoil();
+         f.fermentableSugar = rec->isFermentableSugar(ferm);
+         ret.fermentables.append(f);
+      }
+   }
+
+   if( parts & Hops )
+   {
+      QList< ::Hop*> hops = rec->hops();
+      ret.hops.reserve(hops.size());
+      foreach( ::Hop* hop, hops )
+         ret.hops.append( of(hop) );
+
+      ret.readHopAdjustments();
+   }
+
+   if( parts & Yeasts )
+   {
+      foreach( Yeast* yeast, rec->yeasts() )
+         ret.yeastAttenuations_pct.append( yeast->attenuation_pct() );
+   }
+
+   return ret;
+}
+
+// Options come back as whatever they went in as. Only parse them if that
+// was text.
+static double optionToDouble( QString const& name, double def )
+{
+   bool ok = false;
+   QVariant value = Brewtarget::option(name, def);
+   double ret = Brewtarget::variantToDouble(value, &ok);
+
+   if( !ok )
+      Brewtarget::logW( QString("RecipeSnapshot::readHopAdjustments() could not convert %1 to double").arg(value.toString()) );
+   return ret;
+}
+
+void RecipeSnapshot::readHopAdjustments()
+{
+   firstWortHopAdjust = optionToDouble("firstWortHopAdjustment", 1.1);
+   mashHopAdjust = optionToDouble("mashHopAdjustment", 0.0);
+}
+
+RecipeSnapshot::Hop RecipeSnapshot::of( ::Hop const* hop )
+{
+   Hop ret;
+
+   ret.alpha_pct = hop->alpha_pct();
+   ret.amount_kg = hop->amount_kg();
+   ret.time_min  = hop->time_min();
+   ret.use       = hop->use();
+   ret.form      = hop->form();
+
+   return ret;
+}
+
+RecipeSnapshot::Equipment RecipeSnapshot::of( ::Equipment* equip )
+{
+   Equipment ret;
+
+   ret.boilTime_min        = equip->boilTime_min();
+   ret.evapRate_lHr        = equip->evapRate_lHr();
+   ret.topUpWater_l        = equip->topUpWater_l();
+   ret.topUpKettle_l       = equip->topUpKettle_l();
+   ret.trubChillerLoss_l   = equip->trubChillerLoss_l();
+   ret.lauterDeadspace_l   = equip->lauterDeadspace_l();
+   ret.grainAbsorption_LKg = equip->grainAbsorption_LKg();
+   ret.hopUtilization_pct  = equip->hopUtilization_pct();
+
+   return ret;
+}
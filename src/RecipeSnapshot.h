@@ -0,0 +1,145 @@
+/*
+ * RecipeSnapshot.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RECIPESNAPSHOT_H
+#define _RECIPESNAPSHOT_H
+
+#include <QVector>
+#include "brewtarget.h"
+#include "equipment.h"
+#include "fermentable.h"
+#include "hop.h"
+
+class Recipe;
+
+/*!
+ * \class RecipeSnapshot
+ *
+ * \brief Everything RecipeCalculator needs to know about a recipe, copied
+ * out of the database in one go.
+ *
+ * Once taken, a snapshot is plain data: no QObjects, no SQL, no signals. It
+ * can be handed to another thread, kept around, or tweaked to ask "what if".
+ * Only of() has to run on a thread that may talk to the database.
+ */
+class RecipeSnapshot
+{
+public:
+   //! \brief Which bits of() should bother reading
+   enum Part
+   {
+      Basics       = 0x01,  //!< batch size, boil size, efficiency
+      Equip        = 0x02,
+      MashSteps    = 0x04,
+      Fermentables = 0x08,
+      Hops         = 0x10,
+      Yeasts       = 0x20,
+      All          = 0x3F
+   };
+
+   struct Equipment
+   {
+      double boilTime_min;
+      double evapRate_lHr;
+      double topUpWater_l;
+      double topUpKettle_l;
+      double trubChillerLoss_l;
+      double lauterDeadspace_l;
+      double grainAbsorption_LKg;
+      double hopUtilization_pct;
+
+      double wortEndOfBoil_l( double kettleWort_l ) const
+      {
+         return ::Equipment::wortEndOfBoil_l( kettleWort_l, boilTime_min, evapRate_lHr );
+      }
+   };
+
+   struct Fermentable
+   {
+      ::Fermentable::Type type;
+      double amount_kg;
+      double yield_pct;
+      double moisture_pct;
+      double color_srm;
+      double ibuGalPerLb;
+      bool isMashed;
+      bool addAfterBoil;
+      //! False for lactose, which the yeast won't touch
+      bool fermentableSugar;
+
+      bool isSugar() const { return type == ::Fermentable::Sugar; }
+      bool isExtract() const { return type == ::Fermentable::Extract || type == ::Fermentable::Dry_Extract; }
+      double equivSucrose_kg() const
+      {
+         return ::Fermentable::equivSucrose_kg( type, amount_kg, yield_pct, moisture_pct, isMashed );
+      }
+   };
+
+   struct Hop
+   {
+      double alpha_pct;
+      double amount_kg;
+      double time_min;
+      ::Hop::Use use;
+      ::Hop::Form form;
+   };
+
+   struct MashStep
+   {
+      bool infusion;
+      double infuseAmount_l;
+   };
+
+   RecipeSnapshot();
+
+   /*!
+    * \brief Reads \c parts of \c rec. What isn't asked for is left empty, so
+    * only use it with the RecipeCalculator bits that don't need it.
+    */
+   static RecipeSnapshot of( Recipe* rec, int parts = All );
+   static Hop of( ::Hop const* hop );
+   static Equipment of( ::Equipment* equip );
+   //! Fills in the hop adjustments from the options. of() does it with Hops
+   void readHopAdjustments();
+
+   double batchSize_l;
+   double boilSize_l;
+   double efficiency_pct;
+
+   bool hasEquipment;
+   Equipment equipment;
+   //! No mash and a mash without steps add the same amount of water
+   bool hasMash;
+   QVector<MashStep> mashSteps;
+
+   QVector<Fermentable> fermentables;
+   QVector<Hop> hops;
+   //! Only the attenuation matters, so that's all there is
+   QVector<double> yeastAttenuations_pct;
+
+   //! The "firstWortHopAdjustment" and "mashHopAdjustment" options
+   double firstWortHopAdjust;
+   double mashHopAdjust;
+
+   //! The formulas picked in the options when the snapshot was made. Copied
+   //  here, since the options dialog changes them on the main thread
+   Brewtarget::IbuType ibuFormula;
+   Brewtarget::ColorType colorFormula;
+};
+
+#endif /* _RECIPESNAPSHOT_H */
@@ -0,0 +1,270 @@
+/*
+ * RecipeSweep.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RecipeSweep.h"
+#include "RecipeCalculator.h"
+#include "recipe.h"
+#include "equipment.h"
+#include <QObject>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+// A few hundred microseconds of work per task, so the pool isn't spending
+// more time handing out tasks than doing them
+static const int variantsPerTask = 64;
+
+class RecipeSweep::Task : public QRunnable
+{
+public:
+   Task( RecipeSweep const* sweep, int begin, int end, Result* out )
+      : _sweep(sweep), _begin(begin), _end(end), _out(out)
+   {
+      setAutoDelete(true);
+   }
+
+   void run()
+   {
+      // Every task has its own rows, so nobody needs a lock
+      for( int i = _begin; i < _end; ++i )
+         _sweep->evaluate(i, _out[i]);
+   }
+
+private:
+   RecipeSweep const* _sweep;
+   int _begin;
+   int _end;
+   Result* _out;
+};
+
+RecipeSweep::RecipeSweep( Recipe* rec, Mode mode )
+   : _mode(mode),
+     _base( RecipeSnapshot::of(rec) )
+{
+   Profile own;
+
+   own.hasEquipment = _base.hasEquipment;
+   own.equipment = _base.equipment;
+   own.batchSize_l = _base.batchSize_l;
+   own.boilSize_l = _base.boilSize_l;
+   if( rec && rec->equipment() )
+      own.name = rec->equipment()->name();
+
+   _own.append(own);
+}
+
+void RecipeSweep::setBatchSizes_l( QList<double> const& sizes )
+{
+   _batchSizes_l = sizes;
+}
+
+void RecipeSweep::setEfficiencies_pct( QList<double> const& effs )
+{
+   _efficiencies_pct = effs;
+}
+
+void RecipeSweep::addEquipment( Equipment* equip )
+{
+   if( equip == 0 )
+      return;
+
+   Profile p;
+   p.name = equip->name();
+   p.hasEquipment = true;
+   p.equipment = RecipeSnapshot::of(equip);
+   p.batchSize_l = equip->batchSize_l();
+   p.boilSize_l = equip->boilSize_l();
+
+   _profiles.append(p);
+}
+
+QList<RecipeSweep::Profile> const& RecipeSweep::profiles() const
+{
+   return _profiles.isEmpty() ? _own : _profiles;
+}
+
+int RecipeSweep::size() const
+{
+   return profiles().size() * qMax(1, _batchSizes_l.size()) * qMax(1, _efficiencies_pct.size());
+}
+
+QVector<RecipeSweep::Result> RecipeSweep::run( int maxThreads ) const
+{
+   int n = size();
+   QVector<Result> ret(n);
+
+   if( maxThreads <= 0 )
+      maxThreads = QThread::idealThreadCount();
+
+   // Not worth waking anybody up for
+   if( maxThreads <= 1 || n <= variantsPerTask )
+   {
+      for( int i = 0; i < n; ++i )
+         evaluate(i, ret[i]);
+      return ret;
+   }
+
+   QThreadPool pool;
+   Result* out = ret.data();
+
+   pool.setMaxThreadCount(maxThreads);
+   for( int begin = 0; begin < n; begin += variantsPerTask )
+      pool.start( new Task(this, begin, qMin(n, begin + variantsPerTask), out) );
+   pool.waitForDone();
+
+   return ret;
+}
+
+void RecipeSweep::evaluate( int i, Result& ret ) const
+{
+   int nBatch = qMax(1, _batchSizes_l.size());
+   int nEff = qMax(1, _efficiencies_pct.size());
+   int e = i / (nBatch * nEff);
+   int b = (i / nEff) % nBatch;
+   int f = i % nEff;
+
+   Profile const& p = profiles().at(e);
+   double batchSize_l = _batchSizes_l.isEmpty() ? p.batchSize_l : _batchSizes_l.at(b);
+   double efficiency_pct = _efficiencies_pct.isEmpty() ? _base.efficiency_pct : _efficiencies_pct.at(f);
+   // Same ratios ScaleRecipeTool::scale() goes by
+   double volRatio = (_base.batchSize_l > 0.0) ? batchSize_l / _base.batchSize_l : 1.0;
+   double effRatio = (efficiency_pct > 0.0) ? _base.efficiency_pct / efficiency_pct : 1.0;
+   int j;
+
+   RecipeSnapshot snap(_base);
+   snap.batchSize_l = batchSize_l;
+   snap.efficiency_pct = efficiency_pct;
+   // Keep the equipment's idea of how much boils off per batch
+   if( p.batchSize_l > 0.0 )
+      snap.boilSize_l = p.boilSize_l * (batchSize_l / p.batchSize_l);
+   else
+      snap.boilSize_l = _base.boilSize_l * volRatio;
+   snap.hasEquipment = p.hasEquipment;
+   snap.equipment = p.equipment;
+
+   for( j = 0; j < snap.mashSteps.size(); ++j )
+      snap.mashSteps[j].infuseAmount_l *= volRatio;
+
+   if( _mode == ScaleIngredients )
+   {
+      for( j = 0; j < snap.fermentables.size(); ++j )
+      {
+         RecipeSnapshot::Fermentable& ferm = snap.fermentables[j];
+         if( !ferm.isSugar() && !ferm.isExtract() )
+            ferm.amount_kg = ferm.amount_kg * effRatio * volRatio;
+         else
+            ferm.amount_kg = ferm.amount_kg * volRatio;
+      }
+
+      for( j = 0; j < snap.hops.size(); ++j )
+         snap.hops[j].amount_kg = snap.hops[j].amount_kg * volRatio;
+   }
+
+   RecipeCalculator::Results calcs = RecipeCalculator::calculate(snap);
+
+   ret.equipment = _profiles.isEmpty() ? -1 : e;
+   ret.batchSize_l = batchSize_l;
+   ret.efficiency_pct = efficiency_pct;
+   ret.grains_kg = calcs.grains_kg;
+   ret.og = calcs.gravities.og;
+   ret.fg = calcs.gravities.fg;
+   ret.IBU = calcs.IBU;
+   ret.color_srm = calcs.color_srm;
+   ret.ABV_pct = calcs.ABV_pct;
+}
+
+QStringList RecipeSweep::equipmentNames() const
+{
+   QStringList ret;
+
+   foreach( Profile const& p, _profiles )
+      ret.append(p.name);
+
+   return ret;
+}
+
+QStringList RecipeSweep::columnNames()
+{
+   return QStringList()
+      << QObject::tr("Equipment")
+      << QObject::tr("Batch Size (L)")
+      << QObject::tr("Efficiency (%)")
+      << QObject::tr("Grains (kg)")
+      << QObject::tr("OG")
+      << QObject::tr("FG")
+      << QObject::tr("IBU")
+      << QObject::tr("Color (SRM)")
+      << QObject::tr("ABV (%)");
+}
+
+QVariant RecipeSweep::cell( Result const& row, int column ) const
+{
+   switch( column )
+   {
+      case EQUIPCOL:
+         return (row.equipment < 0) ? _own.first().name : _profiles.at(row.equipment).name;
+      case BATCHSIZECOL:
+         return row.batchSize_l;
+      case EFFICIENCYCOL:
+         return row.efficiency_pct;
+      case GRAINSCOL:
+         return row.grains_kg;
+      case OGCOL:
+         return row.og;
+      case FGCOL:
+         return row.fg;
+      case IBUCOL:
+         return row.IBU;
+      case COLORCOL:
+         return row.color_srm;
+      case ABVCOL:
+         return row.ABV_pct;
+      default:
+         return QVariant();
+   }
+}
+
+int RecipeSweep::precision( int column )
+{
+   // Nobody weighs grain to the microgram
+   static const int decimals[NUMCOLS] = { 0, 2, 1, 3, 3, 3, 1, 1, 1 };
+
+   return (column >= 0 && column < NUMCOLS) ? decimals[column] : 0;
+}
+
+QString RecipeSweep::toCsv( QVector<Result> const& rows ) const
+{
+   QString ret;
+   QStringList fields;
+   int i;
+
+   ret.reserve( (rows.size() + 1) * 64 );
+   ret += columnNames().join(",") + "\n";
+
+   foreach( Result const& row, rows )
+   {
+      fields.clear();
+      // The only text in here, and it is whatever the user typed
+      fields << QString("\"%1\"").arg( cell(row, EQUIPCOL).toString().replace("\"", "\"\"") );
+      for( i = BATCHSIZECOL; i < NUMCOLS; ++i )
+         fields << QString::number( cell(row, i).toDouble(), 'f', precision(i) );
+      ret += fields.join(",") + "\n";
+   }
+
+   return ret;
+}
@@ -0,0 +1,147 @@
+/*
+ * RecipeSweep.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RECIPESWEEP_H
+#define _RECIPESWEEP_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include "RecipeSnapshot.h"
+
+class Recipe;
+class Equipment;
+
+/*!
+ * \class RecipeSweep
+ *
+ * \brief Asks "what if" of a recipe for every batch size, efficiency and
+ * equipment in a grid, without touching the recipe.
+ *
+ * The recipe and the equipment are snapshotted when they are handed over, so
+ * the constructor and addEquipment() have to run where the database is
+ * happy. After that, run() works on copies of the snapshot, spread over a
+ * thread pool, and the database never hears about it.
+ *
+ * Each variant is scaled the way ScaleRecipeTool would scale it: hops and
+ * fermentables follow the batch size, and grains also make up for the
+ * efficiency. With \c KeepIngredients, the amounts stay put and you see what
+ * the new size and efficiency do to the beer instead. Mash infusions are
+ * scaled with the batch, as if the mash wizard had been re-run.
+ */
+class RecipeSweep
+{
+public:
+   enum Mode
+   {
+      ScaleIngredients, //!< Same beer, more or less of it
+      KeepIngredients   //!< Same ingredients, different beer
+   };
+
+   //! \brief One cell of the grid, and what comes out of it
+   struct Result
+   {
+      //! Index into equipmentNames(), or -1 for the recipe's own equipment
+      int equipment;
+      double batchSize_l;
+      double efficiency_pct;
+
+      double grains_kg;
+      double og;
+      double fg;
+      double IBU;
+      double color_srm;
+      double ABV_pct;
+   };
+
+   enum Column
+   {
+      EQUIPCOL,
+      BATCHSIZECOL,
+      EFFICIENCYCOL,
+      GRAINSCOL,
+      OGCOL,
+      FGCOL,
+      IBUCOL,
+      COLORCOL,
+      ABVCOL,
+      NUMCOLS
+   };
+
+   //! \brief Snapshots \c rec. Without any other setup, run() just gives back the recipe
+   RecipeSweep( Recipe* rec, Mode mode = ScaleIngredients );
+
+   //! If none are given, each equipment brings its own batch size
+   void setBatchSizes_l( QList<double> const& sizes );
+   //! If none are given, the recipe's efficiency it is
+   void setEfficiencies_pct( QList<double> const& effs );
+   //! Snapshots \c equip. If none are added, the recipe's own is used
+   void addEquipment( Equipment* equip );
+
+   //! How many rows run() will give back
+   int size() const;
+
+   /*!
+    * \brief Works out every variant, on up to \c maxThreads threads (0 means
+    * as many as the machine likes). Rows come back equipment first, then
+    * batch size, then efficiency.
+    */
+   QVector<Result> run( int maxThreads = 0 ) const;
+
+   //! Names of what was given to addEquipment(), in order
+   QStringList equipmentNames() const;
+
+   //! \brief Column headers for a table of results
+   static QStringList columnNames();
+   //! \brief What goes in \c column for \c row, in SI units
+   QVariant cell( Result const& row, int column ) const;
+   //! \brief Decimals worth showing in \c column
+   static int precision( int column );
+   //! \brief The whole table as comma separated values, header first
+   QString toCsv( QVector<Result> const& rows ) const;
+
+private:
+   //! \brief An equipment, as far as the sweep is concerned
+   struct Profile
+   {
+      QString name;
+      bool hasEquipment;
+      RecipeSnapshot::Equipment equipment;
+      double batchSize_l;
+      double boilSize_l;
+   };
+
+   class Task;
+
+   //! Works out row \c i of the grid into \c ret
+   void evaluate( int i, Result& ret ) const;
+   //! The list of profiles to go through, whether or not any were added
+   QList<Profile> const& profiles() const;
+
+   Mode _mode;
+   RecipeSnapshot _base;
+   //! Just the recipe's own equipment, for when nothing was added
+   QList<Profile> _own;
+   QList<Profile> _profiles;
+   QList<double> _batchSizes_l;
+   QList<double> _efficiencies_pct;
+};
+
+#endif /* _RECIPESWEEP_H */
@@ -0,0 +1,91 @@
+/*
+ * RecipeSweepTableModel.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RecipeSweepTableModel.h"
+#include "BtLocale.h"
+
+RecipeSweepTableModel::RecipeSweepTableModel( QObject* parent )
+   : QAbstractTableModel(parent)
+{
+}
+
+RecipeSweepTableModel::~RecipeSweepTableModel()
+{
+}
+
+void RecipeSweepTableModel::setResults( RecipeSweep const& sweep, QVector<RecipeSweep::Result> const& rows )
+{
+   beginResetModel();
+   _sweep.reset( new RecipeSweep(sweep) );
+   _rows = rows;
+   endResetModel();
+}
+
+void RecipeSweepTableModel::clear()
+{
+   beginResetModel();
+   _sweep.reset();
+   _rows.clear();
+   endResetModel();
+}
+
+QVector<RecipeSweep::Result> const& RecipeSweepTableModel::results() const
+{
+   return _rows;
+}
+
+QString RecipeSweepTableModel::toCsv() const
+{
+   return _sweep ? _sweep->toCsv(_rows) : QString();
+}
+
+int RecipeSweepTableModel::rowCount( const QModelIndex& parent ) const
+{
+   return parent.isValid() ? 0 : _rows.size();
+}
+
+int RecipeSweepTableModel::columnCount( const QModelIndex& parent ) const
+{
+   return parent.isValid() ? 0 : static_cast<int>(RecipeSweep::NUMCOLS);
+}
+
+QVariant RecipeSweepTableModel::data( const QModelIndex& index, int role ) const
+{
+   if( ! _sweep || ! index.isValid() || index.row() >= _rows.size() )
+      return QVariant();
+
+   int column = index.column();
+
+   if( role == Qt::TextAlignmentRole )
+      return column == RecipeSweep::EQUIPCOL ? int(Qt::AlignLeft | Qt::AlignVCenter) : int(Qt::AlignRight | Qt::AlignVCenter);
+   if( role != Qt::DisplayRole )
+      return QVariant();
+
+   QVariant cell = _sweep->cell( _rows.at(index.row()), column );
+   if( column == RecipeSweep::EQUIPCOL )
+      return cell;
+   return BtLocale::toString( cell.toDouble(), 'f', RecipeSweep::precision(column) );
+}
+
+QVariant RecipeSweepTableModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+   if( orientation != Qt::Horizontal || role != Qt::DisplayRole )
+      return QVariant();
+
+   return RecipeSweep::columnNames().value(section);
+}
@@ -0,0 +1,67 @@
+/*
+ * RecipeSweepTableModel.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RECIPESWEEPTABLEMODEL_H
+#define _RECIPESWEEPTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QModelIndex>
+#include <QScopedPointer>
+#include <QVariant>
+#include <QVector>
+#include "RecipeSweep.h"
+
+/*!
+ * \class RecipeSweepTableModel
+ *
+ * \brief Read-only table of what a RecipeSweep came up with, one row per
+ * variant and one column per RecipeSweep::Column, ready for a QTableView.
+ */
+class RecipeSweepTableModel : public QAbstractTableModel
+{
+   Q_OBJECT
+
+public:
+   RecipeSweepTableModel( QObject* parent = 0 );
+   virtual ~RecipeSweepTableModel();
+
+   //! \brief Shows \c rows, as \c sweep ran them. Keeps its own copy of \c sweep
+   void setResults( RecipeSweep const& sweep, QVector<RecipeSweep::Result> const& rows );
+   //! \brief Empties the table
+   void clear();
+   //! \brief What is being shown
+   QVector<RecipeSweep::Result> const& results() const;
+   //! \brief The table as comma separated values, for exporting. "" if empty
+   QString toCsv() const;
+
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
+
+private:
+   //! Null until setResults()
+   QScopedPointer<RecipeSweep> _sweep;
+   QVector<RecipeSweep::Result> _rows;
+};
+
+#endif /* _RECIPESWEEPTABLEMODEL_H */
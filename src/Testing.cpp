@@ -26,6 +26,33 @@
 #include "fermentable.h"
 #include "mash.h"
 #include "mashstep.h"
+#include "brewnote.h"
+#include "instruction.h"
+#include "misc.h"
+#include "style.h"
+#include "water.h"
+#include "yeast.h"
+#include "PropertyIds.h"
+#include "RecipeCalculator.h"
+#include "RecipeSweep.h"
+#include "RecipeSweepTableModel.h"
+#include "LibraryRecalculator.h"
+#include "BtLocale.h"
+#include "ToolTipCache.h"
+#include "RecipeFormatter.h"
+#include "PrintPipeline.h"
+#include "IbuMethods.h"
+#include "ColorMethods.h"
+#include "Algorithms.h"
+#include "Trace.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPrinter>
 
 QTEST_MAIN(Testing)
 
@@ -80,6 +107,32 @@ void Testing::initTestCase()
    twoRow->setIsMashed(true);
 }
 
+Recipe* Testing::newSimpleRecipe(QString const& name)
+{
+   Database& db = Database::instance();
+   Recipe* rec = db.newRecipe();
+
+   rec->setName(name);
+   rec->setBatchSize_l(equipFiveGalNoLoss->batchSize_l());
+   rec->setBoilSize_l(equipFiveGalNoLoss->boilSize_l());
+   db.addToRecipe(rec, equipFiveGalNoLoss);
+   db.addToRecipe(rec, twoRow);
+   db.addToRecipe(rec, cascade_4pct);
+
+   return rec;
+}
+
+Recipe* Testing::newBrewNotesRecipe(QString const& name, int notes)
+{
+   Database& db = Database::instance();
+   Recipe* rec = newSimpleRecipe(name);
+
+   for( int i = 0; i < notes; ++i )
+      db.newBrewNote(rec, false)->setSg(1.040 + i/10000.0);
+
+   return rec;
+}
+
 void Testing::recipeCalcTest_allGrain()
 {
    double const grain_kg = 5.0;
@@ -234,6 +287,838 @@ void Testing::postBoilLossOgTest()
    QVERIFY2( fuzzyComp(recLoss->og(), recNoLoss->og(), 0.002), "OG of recipe with post-boil loss is different from no-loss recipe" );
 }
 
+void Testing::recipeCalculatorTest()
+{
+   Database& db = Database::instance();
+   Recipe* rec = db.newRecipe();
+   rec->setName("recipeCalculatorTest");
+   rec->setBatchSize_l(equipFiveGalNoLoss->batchSize_l());
+   rec->setBoilSize_l(equipFiveGalNoLoss->boilSize_l());
+
+   Mash* mash = db.newMash();
+   MashStep* step = db.newMashStep(mash);
+   step->setType(MashStep::Infusion);
+   step->setInfuseAmount_l(25.0);
+
+   // Something of every kind the calculations treat differently
+   Fermentable* lactose = db.newFermentable();
+   lactose->setName("Milk Sugar (Lactose)");
+   lactose->setType(Fermentable::Sugar);
+   lactose->setYield_pct(76.0);
+   lactose->setAmount_kg(0.25);
+   lactose->setAddAfterBoil(true);
+   Fermentable* crystal = db.newFermentable();
+   crystal->setType(Fermentable::Grain);
+   crystal->setYield_pct(74.0);
+   crystal->setColor_srm(60.0);
+   crystal->setMoisture_pct(4.0);
+   crystal->setIsMashed(false);
+   crystal->setAmount_kg(0.3);
+   Hop* fwh = db.newHop();
+   fwh->setAlpha_pct(7.5);
+   fwh->setAmount_kg(0.02);
+   fwh->setUse(Hop::First_Wort);
+   fwh->setForm(Hop::Pellet);
+   Yeast* yeast = db.newYeast();
+   yeast->setAttenuation_pct(73.0);
+
+   db.addToRecipe(rec, equipFiveGalNoLoss);
+   db.addToRecipe(rec, twoRow);
+   db.addToRecipe(rec, crystal);
+   db.addToRecipe(rec, lactose);
+   db.addToRecipe(rec, cascade_4pct);
+   db.addToRecipe(rec, fwh);
+   db.addToRecipe(rec, yeast);
+   db.addToRecipe(rec, mash);
+
+   // Size the recipe's own copies of the shared fixtures, so the other tests
+   // still get them untouched
+   foreach( Fermentable* ferm, rec->fermentables() )
+   {
+      if( ferm->name() == twoRow->name() )
+         ferm->setAmount_kg(4.5);
+   }
+   foreach( Hop* hop, rec->hops() )
+   {
+      if( hop->name() == cascade_4pct->name() )
+         hop->setAmount_kg(0.03);
+   }
+
+   // Goes through recalcAll()
+   rec->setEfficiency_pct(72.0);
+
+   RecipeCalculator::Results calcs = RecipeCalculator::calculate( RecipeSnapshot::of(rec) );
+
+   // What the recipe.cpp from before RecipeCalculator came up with for this
+   // recipe, bit for bit
+   QVERIFY( rec->grainsInMash_kg()  == 4.5 );
+   QVERIFY( rec->grains_kg()        == 5.05 );
+   QVERIFY( rec->wortFromMash_l()   == 20.5 );
+   QVERIFY( rec->boilVolume_l()     == 20.657529930686831 );
+   QVERIFY( rec->finalVolume_l()    == 16.657529930686831 );
+   QVERIFY( rec->postBoilVolume_l() == 16.657529930686831 );
+   QVERIFY( rec->color_srm()        == 7.8567486377689981 );
+   QVERIFY( rec->og()               == 1.0491095047081567 );
+   QVERIFY( rec->fg()               == 1.0132595662712023 );
+   QVERIFY( rec->ABV_pct()          == 4.4139785763616475 );
+   QVERIFY( rec->boilGrav()         == 1.0379120930251309 );
+   QVERIFY( rec->IBU()              == 35.052013354244615 );
+   QVERIFY( rec->calories12oz()     == 162.42909047918269 );
+
+   // Lactose has to show up as unfermentable
+   QVERIFY( calcs.gravities.fg_fermentable == 1.0122648348073406 );
+   QVERIFY( calcs.gravities.fg_fermentable < calcs.gravities.fg );
+
+   // And the piecemeal path, which only redoes the IBUs. The recipe has its
+   // own copy of the hop, so change that one
+   QList<Hop*> hops = rec->hops();
+   foreach( Hop* hop, hops )
+   {
+      if( hop->use() == Hop::First_Wort )
+         hop->setAmount_kg(0.025);
+   }
+   QVERIFY( rec->IBU() == 40.327254169995356 );
+   QList<double> ibus = rec->IBUs();
+   QCOMPARE( ibus.size(), hops.size() );
+   for( int i = 0; i < hops.size(); ++i )
+   {
+      double want = (hops[i]->use() == Hop::First_Wort) ? 26.376204078753723 : 13.951050091241635;
+      QVERIFY( ibus[i] == want );
+      QVERIFY( rec->ibuFromHop(hops[i]) == want );
+   }
+}
+
+void Testing::recipeCopyTest()
+{
+   Recipe* rec = Database::instance().newRecipe();
+   rec->setName("TestRecipe_copy");
+
+   Database::instance().addToRecipe(rec, twoRow);
+   Database::instance().addToRecipe(rec, cascade_4pct);
+
+   Recipe* copy = Database::instance().newRecipe(rec);
+   QList<Fermentable*> ferms = copy->fermentables();
+   QList<Hop*> hops = copy->hops();
+
+   QVERIFY( copy->key() != rec->key() );
+   QCOMPARE( ferms.size(), rec->fermentables().size() );
+   QCOMPARE( hops.size(), rec->hops().size() );
+
+   // Same ingredient, different row
+   QVERIFY( ferms[0]->key() != rec->fermentables()[0]->key() );
+   QCOMPARE( ferms[0]->name(), rec->fermentables()[0]->name() );
+   QVERIFY( fuzzyComp(hops[0]->alpha_pct(), rec->hops()[0]->alpha_pct(), 1e-6) );
+   QVERIFY( ! hops[0]->display() );
+}
+
+void Testing::folderRenameTest()
+{
+   Database& db = Database::instance();
+   Recipe* top = db.newRecipe();
+   Recipe* deep = db.newRecipe();
+   Recipe* lookalike = db.newRecipe();
+
+   top->setFolder("/folderTest/a", false);
+   deep->setFolder("/folderTest/a/b", false);
+   // Shares a prefix, but isn't in the folder
+   lookalike->setFolder("/folderTest/ab", false);
+
+   QCOMPARE( db.renameFolder(Brewtarget::RECTABLE, "/folderTest/a", "/folderTest/z"), 2 );
+
+   // What's cached and what's in the db should both have moved
+   QCOMPARE( top->folder(), QString("/folderTest/z") );
+   QCOMPARE( deep->folder(), QString("/folderTest/z/b") );
+   QCOMPARE( lookalike->folder(), QString("/folderTest/ab") );
+   QCOMPARE( db.get(Brewtarget::RECTABLE, deep->key(), "folder").toString(), QString("/folderTest/z/b") );
+   QCOMPARE( db.get(Brewtarget::RECTABLE, lookalike->key(), "folder").toString(), QString("/folderTest/ab") );
+}
+
+void Testing::getColumnsTest()
+{
+   Database& db = Database::instance();
+   Equipment* e = db.newEquipment();
+   QVector<const char*> cols;
+   cols << "batch_size" << "boil_time" << "name";
+
+   e->setName("getColumnsTest");
+   e->setBatchSize_l(19.5);
+   e->setBoilTime_min(75);
+
+   // Twice, so the second goes through the cached statement
+   for ( int i = 0; i < 2; ++i ) {
+      QVector<QVariant> vals = db.get(Brewtarget::EQUIPTABLE, e->key(), cols);
+      QCOMPARE( vals.size(), 3 );
+      QCOMPARE( vals[0].toDouble(), db.get(Brewtarget::EQUIPTABLE, e->key(), "batch_size").toDouble() );
+      QCOMPARE( vals[1].toDouble(), 75.0 );
+      QCOMPARE( vals[2].toString(), QString("getColumnsTest") );
+   }
+}
+
+//! The per-name hop_children rebuild that populateChildTablesByName()
+//  replaced: a couple of queries per name and an insert per child
+static bool populateHopChildrenOneByOne( QSqlDatabase db )
+{
+   QSqlQuery names( "SELECT DISTINCT name FROM hop", db );
+   if ( ! names.isActive() )
+      return false;
+
+   while ( names.next() ) {
+      QString name = names.value(0).toString();
+      QSqlQuery parent(db);
+      parent.prepare( QString("SELECT id FROM hop WHERE ( name=:name AND display=%1 ) ORDER BY id ASC LIMIT 1").arg(Brewtarget::dbTrue()) );
+      parent.bindValue(":name", name);
+      if ( ! parent.exec() )
+         return false;
+      // Nobody to be the child of. The original built an INSERT with an
+      // empty parent id here and threw on it
+      if ( ! parent.next() )
+         continue;
+
+      QSqlQuery children(db);
+      children.prepare( QString("SELECT id FROM hop WHERE ( name=:name AND display=%1 ) ORDER BY id ASC").arg(Brewtarget::dbFalse()) );
+      children.bindValue(":name", name);
+      if ( ! children.exec() )
+         return false;
+
+      while ( children.next() ) {
+         QSqlQuery insert(db);
+         if ( ! insert.exec( QString("INSERT OR REPLACE INTO hop_children (parent_id, child_id) VALUES (%1, %2)")
+                                .arg(parent.value(0).toInt()).arg(children.value(0).toInt()) ) )
+            return false;
+      }
+   }
+   return true;
+}
+
+void Testing::populateChildTablesTest()
+{
+   Database& db = Database::instance();
+   QSqlQuery q(db.sqlDatabase());
+   QList< QPair<int,int> > oneByOne, grouped;
+
+   // Everything in here gets rolled back, so the other tests never notice
+   db.sqlDatabase().transaction();
+
+   QVERIFY( q.exec("DELETE FROM hop_children") );
+   QVERIFY( populateHopChildrenOneByOne(db.sqlDatabase()) );
+   QVERIFY( q.exec("SELECT parent_id, child_id FROM hop_children ORDER BY child_id") );
+   while ( q.next() )
+      oneByOne.append( qMakePair(q.value(0).toInt(), q.value(1).toInt()) );
+
+   QVERIFY( q.exec("DELETE FROM hop_children") );
+   db.populateChildTablesByName(Brewtarget::HOPTABLE);
+   QVERIFY( q.exec("SELECT parent_id, child_id FROM hop_children ORDER BY child_id") );
+   while ( q.next() )
+      grouped.append( qMakePair(q.value(0).toInt(), q.value(1).toInt()) );
+
+   q.finish();
+   db.sqlDatabase().rollback();
+
+   QVERIFY( oneByOne == grouped );
+}
+
+void Testing::populateChildTablesBenchmark_data()
+{
+   QTest::addColumn<bool>("grouped");
+
+   QTest::newRow("one by one") << false;
+   QTest::newRow("grouped") << true;
+}
+
+void Testing::populateChildTablesBenchmark()
+{
+   QFETCH(bool, grouped);
+   Database& db = Database::instance();
+   QSqlQuery q(db.sqlDatabase());
+   bool ok = true;
+
+   // Same as populateChildTablesTest, none of this is kept
+   db.sqlDatabase().transaction();
+
+   QBENCHMARK
+   {
+      ok = ok && q.exec("DELETE FROM hop_children");
+      if ( grouped )
+         db.populateChildTablesByName(Brewtarget::HOPTABLE);
+      else
+         ok = ok && populateHopChildrenOneByOne(db.sqlDatabase());
+   }
+
+   q.finish();
+   db.sqlDatabase().rollback();
+
+   QVERIFY( ok );
+}
+
+void Testing::pgsqlConversionTest()
+{
+   QByteArray host = qgetenv("BREWTARGET_TEST_PGSQL_HOST");
+   if ( host.isEmpty() )
+      QSKIP("BREWTARGET_TEST_PGSQL_HOST is not set");
+
+   QString dbName   = qgetenv("BREWTARGET_TEST_PGSQL_DB").isEmpty() ? QString("brewtarget_test") : QString(qgetenv("BREWTARGET_TEST_PGSQL_DB"));
+   QString user     = QString(qgetenv("BREWTARGET_TEST_PGSQL_USER"));
+   QString password = QString(qgetenv("BREWTARGET_TEST_PGSQL_PASSWORD"));
+   int port         = qgetenv("BREWTARGET_TEST_PGSQL_PORT").isEmpty() ? 5432 : qgetenv("BREWTARGET_TEST_PGSQL_PORT").toInt();
+
+   QStringList tables;
+   tables << "hop" << "fermentable" << "equipment" << "recipe" << "hop_in_recipe" << "mashstep";
+
+   Database::instance().convertDatabase(host, dbName, user, password, port, Brewtarget::PGSQL);
+
+   {
+      QSqlDatabase pg = QSqlDatabase::addDatabase("QPSQL", "pgsqlConversionTest");
+      pg.setHostName(host);
+      pg.setDatabaseName(dbName);
+      pg.setUserName(user);
+      pg.setPassword(password);
+      pg.setPort(port);
+      QVERIFY2( pg.open(), qPrintable(pg.lastError().text()) );
+
+      QSqlQuery oldCount(Database::instance().sqlDatabase());
+      QSqlQuery newCount(pg);
+      foreach( QString table, tables ) {
+         QString count = QString("SELECT COUNT(*) FROM %1").arg(table);
+         QVERIFY( oldCount.exec(count) && oldCount.next() );
+         QVERIFY( newCount.exec(count) && newCount.next() );
+         QVERIFY2( oldCount.value(0).toInt() == newCount.value(0).toInt(), qPrintable(table) );
+      }
+      pg.close();
+   }
+   QSqlDatabase::removeDatabase("pgsqlConversionTest");
+}
+
+//! \returns what's wrong with T's PropertyIds, or nothing if they are right.
+template<class T> static QString propertyIdsMismatch( const char* const* names, int count )
+{
+   QMetaObject const& mo = T::staticMetaObject;
+   int own = mo.propertyCount() - mo.propertyOffset();
+
+   if ( own != count )
+      return QString("%1 has %2 properties, PropertyIds has %3").arg(mo.className()).arg(own).arg(count);
+
+   for ( int i = 0; i < count; ++i ) {
+      if ( qstrcmp(mo.property(mo.propertyOffset() + i).name(), names[i]) != 0 )
+         return QString("%1 property %2 is %3, PropertyIds says %4")
+                  .arg(mo.className()).arg(i).arg(mo.property(mo.propertyOffset() + i).name()).arg(names[i]);
+   }
+   return QString();
+}
+
+void Testing::propertyIdsTest()
+{
+   QStringList errors;
+
+   errors << propertyIdsMismatch<BeerXMLElement>( PropertyIds::BeerXMLElement::names, PropertyIds::BeerXMLElement::count )
+          << propertyIdsMismatch<BrewNote>( PropertyIds::BrewNote::names, PropertyIds::BrewNote::count )
+          << propertyIdsMismatch<Equipment>( PropertyIds::Equipment::names, PropertyIds::Equipment::count )
+          << propertyIdsMismatch<Fermentable>( PropertyIds::Fermentable::names, PropertyIds::Fermentable::count )
+          << propertyIdsMismatch<Hop>( PropertyIds::Hop::names, PropertyIds::Hop::count )
+          << propertyIdsMismatch<Instruction>( PropertyIds::Instruction::names, PropertyIds::Instruction::count )
+          << propertyIdsMismatch<Mash>( PropertyIds::Mash::names, PropertyIds::Mash::count )
+          << propertyIdsMismatch<MashStep>( PropertyIds::MashStep::names, PropertyIds::MashStep::count )
+          << propertyIdsMismatch<Misc>( PropertyIds::Misc::names, PropertyIds::Misc::count )
+          << propertyIdsMismatch<Recipe>( PropertyIds::Recipe::names, PropertyIds::Recipe::count )
+          << propertyIdsMismatch<Style>( PropertyIds::Style::names, PropertyIds::Style::count )
+          << propertyIdsMismatch<Water>( PropertyIds::Water::names, PropertyIds::Water::count )
+          << propertyIdsMismatch<Yeast>( PropertyIds::Yeast::names, PropertyIds::Yeast::count );
+   errors.removeAll(QString());
+
+   QVERIFY2( errors.isEmpty(), qPrintable(errors.join("; ")) );
+
+   // And the thing the listeners actually rely on
+   QMetaObject const& mo = Recipe::staticMetaObject;
+   QCOMPARE( BeerXMLElement::propertyId<Recipe>(mo.property(mo.indexOfProperty("mash"))), int(PropertyIds::Recipe::mash) );
+   QCOMPARE( BeerXMLElement::propertyId<Recipe>(mo.property(mo.indexOfProperty("name"))), -1 );
+   QCOMPARE( BeerXMLElement::propertyId<BeerXMLElement>(mo.property(mo.indexOfProperty("name"))), int(PropertyIds::BeerXMLElement::name) );
+}
+
+//! \brief Puts the formula globals back however the test leaves
+class FormulaGuard
+{
+public:
+   FormulaGuard() : ibu(Brewtarget::ibuFormula), color(Brewtarget::colorFormula) {}
+   ~FormulaGuard()
+   {
+      Brewtarget::ibuFormula = ibu;
+      Brewtarget::colorFormula = color;
+   }
+
+private:
+   Brewtarget::IbuType ibu;
+   Brewtarget::ColorType color;
+};
+
+void Testing::ibuBatchTest()
+{
+   FormulaGuard guard;
+   Brewtarget::IbuType ibuTypes[] = { Brewtarget::TINSETH, Brewtarget::RAGER, Brewtarget::NOONAN };
+   Brewtarget::ColorType colorTypes[] = { Brewtarget::MOREY, Brewtarget::DANIEL, Brewtarget::MOSHER };
+   // One in each of Noonan's rows, and either side of Rager's cutoff
+   double gravities[] = { 1.040, 1.055, 1.070, 1.095 };
+   int const n = 4096;
+   QVector<double> AArating(n), grams(n), minutes(n), batch(n), scalar(n), mcu(n);
+   int i, j, k;
+
+   for( i = 0; i < n; ++i )
+   {
+      AArating[i] = 0.02 + 0.0001*(i % 150);
+      grams[i] = 5.0 + 0.5*(i % 97);
+      minutes[i] = i % 91;
+      mcu[i] = 0.25*(i % 160);
+   }
+
+   for( j = 0; j < 3; ++j )
+   {
+      Brewtarget::ibuFormula = ibuTypes[j];
+      for( k = 0; k < 4; ++k )
+      {
+         for( i = 0; i < n; ++i )
+            scalar[i] = IbuMethods::getIbus(AArating[i], grams[i], 20.0, gravities[k], minutes[i]);
+         IbuMethods::getIbus(AArating.constData(), grams.constData(), minutes.constData(), n, 20.0, gravities[k], batch.data());
+
+         // Bit for bit, so no QCOMPARE and its fuzziness
+         QVERIFY( scalar == batch );
+      }
+   }
+
+   for( j = 0; j < 3; ++j )
+   {
+      Brewtarget::colorFormula = colorTypes[j];
+      for( i = 0; i < n; ++i )
+         scalar[i] = ColorMethods::mcuToSrm(mcu[i]);
+      ColorMethods::mcuToSrm(mcu.constData(), n, batch.data());
+
+      QVERIFY( scalar == batch );
+   }
+}
+
+void Testing::ibuBatchBenchmark_data()
+{
+   QTest::addColumn<bool>("batch");
+
+   QTest::newRow("one at a time") << false;
+   QTest::newRow("batch") << true;
+}
+
+void Testing::ibuBatchBenchmark()
+{
+   QFETCH(bool, batch);
+   FormulaGuard guard;
+   int const n = 4096;
+   QVector<double> AArating(n), grams(n), minutes(n), ibus(n), mcu(n), srm(n);
+   int i;
+
+   for( i = 0; i < n; ++i )
+   {
+      AArating[i] = 0.02 + 0.0001*(i % 150);
+      grams[i] = 5.0 + 0.5*(i % 97);
+      minutes[i] = i % 91;
+      mcu[i] = 0.25*(i % 160);
+   }
+   Brewtarget::ibuFormula = Brewtarget::TINSETH;
+   Brewtarget::colorFormula = Brewtarget::MOREY;
+
+   QBENCHMARK
+   {
+      if( batch )
+      {
+         IbuMethods::getIbus(AArating.constData(), grams.constData(), minutes.constData(), n, 20.0, 1.055, ibus.data());
+         ColorMethods::mcuToSrm(mcu.constData(), n, srm.data());
+      }
+      else
+      {
+         for( i = 0; i < n; ++i )
+         {
+            ibus[i] = IbuMethods::getIbus(AArating[i], grams[i], 20.0, 1.055, minutes[i]);
+            srm[i] = ColorMethods::mcuToSrm(mcu[i]);
+         }
+      }
+   }
+}
+
+void Testing::recipeSweepTest()
+{
+   twoRow->setAmount_kg(5.0);
+   cascade_4pct->setAmount_kg(0.0284);
+   Recipe* rec = newSimpleRecipe("recipeSweepTest");
+   rec->setEfficiency_pct(70.0);
+
+   double og = rec->og();
+   double ibu = rec->IBU();
+
+   // Nothing asked, so the recipe is all there is
+   RecipeSweep same(rec);
+   QCOMPARE( same.size(), 1 );
+   QVector<RecipeSweep::Result> rows = same.run();
+   QVERIFY( rows.first().og == og );
+   QVERIFY( rows.first().IBU == ibu );
+
+   QList<double> sizes, effs;
+   for( int i = 0; i < 10; ++i )
+   {
+      sizes << 10.0 + 5.0*i;
+      effs << 55.0 + 3.0*i;
+   }
+
+   RecipeSweep scaled(rec, RecipeSweep::ScaleIngredients);
+   scaled.setBatchSizes_l(sizes);
+   scaled.setEfficiencies_pct(effs);
+   scaled.addEquipment(equipFiveGalNoLoss);
+   QCOMPARE( scaled.size(), 100 );
+
+   QVector<RecipeSweep::Result> oneThread = scaled.run(1);
+   QVector<RecipeSweep::Result> manyThreads = scaled.run(4);
+   QCOMPARE( manyThreads.size(), oneThread.size() );
+   for( int i = 0; i < oneThread.size(); ++i )
+   {
+      QCOMPARE( manyThreads[i].equipment, 0 );
+      QVERIFY( manyThreads[i].og == oneThread[i].og );
+      QVERIFY( manyThreads[i].IBU == oneThread[i].IBU );
+      QVERIFY( manyThreads[i].color_srm == oneThread[i].color_srm );
+      QVERIFY( manyThreads[i].ABV_pct == oneThread[i].ABV_pct );
+      // Scaling is meant to keep the same beer
+      QVERIFY2( fuzzyComp(oneThread[i].og, og, 0.002), "scaled og drifted" );
+   }
+
+   // Same grain at a better efficiency has to make stronger wort
+   RecipeSweep kept(rec, RecipeSweep::KeepIngredients);
+   kept.setEfficiencies_pct( QList<double>() << 60.0 << 80.0 );
+   rows = kept.run();
+   QCOMPARE( rows.size(), 2 );
+   QVERIFY( rows[0].og < og );
+   QVERIFY( og < rows[1].og );
+
+   // Header, then a line a row
+   QCOMPARE( scaled.toCsv(oneThread).count("\n"), oneThread.size() + 1 );
+
+   // The table shows the same thing, and exports it the same way
+   RecipeSweepTableModel table;
+   table.setResults(scaled, oneThread);
+   QCOMPARE( table.rowCount(), oneThread.size() );
+   QCOMPARE( table.columnCount(), int(RecipeSweep::NUMCOLS) );
+   QCOMPARE( table.headerData(RecipeSweep::OGCOL, Qt::Horizontal).toString(), RecipeSweep::columnNames().at(RecipeSweep::OGCOL) );
+   QCOMPARE( table.data(table.index(0, RecipeSweep::EQUIPCOL)).toString(), equipFiveGalNoLoss->name() );
+   QCOMPARE( table.data(table.index(0, RecipeSweep::OGCOL)).toString(), BtLocale::toString(oneThread[0].og, 'f', 3) );
+   QCOMPARE( table.toCsv(), scaled.toCsv(oneThread) );
+
+   // And the recipe never noticed
+   QVERIFY( rec->og() == og );
+   QVERIFY( rec->efficiency_pct() == 70.0 );
+}
+
+void Testing::libraryRecalcTest()
+{
+   Database& db = Database::instance();
+   FormulaGuard guard;
+   twoRow->setAmount_kg(5.0);
+   cascade_4pct->setAmount_kg(0.0284);
+   Recipe* rec = newSimpleRecipe("libraryRecalcTest");
+   rec->setEfficiency_pct(70.0);
+
+   double before = rec->IBU();
+   // Nobody tells the recipe about this, which is the whole point
+   Brewtarget::ibuFormula = (Brewtarget::ibuFormula == Brewtarget::RAGER) ? Brewtarget::TINSETH : Brewtarget::RAGER;
+   QVERIFY( rec->IBU() == before );
+
+   LibraryRecalculator job;
+   QSignalSpy finished(&job, SIGNAL(finished(bool)));
+   job.setBatchSize(2);
+   job.start();
+   QVERIFY( finished.count() == 1 || finished.wait(30000) );
+   QCOMPARE( finished.first().first().toBool(), false );
+
+   RecipeCalculator::Results calcs = RecipeCalculator::calculate( RecipeSnapshot::of(rec) );
+   QVERIFY( rec->IBU() == calcs.IBU );
+   QVERIFY( rec->IBU() != before );
+   QVERIFY( rec->og() == calcs.gravities.og );
+
+   // And the next load would take it from the cache
+   QVERIFY( db.calcCache(rec).contains( db.recipeFingerprint(rec) ) );
+
+   // Saving new answers mustn't change the question
+   QString fingerprint = db.recipeFingerprint(rec);
+   db.updateEntry( Brewtarget::RECTABLE, rec->key(), "og", rec->og() + 0.01, QMetaProperty(), rec, false );
+   QCOMPARE( db.recipeFingerprint(rec), fingerprint );
+   db.updateEntry( Brewtarget::RECTABLE, rec->key(), "og", rec->og(), QMetaProperty(), rec, false );
+}
+
+void Testing::localeNumbersTest()
+{
+   QLocale oldDefault;
+   QLocale locales[] = { QLocale(QLocale::English, QLocale::UnitedStates), QLocale(QLocale::German, QLocale::Germany) };
+   QStringList texts;
+   texts << "0" << "42" << "-7" << "+3" << "1.5" << "1,5" << ".25" << ",25" << "5."
+         << "1.500" << "1,500" << "1,000.25" << "1.000,25" << "1e3" << " 2" << "-"
+         << "" << "abc" << "0.0000001" << "123456789.123456789";
+   QList<double> values;
+   values << 0.0 << -1.25 << 1234567.891 << 0.0005 << 1e-9 << 98765.4321;
+   int i, j;
+
+   for( i = 0; i < 2; ++i )
+   {
+      QLocale::setDefault(locales[i]);
+      BtLocale::localeChanged();
+
+      foreach( QString text, texts )
+      {
+         bool okFresh = false, okCached = false;
+         double fresh = QLocale().toDouble(text, &okFresh);
+         if( ! okFresh )
+            fresh = text.toDouble(&okFresh);
+         double cached = BtLocale::toDouble(text, &okCached);
+
+         QVERIFY2( okCached == okFresh, qPrintable(text) );
+         if( okFresh )
+            QVERIFY2( cached == fresh, qPrintable(text) );
+      }
+
+      foreach( double value, values )
+      {
+         for( j = 0; j < 4; ++j )
+            QCOMPARE( BtLocale::toString(value, 'f', j), QString("%L1").arg(value, 0, 'f', j) );
+      }
+   }
+
+   QLocale::setDefault(oldDefault);
+   BtLocale::localeChanged();
+}
+
+void Testing::instructionBatchTest()
+{
+   QList<Recipe*> recs;
+   int changes = 0;
+   int i, j;
+
+   // With an equipment, or we'd get asked for the boil time
+   for( i = 0; i < 2; ++i )
+      recs.append( newSimpleRecipe(QString("instructionBatchTest %1").arg(i)) );
+
+   Recipe* rec = recs.first();
+   QMetaObject::Connection counter = QObject::connect( rec, &BeerXMLElement::changed, [&changes](QMetaProperty prop, QVariant) {
+      if( BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::instructions )
+         ++changes;
+   });
+
+   rec->generateInstructions();
+   QList<Instruction*> first = rec->instructions();
+   QVERIFY( first.size() > 0 );
+   QCOMPARE( changes, 1 );
+   for( i = 0; i < first.size(); ++i )
+      QCOMPARE( first.at(i)->instructionNumber(), i+1 );
+
+   // Again, for both of them at once
+   Recipe::generateInstructions(recs);
+   QList<Instruction*> second = rec->instructions();
+   QCOMPARE( changes, 2 );
+   QCOMPARE( second.size(), first.size() );
+   for( i = 0; i < second.size(); ++i )
+   {
+      QCOMPARE( second.at(i)->instructionNumber(), i+1 );
+      QCOMPARE( second.at(i)->name(), first.at(i)->name() );
+      for( j = 0; j < first.size(); ++j )
+         QVERIFY( second.at(i)->key() != first.at(j)->key() );
+   }
+   QCOMPARE( recs.last()->instructions().size(), first.size() );
+
+   rec->clearInstructions();
+   QObject::disconnect(counter);
+   QVERIFY( rec->instructions().isEmpty() );
+   QCOMPARE( changes, 3 );
+}
+
+void Testing::toolTipCacheTest()
+{
+   ToolTipCache cache;
+   double alpha = cascade_4pct->alpha_pct();
+
+   QString before = cache.toolTip(cascade_4pct);
+   QCOMPARE( before, RecipeFormatter::getToolTip(cascade_4pct) );
+   QVERIFY( before.contains(cascade_4pct->name()) );
+   QVERIFY( cache.contains(cascade_4pct) );
+
+   // Change it and it has to be made again
+   cascade_4pct->setAlpha_pct(alpha + 1.0);
+   QVERIFY( ! cache.contains(cascade_4pct) );
+   QString after = cache.toolTip(cascade_4pct);
+   QVERIFY( after != before );
+   QCOMPARE( after, RecipeFormatter::getToolTip(cascade_4pct) );
+   cascade_4pct->setAlpha_pct(alpha);
+
+   // What the worker puts together has to match what's made here
+   QSignalSpy prefetched(&cache, SIGNAL(prefetched(int)));
+   cache.prefetch( QList<BeerXMLElement*>() << twoRow << equipFiveGalNoLoss );
+   QVERIFY( prefetched.count() == 1 || prefetched.wait(10000) );
+   QCOMPARE( prefetched.first().first().toInt(), 2 );
+   QVERIFY( cache.contains(twoRow) );
+   QCOMPARE( cache.toolTip(twoRow), RecipeFormatter::getToolTip(twoRow) );
+   QCOMPARE( cache.toolTip(equipFiveGalNoLoss), RecipeFormatter::getToolTip(equipFiveGalNoLoss) );
+
+   ToolTipCache::invalidateAll();
+   QVERIFY( ! cache.contains(twoRow) );
+}
+
+void Testing::recipeFormatterTest()
+{
+   Recipe* rec = newBrewNotesRecipe("recipeFormatterTest", 300);
+   RecipeFormatter kept;
+
+   kept.setRecipe(rec);
+   QString first = kept.getHTMLFormat();
+   QCOMPARE( kept.getHTMLFormat(), first );
+
+   // One hop and one brew note change. What comes out has to be what a
+   // formatter that never saw the recipe before comes up with
+   Hop* hop = rec->hops().first();
+   hop->setAmount_kg(hop->amount_kg() * 2.0);
+   rec->brewNotes().first()->setFg(1.009);
+
+   RecipeFormatter fresh;
+   fresh.setRecipe(rec);
+   QString changed = kept.getHTMLFormat();
+   QVERIFY( changed != first );
+   QCOMPARE( changed, fresh.getHTMLFormat() );
+   QCOMPARE( kept.getHTMLFormat(QList<Recipe*>() << rec), fresh.getHTMLFormat(QList<Recipe*>() << rec) );
+
+   // No hop changes here, but every hop's IBUs do
+   rec->setBatchSize_l(rec->batchSize_l() * 2.0);
+
+   RecipeFormatter resized;
+   resized.setRecipe(rec);
+   QString bigger = kept.getHTMLFormat();
+   QVERIFY( bigger != changed );
+   QCOMPARE( bigger, resized.getHTMLFormat() );
+}
+
+void Testing::recipeFormatterBenchmark_data()
+{
+   QTest::addColumn<bool>("kept");
+
+   QTest::newRow("from scratch") << false;
+   QTest::newRow("kept") << true;
+}
+
+void Testing::recipeFormatterBenchmark()
+{
+   QFETCH(bool, kept);
+   Recipe* rec = newBrewNotesRecipe("recipeFormatterBenchmark", 300);
+   RecipeFormatter formatter;
+
+   formatter.setRecipe(rec);
+   formatter.getHTMLFormat();
+
+   QBENCHMARK
+   {
+      if( ! kept )
+         RecipeFormatter::invalidateAll();
+      formatter.getHTMLFormat();
+   }
+}
+
+void Testing::printPipelineTest()
+{
+   QList<Recipe*> recs;
+   QTemporaryDir dir;
+   int i;
+
+   QVERIFY( dir.isValid() );
+   for( i = 0; i < 6; ++i )
+      recs.append( newSimpleRecipe(QString("printPipelineTest %1").arg(i)) );
+   Recipe::generateInstructions(recs);
+
+   for( i = 0; i < 2; ++i )
+   {
+      PrintPipeline::Kind kind = i == 0 ? PrintPipeline::RECIPE : PrintPipeline::BREWDAY;
+      QString fileName = dir.filePath(QString("printPipelineTest%1.pdf").arg(i));
+      QPrinter printer(QPrinter::HighResolution);
+      PrintPipeline pipeline;
+      QSignalSpy progress(&pipeline, SIGNAL(progress(int,int)));
+
+      printer.setOutputFormat(QPrinter::PdfFormat);
+      printer.setOutputFileName(fileName);
+      pipeline.setMaxThreadCount(3);
+
+      QVERIFY( pipeline.exec(recs, &printer, kind) );
+
+      // One each, in order
+      QCOMPARE( progress.count(), recs.size() );
+      for( int j = 0; j < progress.count(); ++j )
+      {
+         QCOMPARE( progress.at(j).at(0).toInt(), j+1 );
+         QCOMPARE( progress.at(j).at(1).toInt(), recs.size() );
+      }
+
+      QFile pdf(fileName);
+      QVERIFY( pdf.open(QIODevice::ReadOnly) );
+      QVERIFY( pdf.read(4) == "%PDF" );
+   }
+}
+
+void Testing::srmColorTableTest()
+{
+   int i;
+
+   // Right on at the table's own steps, and off the ends
+   for( i = -100; i <= 6000; ++i )
+   {
+      double srm = i / 100.0;
+      QCOMPARE( Algorithms::srmToColor(srm), Algorithms::srmToColorExact(srm) );
+   }
+
+   // In between, no more than rounding away
+   for( i = 0; i < 10000; ++i )
+   {
+      double srm = i * 0.0049;
+      QColor got = Algorithms::srmToColor(srm);
+      QColor want = Algorithms::srmToColorExact(srm);
+      QVERIFY( qAbs(got.red() - want.red()) <= 1 );
+      // Except green, which drops to nothing past 35, so the nearest step
+      // can land on the other side of it
+      if( qAbs(srm - 35.0) > 0.005 )
+         QVERIFY( qAbs(got.green() - want.green()) <= 1 );
+      QVERIFY( qAbs(got.blue() - want.blue()) <= 1 );
+   }
+
+   // 25 EBC is 12.7 SRM
+   QCOMPARE( Algorithms::ebcToColor(25.0), Algorithms::srmToColor(12.7) );
+   QCOMPARE( Algorithms::ebcToColor(0.0), Algorithms::srmToColor(0.0) );
+}
+
+void Testing::traceTest()
+{
+   if( Trace::isEnabled() )
+      QSKIP("Tracing was turned on from outside");
+
+   // Off, nothing gets kept and there is nothing to write
+   {
+      TraceSpan span("Testing::traceTest off", "test", QString("off"));
+   }
+   Trace::instant("Testing::traceTest off instant", "test");
+   QCOMPARE( Trace::count(), 0 );
+   QVERIFY( ! Trace::write() );
+
+   QTemporaryDir dir;
+   QVERIFY( dir.isValid() );
+   QString traceFile = dir.path() + "/trace.json";
+   Trace::enable(traceFile);
+   QVERIFY( Trace::isEnabled() );
+
+   {
+      TraceSpan span("Testing::traceTest on", "test", Trace::isEnabled() ? QString("on") : QString());
+   }
+   QCOMPARE( Trace::count(), 1 );
+
+   QVERIFY( Trace::write() );
+   QFile in(traceFile);
+   QVERIFY( in.open(QIODevice::ReadOnly) );
+   QJsonArray events = QJsonDocument::fromJson(in.readAll()).object().value("traceEvents").toArray();
+   QCOMPARE( events.size(), 1 );
+   QJsonObject ev = events.at(0).toObject();
+   QCOMPARE( ev.value("name").toString(), QString("Testing::traceTest on") );
+   QCOMPARE( ev.value("ph").toString(), QString("X") );
+   QCOMPARE( ev.value("args").toObject().value("detail").toString(), QString("on") );
+}
+
 void Testing::cleanupTestCase()
 {
    Brewtarget::cleanup();
@@ -30,6 +30,7 @@
 class Equipment;
 class Hop;
 class Fermentable;
+class Recipe;
 
 #include "brewtarget.h"
 #include "pstdint.h"
@@ -62,6 +63,12 @@ private:
    //! \brief 70% yield, no moisture, 2 SRM
    Fermentable* twoRow;
 
+   //! \brief New recipe sized for equipFiveGalNoLoss, with it, twoRow and
+   //  cascade_4pct added
+   Recipe* newSimpleRecipe(QString const& name);
+   //! \brief newSimpleRecipe() with \b notes brew notes
+   Recipe* newBrewNotesRecipe(QString const& name, int notes);
+
 private slots:
 
    // Run once before all test cases
@@ -103,6 +110,87 @@ private slots:
 
    //! \brief Verify post-boil losses do not affect OG
    void postBoilLossOgTest();
+
+   //! \brief Verify Recipe's numbers are exactly what RecipeCalculator gets
+   //  from a snapshot of it
+   void recipeCalculatorTest();
+
+   //! \brief Verify copying a recipe copies its ingredients, not shares them
+   void recipeCopyTest();
+
+   //! \brief Verify moving a folder moves its subfolders and nothing else
+   void folderRenameTest();
+
+   //! \brief Verify reading several columns at once agrees with reading
+   //  them one at a time
+   void getColumnsTest();
+
+   //! \brief Verify the grouped parent/child rebuild matches the per-name
+   //  one it replaced
+   void populateChildTablesTest();
+
+   //! \brief How long rebuilding hop_children takes one name at a time and
+   //  grouped
+   void populateChildTablesBenchmark_data();
+   void populateChildTablesBenchmark();
+
+   //! \brief Verify copying to PostgreSQL moves every row. Skipped unless
+   //  BREWTARGET_TEST_PGSQL_HOST points at an empty database
+   void pgsqlConversionTest();
+
+   //! \brief Verify the generated PropertyIds still line up with what moc
+   //  thinks the properties are
+   void propertyIdsTest();
+
+   //! \brief Verify the batch IBU and color formulae match the one at a
+   //  time ones bit for bit
+   void ibuBatchTest();
+
+   //! \brief How long the IBU and color formulae take one at a time and in
+   //  a batch
+   void ibuBatchBenchmark_data();
+   void ibuBatchBenchmark();
+
+   //! \brief Verify a sweep leaves the recipe be, agrees with it where the
+   //  grid crosses it, and gets the same answers on any number of threads
+   void recipeSweepTest();
+
+   //! \brief Verify a library recalculation leaves every recipe with what
+   //  it would have worked out itself, and its cache good for next time
+   void libraryRecalcTest();
+
+   //! \brief Verify BtLocale reads and writes numbers exactly like QLocale,
+   //  in a '.' locale and a ',' one
+   void localeNumbersTest();
+
+   //! \brief Verify generated instructions land in order with one change
+   //  signal, and regenerating replaces them instead of piling on
+   void instructionBatchTest();
+
+   //! \brief Verify cached and prefetched tooltips are the ones RecipeFormatter
+   //  makes, and that a change makes the cache forget
+   void toolTipCacheTest();
+
+   //! \brief Verify the html view comes out the same kept as made from
+   //  scratch, after changes too
+   void recipeFormatterTest();
+
+   //! \brief How long the html view of a recipe with hundreds of brew notes
+   //  takes from scratch and kept
+   void recipeFormatterBenchmark_data();
+   void recipeFormatterBenchmark();
+
+   //! \brief Verify a handful of recipes and brew sheets go into one PDF in
+   //  order, with progress for each
+   void printPipelineTest();
+
+   //! \brief Verify the SRM color table matches the curve fit it's made
+   //  from, EBC included
+   void srmColorTableTest();
+
+   //! \brief Verify a disabled span records nothing, and an enabled one ends
+   //  up in the trace file. Last, since there is no turning tracing off again
+   void traceTest();
 };
 
 #endif /*TESTING_H*/
@@ -0,0 +1,278 @@
+/*
+ * ToolTipCache.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ToolTipCache.h"
+#include "recipe.h"
+#include "style.h"
+#include "equipment.h"
+#include "fermentable.h"
+#include "hop.h"
+#include "misc.h"
+#include "yeast.h"
+#include "MemoryAccounting.h"
+#include <QMetaObject>
+#include <QRunnable>
+
+QAtomicInt ToolTipCache::generation(1);
+
+class ToolTipCache::Task : public QRunnable
+{
+public:
+   Task( ToolTipCache* cache, QList<Item>* items ) : _cache(cache), _items(items)
+   {
+      setAutoDelete(true);
+   }
+
+   void run()
+   {
+      // Nothing touches the list until collect(), so no locks. Everything
+      // was read before it got here, so no database either
+      for( int i = 0; i < _items->size(); ++i )
+      {
+         Item& item = (*_items)[i];
+
+         if( item.data.table == Brewtarget::NOTABLE )
+            item.toolTip = RecipeFormatter::getToolTip(item.recipe);
+         else
+            item.toolTip = RecipeFormatter::getToolTip(item.data);
+      }
+
+      QMetaObject::invokeMethod(_cache, "collect", Qt::QueuedConnection);
+   }
+
+private:
+   ToolTipCache* _cache;
+   QList<Item>* _items;
+};
+
+ToolTipCache::ToolTipCache( QObject* parent )
+   : QObject(parent),
+     _pending(0),
+     _generation(generation.load())
+{
+   // It's only string building, and the window needs the rest
+   _pool.setMaxThreadCount(1);
+}
+
+ToolTipCache::~ToolTipCache()
+{
+   // The task points into _pending
+   _pool.waitForDone();
+
+   delete _pending;
+}
+
+void ToolTipCache::invalidateAll()
+{
+   generation.ref();
+}
+
+void ToolTipCache::checkGeneration()
+{
+   int current = generation.load();
+   if( current != _generation )
+   {
+      _toolTips.clear();
+      _generation = current;
+   }
+}
+
+QString ToolTipCache::toolTip( BeerXMLElement* elem )
+{
+   if( elem == 0 )
+      return "";
+
+   checkGeneration();
+
+   QHash<BeerXMLElement*, QString>::const_iterator it = _toolTips.constFind(elem);
+   if( it != _toolTips.constEnd() )
+      return it.value();
+
+   QString ret = makeToolTip(elem);
+   if( ! ret.isEmpty() )
+   {
+      watch(elem);
+      _toolTips.insert(elem, ret);
+   }
+   return ret;
+}
+
+bool ToolTipCache::contains( BeerXMLElement* elem )
+{
+   checkGeneration();
+   return _toolTips.contains(elem);
+}
+
+int ToolTipCache::size() const
+{
+   return _toolTips.size();
+}
+
+qint64 ToolTipCache::bytes() const
+{
+   qint64 ret = _toolTips.size() * MemoryAccounting::hashNodeBytes<BeerXMLElement*,QString>()
+              + _changes.size() * MemoryAccounting::hashNodeBytes<BeerXMLElement*,int>();
+
+   foreach( QString const& tip, _toolTips )
+      ret += MemoryAccounting::stringBytes(tip);
+
+   return ret;
+}
+
+void ToolTipCache::prefetch( QList<BeerXMLElement*> const& elems )
+{
+   checkGeneration();
+
+   // One at a time. Whatever is asked for in the meantime goes next
+   if( _pending )
+   {
+      foreach( BeerXMLElement* elem, elems )
+      {
+         if( elem && ! _toolTips.contains(elem) )
+            _queued.append(elem);
+      }
+      return;
+   }
+
+   QList<Item>* items = new QList<Item>();
+
+   foreach( BeerXMLElement* elem, elems )
+   {
+      if( elem == 0 || _toolTips.contains(elem) )
+         continue;
+
+      Item item;
+      item.element = elem;
+
+      // A read that failed leaves it for toolTip() to try again, rather
+      // than have the worker make a blank one
+      if( Recipe* rec = qobject_cast<Recipe*>(elem) )
+      {
+         // The numbers are in memory or they need a recalculation, and
+         // that isn't for here either
+         if( ! RecipeFormatter::recipeToolTipNumbers(rec, item.recipe) ||
+             ! RecipeFormatter::recipeToolTipStyle(rec, item.recipe) )
+            continue;
+      }
+      else if( ! RecipeFormatter::elementToolTipData(elem, item.data) )
+         continue; // Folders and brewnotes have no tooltip
+
+      watch(elem);
+      item.generation = _changes.value(elem);
+      items->append(item);
+   }
+
+   if( items->isEmpty() )
+   {
+      delete items;
+      return;
+   }
+
+   _pending = items;
+   _pool.start( new Task(this, _pending) );
+}
+
+void ToolTipCache::collect()
+{
+   QList<Item>* items = _pending;
+   bool stale = generation.load() != _generation;
+   int count = 0;
+
+   _pending = 0;
+   if( items == 0 )
+      return;
+
+   checkGeneration();
+
+   foreach( Item const& item, *items )
+   {
+      // Changed or deleted while the worker was at it
+      if( stale || item.element.isNull() || item.toolTip.isEmpty() )
+         continue;
+      if( _changes.value(item.element.data()) != item.generation )
+         continue;
+
+      _toolTips.insert(item.element.data(), item.toolTip);
+      ++count;
+   }
+   delete items;
+
+   emit prefetched(count);
+
+   if( ! _queued.isEmpty() )
+   {
+      QList<BeerXMLElement*> next;
+      foreach( QPointer<BeerXMLElement> const& elem, _queued )
+      {
+         if( ! elem.isNull() )
+            next.append(elem.data());
+      }
+      _queued.clear();
+      prefetch(next);
+   }
+}
+
+void ToolTipCache::watch( BeerXMLElement* elem )
+{
+   if( _changes.contains(elem) )
+      return;
+
+   _changes.insert(elem, 0);
+   connect( elem, SIGNAL(changed(QMetaProperty,QVariant)), this, SLOT(forget()) );
+   connect( elem, SIGNAL(changedName(QString)), this, SLOT(forget()) );
+   connect( elem, SIGNAL(destroyed(QObject*)), this, SLOT(forget(QObject*)) );
+}
+
+void ToolTipCache::forget()
+{
+   BeerXMLElement* elem = qobject_cast<BeerXMLElement*>(sender());
+   if( elem == 0 )
+      return;
+
+   _toolTips.remove(elem);
+   ++_changes[elem];
+}
+
+void ToolTipCache::forget( QObject* obj )
+{
+   // Half gone already, so no qobject_cast. We only want the address
+   BeerXMLElement* elem = static_cast<BeerXMLElement*>(obj);
+
+   _toolTips.remove(elem);
+   _changes.remove(elem);
+}
+
+QString ToolTipCache::makeToolTip( BeerXMLElement* elem )
+{
+   if( Recipe* rec = qobject_cast<Recipe*>(elem) )
+      return RecipeFormatter::getToolTip(rec);
+   if( Style* style = qobject_cast<Style*>(elem) )
+      return RecipeFormatter::getToolTip(style);
+   if( Equipment* kit = qobject_cast<Equipment*>(elem) )
+      return RecipeFormatter::getToolTip(kit);
+   if( Fermentable* ferm = qobject_cast<Fermentable*>(elem) )
+      return RecipeFormatter::getToolTip(ferm);
+   if( Hop* hop = qobject_cast<Hop*>(elem) )
+      return RecipeFormatter::getToolTip(hop);
+   if( Misc* misc = qobject_cast<Misc*>(elem) )
+      return RecipeFormatter::getToolTip(misc);
+   if( Yeast* yeast = qobject_cast<Yeast*>(elem) )
+      return RecipeFormatter::getToolTip(yeast);
+
+   return "";
+}
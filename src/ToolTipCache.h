@@ -0,0 +1,113 @@
+/*
+ * ToolTipCache.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TOOLTIPCACHE_H
+#define _TOOLTIPCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include "RecipeFormatter.h"
+
+class BeerXMLElement;
+
+/*!
+ * \class ToolTipCache
+ *
+ * \brief Remembers the tooltips RecipeFormatter made, so hovering over the
+ * same row twice doesn't cost a dozen queries twice.
+ *
+ * A tooltip is forgotten when its element says it changed(), and every
+ * tooltip everywhere is forgotten when invalidateAll() is called (say, the
+ * units or the language changed). prefetch() reads what the tooltips show
+ * here, one query per element, and has another thread put them together,
+ * so by the time the mouse gets there the answer is waiting.
+ */
+class ToolTipCache : public QObject
+{
+   Q_OBJECT
+
+public:
+   ToolTipCache( QObject* parent = 0 );
+   virtual ~ToolTipCache();
+
+   //! \brief The tooltip for \b elem, made here and now if we haven't got it
+   QString toolTip( BeerXMLElement* elem );
+   //! \brief True if toolTip() won't have to make it
+   bool contains( BeerXMLElement* elem );
+   //! \brief Makes the tooltips we haven't got for \b elems, on another thread
+   void prefetch( QList<BeerXMLElement*> const& elems );
+   //! \brief How many tooltips we are holding
+   int size() const;
+   //! \brief What they cost, for MemoryAccounting
+   qint64 bytes() const;
+
+   //! \brief Makes every cache forget every tooltip
+   static void invalidateAll();
+
+signals:
+   //! \brief Some tooltips came back from prefetch()
+   void prefetched( int count );
+
+private slots:
+   //! Whoever sent this has changed
+   void forget();
+   void forget( QObject* elem );
+   void collect();
+
+private:
+   //! \brief One element's worth of prefetching
+   struct Item
+   {
+      Item() : generation(0) {}
+
+      QPointer<BeerXMLElement> element;
+      int generation;
+      //! What the worker formats. Recipes use \c recipe, the rest \c data
+      RecipeFormatter::RecipeToolTip recipe;
+      RecipeFormatter::ElementToolTip data;
+      QString toolTip;
+   };
+
+   class Task;
+
+   //! \brief Watches \b elem, if we aren't already
+   void watch( BeerXMLElement* elem );
+   //! \brief Drops everything if invalidateAll() was called since we last looked
+   void checkGeneration();
+   //! \brief Makes the tooltip of whatever \b elem is. "" if it doesn't have one
+   static QString makeToolTip( BeerXMLElement* elem );
+
+   QHash<BeerXMLElement*, QString> _toolTips;
+   //! Bumped every time an element changes, so stale prefetches get dropped
+   QHash<BeerXMLElement*, int> _changes;
+   //! Prefetches out with the worker. The task owns the list until collect()
+   QList<Item>* _pending;
+   //! Asked for while the worker was busy
+   QList< QPointer<BeerXMLElement> > _queued;
+   QThreadPool _pool;
+   int _generation;
+
+   static QAtomicInt generation;
+};
+
+#endif /* _TOOLTIPCACHE_H */
@@ -0,0 +1,169 @@
+/*
+ * Trace.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include "Trace.h"
+
+namespace {
+
+struct TraceEvent
+{
+   const char* name;
+   const char* category;
+   char phase;
+   qint64 start_us;
+   qint64 duration_us;
+   int tid;
+   QString detail;
+};
+
+// Everything lives in here, so it is built before enable() registers
+// writeAtExit() and so outlives it
+QMutex traceMutex;
+QElapsedTimer traceClock;
+QString traceFile;
+QVector<TraceEvent> traceEvents;
+// Perfetto draws one row per tid, so keep them small and in order of
+// appearance instead of using raw thread handles
+QHash<Qt::HANDLE, int> traceThreads;
+
+int threadNumber()
+{
+   Qt::HANDLE self = QThread::currentThreadId();
+   QHash<Qt::HANDLE,int>::const_iterator i = traceThreads.constFind(self);
+   if ( i != traceThreads.constEnd() )
+      return i.value();
+
+   int n = traceThreads.size() + 1;
+   traceThreads.insert(self, n);
+   return n;
+}
+
+void writeAtExit()
+{
+   Trace::write();
+}
+
+}
+
+QAtomicInt Trace::_enabled(0);
+
+void Trace::enable(QString const& filename)
+{
+   QMutexLocker locker(&traceMutex);
+
+   if ( isEnabled() )
+      return;
+
+   traceFile = filename;
+   traceEvents.reserve(4096);
+   traceClock.start();
+   // The main thread is always row 1
+   threadNumber();
+   // Release, so whoever sees us enabled also sees the clock started
+   _enabled.storeRelease(1);
+
+   // Some of our exits are exit(0), so main() returning isn't good enough
+   std::atexit(writeAtExit);
+}
+
+qint64 Trace::now_us()
+{
+   return traceClock.nsecsElapsed() / 1000;
+}
+
+int Trace::count()
+{
+   QMutexLocker locker(&traceMutex);
+   return traceEvents.size();
+}
+
+void Trace::complete(const char* name, const char* category, qint64 start_us, qint64 duration_us, QString const& detail)
+{
+   if ( ! isEnabled() )
+      return;
+
+   QMutexLocker locker(&traceMutex);
+   TraceEvent e = { name, category, 'X', start_us, duration_us, threadNumber(), detail };
+   traceEvents.append(e);
+}
+
+void Trace::instant(const char* name, const char* category)
+{
+   if ( ! isEnabled() )
+      return;
+
+   qint64 t = now_us();
+   QMutexLocker locker(&traceMutex);
+   TraceEvent e = { name, category, 'i', t, 0, threadNumber(), QString() };
+   traceEvents.append(e);
+}
+
+bool Trace::write()
+{
+   if ( ! isEnabled() )
+      return false;
+
+   QMutexLocker locker(&traceMutex);
+   QJsonArray events;
+
+   foreach( TraceEvent const& e, traceEvents )
+   {
+      QJsonObject ev;
+      ev["name"] = QString::fromLatin1(e.name);
+      ev["cat"]  = QString::fromLatin1(e.category);
+      ev["ph"]   = QString(QChar(e.phase));
+      ev["ts"]   = static_cast<double>(e.start_us);
+      ev["pid"]  = static_cast<int>(QCoreApplication::applicationPid());
+      ev["tid"]  = e.tid;
+      if ( e.phase == 'X' )
+         ev["dur"] = static_cast<double>(e.duration_us);
+      else
+         ev["s"] = QString("g");
+      if ( ! e.detail.isEmpty() )
+      {
+         QJsonObject args;
+         args["detail"] = e.detail;
+         ev["args"] = args;
+      }
+      events.append(ev);
+   }
+
+   QJsonObject root;
+   root["traceEvents"] = events;
+   root["displayTimeUnit"] = QString("ms");
+
+   QFile out(traceFile);
+   if ( ! out.open(QIODevice::WriteOnly | QIODevice::Truncate) )
+      return false;
+
+   out.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+   return true;
+}
@@ -0,0 +1,93 @@
+/*
+ * Trace.h is part of Brewtarget, and is Copyright the following
+ * authors 2009-2016
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include <QAtomicInt>
+#include <QString>
+#include <QtGlobal>
+
+/*!
+ * \class Trace
+ *
+ * \brief Records timed spans and writes them out as Chrome trace-event JSON,
+ * which chrome://tracing and Perfetto both open.
+ *
+ * Nothing is recorded until enable() is called, and a disabled TraceSpan
+ * costs one atomic load. Spans with a detail should only build it when
+ * isEnabled(), or they pay for the string anyway.
+ */
+class Trace
+{
+public:
+   //! \brief Starts recording. Everything gets written to \c filename at exit
+   static void enable(QString const& filename);
+   static bool isEnabled() { return _enabled.loadAcquire() != 0; }
+
+   //! \brief Records a finished span. \c name and \c category must outlive
+   //  the program, which string literals do.
+   static void complete(const char* name, const char* category, qint64 start_us, qint64 duration_us, QString const& detail = QString());
+   //! \brief Records a point in time, like "the window is up"
+   static void instant(const char* name, const char* category = "app");
+   //! \brief Microseconds since enable()
+   static qint64 now_us();
+   //! \brief How many spans and instants are waiting to be written
+   static int count();
+
+   //! \brief Writes what we have so far. Called at exit, but safe to call any time
+   static bool write();
+
+private:
+   //! Spans on worker threads check this too, hence atomic
+   static QAtomicInt _enabled;
+};
+
+/*!
+ * \class TraceSpan
+ *
+ * \brief Times its own lifetime. Drop one at the top of a scope:
+ *
+ *    TraceSpan span("Database::load", "db");
+ */
+class TraceSpan
+{
+public:
+   TraceSpan(const char* name, const char* category = "app")
+      : _name(name), _category(category), _start(Trace::isEnabled() ? Trace::now_us() : -1) {}
+   //! \brief \c detail ends up in the span's args, e.g. the table being read
+   TraceSpan(const char* name, const char* category, QString const& detail)
+      : _name(name), _category(category), _start(Trace::isEnabled() ? Trace::now_us() : -1), _detail(detail) {}
+
+   ~TraceSpan()
+   {
+      if ( _start >= 0 )
+         Trace::complete(_name, _category, _start, Trace::now_us() - _start, _detail);
+   }
+
+private:
+   const char* _name;
+   const char* _category;
+   qint64 _start;
+   QString _detail;
+
+   TraceSpan(TraceSpan const&);
+   TraceSpan& operator=(TraceSpan const&);
+};
+
+#endif /* _TRACE_H */
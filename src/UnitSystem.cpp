@@ -21,6 +21,7 @@
 
 #include "UnitSystem.h"
 #include "brewtarget.h"
+#include "BtLocale.h"
 #include <QRegExp>
 #include <QString>
 #include <QLocale>
@@ -104,7 +105,7 @@ QString UnitSystem::displayAmount( double amount, Unit* units, int precision, Un
    // Special cases. Make sure the unit isn't null and that we're
    // dealing with volume.
    if( units == 0 || units->getUnitType() != _type)
-      return QString("%L1").arg(amount, fieldWidth, format, precision);
+      return BtLocale::toString(amount, format, precision);
 
    // We really shouldn't ever reference something that could be null until
    // after we have verified it isn't.
@@ -120,7 +121,7 @@ QString UnitSystem::displayAmount( double amount, Unit* units, int precision, Un
    if ( scaleToUnit().contains(scale) )
    {
       Unit* bob = scaleToUnit().value(scale);
-      return QString("%L1 %2").arg(bob->fromSI(SIAmount), fieldWidth, format, precision).arg(bob->getUnitName());
+      return BtLocale::toString(bob->fromSI(SIAmount), format, precision) + " " + bob->getUnitName();
    }
 
    // scaleToUnit() is a QMap which means we loop in the  order in which the
@@ -136,7 +137,7 @@ QString UnitSystem::displayAmount( double amount, Unit* units, int precision, Un
       // through the loop at least once already, and the boundary condition is
       // met, use the Unit* from the last loop.
       if ( last && absSIAmount < bob->toSI(boundary) )
-         return QString("%L1 %2").arg(last->fromSI(SIAmount), fieldWidth, format, precision).arg(last->getUnitName());
+         return BtLocale::toString(last->fromSI(SIAmount), format, precision) + " " + last->getUnitName();
 
       // If we get all the way through the map, this will be the largest unit
       // available
@@ -145,7 +146,7 @@ QString UnitSystem::displayAmount( double amount, Unit* units, int precision, Un
 
    // If we get here, use the largest unit available
    if( last )
-      return QString("%L1 %2").arg(last->fromSI(SIAmount), fieldWidth, format, precision).arg(last->getUnitName());
+      return BtLocale::toString(last->fromSI(SIAmount), format, precision) + " " + last->getUnitName();
    else
       return QString("nounit"); // Should never happen, so be obvious if it does
 
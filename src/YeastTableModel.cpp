@@ -39,6 +39,9 @@
 #include "unit.h"
 #include "brewtarget.h"
 #include "recipe.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "PropertyIds.h"
 
 YeastTableModel::YeastTableModel(QTableView* parent, bool editable)
    : QAbstractTableModel(parent),
@@ -57,6 +60,15 @@ YeastTableModel::YeastTableModel(QTableView* parent, bool editable)
    parentTableWidget->setWordWrap(false);
 
    connect(headerView, SIGNAL(customContextMenuRequested(const QPoint&)), this, SLOT(contextMenu(const QPoint&)));
+
+   MemoryAccounting::addSource(this, [this]() {
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Tables", objectName(), yeastObs.size(), yeastObs.size() * sizeof(void*) );
+   });
+}
+
+YeastTableModel::~YeastTableModel()
+{
+   MemoryAccounting::removeSources(this);
 }
 
 void YeastTableModel::addYeast(Yeast* yeast)
@@ -83,6 +95,8 @@ void YeastTableModel::addYeast(Yeast* yeast)
 
 void YeastTableModel::observeRecipe(Recipe* rec)
 {
+   TraceSpan span("YeastTableModel::observeRecipe", "model");
+
    if( recObs )
    {
       disconnect( recObs, 0, this, 0 );
@@ -187,7 +201,7 @@ void YeastTableModel::changed(QMetaProperty prop, QVariant /*val*/)
    Recipe* recSender = qobject_cast<Recipe*>(sender());
    if( recSender && recSender == recObs )
    {
-      if( QString(prop.name()) == "yeasts" )
+      if( BeerXMLElement::propertyId<Recipe>(prop) == PropertyIds::Recipe::yeasts )
       {
          removeAll();
          addYeasts( recObs->yeasts() );
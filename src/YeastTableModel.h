@@ -56,7 +56,7 @@ class YeastTableModel : public QAbstractTableModel
 
 public:
    YeastTableModel(QTableView* parent=0, bool editable=true);
-   virtual ~YeastTableModel() {}
+   virtual ~YeastTableModel();
    //! \brief Observe a recipe's list of fermentables.
    void observeRecipe(Recipe* rec);
    //! \brief If true, we model the database's list of yeasts.
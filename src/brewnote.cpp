@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QLocale>
 #include "brewnote.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 #include "Algorithms.h"
 #include "mashstep.h"
@@ -207,18 +208,18 @@ BrewNote::BrewNote(BrewNote const& other)
 // Setters=====================================================================
 void BrewNote::setBrewDate(QDateTime const& date)
 {
-   set("brewDate", "brewDate", date.toString(Qt::ISODate));
+   set(PropertyIds::BrewNote::brewDate, "brewDate", date.toString(Qt::ISODate));
    emit brewDateChanged(date);
 }
 
 void BrewNote::setFermentDate(QDateTime const& date)
 {
-   set("fermentDate", "fermentDate", date.toString(Qt::ISODate));
+   set(PropertyIds::BrewNote::fermentDate, "fermentDate", date.toString(Qt::ISODate));
 }
 
 void BrewNote::setNotes(QString const& var, bool notify)
 {
-   set("notes", "notes", var, notify);
+   set(PropertyIds::BrewNote::notes, "notes", var, notify);
 }
 
 void BrewNote::setLoading(bool flag) { loading = flag; }
@@ -228,7 +229,7 @@ void BrewNote::setLoading(bool flag) { loading = flag; }
 // the brewnote.
 void BrewNote::setSg(double var)
 {
-   set("sg", "sg", var);
+   set(PropertyIds::BrewNote::sg, "sg", var);
 
    if ( loading )
       return;
@@ -239,7 +240,7 @@ void BrewNote::setSg(double var)
 
 void BrewNote::setVolumeIntoBK_l(double var)
 {
-   set("volumeIntoBK_l", "volume_into_bk", var);
+   set(PropertyIds::BrewNote::volumeIntoBK_l, "volume_into_bk", var);
 
    if ( loading )
       return;
@@ -251,7 +252,7 @@ void BrewNote::setVolumeIntoBK_l(double var)
 
 void BrewNote::setOg(double var)
 {
-   set("og", "og", var);
+   set(PropertyIds::BrewNote::og, "og", var);
 
    if ( loading )
       return;
@@ -263,7 +264,7 @@ void BrewNote::setOg(double var)
 
 void BrewNote::setVolumeIntoFerm_l(double var)
 {
-   set("volumeIntoFerm_l", "volume_into_fermenter", var);
+   set(PropertyIds::BrewNote::volumeIntoFerm_l, "volume_into_fermenter", var);
 
    if ( loading )
       return;
@@ -273,7 +274,7 @@ void BrewNote::setVolumeIntoFerm_l(double var)
 
 void BrewNote::setFg(double var)
 {
-   set("fg", "fg", var);
+   set(PropertyIds::BrewNote::fg, "fg", var);
 
    if ( loading )
       return;
@@ -297,7 +298,7 @@ void BrewNote::setProjPoints(double var)
       convertPnts = (total_g - 1.0 ) * 1000;
    }
 
-   set("projPoints", "projected_points", convertPnts);
+   set(PropertyIds::BrewNote::projPoints, "projected_points", convertPnts);
 }
 
 void BrewNote::setProjFermPoints(double var)
@@ -314,28 +315,28 @@ void BrewNote::setProjFermPoints(double var)
       convertPnts = (total_g - 1.0 ) * 1000;
    }
 
-   set("projPoints", "projected_ferm_points", convertPnts);
+   set(PropertyIds::BrewNote::projPoints, "projected_ferm_points", convertPnts);
 }
 
-void BrewNote::setABV(double var)               { set("abv", "abv", var); }
-void BrewNote::setEffIntoBK_pct(double var)     { set("effIntoBK_pct", "eff_into_bk", var); }
-void BrewNote::setBrewhouseEff_pct(double var)  { set("brewhouseEff_pct", "brewhouse_eff", var); }
-void BrewNote::setStrikeTemp_c(double var)      { set("strikeTemp_c", "strike_temp", var); }
-void BrewNote::setMashFinTemp_c(double var)     { set("mashFinTemp_c", "mash_final_temp", var); }
-void BrewNote::setPostBoilVolume_l(double var)  { set("postBoilVolume_l", "post_boil_volume", var); }
-void BrewNote::setPitchTemp_c(double var)       { set("pitchTemp_c", "pitch_temp", var); }
-void BrewNote::setFinalVolume_l(double var)     { set("finalVolume_l", "final_volume", var); }
-void BrewNote::setProjBoilGrav(double var)      { set("projBoilGrav", "projected_boil_grav", var); }
-void BrewNote::setProjVolIntoBK_l(double var)   { set("projVolIntoBK_l", "projected_vol_into_bk", var); }
-void BrewNote::setProjStrikeTemp_c(double var)  { set("projStrikeTemp_c", "projected_strike_temp", var); }
-void BrewNote::setProjMashFinTemp_c(double var) { set("projMashFinTemp_c", "projected_mash_fin_temp", var); }
-void BrewNote::setProjOg(double var)            { set("projOg", "projected_og", var); }
-void BrewNote::setProjVolIntoFerm_l(double var) { set("projVolIntoFerm_l", "projected_vol_into_ferm", var); }
-void BrewNote::setProjFg(double var)            { set("projFg", "projected_fg", var); }
-void BrewNote::setProjEff_pct(double var)       { set("projEff_pct", "projected_eff", var); }
-void BrewNote::setProjABV_pct(double var)       { set("projABV_pct", "projected_abv", var); }
-void BrewNote::setProjAtten(double var)         { set("projAtten", "projected_atten", var); }
-void BrewNote::setBoilOff_l(double var)         { set("boilOff_l", "boil_off", var); }
+void BrewNote::setABV(double var)               { set(PropertyIds::BrewNote::abv, "abv", var); }
+void BrewNote::setEffIntoBK_pct(double var)     { set(PropertyIds::BrewNote::effIntoBK_pct, "eff_into_bk", var); }
+void BrewNote::setBrewhouseEff_pct(double var)  { set(PropertyIds::BrewNote::brewhouseEff_pct, "brewhouse_eff", var); }
+void BrewNote::setStrikeTemp_c(double var)      { set(PropertyIds::BrewNote::strikeTemp_c, "strike_temp", var); }
+void BrewNote::setMashFinTemp_c(double var)     { set(PropertyIds::BrewNote::mashFinTemp_c, "mash_final_temp", var); }
+void BrewNote::setPostBoilVolume_l(double var)  { set(PropertyIds::BrewNote::postBoilVolume_l, "post_boil_volume", var); }
+void BrewNote::setPitchTemp_c(double var)       { set(PropertyIds::BrewNote::pitchTemp_c, "pitch_temp", var); }
+void BrewNote::setFinalVolume_l(double var)     { set(PropertyIds::BrewNote::finalVolume_l, "final_volume", var); }
+void BrewNote::setProjBoilGrav(double var)      { set(PropertyIds::BrewNote::projBoilGrav, "projected_boil_grav", var); }
+void BrewNote::setProjVolIntoBK_l(double var)   { set(PropertyIds::BrewNote::projVolIntoBK_l, "projected_vol_into_bk", var); }
+void BrewNote::setProjStrikeTemp_c(double var)  { set(PropertyIds::BrewNote::projStrikeTemp_c, "projected_strike_temp", var); }
+void BrewNote::setProjMashFinTemp_c(double var) { set(PropertyIds::BrewNote::projMashFinTemp_c, "projected_mash_fin_temp", var); }
+void BrewNote::setProjOg(double var)            { set(PropertyIds::BrewNote::projOg, "projected_og", var); }
+void BrewNote::setProjVolIntoFerm_l(double var) { set(PropertyIds::BrewNote::projVolIntoFerm_l, "projected_vol_into_ferm", var); }
+void BrewNote::setProjFg(double var)            { set(PropertyIds::BrewNote::projFg, "projected_fg", var); }
+void BrewNote::setProjEff_pct(double var)       { set(PropertyIds::BrewNote::projEff_pct, "projected_eff", var); }
+void BrewNote::setProjABV_pct(double var)       { set(PropertyIds::BrewNote::projABV_pct, "projected_abv", var); }
+void BrewNote::setProjAtten(double var)         { set(PropertyIds::BrewNote::projAtten, "projected_atten", var); }
+void BrewNote::setBoilOff_l(double var)         { set(PropertyIds::BrewNote::boilOff_l, "boil_off", var); }
 
 // Getters
 QDateTime BrewNote::brewDate()      const { return QDateTime::fromString(get("brewDate").toString(),Qt::ISODate); }
@@ -47,11 +47,14 @@
 #include <QPixmap>
 #include <QSplashScreen>
 #include <QSettings>
+#include <QHash>
+#include <QPrinter>
 
 #include "brewtarget.h"
 #include "config.h"
 #include "database.h"
 #include "Algorithms.h"
+#include "BtLocale.h"
 #include "fermentable.h"
 #include "UnitSystem.h"
 #include "UnitSystems.h"
@@ -75,6 +78,11 @@
 #include "mash.h"
 #include "instruction.h"
 #include "water.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "RecipeFormatter.h"
+#include "PrintPipeline.h"
+#include "recipe.h"
 
 // Needed for kill(2)
 #if defined(Q_OS_UNIX)
@@ -228,6 +236,9 @@ void Brewtarget::setLanguage(QString twoLetterLanguage)
    if( btTrans->load( filename, translations.canonicalPath() ) )
       qApp->installTranslator(btTrans);
 
+   // Cheap, and the next number anybody reads picks up whatever changed
+   BtLocale::localeChanged();
+
 }
 
 const QString& Brewtarget::getCurrentLanguage()
@@ -374,6 +385,8 @@ QDir Brewtarget::getUserDataDir()
 
 bool Brewtarget::initialize(const QString &userDirectory)
 {
+   TraceSpan span("Brewtarget::initialize", "startup");
+
    // Need these for changed(QMetaProperty,QVariant) to be emitted across threads.
    qRegisterMetaType<QMetaProperty>();
    qRegisterMetaType<Equipment*>();
@@ -422,7 +435,10 @@ bool Brewtarget::initialize(const QString &userDirectory)
       setOption("user_data_dir", userDataDir.canonicalPath());
    }
 
-   loadTranslations(); // Do internationalization.
+   {
+      TraceSpan translating("Brewtarget::loadTranslations", "startup");
+      loadTranslations(); // Do internationalization.
+   }
 
 #if defined(Q_OS_MAC)
    qt_set_sequence_auto_mnemonic(true); // turns on Mac Keyboard shortcuts
@@ -493,6 +509,9 @@ QString Brewtarget::dbFalse(Brewtarget::DBTypes type)
 void Brewtarget::cleanup()
 {
    log.info("Brewtarget is cleaning up.");
+   if ( MemoryAccounting::dumpAtExit() )
+      QTextStream(stdout) << MemoryAccounting::text() << endl;
+
    // Should I do qApp->removeTranslator() first?
    delete defaultTrans;
    delete btTrans;
@@ -500,6 +519,9 @@ void Brewtarget::cleanup()
 
    Database::dropInstance();
 
+   // The writer thread lives until static destruction, but don't bet the
+   // last few lines on that going well
+   log.flush();
 }
 
 bool Brewtarget::isInteractive() {
@@ -523,9 +545,20 @@ int Brewtarget::run(const QString &userDirectory)
       return 1;
    }
    log.info("Starting Brewtarget.");
-   _mainWindow = new MainWindow();
-   _mainWindow->setVisible(true);
-   splashScreen.finish(_mainWindow);
+   {
+      TraceSpan building("MainWindow::MainWindow", "startup");
+      _mainWindow = new MainWindow();
+   }
+   {
+      TraceSpan showing("MainWindow first show", "startup");
+      _mainWindow->setVisible(true);
+      splashScreen.finish(_mainWindow);
+      // Only so the span covers the first paint. Startup shouldn't change
+      // because someone asked for a trace
+      if( Trace::isEnabled() )
+         qApp->processEvents();
+   }
+   Trace::instant("MainWindow shown", "startup");
    QObject::connect( &log, SIGNAL(wroteEntry(const QString)), _mainWindow, SLOT(updateStatus(const QString)) );
 
    checkForNewVersion(_mainWindow);
@@ -538,6 +571,60 @@ int Brewtarget::run(const QString &userDirectory)
    return ret;
 }
 
+int Brewtarget::printPdf(const QString &userDirectory, const QString &fileName, const QStringList &names, bool brewSheets)
+{
+   QMultiHash<QString, Recipe*> byName;
+   QList<Recipe*> recipes;
+   bool ok;
+
+   // Nobody is there to click on anything
+   setInteractive(false);
+   if( !initialize(userDirectory) )
+   {
+      cleanup();
+      return 1;
+   }
+
+   foreach( Recipe* rec, Database::instance().recipes() )
+   {
+      if( rec->display() )
+         byName.insert(rec->name(), rec);
+   }
+
+   // In the order asked for. values() has the last one in first
+   foreach( QString const& name, names )
+   {
+      QList<Recipe*> found = byName.values(name);
+      if( found.isEmpty() )
+         logW(QString("No recipe called \"%1\" to print").arg(name));
+      for( int i = found.size() - 1; i >= 0; --i )
+         recipes.append(found.at(i));
+   }
+
+   if( recipes.isEmpty() )
+   {
+      logE(QString("Nothing to print to %1").arg(fileName));
+      cleanup();
+      return 1;
+   }
+
+   // The pipeline has to be gone before the database is
+   {
+      QPrinter printer(QPrinter::HighResolution);
+      printer.setOutputFormat(QPrinter::PdfFormat);
+      printer.setOutputFileName(fileName);
+
+      PrintPipeline pipeline;
+      QObject::connect( &pipeline, &PrintPipeline::progress, [&recipes](int done, int total) {
+         QTextStream(stdout) << QString("Printed %1 of %2: %3").arg(done).arg(total).arg(recipes.at(done-1)->name()) << endl;
+      });
+      ok = pipeline.exec(recipes, &printer, brewSheets ? PrintPipeline::BREWDAY : PrintPipeline::RECIPE);
+   }
+
+   cleanup();
+   return ok ? 0 : 1;
+}
+
 // Read the old options.xml file one more time, then move it out of the way.
 void Brewtarget::convertPersistentOptions()
 {
@@ -982,45 +1069,25 @@ void Brewtarget::logW( QString message )
    log.warn(message);
 }
 
-/* Qt5 changed how QString::toDouble() works in that it will always convert
-   in the C locale. We are instructed to use QLocale::toDouble instead, except
-   that will never fall back to the C locale. This doesn't really work for us,
-   so I am writing a convenience function that emulates the old behavior.
-*/
+// BtLocale has the gory details, and keeps the QLocale around between calls
 double Brewtarget::toDouble(QString text, bool* ok)
 {
-   double ret = 0.0;
-   bool success = false;
-   QLocale sysDefault = QLocale();
-
-   ret = sysDefault.toDouble(text,&success);
-
-   // If we failed, try C conversion
-   if ( ! success ) 
-      ret = text.toDouble(&success);
-
-   // If we were asked to return the success, return it here.
-   if ( ok != NULL )
-      *ok = success;
-
-   // Whatever we got, we return it
-   return ret;
+   return BtLocale::toDouble(text, ok);
 }
 
 // And a few convenience methods, just for that sweet, sweet syntatic sugar
 double Brewtarget::toDouble(const BeerXMLElement* element, QString attribute, QString caller)
 {
    double amount = 0.0;
-   QString value;
    bool ok = false;
+   QVariant value = element->property(attribute.toLatin1().constData());
 
-   if ( element->property(attribute.toLatin1().constData()).canConvert(QVariant::String) )
+   if ( value.canConvert(QVariant::String) )
    {
       // Get the amount
-      value = element->property(attribute.toLatin1().constData()).toString();
-      amount = toDouble( value, &ok );
+      amount = variantToDouble( value, &ok );
       if ( ! ok )
-         logW( QString("%1 could not convert %2 to double").arg(caller).arg(value));
+         logW( QString("%1 could not convert %2 to double").arg(caller).arg(value.toString()));
       // Get the display units and scale
    }
    return amount;
@@ -1040,11 +1107,28 @@ double Brewtarget::toDouble(QString text, QString caller)
 }
 
 
+double Brewtarget::variantToDouble(QVariant const& value, bool* ok)
+{
+   // Numbers stay numbers. Turning them into C locale text and reading that
+   // back in the user's locale is slow, and wrong where '.' groups digits
+   switch( static_cast<int>(value.type()) )
+   {
+      case QMetaType::Double:
+      case QMetaType::Float:
+      case QMetaType::Int:
+      case QMetaType::UInt:
+      case QMetaType::LongLong:
+      case QMetaType::ULongLong:
+         return value.toDouble(ok);
+      default:
+         return toDouble( value.toString(), ok );
+   }
+}
+
 // Displays "amount" of units "units" in the proper format.
 // If "units" is null, just return the amount.
 QString Brewtarget::displayAmount( double amount, Unit* units, int precision, Unit::unitDisplay displayUnits, Unit::unitScale displayScale)
 {
-   int fieldWidth = 0;
    char format = 'f';
    UnitSystem* temp;
 
@@ -1054,7 +1138,7 @@ QString Brewtarget::displayAmount( double amount, Unit* units, int precision, Un
 
    // Special case.
    if( units == 0 )
-      return QString("%L1").arg(amount, fieldWidth, format, precision);
+      return BtLocale::toString(amount, format, precision);
 
    QString SIUnitName = units->getSIUnitName();
    double SIAmount = units->toSI( amount );
@@ -1064,7 +1148,7 @@ QString Brewtarget::displayAmount( double amount, Unit* units, int precision, Un
    temp = findUnitSystem(units, displayUnits);
    // If we cannot find a unit system
    if ( temp == 0 )
-      ret = QString("%L1 %2").arg(SIAmount, fieldWidth, format, precision).arg(SIUnitName);
+      ret = BtLocale::toString(SIAmount, format, precision) + " " + SIUnitName;
    else
       ret = temp->displayAmount( amount, units, precision, displayScale );
 
@@ -1074,18 +1158,17 @@ QString Brewtarget::displayAmount( double amount, Unit* units, int precision, Un
 QString Brewtarget::displayAmount(BeerXMLElement* element, QObject* object, QString attribute, Unit* units, int precision )
 {
    double amount = 0.0;
-   QString value;
    bool ok = false;
    Unit::unitScale dispScale;
    Unit::unitDisplay dispUnit;
+   QVariant value = element->property(attribute.toLatin1().constData());
 
-   if ( element->property(attribute.toLatin1().constData()).canConvert(QVariant::Double) )
+   if ( value.canConvert(QVariant::Double) )
    {
       // Get the amount
-      value = element->property(attribute.toLatin1().constData()).toString();
-      amount = toDouble( value, &ok );
+      amount = variantToDouble( value, &ok );
       if ( ! ok )
-         logW( QString("Brewtarget::displayAmount(BeerXMLElement*,QObject*,QString,Unit*,int) could not convert %1 to double").arg(value));
+         logW( QString("Brewtarget::displayAmount(BeerXMLElement*,QObject*,QString,Unit*,int) could not convert %1 to double").arg(value.toString()));
       // Get the display units and scale
       dispUnit  = (Unit::unitDisplay)option(attribute, Unit::noUnit,  object->objectName(), UNIT).toInt();
       dispScale = (Unit::unitScale)option(  attribute, Unit::noScale, object->objectName(), SCALE).toInt();
@@ -1140,18 +1223,17 @@ double Brewtarget::amountDisplay( double amount, Unit* units, int precision, Uni
 double Brewtarget::amountDisplay(BeerXMLElement* element, QObject* object, QString attribute, Unit* units, int precision )
 {
    double amount = 0.0;
-   QString value;
    bool ok = false;
    Unit::unitScale dispScale;
    Unit::unitDisplay dispUnit;
+   QVariant value = element->property(attribute.toLatin1().constData());
 
-   if ( element->property(attribute.toLatin1().constData()).canConvert(QVariant::Double) )
+   if ( value.canConvert(QVariant::Double) )
    {
       // Get the amount
-      value = element->property(attribute.toLatin1().constData()).toString();
-      amount = toDouble( value, &ok );
+      amount = variantToDouble( value, &ok );
       if ( ! ok )
-         logW( QString("Brewtarget::amountDisplay(BeerXMLElement*,QObject*,QString,Unit*,int) could not convert %1 to double").arg(value));
+         logW( QString("Brewtarget::amountDisplay(BeerXMLElement*,QObject*,QString,Unit*,int) could not convert %1 to double").arg(value.toString()));
       // Get the display units and scale
       dispUnit  = (Unit::unitDisplay)option(attribute, Unit::noUnit,  object->objectName(), UNIT).toInt();
       dispScale = (Unit::unitScale)option(  attribute, Unit::noScale, object->objectName(), SCALE).toInt();
@@ -1352,6 +1434,10 @@ void Brewtarget::setOption(QString attribute, QVariant value, const QString sect
       name = generateName(attribute,section,ops);
 
    QSettings().setValue(name,value);
+
+   // Somebody picked other units for a field, which the printouts show too
+   if ( ops != NOOP )
+      RecipeFormatter::invalidateAll();
 }
 
 QVariant Brewtarget::option(QString attribute, QVariant default_value, QString section, iUnitOps ops)
@@ -44,6 +44,7 @@ extern void qt_set_sequence_auto_mnemonic(bool b);
 #include <QMenu>
 #include <QMetaProperty>
 #include <QList>
+#include <QStringList>
 #include "UnitSystem.h"
 #include "Log.h"
 
@@ -178,10 +179,18 @@ public:
     * \return Exit code from the application.
     */
    static int run(const QString &userDirectory = QString());
+   /*!
+    * \brief Prints the recipes called \b names into the PDF \b fileName,
+    * with no window. Brew day sheets instead of recipes if \b brewSheets.
+    * \return Exit code, 0 if everything got printed.
+    */
+   static int printPdf(const QString &userDirectory, const QString &fileName, const QStringList &names, bool brewSheets = false);
 
    static double toDouble(QString text, bool* ok = 0);
    static double toDouble(const BeerXMLElement* element, QString attribute, QString caller);
    static double toDouble(QString text, QString caller);
+   //! \brief A QVariant as a double, skipping the text if it already is a number
+   static double variantToDouble(QVariant const& value, bool* ok = 0);
 
    //! \brief Log an error message.
    static void logE( QString message );
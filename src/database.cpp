@@ -52,6 +52,11 @@
 #include <QInputDialog>
 #include <QCryptographicHash>
 #include <QPair>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QVarLengthArray>
 
 #include "Algorithms.h"
 #include "brewnote.h"
@@ -101,12 +106,16 @@ Database::Database()
    _threadToConnectionMutex.lock();
 
    converted = false;
+   batchDepth = 0;
 
    loadWasSuccessful = load();
+
+   MemoryAccounting::addSource(this, [this]() { return memoryReport(); });
 }
 
 Database::~Database()
 {
+   MemoryAccounting::removeSources(this);
 
    // If we have not explicitly unloaded, do so now and discard changes.
    if( QSqlDatabase::database( dbConName, false ).isOpen() )
@@ -169,6 +178,10 @@ bool Database::loadSQLite()
       Brewtarget::lastDbMergeRequest = QDateTime::currentDateTime();
    }
 
+   // Has to be taken before we open it. Anything we write from here on
+   // bumps the change counter
+   dbStamp = DatabaseSnapshot::stamp(dbFileName);
+
    // Open SQLite db.
    sqldb = QSqlDatabase::addDatabase("QSQLITE");
    sqldb.setDatabaseName(dbFileName);
@@ -274,11 +287,13 @@ bool Database::loadPgSQL()
 
 bool Database::load()
 {
+   TraceSpan span("Database::load", "db");
    bool dbIsOpen;
    QSqlDatabase sqldb;
 
    createFromScratch=false;
    schemaUpdated=false;
+   dbStamp.clear();
 
    if ( Brewtarget::dbType() == Brewtarget::PGSQL )
    {
@@ -309,7 +324,10 @@ bool Database::load()
    // Update the database if need be. This has to happen before we do anything
    // else or we dump core
    bool schemaErr = false;
-   schemaUpdated = updateSchema(&schemaErr);
+   {
+      TraceSpan updating("Database::updateSchema", "db");
+      schemaUpdated = updateSchema(&schemaErr);
+   }
 
    // Since updateSchema could add new tables, we have to wait until this
    // point to populate the tables.
@@ -348,28 +366,59 @@ bool Database::load()
          == QMessageBox::Yes
       ) {
          updateDatabase(dataDbFile.fileName());
+         dbStamp.clear();
       }
 
       // Update this field.
       Brewtarget::lastDbMergeRequest = QDateTime::currentDateTime();
    }
 
+   // If the db is exactly as we left it, last shutdown already wrote down
+   // everything below. A new or upgraded schema means we touched the file,
+   // so the stamp won't do.
+   DatabaseSnapshot* snap = 0;
+   if ( ! createFromScratch && ! schemaUpdated && ! dbStamp.isEmpty() )
+   {
+      TraceSpan reading("Database::load snapshot", "db");
+      snap = DatabaseSnapshot::load(snapshotFileName(), dbStamp);
+   }
+   Brewtarget::log.info( QString("%1: %2").arg(Q_FUNC_INFO).arg(snap ? "loading from snapshot" : "no usable snapshot, loading from the db"));
+
    // Create and store all pointers.
-   populateElements( allBrewNotes, Brewtarget::BREWNOTETABLE );
-   populateElements( allEquipments, Brewtarget::EQUIPTABLE );
-   populateElements( allFermentables, Brewtarget::FERMTABLE );
-   populateElements( allHops, Brewtarget::HOPTABLE );
-   populateElements( allInstructions, Brewtarget::INSTRUCTIONTABLE );
-   populateElements( allMashs, Brewtarget::MASHTABLE );
-   populateElements( allMashSteps, Brewtarget::MASHSTEPTABLE );
-   populateElements( allMiscs, Brewtarget::MISCTABLE );
-   populateElements( allStyles, Brewtarget::STYLETABLE );
-   populateElements( allWaters, Brewtarget::WATERTABLE );
-   populateElements( allYeasts, Brewtarget::YEASTTABLE );
-
-   populateElements( allRecipes, Brewtarget::RECTABLE );
+   populateElements( allBrewNotes, Brewtarget::BREWNOTETABLE, snap );
+   populateElements( allEquipments, Brewtarget::EQUIPTABLE, snap );
+   populateStore( Brewtarget::FERMTABLE, snap );
+   populateStore( Brewtarget::HOPTABLE, snap );
+   populateElements( allInstructions, Brewtarget::INSTRUCTIONTABLE, snap );
+   populateElements( allMashs, Brewtarget::MASHTABLE, snap );
+   populateElements( allMashSteps, Brewtarget::MASHSTEPTABLE, snap );
+   populateStore( Brewtarget::MISCTABLE, snap );
+   populateElements( allStyles, Brewtarget::STYLETABLE, snap );
+   populateElements( allWaters, Brewtarget::WATERTABLE, snap );
+   populateStore( Brewtarget::YEASTTABLE, snap );
+
+   populateElements( allRecipes, Brewtarget::RECTABLE, snap );
+
+   if ( snap )
+   {
+      foreach( Brewtarget::DBTable table, QList<Brewtarget::DBTable>() << Brewtarget::FERMTABLE << Brewtarget::HOPTABLE << Brewtarget::MISCTABLE << Brewtarget::YEASTTABLE )
+      {
+         Brewtarget::DBTable invtable = tableToInventoryTable[table];
+         inventoryKeys[table] = snap->inventoryKeys.value(table);
+         inventoryValues[invtable] = snap->inventoryValues.value(invtable);
+      }
+      snapshotCalcCaches = snap->calcCaches;
+   }
+   else
+   {
+      populateInventory( Brewtarget::FERMTABLE );
+      populateInventory( Brewtarget::HOPTABLE );
+      populateInventory( Brewtarget::MISCTABLE );
+      populateInventory( Brewtarget::YEASTTABLE );
+   }
 
    // Connect fermentable,hop changed signals to their parent recipe.
+   TraceSpan wiring("Database::load signal wiring", "db");
    QHash<int,Recipe*>::iterator i;
    QList<Fermentable*>::iterator j;
    QList<Hop*>::iterator k;
@@ -380,7 +429,14 @@ bool Database::load()
 
    for( i = allRecipes.begin(); i != allRecipes.end(); i++ )
    {
-      Equipment* e = equipment(*i);
+      Equipment* e;
+      if ( snap )
+      {
+         QList<Equipment*> tmpE = snapshotChildren( snap, Brewtarget::EQUIPTABLE, (*i)->_key, allEquipments );
+         e = tmpE.isEmpty() ? 0 : tmpE.first();
+      }
+      else
+         e = equipment(*i);
       if( e )
       {
          connect( e, SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptEquipChange(QMetaProperty,QVariant)) );
@@ -388,29 +444,39 @@ bool Database::load()
          connect( e, SIGNAL(changedBoilTime_min(double)), *i, SLOT(setBoilTime_min(double)));
       }
 
-      QList<Fermentable*> tmpF = fermentables(*i);
+      QList<Fermentable*> tmpF = snap ? snapshotChildren( snap, Brewtarget::FERMTABLE, (*i)->_key, allFermentables ) : fermentables(*i);
       for( j = tmpF.begin(); j != tmpF.end(); ++j )
          connect( *j, SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptFermChange(QMetaProperty,QVariant)) );
 
-      QList<Hop*> tmpH = hops(*i);
+      QList<Hop*> tmpH = snap ? snapshotChildren( snap, Brewtarget::HOPTABLE, (*i)->_key, allHops ) : hops(*i);
       for( k = tmpH.begin(); k != tmpH.end(); ++k )
          connect( *k, SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptHopChange(QMetaProperty,QVariant)) );
 
-      QList<Yeast*> tmpY = yeasts(*i);
+      QList<Yeast*> tmpY = snap ? snapshotChildren( snap, Brewtarget::YEASTTABLE, (*i)->_key, allYeasts ) : yeasts(*i);
       for( l = tmpY.begin(); l != tmpY.end(); ++l )
          connect( *l, SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptYeastChange(QMetaProperty,QVariant)) );
 
-      connect( mash(*i), SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptMashChange(QMetaProperty,QVariant)) );
+      Mash* ma;
+      if ( snap )
+      {
+         QList<Mash*> tmpMa = snapshotChildren( snap, Brewtarget::MASHTABLE, (*i)->_key, allMashs );
+         ma = tmpMa.isEmpty() ? 0 : tmpMa.first();
+      }
+      else
+         ma = mash(*i);
+      connect( ma, SIGNAL(changed(QMetaProperty,QVariant)), *i, SLOT(acceptMashChange(QMetaProperty,QVariant)) );
    }
 
    QList<Mash*> tmpM = mashs();
    for( m = tmpM.begin(); m != tmpM.end(); ++m )
    {
-      QList<MashStep*> tmpMS = mashSteps(*m);
+      QList<MashStep*> tmpMS = snap ? snapshotChildren( snap, Brewtarget::MASHSTEPTABLE, (*m)->_key, allMashSteps ) : mashSteps(*m);
       for( n=tmpMS.begin(); n != tmpMS.end(); ++n)
          connect( *n, SIGNAL(changed(QMetaProperty,QVariant)), *m, SLOT(acceptMashStepChange(QMetaProperty,QVariant)) );
    }
 
+   delete snap;
+   logElementMemory();
    return true;
 }
 
@@ -537,21 +603,127 @@ QSqlDatabase Database::sqlDatabase()
    return sqldb;
 }
 
+int Database::StatementCache::columnId( QByteArray const& columns )
+{
+   QHash<QByteArray,int>::const_iterator it = columnIds.constFind(columns);
+   if ( it != columnIds.constEnd() )
+      return it.value();
+
+   // columns is usually raw data over somebody else's buffer. Keep a copy
+   int id = columnIds.size();
+   columnIds.insert( QByteArray(columns.constData(), columns.size()), id );
+   return id;
+}
+
+Database::StatementCache& Database::statementCache()
+{
+   if ( ! statements.hasLocalData() )
+      statements.setLocalData(new StatementCache);
+
+   StatementCache* cache = statements.localData();
+   int generation = statementGeneration.load();
+   if ( cache->generation != generation ) {
+      cache->select.clear();
+      cache->generation = generation;
+   }
+   return *cache;
+}
+
+QSqlQuery& Database::selectStatement( Brewtarget::DBTable table, QByteArray const& columns )
+{
+   StatementCache& cache = statementCache();
+   quint32 index = (static_cast<quint32>(cache.columnId(columns)) << 8) | static_cast<quint32>(table);
+
+   QHash<quint32,QSqlQuery>::iterator it = cache.select.find(index);
+   if ( it == cache.select.end() ) {
+      QSqlQuery q( sqlDatabase() );
+      q.setForwardOnly(true);
+      q.prepare( QString("SELECT %1 from %2 WHERE id=:id")
+                   .arg(QString::fromLatin1(columns))
+                   .arg(tableNames[table]) );
+      it = cache.select.insert(index, q);
+   }
+   return it.value();
+}
+
+QVariant Database::get( Brewtarget::DBTable table, int key, const char* col_name )
+{
+   TraceSpan span("Database::get", "sql", Trace::isEnabled() ? QString("%1_%2").arg(tableNames[table]).arg(col_name) : QString());
+
+   QSqlQuery& q = selectStatement( table, QByteArray::fromRawData(col_name, qstrlen(col_name)) );
+   q.bindValue(0, key);
+
+   if( !q.exec() || !q.next() )
+   {
+      Brewtarget::logE( QString("Database::get(): %1 (%2) %3").arg(q.lastQuery()).arg(col_name).arg(q.lastError().text()));
+      q.finish();
+      return QVariant();
+   }
+
+   QVariant ret( q.value(0) );
+   q.finish();
+   return ret;
+}
+
+QVector<QVariant> Database::get( Brewtarget::DBTable table, int key, QVector<const char*> const& col_names )
+{
+   QVarLengthArray<char,256> columns;
+   for ( int i = 0; i < col_names.size(); ++i ) {
+      if ( i > 0 )
+         columns.append(',');
+      columns.append( col_names[i], qstrlen(col_names[i]) );
+   }
+   TraceSpan span("Database::get", "sql", Trace::isEnabled() ? QString("%1_%2").arg(tableNames[table]).arg(QString::fromLatin1(columns.constData(), columns.size())) : QString());
+
+   QVector<QVariant> ret(col_names.size());
+   QSqlQuery& q = selectStatement( table, QByteArray::fromRawData(columns.constData(), columns.size()) );
+   q.bindValue(0, key);
+
+   if( !q.exec() || !q.next() )
+   {
+      Brewtarget::logE( QString("Database::get(): %1 %2").arg(q.lastQuery()).arg(q.lastError().text()));
+      q.finish();
+      return ret;
+   }
+
+   for ( int i = 0; i < ret.size(); ++i )
+      ret[i] = q.value(i);
+   q.finish();
+   return ret;
+}
+
 void Database::unload()
 {
 
 
-   // selectSome saves context. If we close the database before we tear that
-   // context down, core gets dumped
-   selectSome.clear();
+   // Read what the next start needs while we still can. The stamp has to
+   // wait until the file is closed and nothing else can be written
+   DatabaseSnapshot* snap = 0;
+   if (loadWasSuccessful && Brewtarget::dbType() == Brewtarget::SQLITE )
+   {
+      TraceSpan span("Database::takeSnapshot", "db");
+      snap = takeSnapshot();
+   }
+
+   // The prepared statements save context. If we close the database before
+   // we tear that context down, core gets dumped. Other threads drop theirs
+   // the next time they look
+   statementCache().select.clear();
+   statementGeneration.ref();
+   inventoryKeys.clear();
+   inventoryValues.clear();
+   snapshotCalcCaches.clear();
    QSqlDatabase::database( dbConName, false ).close();
    QSqlDatabase::removeDatabase( dbConName );
 
    if (loadWasSuccessful && Brewtarget::dbType() == Brewtarget::SQLITE )
    {
       dbFile.close();
+      if ( snap && ! snap->save(snapshotFileName(), DatabaseSnapshot::stamp(dbFileName)) )
+         Brewtarget::logW( QString("%1: could not write %2").arg(Q_FUNC_INFO).arg(snapshotFileName()));
       automaticBackup();
    }
+   delete snap;
 }
 
 void Database::automaticBackup()
@@ -610,15 +782,15 @@ void Database::automaticBackup()
    while ( fileNames.size() > maxBackups ) {
       // takeFirst() removes the file from the list, which is important
       QString victim = backupDir + "/" + fileNames.takeFirst();
-      QFile *file = new QFile(victim);
-      QFileInfo *fileThing = new QFileInfo(victim);
+      QFile file(victim);
+      QFileInfo fileThing(victim);
 
       // Make sure it exists, and make sure it is a file before we
       // try remove it
-      if ( fileThing->exists() && fileThing->isFile() ) {
+      if ( fileThing.exists() && fileThing.isFile() ) {
          // If we can't remove it, give a warning.
-         if (! file->remove() ) {
-            Brewtarget::logW( QString("%1 : could not remove %2 (%3).").arg(Q_FUNC_INFO).arg(victim).arg(file->error()));
+         if (! file.remove() ) {
+            Brewtarget::logW( QString("%1 : could not remove %2 (%3).").arg(Q_FUNC_INFO).arg(victim).arg(file.error()));
          }
       }
    }
@@ -845,13 +1017,196 @@ Recipe* Database::getParentRecipe( BrewNote const* note )
    return allRecipes[key];
 }
 
+QString Database::recipeFingerprint( Recipe const* rec )
+{
+   QCryptographicHash hash(QCryptographicHash::Sha1);
+   QStringList queries;
+   QSqlQuery q(sqlDatabase());
+   q.setForwardOnly(true);
+
+   // The order matters, but only in that it has to be the same every time
+   queries << QString("SELECT * FROM recipe WHERE id = %1").arg(rec->_key)
+           << QString("SELECT f.* FROM fermentable_in_recipe r JOIN fermentable f ON f.id = r.fermentable_id WHERE r.recipe_id = %1 ORDER BY r.id").arg(rec->_key)
+           << QString("SELECT h.* FROM hop_in_recipe r JOIN hop h ON h.id = r.hop_id WHERE r.recipe_id = %1 ORDER BY r.id").arg(rec->_key)
+           << QString("SELECT y.* FROM yeast_in_recipe r JOIN yeast y ON y.id = r.yeast_id WHERE r.recipe_id = %1 ORDER BY r.id").arg(rec->_key)
+           << QString("SELECT e.* FROM recipe r JOIN equipment e ON e.id = r.equipment_id WHERE r.id = %1").arg(rec->_key)
+           << QString("SELECT m.* FROM recipe r JOIN mash m ON m.id = r.mash_id WHERE r.id = %1").arg(rec->_key)
+           << QString("SELECT s.* FROM recipe r JOIN mashstep s ON s.mash_id = r.mash_id WHERE r.id = %1 ORDER BY s.id").arg(rec->_key);
+
+   try {
+      for ( int n = 0; n < queries.size(); ++n ) {
+         if ( ! q.exec(queries.at(n)) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+         while ( q.next() ) {
+            QSqlRecord here = q.record();
+            for ( int i = 0; i < here.count(); ++i ) {
+               QString field = here.fieldName(i);
+               // Don't fingerprint the fingerprint. og and fg are answers,
+               // written back to the recipe row once they are worked out,
+               // so they can't be part of the question either
+               if ( field == "calc_cache" || (n == 0 && (field == "og" || field == "fg")) )
+                  continue;
+               hash.addData( field.toUtf8() );
+               hash.addData( "=" );
+               hash.addData( here.value(i).toString().toUtf8() );
+               hash.addData( ";" );
+            }
+         }
+         hash.addData( "|" );
+      }
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      q.finish();
+      // Nothing will ever match this, so everything just gets recalculated
+      return QString();
+   }
+   q.finish();
+
+   hash.addData( Brewtarget::ibuFormulaName().toUtf8() );
+   hash.addData( Brewtarget::colorFormulaName().toUtf8() );
+   hash.addData( Brewtarget::option("firstWortHopAdjustment", 1.1).toString().toUtf8() );
+   hash.addData( Brewtarget::option("mashHopAdjustment", 0).toString().toUtf8() );
+
+   return QString(hash.result().toHex());
+}
+
+QString Database::calcCache( Recipe const* rec )
+{
+   if ( snapshotCalcCaches.contains(rec->_key) )
+      return snapshotCalcCaches.take(rec->_key);
+
+   return get( Brewtarget::RECTABLE, rec->_key, "calc_cache" ).toString();
+}
+
+void Database::setCalcCache( Recipe* rec, QString const& calcs )
+{
+   // Or the first calcCache() would hand back what this replaced
+   snapshotCalcCaches.remove(rec->_key);
+   updateEntry( Brewtarget::RECTABLE, rec->_key, "calc_cache", calcs, QMetaProperty(), rec, false );
+}
+
+void Database::beginBatch()
+{
+   if ( batchDepth++ == 0 )
+      sqlDatabase().transaction();
+}
+
+void Database::commitBatch()
+{
+   if ( batchDepth <= 0 )
+      return;
+
+   if ( --batchDepth == 0 )
+      sqlDatabase().commit();
+}
+
+void Database::rollbackBatch()
+{
+   if ( batchDepth <= 0 )
+      return;
+
+   batchDepth = 0;
+   sqlDatabase().rollback();
+}
+
+QString Database::snapshotFileName()
+{
+   return QFileInfo(dbFileName).absoluteDir().filePath("database.snapshot");
+}
+
+DatabaseSnapshot* Database::takeSnapshot()
+{
+   DatabaseSnapshot* snap = new DatabaseSnapshot();
+   QSqlDatabase sqldb = sqlDatabase();
+   QSqlQuery q(sqldb);
+   q.setForwardOnly(true);
+
+   QList<Brewtarget::DBTable> tables;
+   tables << Brewtarget::BREWNOTETABLE << Brewtarget::EQUIPTABLE << Brewtarget::FERMTABLE
+          << Brewtarget::HOPTABLE << Brewtarget::INSTRUCTIONTABLE << Brewtarget::MASHTABLE
+          << Brewtarget::MASHSTEPTABLE << Brewtarget::MISCTABLE << Brewtarget::STYLETABLE
+          << Brewtarget::WATERTABLE << Brewtarget::YEASTTABLE << Brewtarget::RECTABLE;
+
+   // child table -> how to find (parent, child) pairs
+   QList< QPair<Brewtarget::DBTable,QString> > relations;
+   relations << qMakePair(Brewtarget::FERMTABLE, QString("SELECT recipe_id, fermentable_id FROM %1").arg(tableNames[Brewtarget::FERMINRECTABLE]))
+             << qMakePair(Brewtarget::HOPTABLE, QString("SELECT recipe_id, hop_id FROM %1").arg(tableNames[Brewtarget::HOPINRECTABLE]))
+             << qMakePair(Brewtarget::YEASTTABLE, QString("SELECT recipe_id, yeast_id FROM %1").arg(tableNames[Brewtarget::YEASTINRECTABLE]))
+             << qMakePair(Brewtarget::EQUIPTABLE, QString("SELECT id, equipment_id FROM %1").arg(tableNames[Brewtarget::RECTABLE]))
+             << qMakePair(Brewtarget::MASHTABLE, QString("SELECT id, mash_id FROM %1").arg(tableNames[Brewtarget::RECTABLE]))
+             << qMakePair(Brewtarget::MASHSTEPTABLE, QString("SELECT mash_id, id FROM %1 WHERE deleted = %2 ORDER BY step_number")
+                                                        .arg(tableNames[Brewtarget::MASHSTEPTABLE]).arg(Brewtarget::dbFalse()));
+
+   try {
+      foreach( Brewtarget::DBTable table, tables ) {
+         // Not every table has every column. Ask for what's there
+         QSqlRecord fields = sqldb.record(tableNames[table]);
+         QStringList cols;
+         cols << "id";
+         foreach( QString col, QStringList() << "name" << "folder" << "display" << "deleted" )
+            cols << (fields.contains(col) ? col : QString("NULL"));
+
+         if ( ! q.exec( QString("SELECT %1 FROM %2").arg(cols.join(", ")).arg(tableNames[table]) ) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+         QVector<DatabaseSnapshot::Row>& rows = snap->rows[table];
+         while ( q.next() ) {
+            DatabaseSnapshot::Row row;
+            row.key = q.value(0).toInt();
+            row.name = q.value(1).toString();
+            row.folder = q.value(2).toString();
+            row.display = q.value(3).isNull() ? -1 : q.value(3).toBool();
+            row.deleted = q.value(4).isNull() ? -1 : q.value(4).toBool();
+            rows.append(row);
+         }
+      }
+
+      for ( int i = 0; i < relations.size(); ++i ) {
+         if ( ! q.exec(relations[i].second) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+         QHash< int, QVector<int> >& children = snap->children[relations[i].first];
+         while ( q.next() ) {
+            if ( ! q.value(1).isNull() )
+               children[q.value(0).toInt()].append(q.value(1).toInt());
+         }
+      }
+
+      if ( ! q.exec( QString("SELECT id, calc_cache FROM %1 WHERE calc_cache IS NOT NULL").arg(tableNames[Brewtarget::RECTABLE]) ) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+      while ( q.next() )
+         snap->calcCaches.insert( q.value(0).toInt(), q.value(1).toString() );
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      q.finish();
+      delete snap;
+      return 0;
+   }
+   q.finish();
+
+   // Start from scratch, so nothing stale the caches picked up goes to disk
+   inventoryKeys.clear();
+   inventoryValues.clear();
+   foreach( Brewtarget::DBTable table, QList<Brewtarget::DBTable>() << Brewtarget::FERMTABLE << Brewtarget::HOPTABLE << Brewtarget::MISCTABLE << Brewtarget::YEASTTABLE ) {
+      Brewtarget::DBTable invtable = tableToInventoryTable[table];
+      populateInventory(table);
+      snap->inventoryKeys.insert( table, inventoryKeys.value(table) );
+      snap->inventoryValues.insert( invtable, inventoryValues.value(invtable) );
+   }
+
+   return snap;
+}
+
 Recipe*      Database::recipe(int key)      { return allRecipes[key]; }
 Equipment*   Database::equipment(int key)   { return allEquipments[key]; }
-Fermentable* Database::fermentable(int key) { return allFermentables[key]; }
-Hop*         Database::hop(int key)         { return allHops[key]; }
-Misc*        Database::misc(int key)        { return allMiscs[key]; }
+Fermentable* Database::fermentable(int key) { return element(allFermentables, key); }
+Hop*         Database::hop(int key)         { return element(allHops, key); }
+Misc*        Database::misc(int key)        { return element(allMiscs, key); }
 Style*       Database::style(int key)       { return allStyles[key]; }
-Yeast*       Database::yeast(int key)       { return allYeasts[key]; }
+Yeast*       Database::yeast(int key)       { return element(allYeasts, key); }
 
 void Database::swapMashStepOrder(MashStep* m1, MashStep* m2)
 {
@@ -1232,6 +1587,129 @@ Instruction* Database::newInstruction(Recipe* rec)
    return tmp;
 }
 
+// SQLite won't bind more than 999 values in one statement, and we bind three
+// per row
+static const int instructionsPerInsert = 100;
+
+QList<Instruction*> Database::replaceInstructions(Recipe* rec, QList<Instruction::Draft> const& drafts)
+{
+   QList<Instruction*> ret;
+   QList<Instruction*> old;
+   QList<int> keys;
+   QString tName = tableNames[Brewtarget::INSTRUCTIONTABLE];
+   QString relTableName = tableNames[Brewtarget::INSTINRECTABLE];
+   // Somebody else's batch is open, and they get to commit it
+   bool transact = batchDepth == 0;
+   int maxKey = 0;
+   int i;
+
+   if ( rec == 0 )
+      return ret;
+
+   old = instructions(rec);
+
+   if ( transact )
+      sqlDatabase().transaction();
+
+   QSqlQuery q(sqlDatabase());
+   q.setForwardOnly(true);
+
+   try {
+      if ( ! q.exec( QString("DELETE FROM %1 WHERE recipe_id=%2").arg(relTableName).arg(rec->_key)) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      if ( ! old.isEmpty() ) {
+         QStringList oldKeys;
+         foreach( Instruction* ins, old )
+            oldKeys.append( QString::number(ins->_key) );
+
+         if ( ! q.exec( QString("DELETE FROM %1 WHERE id IN (%2)").arg(tName).arg(oldKeys.join(","))) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+      }
+
+      if ( ! drafts.isEmpty() ) {
+         // Same as cloneRowsInRecipe(): the new rows are the ones past the
+         // old maximum, so nobody else may take ids while we're at it
+         if ( Brewtarget::dbType() == Brewtarget::PGSQL ) {
+            if ( ! q.exec( QString("LOCK TABLE %1 IN EXCLUSIVE MODE").arg(tName)) )
+               throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+         }
+
+         if ( ! q.exec( QString("SELECT MAX(id) FROM %1").arg(tName)) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+         if ( q.next() )
+            maxKey = q.value(0).toInt();
+
+         for ( int begin = 0; begin < drafts.size(); begin += instructionsPerInsert ) {
+            int end = qMin(drafts.size(), begin + instructionsPerInsert);
+            QString values;
+
+            // Anything in a recipe is hidden
+            for ( i = begin; i < end; ++i )
+               values += QString("%1(?,?,?,%2)").arg(i == begin ? "" : ",").arg(Brewtarget::dbFalse());
+
+            q.prepare( QString("INSERT INTO %1 (name,directions,interval,display) VALUES %2").arg(tName).arg(values) );
+            for ( i = begin; i < end; ++i ) {
+               q.addBindValue( drafts.at(i).name );
+               q.addBindValue( drafts.at(i).directions );
+               q.addBindValue( drafts.at(i).interval );
+            }
+
+            if ( ! q.exec() )
+               throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+         }
+
+         if ( ! q.exec( QString("SELECT id FROM %1 WHERE id > %2 ORDER BY id").arg(tName).arg(maxKey)) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+         while ( q.next() )
+            keys.append( q.value(0).toInt() );
+
+         if ( keys.size() != drafts.size() )
+            throw QString("inserted %1 instructions but found %2").arg(drafts.size()).arg(keys.size());
+
+         // inc_ins_num numbers them in the order they go in, which is the
+         // order of the drafts
+         if ( ! q.exec( QString("INSERT INTO %1 (instruction_id, recipe_id) SELECT id, %2 FROM %3 WHERE id > %4 ORDER BY id")
+                           .arg(relTableName).arg(rec->_key).arg(tName).arg(maxKey)) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+      }
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      q.finish();
+      if ( transact )
+         sqlDatabase().rollback();
+      throw;
+   }
+
+   q.finish();
+   if ( transact )
+      sqlDatabase().commit();
+
+   foreach( Instruction* ins, old )
+      allInstructions.remove(ins->_key);
+
+   for ( i = 0; i < keys.size(); ++i ) {
+      Instruction::Draft const& draft = drafts.at(i);
+      Instruction* ins = new Instruction();
+
+      ins->_key = keys.at(i);
+      ins->_table = Brewtarget::INSTRUCTIONTABLE;
+      ins->_name = draft.name;
+      foreach( QString const& reagent, draft.reagents )
+         ins->addReagent(reagent);
+
+      allInstructions.insert(ins->_key, ins);
+      ret.append(ins);
+   }
+
+   // Everybody watching gets to redo their list once, not once per step
+   emit rec->changed( rec->metaProperty("instructions"), ret.size() );
+   emit changed( metaProperty("instructions"), QVariant() );
+
+   return ret;
+}
+
 int Database::instructionNumber(Instruction const* in)
 {
    QSqlQuery q(
@@ -1429,13 +1907,16 @@ Recipe* Database::newRecipe(Recipe* other)
    try {
       tmp = copy<Recipe>(other, true, &allRecipes);
 
-      // Copy fermentables, hops, miscs and yeasts. We've the convenience
-      // methods, so use them? And now I have to instruct all of them to not do
-      // transactions either. -4 SAN points!
-      addToRecipe( tmp, other->fermentables(), false);
-      addToRecipe( tmp, other->hops(), false);
-      addToRecipe( tmp, other->miscs(), false);
-      addToRecipe( tmp, other->yeasts(), false);
+      // Copy fermentables, hops, miscs and yeasts. Going through
+      // addToRecipe() costs a handful of queries per ingredient, so clone
+      // each table in one go instead and just hook up the signals.
+      foreach( Fermentable* ferm, cloneIngredientsInRecipe(other, tmp, &allFermentables) )
+         connect( ferm, SIGNAL(changed(QMetaProperty,QVariant)), tmp, SLOT(acceptFermChange(QMetaProperty,QVariant)) );
+      foreach( Hop* hop, cloneIngredientsInRecipe(other, tmp, &allHops) )
+         connect( hop, SIGNAL(changed(QMetaProperty,QVariant)), tmp, SLOT(acceptHopChange(QMetaProperty,QVariant)) );
+      cloneIngredientsInRecipe(other, tmp, &allMiscs);
+      foreach( Yeast* yeast, cloneIngredientsInRecipe(other, tmp, &allYeasts) )
+         connect( yeast, SIGNAL(changed(QMetaProperty,QVariant)), tmp, SLOT(acceptYeastChange(QMetaProperty,QVariant)) );
 
       // Copy style/mash/equipment
       // Style or equipment might be non-existent but these methods handle that.
@@ -1539,6 +2020,103 @@ void Database::deleteRecord( Brewtarget::DBTable table, BeerXMLElement* object )
 
 }
 
+// A handful of statements per table, and no transaction of its own.
+// newRecipe(Recipe*) gets here through cloneIngredientsInRecipe() with one
+// already open, so a failure rolls back the whole copy
+QList< QPair<int,int> > Database::cloneRowsInRecipe( Brewtarget::DBTable table, QString const& prefix, int oldRecKey, int newRecKey )
+{
+   QList< QPair<int,int> > ret;
+   QList<int> oldKeys;
+   QString tName = tableNames[table];
+   QString relTableName = QString("%1_in_recipe").arg(prefix);
+   QString ingKeyName = QString("%1_id").arg(prefix);
+   QString childTableName = QString("%1_children").arg(prefix);
+   QSqlRecord fields = sqlDatabase().record(tName);
+   QString columns, values, children;
+   int maxKey = 0;
+
+   QSqlQuery q(sqlDatabase());
+
+   // Copy every column but the id. Anything in a recipe is hidden, so display
+   // gets overwritten on the way through
+   for (int i=0; i < fields.count(); ++i) {
+      QString name = fields.fieldName(i);
+      QString value = name == "display" ? Brewtarget::dbFalse() : name;
+
+      if ( name == "id" )
+         continue;
+
+      columns += columns.isEmpty() ? name : QString(",%1").arg(name);
+      values  += values.isEmpty() ? value : QString(",%1").arg(value);
+   }
+
+   try {
+      QString select = QString("SELECT DISTINCT %1 FROM %2 WHERE recipe_id=%3 ORDER BY %1")
+                           .arg(ingKeyName).arg(relTableName).arg(oldRecKey);
+      if ( ! q.exec(select) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      while ( q.next() )
+         oldKeys.append( q.value(0).toInt() );
+
+      if ( oldKeys.isEmpty() )
+         return ret;
+
+      // The new keys are matched to the old ones by order, which only works
+      // if nobody else gets ids out of the table while we are busy. SQLite
+      // already gave us the write lock when the recipe got copied. Postgres
+      // needs to be told
+      if ( Brewtarget::dbType() == Brewtarget::PGSQL ) {
+         if ( ! q.exec( QString("LOCK TABLE %1 IN EXCLUSIVE MODE").arg(tName)) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+      }
+
+      if ( ! q.exec( QString("SELECT MAX(id) FROM %1").arg(tName)) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+      if ( q.next() )
+         maxKey = q.value(0).toInt();
+
+      QString insert = QString("INSERT INTO %1 (%2) SELECT %3 FROM %1 WHERE id IN (SELECT %4 FROM %5 WHERE recipe_id=%6) ORDER BY id")
+                           .arg(tName).arg(columns).arg(values)
+                           .arg(ingKeyName).arg(relTableName).arg(oldRecKey);
+      if ( ! q.exec(insert) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      if ( ! q.exec( QString("SELECT id FROM %1 WHERE id > %2 ORDER BY id").arg(tName).arg(maxKey)) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      while ( q.next() ) {
+         if ( ret.size() == oldKeys.size() )
+            throw QString("found more new rows in %1 than were copied").arg(tName);
+         ret.append( qMakePair(oldKeys.at(ret.size()), q.value(0).toInt()) );
+      }
+
+      if ( ret.size() != oldKeys.size() )
+         throw QString("copied %1 rows from %2 but found %3").arg(oldKeys.size()).arg(tName).arg(ret.size());
+
+      insert = QString("INSERT INTO %1 (%2, recipe_id) SELECT id, %3 FROM %4 WHERE id > %5")
+                  .arg(relTableName).arg(ingKeyName).arg(newRecKey).arg(tName).arg(maxKey);
+      if ( ! q.exec(insert) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      // Same parent/child bookkeeping as addIngredientToRecipe()
+      for (int i=0; i < ret.size(); ++i) {
+         children += QString("%1(%2,%3)").arg(i == 0 ? "" : ",").arg(ret.at(i).first).arg(ret.at(i).second);
+      }
+      insert = QString("INSERT INTO %1 (parent_id, child_id) VALUES %2").arg(childTableName).arg(children);
+      if ( ! q.exec(insert) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      q.finish();
+      throw;
+   }
+
+   q.finish();
+   return ret;
+}
+
 // NOTE: This really should be in a transaction, but I am going to leave that
 // as the responsibility of the calling method. I am not comfortable with this
 // idea.
@@ -1586,6 +2164,11 @@ void Database::updateEntry( Brewtarget::DBTable table, int key, const char* col_
 {
    // Assumes the table has a column called 'deleted'.
    QString tableName = tableNames[table];
+   TraceSpan span("Database::updateEntry", "sql", Trace::isEnabled() ? tableName : QString());
+
+   // Somebody else's batch is open, and they get to commit it
+   if ( batchDepth > 0 )
+      transact = false;
 
    if ( transact )
       sqlDatabase().transaction();
@@ -1619,6 +2202,11 @@ void Database::updateEntry( Brewtarget::DBTable table, int key, const char* col_
    if ( transact )
       sqlDatabase().commit();
 
+   // Keep the inventory cache honest. Inventory tables only have the one
+   // value column, so the key is enough
+   if ( inventoryValues.contains(table) )
+      inventoryValues[table].insert(key,value);
+
    if ( notify )
       emit object->changed(prop,value);
 
@@ -1629,64 +2217,70 @@ void Database::updateEntry( Brewtarget::DBTable table, int key, const char* col_
 //This links ingredients with the same name.
 //The first displayed ingredient in the database is assumed to be the parent.
 void Database::populateChildTablesByName(Brewtarget::DBTable table){
-   Brewtarget::logW( "Populating Children Ingredient Links" );
+   // Rows per upsert. No bound values, so the only limit is how long a
+   // statement we are willing to look at in the logs
+   const int batchSize = 500;
 
-   try {
-      QString queryString = QString("SELECT DISTINCT name FROM %1").arg(tableNames[table]);
+   QHash<QString,int> parents;
+   QList< QPair<QString,int> > children;
+   QStringList values;
+   QString childTable = tableNames[tableToChildTable[table]];
 
-      QSqlQuery nameq( queryString, sqlDatabase() );
+   Brewtarget::logW( "Populating Children Ingredient Links" );
 
-      if ( ! nameq.isActive() )
-         throw QString("%1 %2").arg(nameq.lastQuery()).arg(nameq.lastError().text());
+   try {
+      // One pass over the table. The first displayed row with a given name
+      // is the parent, every hidden row with that name is a child. Ordering
+      // by id makes "first" mean the same thing it always did
+      QString queryString = QString("SELECT id, name, display FROM %1 ORDER BY id ASC").arg(tableNames[table]);
+      QSqlQuery q( sqlDatabase() );
+      q.setForwardOnly(true);
 
-      while (nameq.next()) {
-         QString name = nameq.record().value(0).toString();
-         queryString = QString( "SELECT id FROM %1 WHERE ( name=:name AND display=%2 ) ORDER BY id ASC LIMIT 1")
-                     .arg(tableNames[table])
-                     .arg(Brewtarget::dbTrue());
-         QSqlQuery parentq( sqlDatabase() );
+      if ( ! q.exec(queryString) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
 
-         parentq.prepare(queryString);
-         parentq.bindValue(":name", name);
-         parentq.exec();
+      while ( q.next() ) {
+         QString name = q.value(1).toString();
 
-         if ( !parentq.isActive() )
-            throw QString("%1 %2").arg(parentq.lastQuery()).arg(parentq.lastError().text());
+         if ( q.value(2).toBool() ) {
+            if ( ! parents.contains(name) )
+               parents.insert(name, q.value(0).toInt());
+         }
+         else {
+            children.append( qMakePair(name, q.value(0).toInt()) );
+         }
+      }
+      q.finish();
 
-         parentq.first();
-         QString parentID = parentq.record().value("id").toString();
+      // Then upsert everything in as few statements as we can. This all
+      // happens inside updateSchema()'s transaction
+      for ( int i = 0; i < children.size(); ++i ) {
+         // Orphans with no displayed parent stay orphans
+         if ( parents.contains(children.at(i).first) )
+            values.append( QString("(%1, %2)").arg(parents.value(children.at(i).first)).arg(children.at(i).second) );
 
-         queryString = QString( "SELECT id FROM %1 WHERE ( name=:name AND display=%2 ) ORDER BY id ASC")
-                     .arg(tableNames[table])
-                     .arg(Brewtarget::dbFalse());
-         QSqlQuery childrenq( sqlDatabase() );
-         childrenq.prepare(queryString);
-         childrenq.bindValue(":name", name);
-         childrenq.exec();
+         if ( values.size() < batchSize && i + 1 < children.size() )
+            continue;
+         if ( values.isEmpty() )
+            continue;
 
-         if ( !childrenq.isActive() )
-            throw QString("%1 %2").arg(childrenq.lastQuery()).arg(childrenq.lastError().text());
          // Postgres uses a more verbose upsert syntax. I don't like this, but
          // I'm not seeing a better way yet.
-         while (childrenq.next()) {
-            QString childID = childrenq.record().value("id").toString();
-            switch( Brewtarget::dbType() ) {
-               case Brewtarget::PGSQL:
-                  queryString = QString("INSERT INTO %1 (parent_id, child_id) VALUES (%2, %3) ON CONFLICT(child_id) DO UPDATE set parent_id = EXCLUDED.parent_id")
-                        .arg(tableNames[tableToChildTable[table]])
-                        .arg(parentID)
-                        .arg(childID);
-                  break;
-               default:
-                  queryString = QString("INSERT OR REPLACE INTO %1 (parent_id, child_id) VALUES (%2, %3)")
-                              .arg(tableNames[tableToChildTable[table]])
-                              .arg(parentID)
-                              .arg(childID);
-            }
-            QSqlQuery insertq( queryString, sqlDatabase() );
-            if ( !insertq.isActive() )
-               throw QString("%1 %2").arg(insertq.lastQuery()).arg(insertq.lastError().text());
+         switch( Brewtarget::dbType() ) {
+            case Brewtarget::PGSQL:
+               queryString = QString("INSERT INTO %1 (parent_id, child_id) VALUES %2 ON CONFLICT(child_id) DO UPDATE set parent_id = EXCLUDED.parent_id")
+                     .arg(childTable)
+                     .arg(values.join(","));
+               break;
+            default:
+               queryString = QString("INSERT OR REPLACE INTO %1 (parent_id, child_id) VALUES %2")
+                     .arg(childTable)
+                     .arg(values.join(","));
          }
+
+         if ( ! q.exec(queryString) )
+            throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+         values.clear();
       }
    }
    catch (QString e) {
@@ -1694,6 +2288,7 @@ void Database::populateChildTablesByName(Brewtarget::DBTable table){
       throw QString("%1 %2").arg(Q_FUNC_INFO).arg(e);
    }
 }
+
 // populate ingredient tables
 void Database::populateChildTablesByName(){
 
@@ -1735,6 +2330,173 @@ int Database::getParentID(Brewtarget::DBTable table, int childKey){
 }
 //Returns the key to the inventory table for a given ingredient
 int Database::getInventoryID(Brewtarget::DBTable table, int key){
+   Q_ASSERT( QThread::currentThread() == thread() );
+
+   QHash< Brewtarget::DBTable, QHash<int,int> >::const_iterator keys = inventoryKeys.constFind(table);
+   if ( keys != inventoryKeys.constEnd() ) {
+      QHash<int,int>::const_iterator it = keys->constFind(key);
+      if ( it != keys->constEnd() )
+         return it.value();
+   }
+
+   // Probably a brand new ingredient. Ask once, remember the answer
+   int ret = findInventoryID(table,key);
+   inventoryKeys[table].insert(key,ret);
+   return ret;
+}
+
+QVariant Database::getInventory(Brewtarget::DBTable table, int key, const char* col_name){
+   int invkey = getInventoryID(table, key);
+   Brewtarget::DBTable invtable = tableToInventoryTable[table];
+
+   if ( invkey == 0 )
+      return QVariant(0.0);
+
+   QHash< Brewtarget::DBTable, QHash<int,QVariant> >::const_iterator values = inventoryValues.constFind(invtable);
+   if ( values != inventoryValues.constEnd() ) {
+      QHash<int,QVariant>::const_iterator it = values->constFind(invkey);
+      if ( it != values->constEnd() )
+         return it.value();
+   }
+
+   QVariant val = get(invtable, invkey, col_name);
+   inventoryValues[invtable].insert(invkey,val);
+   return val;
+}
+
+void Database::populateStore( Brewtarget::DBTable table, DatabaseSnapshot const* snap )
+{
+   TraceSpan span("Database::populateStore", "db", Trace::isEnabled() ? tableNames[table] : QString());
+
+   if ( snap ) {
+      stores[table].assign( snap->rows.value(table) );
+      return;
+   }
+
+   QVector<DatabaseSnapshot::Row> rows;
+   QSqlQuery q(sqlDatabase());
+   q.setForwardOnly(true);
+
+   try {
+      if ( ! q.exec( QString("SELECT id, name, folder, display, deleted FROM %1").arg(tableNames[table]) ) )
+         throw QString("%1 %2").arg(q.lastQuery()).arg(q.lastError().text());
+
+      while ( q.next() ) {
+         DatabaseSnapshot::Row row;
+         row.key = q.value(0).toInt();
+         row.name = q.value(1).toString();
+         row.folder = q.value(2).toString();
+         row.display = q.value(3).isNull() ? -1 : q.value(3).toBool();
+         row.deleted = q.value(4).isNull() ? -1 : q.value(4).toBool();
+         rows.append(row);
+      }
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      q.finish();
+      throw;
+   }
+   q.finish();
+
+   stores[table].assign(rows);
+}
+
+QList<MemoryAccounting::Entry> Database::memoryReport()
+{
+   QList<MemoryAccounting::Entry> ret;
+
+   ret << memoryEntry( allBrewNotes, Brewtarget::BREWNOTETABLE )
+       << memoryEntry( allEquipments, Brewtarget::EQUIPTABLE )
+       << memoryEntry( allFermentables, Brewtarget::FERMTABLE )
+       << memoryEntry( allHops, Brewtarget::HOPTABLE )
+       << memoryEntry( allInstructions, Brewtarget::INSTRUCTIONTABLE )
+       << memoryEntry( allMashs, Brewtarget::MASHTABLE )
+       << memoryEntry( allMashSteps, Brewtarget::MASHSTEPTABLE )
+       << memoryEntry( allMiscs, Brewtarget::MISCTABLE )
+       << memoryEntry( allRecipes, Brewtarget::RECTABLE )
+       << memoryEntry( allStyles, Brewtarget::STYLETABLE )
+       << memoryEntry( allWaters, Brewtarget::WATERTABLE )
+       << memoryEntry( allYeasts, Brewtarget::YEASTTABLE );
+
+   QHash< Brewtarget::DBTable, ElementStore >::const_iterator store;
+   for ( store = stores.constBegin(); store != stores.constEnd(); ++store )
+      ret << MemoryAccounting::Entry( "Database", QString("%1 store").arg(tableNames[store.key()]), store->size(), store->bytes() );
+
+   // A prepared sqlite statement is a VM program, somewhere between one and
+   // a few KiB. Two will do. Only this thread's, the others aren't ours to
+   // look at
+   StatementCache const& cache = statementCache();
+   qint64 bytes = cache.select.size() * (MemoryAccounting::hashNodeBytes<quint32,QSqlQuery>() + 2048);
+   QHash<QByteArray,int>::const_iterator column;
+   for ( column = cache.columnIds.constBegin(); column != cache.columnIds.constEnd(); ++column )
+      bytes += column.key().capacity() + MemoryAccounting::hashNodeBytes<QByteArray,int>();
+   ret << MemoryAccounting::Entry( "Database", "prepared statements", cache.select.size(), bytes );
+
+   qint64 count = 0;
+   bytes = 0;
+   foreach( QHash<int,int> const& keys, inventoryKeys ) {
+      count += keys.size();
+      bytes += keys.size() * MemoryAccounting::hashNodeBytes<int,int>();
+   }
+   foreach( QHash<int,QVariant> const& values, inventoryValues ) {
+      count += values.size();
+      bytes += values.size() * MemoryAccounting::hashNodeBytes<int,QVariant>();
+   }
+   ret << MemoryAccounting::Entry( "Database", "inventory cache", count, bytes );
+
+   bytes = 0;
+   foreach( QString const& calcs, snapshotCalcCaches )
+      bytes += MemoryAccounting::stringBytes(calcs) + MemoryAccounting::hashNodeBytes<int,QString>();
+   ret << MemoryAccounting::Entry( "Database", "unclaimed calc caches", snapshotCalcCaches.size(), bytes );
+
+   return ret;
+}
+
+void Database::logElementMemory()
+{
+   logElementMemory( allFermentables, Brewtarget::FERMTABLE );
+   logElementMemory( allHops, Brewtarget::HOPTABLE );
+   logElementMemory( allMiscs, Brewtarget::MISCTABLE );
+   logElementMemory( allYeasts, Brewtarget::YEASTTABLE );
+}
+
+void Database::populateInventory(Brewtarget::DBTable table){
+   Brewtarget::DBTable invtable = tableToInventoryTable[table];
+   QString tName = tableNames[table];
+   QString column = table == Brewtarget::YEASTTABLE ? "quanta" : "amount";
+   QHash<int,int>& keys = inventoryKeys[table];
+   QHash<int,QVariant>& values = inventoryValues[invtable];
+
+   // Children share their parent's inventory, which is what getParentID()
+   // works out one row at a time. The COALESCE does it for everybody at once
+   QString queryString = QString(
+      "SELECT ing.id, inv.id, inv.%1 FROM %2 ing "
+      "LEFT JOIN %3 c ON c.child_id = ing.id "
+      "LEFT JOIN %4 inv ON inv.%2_id = COALESCE(c.parent_id, ing.id)"
+   ).arg(column).arg(tName).arg(tableNames[tableToChildTable[table]]).arg(tableNames[invtable]);
+
+   QSqlQuery q( sqlDatabase() );
+   q.setForwardOnly(true);
+
+   if ( ! q.exec(queryString) ) {
+      // Not fatal. We just end up asking one row at a time, like we used to
+      Brewtarget::logW( QString("%1 %2 %3").arg(Q_FUNC_INFO).arg(q.lastQuery()).arg(q.lastError().text()) );
+      return;
+   }
+
+   keys.clear();
+   values.clear();
+   while ( q.next() ) {
+      int invkey = q.value(1).toInt();
+
+      keys.insert( q.value(0).toInt(), invkey );
+      if ( invkey != 0 )
+         values.insert( invkey, q.value(2) );
+   }
+}
+
+//Returns the key to the inventory table for a given ingredient
+int Database::findInventoryID(Brewtarget::DBTable table, int key){
    int ret;
    QString queryString = QString(
       "SELECT id FROM %1 WHERE %2_id = %3 LIMIT 1"
@@ -1775,6 +2537,75 @@ void Database::newInventory(Brewtarget::DBTable invForTable, int invForID) {
 
    QSqlQuery q( queryString, sqlDatabase() );
 
+   // The new row is shared by the parent and all of its children, and any of
+   // them may have been cached as having no inventory. One more join is
+   // cheaper than finding them all
+   populateInventory(invForTable);
+}
+
+int Database::renameFolder(Brewtarget::DBTable table, QString const& oldPath, QString const& newPath)
+{
+   QString tName = tableNames[table];
+   QString prefix = oldPath + "/";
+   int moved = 0;
+
+   // Both engines speak substr() and ||, and this way I don't have to escape
+   // any % or _ that somebody put in a folder name
+   QSqlQuery q( sqlDatabase() );
+   q.prepare( QString("UPDATE %1 SET folder = :newPath || substr(folder, :oldLen) "
+                      "WHERE folder = :oldPath OR substr(folder, 1, :prefixLen) = :prefix")
+              .arg(tName) );
+   q.bindValue(":newPath", newPath);
+   // substr() counts from one, so this starts on the character right after oldPath
+   q.bindValue(":oldLen", oldPath.length() + 1);
+   q.bindValue(":oldPath", oldPath);
+   q.bindValue(":prefixLen", prefix.length());
+   q.bindValue(":prefix", prefix);
+
+   sqlDatabase().transaction();
+   try {
+      if ( ! q.exec() )
+         throw QString("could not move %1 to %2 in %3: %4").arg(oldPath).arg(newPath).arg(tName).arg(q.lastError().text());
+      moved = q.numRowsAffected();
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      sqlDatabase().rollback();
+      throw;
+   }
+   sqlDatabase().commit();
+
+   switch( table )
+   {
+      case Brewtarget::RECTABLE:
+         renameCachedFolders(allRecipes, oldPath, newPath);
+         break;
+      case Brewtarget::EQUIPTABLE:
+         renameCachedFolders(allEquipments, oldPath, newPath);
+         break;
+      case Brewtarget::FERMTABLE:
+         renameCachedFolders(allFermentables, oldPath, newPath);
+         break;
+      case Brewtarget::HOPTABLE:
+         renameCachedFolders(allHops, oldPath, newPath);
+         break;
+      case Brewtarget::MISCTABLE:
+         renameCachedFolders(allMiscs, oldPath, newPath);
+         break;
+      case Brewtarget::STYLETABLE:
+         renameCachedFolders(allStyles, oldPath, newPath);
+         break;
+      case Brewtarget::YEASTTABLE:
+         renameCachedFolders(allYeasts, oldPath, newPath);
+         break;
+      default:
+         Brewtarget::logW( QString("%1 no folders in %2").arg(Q_FUNC_INFO).arg(tName) );
+   }
+   // and everybody who hasn't been built yet
+   if ( stores.contains(table) )
+      stores[table].renameFolder(oldPath, newPath);
+
+   return moved;
 }
 
 // Add to recipe ==============================================================
@@ -2353,6 +3184,13 @@ bool Database::importFromXML(const QString& filename)
    if( ! xmlDoc.setContent(&inFile, false, &err, &line, &col) )
       Brewtarget::logW(QString("Database::importFromXML: Bad document formatting in %1 %2:%3. %4").arg(filename).arg(line).arg(col).arg(err) );
 
+   // A big import is the one time a whole document sits in memory
+   MemoryAccounting::Scope accounting( [&xmlDoc, &filename]() {
+      qint64 nodes;
+      qint64 bytes = MemoryAccounting::domBytes(xmlDoc, &nodes);
+      return QList<MemoryAccounting::Entry>() << MemoryAccounting::Entry( "Import", QFileInfo(filename).fileName(), nodes, bytes );
+   });
+
    list = xmlDoc.elementsByTagName("RECIPE");
    if ( list.count() )
    {
@@ -5136,91 +5974,303 @@ QStringList Database::allTablesInOrder(QSqlQuery q)
    return tmp;
 }
 
-void Database::copyDatabase( Brewtarget::DBTypes oldType, Brewtarget::DBTypes newType, QSqlDatabase newDb)
+QString Database::makeBulkInsertString( QSqlRecord here, QString realName, int rows )
 {
-   QSqlDatabase oldDb = sqlDatabase();
-   QSqlQuery readOld(oldDb);
+   QString columns, qmarks, values;
 
-   QStringList tables = allTablesInOrder(readOld);
+   for(int i=0; i < here.count(); ++i) {
+      if ( ! columns.isEmpty() ) {
+         columns += QString(",%1").arg( here.fieldName(i));
+         qmarks  += ",?";
+      }
+      else {
+         columns = here.fieldName(i);
+         qmarks = "?";
+      }
+   }
+
+   qmarks = QString("(%1)").arg(qmarks);
+   values.reserve( rows * (qmarks.size() + 1) );
+   for(int i=0; i < rows; ++i) {
+      if ( i > 0 )
+         values += ",";
+      values += qmarks;
+   }
+   return QString("INSERT INTO %1 (%2) VALUES %3").arg(realName).arg(columns).arg(values);
+}
+
+QList<QStringList> Database::copyWaves(QStringList const& tables, Brewtarget::DBTypes newType, QSqlDatabase newDb)
+{
+   QHash<QString,int> level;
+   QList<QStringList> waves;
+   QSqlQuery q(newDb);
 
-   // There are a lot of tables to process
    foreach( QString table, tables ) {
-      QSqlField field;
-      bool mustPrepare = true;
-      int maxid = -1;
-
-      // bt_alltables don't get copied; metatables are created
-      // when the database is. I used to say this about settings. I was wrong
-      // about settings
-      if ( table == "bt_alltables" )
-         continue;
+      QString findParents;
+      int mine = 0;
+
+      if ( newType == Brewtarget::PGSQL ) {
+         findParents = QString("SELECT ccu.table_name AS parent "
+                               "FROM information_schema.table_constraints tc "
+                               "JOIN information_schema.constraint_column_usage ccu "
+                               "ON tc.constraint_name = ccu.constraint_name "
+                               "WHERE tc.constraint_type = 'FOREIGN KEY' AND tc.table_name = '%1'").arg(table);
+      }
+      else {
+         findParents = QString("PRAGMA foreign_key_list(%1)").arg(table);
+      }
 
-      QString findAllQuery = QString("SELECT * FROM %1").arg(table);
-      try {
+      if ( ! q.exec(findParents) )
+         throw QString("Could not find the parents of %1 : %2").arg(table).arg(q.lastError().text());
 
-         if (! readOld.exec(findAllQuery) )
-            throw QString("Could not execute %1 : %2").arg(readOld.lastQuery()).arg(readOld.lastError().text());
+      while ( q.next() ) {
+         QString parent = newType == Brewtarget::PGSQL ? q.value("parent").toString() : q.value("table").toString();
 
-         newDb.transaction();
+         if ( parent == table || ! tables.contains(parent) )
+            continue;
 
-         QSqlQuery upsertNew(newDb); // we will prepare this in a bit
+         // allTablesInOrder puts parents first. If it ever doesn't, the
+         // child waits until everything we have seen so far is done
+         mine = qMax(mine, level.contains(parent) ? level.value(parent) + 1 : waves.size());
+      }
+
+      level.insert(table,mine);
+      while ( waves.size() <= mine )
+         waves.append(QStringList());
+      waves[mine].append(table);
+   }
+   return waves;
+}
+
+int Database::copyTable( QString const& table, Brewtarget::DBTypes newType, QSqlDatabase oldDb, QSqlDatabase newDb)
+{
+   // Both of these have to stay under the bound parameter limits. SQLite
+   // stops at 999, PostgreSQL at 65535
+   const int maxParams = newType == Brewtarget::PGSQL ? 32767 : 999;
+
+   QSqlQuery readOld(oldDb);
+   QSqlQuery batchNew(newDb);
+   QVector<QVariant> pending;
+   int batchRows = 0;
+   int rows = 0;
+   int maxid = -1;
+   int idx = -1;
+
+   QString findAllQuery = QString("SELECT * FROM %1").arg(table);
+
+   readOld.setForwardOnly(true);
+   if (! readOld.exec(findAllQuery) )
+      throw QString("Could not execute %1 : %2").arg(readOld.lastQuery()).arg(readOld.lastError().text());
+
+   newDb.transaction();
+
+   try {
+      QSqlRecord here;
 
-         // Start reading the records from the old db
-         while(readOld.next()) {
-            int idx;
-            QSqlRecord here = readOld.record();
-            QString upsertQuery;
+      // Binds whatever is pending to q and fires it
+      auto flush = [&] (QSqlQuery& q) {
+         for(int i=0; i < pending.size(); ++i)
+            q.bindValue(i, pending.at(i), QSql::In);
 
+         if ( ! q.exec() )
+            throw QString("Could not insert new rows %1 : %2").arg(q.lastQuery()).arg(q.lastError().text());
+         pending.clear();
+      };
+
+      // Start reading the records from the old db
+      while(readOld.next()) {
+         here = readOld.record();
+
+         if ( idx == -1 )
             idx = here.indexOf("id");
 
-            // We are going to need this for resetting the indexes later. We only
-            // need it for copying to postgresql, but .. meh, not worth the extra
-            // work
-            if ( idx != -1 && here.value(idx).toInt() > maxid ) {
-               maxid = here.value(idx).toInt();
-            }
+         // We are going to need this for resetting the indexes later. We only
+         // need it for copying to postgresql, but .. meh, not worth the extra
+         // work
+         if ( idx != -1 && here.value(idx).toInt() > maxid ) {
+            maxid = here.value(idx).toInt();
+         }
 
-            // Prepare the insert for this table if required
-            if ( mustPrepare ) {
-               if ( table == QStringLiteral("settings") ) {
-                  upsertQuery = makeUpdateString(here,table,here.value(idx).toInt());
-               }
-               else {
-                  upsertQuery = makeInsertString(here,table);
-               }
-               upsertNew.prepare(upsertQuery);
-               // but do it only once for this table
-               mustPrepare = false;
-            }
-            // All that's left is to bind
-            for(int i=0; i < here.count(); ++i) {
-               upsertNew.bindValue(i,
-                        convertValue(newType, here.field(i)),
-                        QSql::In
-               );
-            }
+         // settings is the odd one out. The row already exists, so it gets
+         // the old slow treatment
+         if ( table == QStringLiteral("settings") ) {
+            QSqlQuery upsertNew(newDb);
+            upsertNew.prepare( makeUpdateString(here,table,here.value(idx).toInt()) );
+            for(int i=0; i < here.count(); ++i)
+               pending.append( convertValue(newType, here.field(i)) );
+            flush(upsertNew);
+            ++rows;
+            continue;
+         }
+
+         // Prepare the batch insert the first time through
+         if ( batchRows == 0 ) {
+            batchRows = qMax(1, maxParams / here.count());
+            batchNew.prepare( makeBulkInsertString(here,table,batchRows) );
+            pending.reserve( batchRows * here.count() );
+         }
+
+         for(int i=0; i < here.count(); ++i)
+            pending.append( convertValue(newType, here.field(i)) );
+         ++rows;
 
-            // and execute
-            if ( ! upsertNew.exec() )
-               throw QString("Could not insert new row %1 : %2").arg(upsertNew.lastQuery()).arg(upsertNew.lastError().text());
+         if ( pending.size() == batchRows * here.count() )
+            flush(batchNew);
+      }
+
+      // Whatever didn't fill a whole batch gets a statement of its own
+      if ( ! pending.isEmpty() ) {
+         QSqlQuery tailNew(newDb);
+         tailNew.prepare( makeBulkInsertString(here,table,pending.size() / here.count()) );
+         flush(tailNew);
+      }
+
+      // We need to manually reset the sequences
+      if ( newType == Brewtarget::PGSQL && maxid > 0 ) {
+         QString seq = QString("SELECT setval('%1_id_seq',%2)").arg(table).arg(maxid);
+         QSqlQuery updateSeq(newDb);
+
+         if ( ! updateSeq.exec(seq) )
+            throw QString("Could not reset the sequences: %1 %2")
+               .arg(seq).arg(updateSeq.lastError().text());
+      }
+   }
+   catch (QString e) {
+      newDb.rollback();
+      throw;
+   }
+
+   newDb.commit();
+   return rows;
+}
+
+class Database::CopyTableTask : public QRunnable
+{
+public:
+   CopyTableTask(Database* db, QString const& table, Brewtarget::DBTypes newType,
+                 QSqlDatabase oldDb, QSqlDatabase newDb,
+                 QMutex* lock, QStringList* errors, qint64* totalRows)
+      : _db(db), _table(table), _newType(newType), _oldDb(oldDb), _newDb(newDb),
+        _lock(lock), _errors(errors), _totalRows(totalRows)
+   {
+      setAutoDelete(true);
+   }
+
+   void run()
+   {
+      // Connections belong to the thread that made them, so each task makes
+      // its own pair and throws them away when it's done
+      QString conName = QString("copy_%1").arg(_table);
+      QElapsedTimer timer;
+      int rows = 0;
+
+      timer.start();
+      {
+         QSqlDatabase oldDb = QSqlDatabase::cloneDatabase(_oldDb, conName + "_old");
+         QSqlDatabase newDb = QSqlDatabase::cloneDatabase(_newDb, conName + "_new");
+
+         try {
+            if ( ! oldDb.open() )
+               throw QString("Could not open old database: %1").arg(oldDb.lastError().text());
+            if ( ! newDb.open() )
+               throw QString("Could not open new database: %1").arg(newDb.lastError().text());
+
+            rows = _db->copyTable(_table, _newType, oldDb, newDb);
          }
-         // We need to manually reset the sequences
-         if ( newType == Brewtarget::PGSQL && maxid > 0 ) {
-            QString seq = QString("SELECT setval('%1_id_seq',%2)").arg(table).arg(maxid);
-            QSqlQuery updateSeq(seq, newDb);
-
-            if ( ! updateSeq.exec(seq) )
-               throw QString("Could not reset the sequences: %1 %2")
-                  .arg(seq).arg(updateSeq.lastError().text());
+         catch (QString e) {
+            QMutexLocker locker(_lock);
+            _errors->append( QString("%1: %2").arg(_table).arg(e) );
          }
+
+         oldDb.close();
+         newDb.close();
       }
-      catch (QString e) {
-         Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
-         newDb.rollback();
-         throw;
+      QSqlDatabase::removeDatabase(conName + "_old");
+      QSqlDatabase::removeDatabase(conName + "_new");
+
+      QMutexLocker locker(_lock);
+      *_totalRows += rows;
+      Database::reportCopy(_table, rows, timer.elapsed());
+   }
+
+private:
+   Database* _db;
+   QString _table;
+   Brewtarget::DBTypes _newType;
+   QSqlDatabase _oldDb;
+   QSqlDatabase _newDb;
+   QMutex* _lock;
+   QStringList* _errors;
+   qint64* _totalRows;
+};
+
+void Database::copyDatabase( Brewtarget::DBTypes oldType, Brewtarget::DBTypes newType, QSqlDatabase newDb)
+{
+   QSqlDatabase oldDb = sqlDatabase();
+   QSqlQuery readOld(oldDb);
+   QElapsedTimer timer;
+   qint64 totalRows = 0;
+   int done = 0;
+
+   QStringList tables = allTablesInOrder(readOld);
+
+   // bt_alltables don't get copied; metatables are created
+   // when the database is. I used to say this about settings. I was wrong
+   // about settings
+   tables.removeAll("bt_alltables");
+
+   timer.start();
+   try {
+      QList<QStringList> waves = copyWaves(tables, newType, newDb);
+
+      // SQLite locks the whole file on a write, so there is nothing to be
+      // gained by more than one writer. Postgres is happy to take them all
+      if ( newType != Brewtarget::PGSQL ) {
+         foreach( QStringList wave, waves ) {
+            foreach( QString table, wave ) {
+               QElapsedTimer tableTimer;
+               tableTimer.start();
+
+               int rows = copyTable(table, newType, oldDb, newDb);
+               totalRows += rows;
+               reportCopy(QString("[%1/%2] %3").arg(++done).arg(tables.size()).arg(table), rows, tableTimer.elapsed());
+            }
+         }
       }
+      else {
+         QThreadPool pool;
+         QMutex lock;
+         QStringList errors;
 
-      newDb.commit();
+         pool.setMaxThreadCount( qBound(1, QThread::idealThreadCount(), 4) );
+
+         foreach( QStringList wave, waves ) {
+            foreach( QString table, wave ) {
+               pool.start( new CopyTableTask(this, table, newType, oldDb, newDb, &lock, &errors, &totalRows) );
+            }
+            // The next wave holds foreign keys into this one
+            pool.waitForDone();
+            done += wave.size();
+            Brewtarget::log.info( QString("Copied %1 of %2 tables").arg(done).arg(tables.size()) );
+
+            if ( ! errors.isEmpty() )
+               throw errors.join("\n");
+         }
+      }
    }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e));
+      throw;
+   }
+
+   reportCopy(QString("%1 tables").arg(tables.size()), static_cast<int>(totalRows), timer.elapsed());
 }
 
+void Database::reportCopy(QString const& what, int rows, qint64 msecs)
+{
+   // Don't divide by zero. It upsets people
+   double perSecond = rows * 1000.0 / qMax(msecs, static_cast<qint64>(1));
+
+   Brewtarget::log.info( QString("Copied %1 rows of %2 in %3 ms (%4 rows/s)")
+                           .arg(rows).arg(what).arg(msecs).arg(perSecond, 0, 'f', 0) );
+}
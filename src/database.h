@@ -46,9 +46,17 @@ class Database;
 #include <QDebug>
 #include <QRegExp>
 #include <QMap>
+#include <QVector>
+#include <QThread>
+#include <QThreadStorage>
+#include <QAtomicInt>
 #include "BeerXMLElement.h"
 #include "brewtarget.h"
+#include "DatabaseSnapshot.h"
+#include "ElementStore.h"
+#include "MemoryAccounting.h"
 #include "recipe.h"
+#include "Trace.h"
 // Forward declarations
 class BrewNote;
 //class BeerXMLElement;
@@ -91,6 +99,7 @@ class Database : public QObject
    Q_OBJECT
 
    friend class BtSqlQuery; // This class needs the _thread instance.
+   friend class Testing;
 public:
 
    //! This should be the ONLY way you get an instance.
@@ -124,35 +133,12 @@ public:
    void updateEntry( Brewtarget::DBTable table, int key, const char* col_name, QVariant value, QMetaProperty prop, BeerXMLElement* object, bool notify = true, bool transact = false );
 
    //! \brief Get the contents of the cell specified by table/key/col_name.
-   QVariant get( Brewtarget::DBTable table, int key, const char* col_name )
-   {
-      QSqlQuery q;
-      QString index = QString("%1_%2").arg(tableNames[table]).arg(col_name);
-
-      if ( ! selectSome.contains(index) ) {
-         QString query = QString("SELECT %1 from %2 WHERE id=:id")
-                           .arg(col_name)
-                           .arg(tableNames[table]);
-         q = QSqlQuery( sqlDatabase() );
-         q.prepare(query);
-         selectSome.insert(index,q);
-      }
-
-      q = selectSome.value(index);
-      q.bindValue(":id", key);
-
-      q.exec();
-      if( !q.next() )
-      {
-         Brewtarget::logE( QString("Database::get(): %1 (%2) %3").arg(q.lastQuery()).arg(col_name).arg(q.lastError().text()));
-         q.finish();
-         return QVariant();
-      }
-
-      QVariant ret( q.record().value(col_name) );
-      q.finish();
-      return ret;
-   }
+   QVariant get( Brewtarget::DBTable table, int key, const char* col_name );
+   /*!
+    * \brief Get several cells of one row with a single statement.
+    * \returns the values in the same order as \c col_names
+    */
+   QVector<QVariant> get( Brewtarget::DBTable table, int key, QVector<const char*> const& col_names );
 
    //! Get a table view.
    QTableView* createView( Brewtarget::DBTable table );
@@ -194,6 +180,14 @@ public:
    BrewNote* newBrewNote(Recipe* parent, bool signal = true);
    //! Create new instruction attached to \b parent.
    Instruction* newInstruction(Recipe* parent);
+   /*!
+    * \brief Throws out \b parent's instructions and puts \b drafts in their
+    * place, in order. One transaction (or none, inside a batch), one
+    * multi-row insert and a single "instructions" change at the end, instead
+    * of a round trip and a repaint per step.
+    * \returns the new instructions
+    */
+   QList<Instruction*> replaceInstructions(Recipe* parent, QList<Instruction::Draft> const& drafts);
 
    MashStep* newMashStep(Mash* parent, bool connected = true);
 
@@ -228,8 +222,14 @@ public:
    void populateChildTablesByName();
    //! \returns the key of the parent ingredient
    int getParentID(Brewtarget::DBTable table, int childKey);
-   //! \returns the key to the inventory table for a given ingredient
+   //! \returns the key to the inventory table for a given ingredient.
+   // Answered from the inventory cache whenever it can be. GUI thread only,
+   // since a miss fills the cache
    int getInventoryID(Brewtarget::DBTable table, int key);
+   //! \returns the inventory amount (quanta for yeast) for a given
+   // ingredient, or 0.0 if it has no inventory row. GUI thread only, like
+   // getInventoryID()
+   QVariant getInventory(Brewtarget::DBTable table, int key, const char* col_name);
    //! \returns the parent table number from the hash
    Brewtarget::DBTable getChildTable(Brewtarget::DBTable table);
    //! \returns the inventory table number from the hash
@@ -237,6 +237,15 @@ public:
    //! Inserts an new inventory row in the appropriate table
    void newInventory(Brewtarget::DBTable invForTable, int invForID);
 
+   /*!
+    * \brief Moves everything in folder \c oldPath, and in any folder below
+    * it, to \c newPath with one UPDATE. The cached folder of every element
+    * already in memory is rewritten to match, but no signals are emitted.
+    * The caller is expected to fix up its own view of the world.
+    * \returns the number of rows moved
+    */
+   int renameFolder(Brewtarget::DBTable table, QString const& oldPath, QString const& newPath);
+
    //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
    //! \brief Copies all of the mashsteps from \c oldMash to \c newMash
@@ -351,6 +360,31 @@ public:
    //! Get the recipe that this \b note is part of.
    Recipe* getParentRecipe( BrewNote const* note );
 
+   /*!
+    * \returns a hash of everything the calculated values of \b rec depend
+    * on: the recipe row (less the og and fg saved in it), the rows of its
+    * fermentables, hops and yeasts, its equipment, its mash and mash steps,
+    * and the IBU and color formulas.
+    * Costs a handful of queries, which is a lot less than recalcAll().
+    */
+   QString recipeFingerprint( Recipe const* rec );
+   //! \returns the calc_cache column of \b rec. The first call per recipe
+   // is usually answered by the startup snapshot
+   QString calcCache( Recipe const* rec );
+   //! Saves \b calcs as the calc_cache column of \b rec. Nobody listens to
+   // this one, so no changed() signal
+   void setCalcCache( Recipe* rec, QString const& calcs );
+
+   /*!
+    * Opens a transaction that updateEntry() joins instead of making its own,
+    * so a pile of updates costs one commit. Only for the main thread's
+    * connection. Batches nest; only the outermost one commits.
+    */
+   void beginBatch();
+   void commitBatch();
+   //! Throws away everything since the outermost beginBatch()
+   void rollbackBatch();
+
    //! Interchange the step orders of the two steps. Must be in same mash.
    void swapMashStepOrder(MashStep* m1, MashStep* m2);
    //! Interchange the instruction orders. Must be in same recipe.
@@ -483,6 +517,13 @@ private:
    static QFile dataDbFile;
    static QString dataDbFileName;
    static QString dbConName;
+   //! Stamp of dbFile as we found it, before we opened it. Cleared the
+   // moment we change it ourselves during load(), which retires the snapshot
+   QByteArray dbStamp;
+   //! calc_cache values out of the snapshot, handed out once by calcCache()
+   QHash<int,QString> snapshotCalcCaches;
+   //! How many beginBatch() are still open
+   int batchDepth;
 
    // And these are for Postgres databases -- are these really required? Are
    // the sqlite ones really required?
@@ -530,19 +571,174 @@ private:
    QHash< int, Style* > allStyles;
    QHash< int, Water* > allWaters;
    QHash< int, Yeast* > allYeasts;
-//   QHash<Brewtarget::DBTable,QSqlQuery> selectAll;
-   QHash<QString,QSqlQuery> selectSome;
+   /*!
+    * The SELECTs get() has prepared. A statement belongs to the connection
+    * it was prepared on, and there is one connection per thread, so each
+    * thread keeps its own.
+    */
+   struct StatementCache
+   {
+      StatementCache() : generation(0) {}
+      //! Gives each column list its own small int, so nobody formats strings
+      int columnId( QByteArray const& columns );
+
+      //! (column id << 8 | table) -> statement
+      QHash<quint32,QSqlQuery> select;
+      QHash<QByteArray,int> columnIds;
+      //! Stale when it differs from statementGeneration
+      int generation;
+   };
+   QThreadStorage<StatementCache*> statements;
+   //! Bumped by unload(), which closes the connections the statements need
+   QAtomicInt statementGeneration;
+
+   StatementCache& statementCache();
+   //! The prepared "SELECT \c columns FROM \c table WHERE id=:id"
+   QSqlQuery& selectStatement( Brewtarget::DBTable table, QByteArray const& columns );
+
+   //! ingredient table -> (ingredient key -> inventory key). 0 means the
+   // ingredient has no inventory row yet. Neither inventory cache has a
+   // lock, so only the GUI thread reads or fills them
+   QHash< Brewtarget::DBTable, QHash<int,int> > inventoryKeys;
+   //! inventory table -> (inventory key -> amount or quanta)
+   QHash< Brewtarget::DBTable, QHash<int,QVariant> > inventoryValues;
+
+   //! \brief fills inventoryKeys and inventoryValues for \b table with one
+   // join, so the inventory columns can be painted without touching the db
+   void populateInventory(Brewtarget::DBTable table);
+
+   //! \brief Where the startup snapshot lives, next to the db file
+   static QString snapshotFileName();
+   //! \brief Reads everything a DatabaseSnapshot holds out of the db.
+   // Caller owns the result
+   DatabaseSnapshot* takeSnapshot();
+   //! \brief The elements of \b childTable hanging off \b parentKey, as the snapshot recorded them
+   template <class T> QList<T*> snapshotChildren( DatabaseSnapshot const* snap, Brewtarget::DBTable childTable, int parentKey, QHash<int,T*>& all )
+   {
+      QList<T*> ret;
+      foreach( int key, snap->children.value(childTable).value(parentKey) )
+      {
+         T* elem = element( all, key );
+         if ( elem )
+            ret.append( elem );
+      }
+      return ret;
+   }
+
+   //! Tables kept in an ElementStore. Their all* hash only holds the
+   // elements somebody has actually asked for
+   QHash< Brewtarget::DBTable, ElementStore > stores;
+
+   /*!
+    * \brief The element with \b key. If \b hash hasn't got it yet, but the
+    * store for T's table has the row, the object gets built now.
+    *
+    * GUI thread only. It fills \b hash as it goes, and the new object
+    * belongs to whichever thread made it.
+    * \returns 0 if there's no such element
+    */
+   template <class T> T* element( QHash<int,T*>& hash, int key )
+   {
+      Q_ASSERT( QThread::currentThread() == thread() );
+
+      typename QHash<int,T*>::const_iterator it = hash.constFind(key);
+      if ( it != hash.constEnd() )
+         return it.value();
+
+      if ( stores.isEmpty() )
+         return 0;
+
+      Brewtarget::DBTable table = classNameToTable.value( T::staticMetaObject.className(), Brewtarget::NOTABLE );
+      QHash< Brewtarget::DBTable, ElementStore >::const_iterator store = stores.constFind(table);
+      if ( store == stores.constEnd() )
+         return 0;
+
+      int row = store->indexOf(key);
+      if ( row < 0 )
+         return 0;
+
+      T* et = new T();
+      et->_key = key;
+      et->_table = table;
+      et->_name = store->name(row);
+      et->_folder = store->folder(row);
+      if ( store->display(row) >= 0 )
+         et->_display = QVariant(store->display(row) != 0);
+      if ( store->deleted(row) >= 0 )
+         et->_deleted = QVariant(store->deleted(row) != 0);
+
+      hash.insert(key, et);
+      return et;
+   }
+
+   //! Fills the ElementStore for \b table, from the snapshot if there is one.
+   // No objects get made here, see element()
+   void populateStore( Brewtarget::DBTable table, DatabaseSnapshot const* snap = 0 );
+
+   //! \brief What we hold, for MemoryAccounting
+   QList<MemoryAccounting::Entry> memoryReport();
+   //! \brief One all* hash, objects and the strings they cached
+   template <class T> MemoryAccounting::Entry memoryEntry( QHash<int,T*> const& hash, Brewtarget::DBTable table )
+   {
+      qint64 bytes = hash.size() * (MemoryAccounting::objectBytes<T>() + MemoryAccounting::hashNodeBytes<int,T*>());
+      foreach( T const* elem, hash )
+         bytes += MemoryAccounting::stringBytes(elem->_name) + MemoryAccounting::stringBytes(elem->_folder);
+      return MemoryAccounting::Entry( "Database", QString("%1 objects").arg(tableNames[table]), hash.size(), bytes );
+   }
+
+   //! \brief Logs what each store costs, against what it would if every row were an object
+   void logElementMemory();
+   template <class T> void logElementMemory( QHash<int,T*> const& hash, Brewtarget::DBTable table )
+   {
+      ElementStore const& store = stores[table];
+      qint64 perObject = MemoryAccounting::objectBytes<T>() + MemoryAccounting::hashNodeBytes<int,T*>();
+      qint64 asObjects = store.size() * perObject;
+      qint64 now = store.bytes() + hash.size() * perObject;
+
+      Brewtarget::log.info( QString("%1: %2 rows, %3 KiB as objects, %4 KiB now (%5 objects built)")
+                            .arg(tableNames[table]).arg(store.size())
+                            .arg(asObjects/1024).arg(now/1024).arg(hash.size()) );
+   }
+   //! \brief getInventoryID() without the cache
+   int findInventoryID(Brewtarget::DBTable table, int key);
 
    //! Get the right database connection for the calling thread.
    static QSqlDatabase sqlDatabase();
 
    //! Helper to populate all* hashes. T should be a BeerXMLElement subclass.
-   template <class T> void populateElements( QHash<int,T*>& hash, Brewtarget::DBTable table )
+   // With a snapshot, the keys and the cached columns come from there instead.
+   template <class T> void populateElements( QHash<int,T*>& hash, Brewtarget::DBTable table, DatabaseSnapshot const* snap = 0 )
    {
+      TraceSpan span("Database::populateElements", "db", tableNames[table]);
       int key;
       BeerXMLElement* e;
       T* et;
 
+      if ( snap )
+      {
+         QVector<DatabaseSnapshot::Row> const rows = snap->rows.value(table);
+         hash.reserve(rows.size());
+         foreach( DatabaseSnapshot::Row const& row, rows )
+         {
+            if ( hash.contains(row.key) )
+               continue;
+
+            e = new T();
+            et = qobject_cast<T*>(e);
+            et->_key = row.key;
+            et->_table = table;
+            et->_name = row.name;
+            et->_folder = row.folder;
+            if ( row.display >= 0 )
+               et->_display = QVariant(row.display != 0);
+            if ( row.deleted >= 0 )
+               et->_deleted = QVariant(row.deleted != 0);
+
+            hash.insert(row.key,et);
+         }
+         return;
+      }
+
       QSqlQuery q(sqlDatabase());
       q.setForwardOnly(true);
       QString queryString = QString("SELECT id FROM %1").arg(tableNames[table]);
@@ -575,7 +771,7 @@ private:
    }
 
    //! Helper to populate the list using the given filter.
-   template <class T> bool getElements( QList<T*>& list, QString filter, Brewtarget::DBTable table, QHash<int,T*> allElements, QString id=QString("") )
+   template <class T> bool getElements( QList<T*>& list, QString filter, Brewtarget::DBTable table, QHash<int,T*>& allElements, QString id=QString("") )
    {
       int key;
       QSqlQuery q(sqlDatabase());
@@ -603,8 +799,9 @@ private:
       while( q.next() )
       {
          key = q.record().value("id").toInt();
-         if( allElements.contains(key) )
-            list.append( allElements[key] );
+         T* elem = element( allElements, key );
+         if( elem )
+            list.append( elem );
       }
 
       q.finish();
@@ -881,6 +1078,61 @@ private:
       return newOne;
    }
 
+   //! \brief rewrites the cached folder of each element in \c hash that lives in or below \c oldPath
+   template<class T> void renameCachedFolders( QHash<int,T*>& hash, QString const& oldPath, QString const& newPath )
+   {
+      QString prefix = oldPath + "/";
+      foreach( BeerXMLElement* elem, hash )
+      {
+         // Anything that hasn't read its folder yet will get the new one from
+         // the db when it does
+         QString& folder = elem->_folder;
+         if ( folder == oldPath )
+            folder = newPath;
+         else if ( folder.startsWith(prefix) )
+            folder = newPath + folder.mid(oldPath.length());
+      }
+   }
+
+   /*!
+    * \brief Set-based copy of every \em T in \b other into \b newRec.
+    * The rows are cloned with a handful of INSERT ... SELECT statements by
+    * cloneRowsInRecipe() and the objects are made from the new keys without
+    * going back to the database.
+    * \returns the new objects, already in \b keyHash.
+    */
+   template<class T> QList<T*> cloneIngredientsInRecipe( Recipe* other, Recipe* newRec, QHash<int,T*>* keyHash )
+   {
+      const QMetaObject* meta = &T::staticMetaObject;
+      QString prefix = meta->classInfo( meta->indexOfClassInfo("prefix")).value();
+      QString propName = meta->classInfo( meta->indexOfClassInfo("signal")).value();
+      Brewtarget::DBTable table = classNameToTable[meta->className()];
+      QList<T*> ret;
+      QPair<int,int> keys;
+
+      foreach( keys, cloneRowsInRecipe(table, prefix, other->_key, newRec->_key) ) {
+         T* newOne = new T();
+         BeerXMLElement* newOneCast = qobject_cast<BeerXMLElement*>(newOne);
+         newOneCast->_key = keys.second;
+         newOneCast->_table = table;
+         keyHash->insert( keys.second, newOne );
+         ret.append(newOne);
+      }
+
+      if ( ! ret.isEmpty() )
+         emit newRec->changed( newRec->metaProperty(propName), QVariant() );
+
+      return ret;
+   }
+
+   /*!
+    * \brief Does the SQL for cloneIngredientsInRecipe(). Copies the rows of
+    * \b table used by recipe \b oldRecKey, then fills in
+    * <prefix>_in_recipe and <prefix>_children for \b newRecKey.
+    * \returns (old key, new key) pairs.
+    */
+   QList< QPair<int,int> > cloneRowsInRecipe( Brewtarget::DBTable table, QString const& prefix, int oldRecKey, int newRecKey );
+
    // Do an sql update.
    void sqlUpdate( Brewtarget::DBTable table, QString const& setClause, QString const& whereClause );
 
@@ -916,11 +1168,30 @@ private:
    // wants
    QVariant convertValue(Brewtarget::DBTypes newType, QSqlField field);
 
+   //! \brief makes a multi-row insert with \b rows sets of positional
+   // place holders. One statement per batch beats one per row by a mile
+   QString makeBulkInsertString( QSqlRecord here, QString realName, int rows );
+
    QStringList allTablesInOrder(QSqlQuery q);
 
+   //! \brief splits \b tables (in allTablesInOrder order) into waves. Every
+   // table in a wave only references tables in earlier waves, so the tables
+   // in one wave can be loaded at the same time
+   QList<QStringList> copyWaves(QStringList const& tables, Brewtarget::DBTypes newType, QSqlDatabase newDb);
+
+   //! \brief copies one table from \b oldDb to \b newDb in batches, inside
+   // its own transaction. Returns the number of rows copied
+   int copyTable( QString const& table, Brewtarget::DBTypes newType, QSqlDatabase oldDb, QSqlDatabase newDb);
+
    //! \brief does the heavy lifting to copy the contents from one db to the
    //next
    void copyDatabase( Brewtarget::DBTypes oldType, Brewtarget::DBTypes newType, QSqlDatabase oldDb);
+
+   //! \brief logs how many rows of \b what went across and how fast
+   static void reportCopy(QString const& what, int rows, qint64 msecs);
+
+   //! \brief runs copyTable() for one table on its own pair of connections
+   class CopyTableTask;
    void automaticBackup();
 
 };
@@ -23,6 +23,7 @@
 #include <QDomText>
 #include <QObject>
 #include "equipment.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 #include "HeatCalculations.h"
 
@@ -111,7 +112,7 @@ void Equipment::setBoilSize_l( double var )
    }
    else
    {
-      set("boilSize_l", "boil_size", var);
+      set(PropertyIds::Equipment::boilSize_l, "boil_size", var);
       emit changedBoilSize_l(var);
    }
 }
@@ -125,7 +126,7 @@ void Equipment::setBatchSize_l( double var )
    }
    else
    {
-      set("batchSize_l", "batch_size", var);
+      set(PropertyIds::Equipment::batchSize_l, "batch_size", var);
       doCalculations();
    }
 }
@@ -139,7 +140,7 @@ void Equipment::setTunVolume_l( double var )
    }
    else
    {
-      set("tunVolume_l", "tun_volume", var);
+      set(PropertyIds::Equipment::tunVolume_l, "tun_volume", var);
    }
 }
 
@@ -152,7 +153,7 @@ void Equipment::setTunWeight_kg( double var )
    }
    else
    {
-      set("tunWeight_kg", "tun_weight", var);
+      set(PropertyIds::Equipment::tunWeight_kg, "tun_weight", var);
    }
 }
 
@@ -165,7 +166,7 @@ void Equipment::setTunSpecificHeat_calGC( double var )
    }
    else
    {
-      set("tunSpecificHeat_calGC", "tun_specific_heat", var);
+      set(PropertyIds::Equipment::tunSpecificHeat_calGC, "tun_specific_heat", var);
    }
 }
 
@@ -178,7 +179,7 @@ void Equipment::setTopUpWater_l( double var )
    }
    else
    {
-      set("topUpWater_l", "top_up_water", var);
+      set(PropertyIds::Equipment::topUpWater_l, "top_up_water", var);
       doCalculations();
    }
 }
@@ -192,7 +193,7 @@ void Equipment::setTrubChillerLoss_l( double var )
    }
    else
    {
-      set("trubChillerLoss_l", "trub_chiller_loss", var);
+      set(PropertyIds::Equipment::trubChillerLoss_l, "trub_chiller_loss", var);
       doCalculations();
    }
 }
@@ -206,8 +207,8 @@ void Equipment::setEvapRate_pctHr( double var )
    }
    else
    {
-      set("evapRate_pctHr", "evap_rate", var);
-      set("evapRate_lHr", "real_evap_rate", var/100.0 * batchSize_l() ); // We always use this one, so set it.
+      set(PropertyIds::Equipment::evapRate_pctHr, "evap_rate", var);
+      set(PropertyIds::Equipment::evapRate_lHr, "real_evap_rate", var/100.0 * batchSize_l() ); // We always use this one, so set it.
       doCalculations();
    }
 }
@@ -221,7 +222,7 @@ void Equipment::setEvapRate_lHr( double var )
    }
    else
    {
-      set("evapRate_lHr", "real_evap_rate", var);
+      set(PropertyIds::Equipment::evapRate_lHr, "real_evap_rate", var);
       setEvapRate_pctHr( var/batchSize_l() * 100.0 ); // We don't use it, but keep it current.
       doCalculations();
    }
@@ -236,7 +237,7 @@ void Equipment::setBoilTime_min( double var )
    }
    else
    {
-      set("boilTime_min", "boil_time", var);
+      set(PropertyIds::Equipment::boilTime_min, "boil_time", var);
       emit changedBoilTime_min(var);
       doCalculations();
    }
@@ -244,7 +245,7 @@ void Equipment::setBoilTime_min( double var )
 
 void Equipment::setCalcBoilVolume( bool var )
 {
-   set("calcBoilVolume", "calc_boil_volume", var);
+   set(PropertyIds::Equipment::calcBoilVolume, "calc_boil_volume", var);
    if( var )
       doCalculations();
 }
@@ -258,7 +259,7 @@ void Equipment::setLauterDeadspace_l( double var )
    }
    else
    {
-      set("lauterDeadspace_l", "lauter_deadspace", var);
+      set(PropertyIds::Equipment::lauterDeadspace_l, "lauter_deadspace", var);
    }
 }
 
@@ -271,7 +272,7 @@ void Equipment::setTopUpKettle_l( double var )
    }
    else
    {
-      set("topUpKettle_l", "top_up_kettle", var);
+      set(PropertyIds::Equipment::topUpKettle_l, "top_up_kettle", var);
    }
 }
 
@@ -284,13 +285,13 @@ void Equipment::setHopUtilization_pct( double var )
    }
    else
    {
-      set("hopUtilization_pct", "hop_utilization", var);
+      set(PropertyIds::Equipment::hopUtilization_pct, "hop_utilization", var);
    }
 }
 
 void Equipment::setNotes( const QString &var )
 {
-   set("notes", "notes", var);
+   set(PropertyIds::Equipment::notes, "notes", var);
 }
 
 void Equipment::setGrainAbsorption_LKg(double var)
@@ -302,7 +303,7 @@ void Equipment::setGrainAbsorption_LKg(double var)
    }
    else
    {
-      set("absorption_LKg", "absorption", var);
+      set(PropertyIds::Equipment::grainAbsorption_LKg, "absorption", var);
    }
 }
 
@@ -315,7 +316,7 @@ void Equipment::setBoilingPoint_c(double var)
    }
    else 
    {
-      set("boilingPoint_c", "boiling_point", var);
+      set(PropertyIds::Equipment::boilingPoint_c, "boiling_point", var);
    }
 }
 
@@ -342,16 +343,25 @@ double Equipment::boilingPoint_c() const        { return get("boiling_point").to
 
 void Equipment::doCalculations()
 {
+   // One trip to the database instead of six
+   QVector<QVariant> vals = get( QVector<const char*>() << "calc_boil_volume" << "batch_size" << "top_up_water"
+                                                        << "trub_chiller_loss" << "boil_time" << "real_evap_rate" );
+
    // Only do the calculation if we're asked to.
-   if( ! calcBoilVolume() )
+   if( ! vals[0].toBool() )
       return;
 
-   setBoilSize_l( batchSize_l() - topUpWater_l() + trubChillerLoss_l() + (boilTime_min()/(double)60)*evapRate_lHr());
+   setBoilSize_l( vals[1].toDouble() - vals[2].toDouble() + vals[3].toDouble() + (vals[4].toDouble()/(double)60)*vals[5].toDouble());
 }
 
 double Equipment::wortEndOfBoil_l( double kettleWort_l ) const
+{
+   return wortEndOfBoil_l( kettleWort_l, boilTime_min(), evapRate_lHr() );
+}
+
+double Equipment::wortEndOfBoil_l( double kettleWort_l, double boilTime_min, double evapRate_lHr )
 {
    //return kettleWort_l * (1 - (boilTime_min/(double)60) * (evapRate_pctHr/(double)100) );
 
-   return kettleWort_l - (boilTime_min()/(double)60)*evapRate_lHr();
+   return kettleWort_l - (boilTime_min/(double)60)*evapRate_lHr;
 }
@@ -118,6 +118,8 @@ public:
 
    //! \brief Calculate how much wort is left immediately at knockout.
    double wortEndOfBoil_l( double kettleWort_l ) const;
+   //! \brief The same, for a boil that isn't in the database. RecipeSnapshot uses it
+   static double wortEndOfBoil_l( double kettleWort_l, double boilTime_min, double evapRate_lHr );
 
 signals:
    
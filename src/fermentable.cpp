@@ -26,6 +26,7 @@
 #include <QObject>
 #include <QDebug>
 #include "fermentable.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 
 QStringList Fermentable::types = QStringList() << "Grain" << "Sugar" << "Extract" << "Dry Extract" << "Adjunct";
@@ -108,9 +109,13 @@ const QString Fermentable::typeString() const
    return types.at(type());
 }
 const QString Fermentable::typeStringTr() const
+{
+   return typeStringTr(get("ftype").toString());
+}
+QString Fermentable::typeStringTr( QString const& type )
 {
    static QStringList typesTr = QStringList () << QObject::tr("Grain") << QObject::tr("Sugar") << QObject::tr("Extract") << QObject::tr("Dry Extract") << QObject::tr("Adjunct");
-   return typesTr.at(type());
+   return typesTr.at(types.indexOf(type));
 }
 
 const QString Fermentable::additionMethodStringTr() const
@@ -167,23 +172,28 @@ bool Fermentable::isExtract() { return ((type() == Extract) || (type() == Dry_Ex
 bool Fermentable::isSugar() { return (type() == Sugar); }
 bool Fermentable::isValidType( const QString& str ) { return (types.indexOf(str) >= 0); }
 
-void Fermentable::setType( Type t ) { set("type", "ftype", types.at(t)); }
+void Fermentable::setType( Type t ) { set(PropertyIds::Fermentable::type, "ftype", types.at(t)); }
 void Fermentable::setAdditionMethod( Fermentable::AdditionMethod m ) { setIsMashed(m == Fermentable::Mashed); }
 void Fermentable::setAdditionTime( Fermentable::AdditionTime t ) { setAddAfterBoil(t == Fermentable::Late ); }
-void Fermentable::setAddAfterBoil( bool b ) { set("addAfterBoil", "add_after_boil", b); }
-void Fermentable::setOrigin( const QString& str ) { set("origin","origin",str);}
-void Fermentable::setSupplier( const QString& str) { set("supplier","supplier",str);}
-void Fermentable::setNotes( const QString& str ) { set("notes","notes",str);}
-void Fermentable::setRecommendMash( bool b ) { set("recommendMash","recommend_mash",b);}
-void Fermentable::setIsMashed(bool var) { set("isMashed","is_mashed",var); }
-void Fermentable::setIbuGalPerLb( double num ) { set("ibuGalPerLb","ibu_gal_per_lb",num);}
+void Fermentable::setAddAfterBoil( bool b ) { set(PropertyIds::Fermentable::addAfterBoil, "add_after_boil", b); }
+void Fermentable::setOrigin( const QString& str ) { set(PropertyIds::Fermentable::origin,"origin",str);}
+void Fermentable::setSupplier( const QString& str) { set(PropertyIds::Fermentable::supplier,"supplier",str);}
+void Fermentable::setNotes( const QString& str ) { set(PropertyIds::Fermentable::notes,"notes",str);}
+void Fermentable::setRecommendMash( bool b ) { set(PropertyIds::Fermentable::recommendMash,"recommend_mash",b);}
+void Fermentable::setIsMashed(bool var) { set(PropertyIds::Fermentable::isMashed,"is_mashed",var); }
+void Fermentable::setIbuGalPerLb( double num ) { set(PropertyIds::Fermentable::ibuGalPerLb,"ibu_gal_per_lb",num);}
 
 double Fermentable::equivSucrose_kg() const
 {
-   double ret = amount_kg() * yield_pct() * (1.0-moisture_pct()/100.0) / 100.0;
+   return equivSucrose_kg( type(), amount_kg(), yield_pct(), moisture_pct(), isMashed() );
+}
+
+double Fermentable::equivSucrose_kg( Type type, double amount_kg, double yield_pct, double moisture_pct, bool isMashed )
+{
+   double ret = amount_kg * yield_pct * (1.0-moisture_pct/100.0) / 100.0;
    
    // If this is a steeped grain...
-   if( type() == Grain && !isMashed() )
+   if( type == Grain && !isMashed )
       return 0.60 * ret; // Reduce the yield by 60%.
    else
       return ret;
@@ -197,7 +207,7 @@ void Fermentable::setAmount_kg( double num )
    }
    else
    {
-      set("amount_kg", "amount", num);
+      set(PropertyIds::Fermentable::amount_kg, "amount", num);
    }
 }
 void Fermentable::setInventoryAmount( double num )
@@ -209,14 +219,14 @@ void Fermentable::setInventoryAmount( double num )
    }
    else
    {
-      setInventory("inventory", "amount", num);
+      setInventory(PropertyIds::Fermentable::inventory, "amount", num);
    }
 }
 void Fermentable::setYield_pct( double num )
 {
    if( num >= 0.0 && num <= 100.0 )
    {
-      set("yield_pct", "yield", num);
+      set(PropertyIds::Fermentable::yield_pct, "yield", num);
    }
    else
    {
@@ -232,14 +242,14 @@ void Fermentable::setColor_srm( double num )
    }
    else
    {
-      set("color_srm", "color", num);
+      set(PropertyIds::Fermentable::color_srm, "color", num);
    }
 }
 void Fermentable::setCoarseFineDiff_pct( double num )
 {
    if( num >= 0.0 && num <= 100.0 )
    {
-      set("coarseFineDiff_pct", "coarse_fine_diff", num);
+      set(PropertyIds::Fermentable::coarseFineDiff_pct, "coarse_fine_diff", num);
    }
    else
    {
@@ -250,7 +260,7 @@ void Fermentable::setMoisture_pct( double num )
 {
    if( num >= 0.0 && num <= 100.0 )
    {
-      set("moisture_pct", "moisture", num);
+      set(PropertyIds::Fermentable::moisture_pct, "moisture", num);
    }
    else
    {
@@ -266,14 +276,14 @@ void Fermentable::setDiastaticPower_lintner( double num )
    }
    else
    {
-      set("diastaticPower_lintner", "diastatic_power", num);
+      set(PropertyIds::Fermentable::diastaticPower_lintner, "diastatic_power", num);
    }
 }
 void Fermentable::setProtein_pct( double num )
 {
    if( num >= 0.0 && num <= 100.0 )
    {
-      set("protein_pct", "protein", num);
+      set(PropertyIds::Fermentable::protein_pct, "protein", num);
    }
    else
    {
@@ -284,7 +294,7 @@ void Fermentable::setMaxInBatch_pct( double num )
 {
    if( num >= 0.0 && num <= 100.0 )
    {
-      set("maxInBatch_pct", "max_in_batch", num);
+      set(PropertyIds::Fermentable::maxInBatch_pct, "max_in_batch", num);
    }
    else
    {
@@ -118,6 +118,8 @@ public:
 
    //! Returns a translated type string.
    const QString typeStringTr() const;
+   //! The translated name of what the database calls \b type
+   static QString typeStringTr( QString const& type );
    const AdditionMethod additionMethod() const;
 
    //! Returns a translated addition method string.
@@ -144,6 +146,8 @@ public:
 
    // Calculated getters.
    double equivSucrose_kg() const;
+   //! \brief equivSucrose_kg() for one that isn't in the database. RecipeSnapshot uses it
+   static double equivSucrose_kg( Type type, double amount_kg, double yield_pct, double moisture_pct, bool isMashed );
 
    void setType( Type t );
    void setAdditionMethod( AdditionMethod m );
@@ -24,6 +24,7 @@
 #include <QDomText>
 #include <QObject>
 #include "hop.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 
 QStringList Hop::types = QStringList() << "Bittering" << "Aroma" << "Both";
@@ -100,7 +101,7 @@ void Hop::setAlpha_pct( double num )
    }
    else
    {
-      set("alpha_pct", "alpha", num);
+      set(PropertyIds::Hop::alpha_pct, "alpha", num);
    }
 }
 
@@ -113,7 +114,7 @@ void Hop::setAmount_kg( double num )
    }
    else
    {
-      set("amount_kg", "amount", num);
+      set(PropertyIds::Hop::amount_kg, "amount", num);
    }
 }
 
@@ -126,14 +127,14 @@ void Hop::setInventoryAmount( double num )
    }
    else
    {
-      setInventory("inventory", "amount", num);
+      setInventory(PropertyIds::Hop::inventory, "amount", num);
    }
 }
 
 void Hop::setUse(Use u)
 {
    if ( u >= 0 )
-      set("use", "use", uses.at(u));
+      set(PropertyIds::Hop::use, "use", uses.at(u));
 }
 
 void Hop::setTime_min( double num )
@@ -145,25 +146,25 @@ void Hop::setTime_min( double num )
    }
    else
    {
-      set("time_min", "time", num);
+      set(PropertyIds::Hop::time_min, "time", num);
    }
 }
       
 void Hop::setNotes( const QString& str )
 {
-   set("notes", "notes", str);
+   set(PropertyIds::Hop::notes, "notes", str);
 }
 
 void Hop::setType(Type t)
 {
   if ( t >= 0 )
-     set("type", "htype", types.at(t));
+     set(PropertyIds::Hop::type, "htype", types.at(t));
 }
 
 void Hop::setForm( Form f )
 {
    if ( f >= 0 )
-     set("form", "form", forms.at(f));
+     set(PropertyIds::Hop::form, "form", forms.at(f));
 }
 
 void Hop::setBeta_pct( double num )
@@ -175,7 +176,7 @@ void Hop::setBeta_pct( double num )
    }
    else
    {
-      set("beta_pct", "beta", num);
+      set(PropertyIds::Hop::beta_pct, "beta", num);
    }
 }
 
@@ -188,18 +189,18 @@ void Hop::setHsi_pct( double num )
    }
    else
    {
-      set("hsi_pct", "hsi", num);
+      set(PropertyIds::Hop::hsi_pct, "hsi", num);
    }
 }
 
 void Hop::setOrigin( const QString& str )
 {
-   set("origin", "origin", str);
+   set(PropertyIds::Hop::origin, "origin", str);
 }
 
 void Hop::setSubstitutes( const QString& str )
 {
-   set("substitutes", "substitutes", str);
+   set(PropertyIds::Hop::substitutes, "substitutes", str);
 }
 
 void Hop::setHumulene_pct( double num )
@@ -211,7 +212,7 @@ void Hop::setHumulene_pct( double num )
    }
    else
    {
-      set("humulene_pct", "humulene", num);
+      set(PropertyIds::Hop::humulene_pct, "humulene", num);
    }
 }
 
@@ -224,7 +225,7 @@ void Hop::setCaryophyllene_pct( double num )
    }
    else
    {
-      set("caryophyllene_pct", "caryophyllene", num);
+      set(PropertyIds::Hop::caryophyllene_pct, "caryophyllene", num);
    }
 }
 
@@ -237,7 +238,7 @@ void Hop::setCohumulone_pct( double num )
    }
    else
    {
-      set("cohumulone_pct", "cohumulone", num);
+      set(PropertyIds::Hop::cohumulone_pct, "cohumulone", num);
    }
 }
 
@@ -250,7 +251,7 @@ void Hop::setMyrcene_pct( double num )
    }
    else
    {
-      set("myrcene_pct", "myrcene", num);
+      set(PropertyIds::Hop::myrcene_pct, "myrcene", num);
    }
 }
 
@@ -283,9 +284,14 @@ double Hop::inventory() const
 }
 
 const QString Hop::useStringTr() const
+{
+   return useStringTr(get("use").toString());
+}
+
+QString Hop::useStringTr( QString const& use )
 {
    static QStringList usesTr = QStringList() << tr("Mash") << tr("First Wort") << tr("Boil") << tr("Aroma") << tr("Dry Hop") ;
-   return usesTr.at(use());
+   return usesTr.at(uses.indexOf(use));
 }
 
 const QString Hop::typeStringTr() const
@@ -295,8 +301,13 @@ const QString Hop::typeStringTr() const
 }
 
 const QString Hop::formStringTr() const
+{
+   return formStringTr(get("form").toString());
+}
+
+QString Hop::formStringTr( QString const& form )
 {
    static QStringList formsTr = QStringList() << tr("Leaf") << tr("Pellet") << tr("Plug");
-   return formsTr.at(form());
+   return formsTr.at(forms.indexOf(form));
 }
 
@@ -99,6 +99,8 @@ public:
 
    //! \brief A translated use string.
    const QString useStringTr() const;
+   //! \brief The translated name of what the database calls \b use
+   static QString useStringTr( QString const& use );
    double time_min() const;
    const QString notes() const;
    Type type() const;
@@ -109,6 +111,8 @@ public:
    const QString formString() const;
    //! \brief A translated form string.
    const QString formStringTr() const;
+   //! \brief The translated name of what the database calls \b form
+   static QString formStringTr( QString const& form );
    double beta_pct() const;
    double hsi_pct() const;
    const QString origin() const;
@@ -19,6 +19,7 @@
  */
 
 #include "instruction.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 #include "database.h"
 
@@ -47,22 +48,22 @@ Instruction::Instruction()
 // Setters ====================================================================
 void Instruction::setDirections(const QString& dir)
 {
-   set("directions", "directions", dir);
+   set(PropertyIds::Instruction::directions, "directions", dir);
 }
 
 void Instruction::setHasTimer(bool has)
 {
-   set("hasTimer", "hasTimer", has);
+   set(PropertyIds::Instruction::hasTimer, "hasTimer", has);
 }
 
 void Instruction::setTimerValue(const QString& timerVal)
 {
-   set("timerValue", "timerValue", timerVal);
+   set(PropertyIds::Instruction::timerValue, "timerValue", timerVal);
 }
 
 void Instruction::setCompleted(bool comp)
 {
-   set("completed", "completed", comp);
+   set(PropertyIds::Instruction::completed, "completed", comp);
 }
 
 // TODO: figure out.
@@ -75,7 +76,7 @@ void Instruction::setReagent(const QString& reagent)
 
 void Instruction::setInterval(double time) 
 {
-   set("interval", "interval", time);
+   set(PropertyIds::Instruction::interval, "interval", time);
 }
 
 void Instruction::addReagent(const QString& reagent)
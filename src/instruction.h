@@ -42,9 +42,24 @@ class Instruction : public BeerXMLElement
    Q_CLASSINFO("prefix", "instruction")
    friend class Database;
 public:
-   
+
    virtual ~Instruction() {}
 
+   /*!
+    * \brief An instruction that only exists in memory so far. Recipes build
+    * a list of these and hand the lot to Database::replaceInstructions().
+    */
+   struct Draft
+   {
+      Draft( QString const& n = QString(), QString const& dir = QString(), double t = 0.0 )
+         : name(n), directions(dir), interval(t) {}
+
+      QString name;
+      QString directions;
+      double interval;
+      QList<QString> reagents;
+   };
+
    Q_PROPERTY( QString directions READ directions WRITE setDirections /*NOTIFY changed*/ /*changedDirections*/ )
    Q_PROPERTY( bool hasTimer READ hasTimer WRITE setHasTimer /*NOTIFY changed*/ /*changedHasTimer*/ )
    Q_PROPERTY( QString timerValue READ timerValue WRITE setTimerValue /*NOTIFY changed*/ /*changedTimerValue*/ )
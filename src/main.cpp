@@ -25,12 +25,26 @@
 #include "config.h"
 #include "brewtarget.h"
 #include "database.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
 
 void importFromXml(const QString & filename);
 void createBlankDb(const QString & filename);
 
 int main(int argc, char **argv)
 {  
+   // Start the clock as early as we can. --trace below turns it on too, but
+   // only after Qt is up.
+   if ( qEnvironmentVariableIsSet("BREWTARGET_TRACE") )
+      Trace::enable(QString::fromLocal8Bit(qgetenv("BREWTARGET_TRACE")));
+
+   // Printing from the command line shouldn't need a display. The parser
+   // isn't up yet, but it only has to be spotted, not understood.
+   for ( int i = 1; i < argc; ++i ) {
+      if ( QByteArray(argv[i]).startsWith("--print-pdf") && ! qEnvironmentVariableIsSet("QT_QPA_PLATFORM") )
+         qputenv("QT_QPA_PLATFORM", "offscreen");
+   }
+
    QApplication app(argc, argv);
    app.setOrganizationName("brewtarget");
 
@@ -58,14 +72,46 @@ int main(int argc, char **argv)
     */
    const QCommandLineOption userDirectoryOption("user-dir", "Overwrite the directory used by the application with <directory>", "directory", QString());
 
+   /*!
+    * \brief Records where startup time goes into <file>, which
+    * chrome://tracing or Perfetto can open. Setting BREWTARGET_TRACE=<file>
+    * does the same thing.
+    */
+   const QCommandLineOption traceOption("trace", "Write a trace of startup, recalcs and SQL to <file>", "file");
+
+   /*!
+    * \brief Prints what is holding memory to stdout on the way out, while
+    * everything is still alive.
+    */
+   const QCommandLineOption memoryReportOption("memory-report", "Print estimated memory use per subsystem on exit");
+
+   /*!
+    * \brief Prints the recipes named after the options into a PDF and quits,
+    * without ever showing a window. --brew-sheets prints their brew day
+    * sheets instead.
+    */
+   const QCommandLineOption printPdfOption("print-pdf", "Print the recipes named on the command line into the PDF <file>, with no window", "file");
+   const QCommandLineOption brewSheetsOption("brew-sheets", "With --print-pdf, print brew day sheets instead of recipes");
+
    parser.addOption(importFromXmlOption);
    parser.addOption(createBlankDBOption);
    parser.addOption(userDirectoryOption);
+   parser.addOption(traceOption);
+   parser.addOption(memoryReportOption);
+   parser.addOption(printPdfOption);
+   parser.addOption(brewSheetsOption);
+   parser.addPositionalArgument("recipes", "With --print-pdf, the names of the recipes to print", "[recipes...]");
 
    parser.process(app);
 
+   if (parser.isSet(traceOption)) Trace::enable(parser.value(traceOption));
+   if (parser.isSet(memoryReportOption)) MemoryAccounting::setDumpAtExit(true);
+
    if (parser.isSet(importFromXmlOption)) importFromXml(parser.value(importFromXmlOption));
    if (parser.isSet(createBlankDBOption)) createBlankDb(parser.value(createBlankDBOption));
+   if (parser.isSet(printPdfOption))
+      return Brewtarget::printPdf(parser.value(userDirectoryOption), parser.value(printPdfOption),
+                                  parser.positionalArguments(), parser.isSet(brewSheetsOption));
    
    return Brewtarget::run(parser.value(userDirectoryOption));
 }
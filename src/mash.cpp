@@ -22,6 +22,7 @@
 #include <string>
 #include <QVector>
 #include "mash.h"
+#include "PropertyIds.h"
 #include "mashstep.h"
 #include "brewtarget.h"
 #include "database.h"
@@ -61,11 +62,11 @@ Mash::Mash()
 {
 }
 
-void Mash::setGrainTemp_c( double var ) { set("grainTemp_c", "grain_temp", var); }
-void Mash::setNotes( const QString& var ) { set("notes", "notes", var); }
-void Mash::setTunTemp_c( double var ) { set("tunTemp_c", "tun_temp", var); }
-void Mash::setSpargeTemp_c( double var ) { set("spargeTemp_c", "sparge_temp", var); }
-void Mash::setEquipAdjust( bool var ) { set("equipAdjust", "equip_adjust", var); }
+void Mash::setGrainTemp_c( double var ) { set(PropertyIds::Mash::grainTemp_c, "grain_temp", var); }
+void Mash::setNotes( const QString& var ) { set(PropertyIds::Mash::notes, "notes", var); }
+void Mash::setTunTemp_c( double var ) { set(PropertyIds::Mash::tunTemp_c, "tun_temp", var); }
+void Mash::setSpargeTemp_c( double var ) { set(PropertyIds::Mash::spargeTemp_c, "sparge_temp", var); }
+void Mash::setEquipAdjust( bool var ) { set(PropertyIds::Mash::equipAdjust, "equip_adjust", var); }
 
 void Mash::setPh( double var )
 {
@@ -76,7 +77,7 @@ void Mash::setPh( double var )
    }
    else
    {
-      set("ph", "ph", var);
+      set(PropertyIds::Mash::ph, "ph", var);
    }
 }
 
@@ -89,7 +90,7 @@ void Mash::setTunWeight_kg( double var )
    }
    else
    {
-      set("tunWeight_kg", "tun_weight", var);
+      set(PropertyIds::Mash::tunWeight_kg, "tun_weight", var);
    }
 }
 
@@ -102,7 +103,7 @@ void Mash::setTunSpecificHeat_calGC( double var )
    }
    else
    {
-      set("tunSpecificHeat_calGC", "tun_specific_heat", var);
+      set(PropertyIds::Mash::tunSpecificHeat_calGC, "tun_specific_heat", var);
    }
 }
 
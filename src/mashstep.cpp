@@ -19,6 +19,7 @@
 
 #include <QVector>
 #include "mashstep.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 
 QStringList MashStep::types = QStringList() << "Infusion" << "Temperature" << "Decoction" << "Fly Sparge" << "Batch Sparge";
@@ -61,12 +62,12 @@ MashStep::MashStep()
 //================================"SET" METHODS=================================
 void MashStep::setInfuseTemp_c(double var)
 {
-   set("infuseTemp_c", "infuse_temp", var);
+   set(PropertyIds::MashStep::infuseTemp_c, "infuse_temp", var);
 }
 
 void MashStep::setType( Type t )
 {
-   set("type", "mstype", types.at(t));
+   set(PropertyIds::MashStep::type, "mstype", types.at(t));
 }
 
 void MashStep::setInfuseAmount_l( double var )
@@ -78,7 +79,7 @@ void MashStep::setInfuseAmount_l( double var )
    }
    else
    {
-      set("infuseAmount_l", "infuse_amount", var);
+      set(PropertyIds::MashStep::infuseAmount_l, "infuse_amount", var);
    }
 }
 
@@ -91,7 +92,7 @@ void MashStep::setStepTemp_c( double var )
    }
    else
    {
-      set("stepTemp_c", "step_temp", var);
+      set(PropertyIds::MashStep::stepTemp_c, "step_temp", var);
    }
 }
 
@@ -104,7 +105,7 @@ void MashStep::setStepTime_min( double var )
    }
    else
    {
-      set("stepTime_min", "step_time", var);
+      set(PropertyIds::MashStep::stepTime_min, "step_time", var);
    }
 }
 
@@ -118,7 +119,7 @@ void MashStep::setRampTime_min( double var )
    }
    else
    {
-      set("rampTime_min", "ramp_time", var);
+      set(PropertyIds::MashStep::rampTime_min, "ramp_time", var);
    }
 }
 
@@ -131,13 +132,13 @@ void MashStep::setEndTemp_c( double var )
    }
    else
    {
-      set("endTemp_c", "end_temp", var);
+      set(PropertyIds::MashStep::endTemp_c, "end_temp", var);
    }
 }
 
 void MashStep::setDecoctionAmount_l(double var)
 {
-   set("decoctionAmount_l", "decoction_amount", var);
+   set(PropertyIds::MashStep::decoctionAmount_l, "decoction_amount", var);
 }
 
 //============================="GET" METHODS====================================
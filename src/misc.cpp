@@ -24,6 +24,7 @@
 #include <string>
 #include <QVector>
 #include "misc.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 #include <QDomElement>
 #include <QDomText>
@@ -73,15 +74,25 @@ Misc::AmountType Misc::amountType() const { return amountIsWeight() ? AmountType
 const QString Misc::amountTypeString() const { return amountTypes.at(amountType()); }
 
 const QString Misc::typeStringTr() const
+{
+   return typeStringTr(get("mtype").toString());
+}
+
+QString Misc::typeStringTr( QString const& type )
 {
    QStringList typesTr = QStringList() << tr("Spice") << tr("Fining") << tr("Water Agent") << tr("Herb") << tr("Flavor") << tr("Other");
-   return typesTr.at(type());
+   return typesTr.at(types.indexOf(type));
 }
 
 const QString Misc::useStringTr() const
+{
+   return useStringTr(get("use").toString());
+}
+
+QString Misc::useStringTr( QString const& use )
 {
    QStringList usesTr = QStringList() << tr("Boil") << tr("Mash") << tr("Primary") << tr("Secondary") << tr("Bottling");
-   return usesTr.at(use());
+   return usesTr.at(uses.indexOf(use));
 }
 
 const QString Misc::amountTypeStringTr() const
@@ -91,19 +102,19 @@ const QString Misc::amountTypeStringTr() const
 }
 
 //============================"SET" METHODS=====================================
-void Misc::setType( Type t ) { set( "type", "mtype", types.at(t) ); }
-void Misc::setUse( Use u ) { set( "use", "use", uses.at(u) ); }
+void Misc::setType( Type t ) { set( PropertyIds::Misc::type, "mtype", types.at(t) ); }
+void Misc::setUse( Use u ) { set( PropertyIds::Misc::use, "use", uses.at(u) ); }
 void Misc::setAmountType( AmountType t ) { setAmountIsWeight(t == AmountType_Weight ? true : false); }
-void Misc::setUseFor( const QString& var ) { set( "useFor", "use_for", var ); }
-void Misc::setNotes( const QString& var ) { set( "notes", "notes", var ); }
-void Misc::setAmountIsWeight( bool var ) { set( "amountIsWeight", "amount_is_weight", var ); }
+void Misc::setUseFor( const QString& var ) { set( PropertyIds::Misc::useFor, "use_for", var ); }
+void Misc::setNotes( const QString& var ) { set( PropertyIds::Misc::notes, "notes", var ); }
+void Misc::setAmountIsWeight( bool var ) { set( PropertyIds::Misc::amountIsWeight, "amount_is_weight", var ); }
 
 void Misc::setAmount( double var )
 {
    if( var < 0.0 )
       Brewtarget::logW( QString("Misc: amount < 0: %1").arg(var) );
    else
-      set( "amount", "amount", var );
+      set( PropertyIds::Misc::amount, "amount", var );
 }
 
 void Misc::setInventoryAmount( double var )
@@ -111,7 +122,7 @@ void Misc::setInventoryAmount( double var )
    if( var < 0.0 )
       Brewtarget::logW( QString("Misc: inventory < 0: %1").arg(var) );
    else
-      setInventory("inventory", "amount", var );
+      setInventory(PropertyIds::Misc::inventory, "amount", var );
 }
 
 void Misc::setTime( double var )
@@ -119,7 +130,7 @@ void Misc::setTime( double var )
    if( var < 0.0 )
       Brewtarget::logW( QString("Misc: time < 0: %1").arg(var) );
    else
-      set( "time", "time", var );
+      set( PropertyIds::Misc::time, "time", var );
 }
 
 //========================OTHER METHODS=========================================
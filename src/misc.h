@@ -101,9 +101,13 @@ public:
    Type type() const;
    const QString typeString() const;
    const QString typeStringTr() const;
+   //! The translated name of what the database calls \b type
+   static QString typeStringTr( QString const& type );
    Use use() const;
    const QString useString() const;
    const QString useStringTr() const;
+   //! The translated name of what the database calls \b use
+   static QString useStringTr( QString const& use );
    AmountType amountType() const;
    const QString amountTypeString() const;
    const QString amountTypeStringTr() const;
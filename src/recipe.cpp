@@ -33,8 +33,12 @@
 #include <QObject>
 #include <QDebug>
 #include <QSharedPointer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 #include "recipe.h"
+#include "PropertyIds.h"
 #include "style.h"
 #include "misc.h"
 #include "mash.h"
@@ -49,8 +53,10 @@
 #include "IbuMethods.h"
 #include "ColorMethods.h"
 #include "HeatCalculations.h"
+#include "RecipeCalculator.h"
 #include "PhysicalConstants.h"
 #include "QueuedMethod.h"
+#include "Trace.h"
 
 QHash<QString,QString> Recipe::tagToProp = Recipe::tagToPropHash();
 
@@ -153,11 +159,7 @@ void Recipe::swapInstructions( Instruction* ins1, Instruction* ins2 )
 
 void Recipe::clearInstructions()
 {
-   QList<Instruction*> ins = instructions();
-   int i, size;
-   size = ins.size();
-   for( i = 0; i < size; ++i )
-      removeInstruction(ins[i]);
+   Database::instance().replaceInstructions(this, QList<Instruction::Draft>());
 }
 
 void Recipe::insertInstruction(Instruction* ins, int pos)
@@ -168,15 +170,12 @@ void Recipe::insertInstruction(Instruction* ins, int pos)
    Database::instance().insertInstruction(ins,pos);
 }
 
-Instruction* Recipe::mashFermentableIns()
+void Recipe::mashFermentableIns(QList<Instruction::Draft>& ins)
 {
-   Instruction* ins;
    QString str,tmp;
    int i;
 
    /*** Add grains ***/
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Add grains"));
    str = tr("Add ");
    QList<QString> reagents = getReagents(fermentables());
 
@@ -184,32 +183,24 @@ Instruction* Recipe::mashFermentableIns()
       str += reagents.at(i);
 
    str += tr("to the mash tun.");
-   ins->setDirections(str);
-
-   return ins;
-
+   ins.append( Instruction::Draft(tr("Add grains"), str) );
 }
 
-Instruction* Recipe::mashWaterIns(unsigned int size)
+void Recipe::mashWaterIns(QList<Instruction::Draft>& ins, unsigned int size)
 {
-   Instruction* ins;
    QString str, tmp;
    int i;
 
    if( mash() == 0 )
-      return 0;
+      return;
    
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Heat water"));
    str = tr("Bring ");
    QList<QString> reagents = getReagents(mash()->mashSteps());
    for( i = 0; i < reagents.size(); ++i )
       str += reagents.at(i);
 
    str += tr("for upcoming infusions.");
-   ins->setDirections(str);
-
-   return ins;
+   ins.append( Instruction::Draft(tr("Heat water"), str) );
 }
 
 QVector<PreInstruction> Recipe::mashInstructions(double timeRemaining, double totalWaterAdded_l, unsigned int size)
@@ -338,9 +329,8 @@ QVector<PreInstruction> Recipe::miscSteps(Misc::Use type)
    return preins;
 }
 
-Instruction* Recipe::firstWortHopsIns()
+void Recipe::firstWortHopsIns(QList<Instruction::Draft>& ins)
 {
-   Instruction* ins;
    QString str;
    QList<QString> reagents;
 
@@ -354,19 +344,14 @@ Instruction* Recipe::firstWortHopsIns()
          str += reagents.at(i);
 
       str += ".";
-      ins = Database::instance().newInstruction(this);
-      ins->setName(tr("First wort hopping"));
-      ins->setDirections(str);
-      return ins;
+      ins.append( Instruction::Draft(tr("First wort hopping"), str) );
    }
-   return 0;
 }
 
-Instruction* Recipe::topOffIns()
+void Recipe::topOffIns(QList<Instruction::Draft>& ins)
 {
    double wortInBoil_l = 0.0;
    QString str,tmp;
-   Instruction* ins;
 
    Equipment* e = equipment();
    if( e != 0 )
@@ -383,14 +368,11 @@ Instruction* Recipe::topOffIns()
 
          str += tmp;
 
-         ins = Database::instance().newInstruction(this);
-         ins->setName(tr("Pre-boil"));
-         ins->setDirections(str);
-         ins->addReagent(tmp);
-         return ins;
+         Instruction::Draft preboil(tr("Pre-boil"), str);
+         preboil.reagents.append(tmp);
+         ins.append(preboil);
       }
    }
-   return 0;
 }
 
 bool Recipe::hasBoilFermentable()
@@ -477,9 +459,8 @@ PreInstruction Recipe::addExtracts(double timeRemaining)
    return PreInstruction(str, tr("Add Extracts to water"), timeRemaining);
 }
 
-Instruction* Recipe::postboilFermentablesIns()
+void Recipe::postboilFermentablesIns(QList<Instruction::Draft>& ins)
 {
-   Instruction* ins;
    QString str,tmp;
    unsigned int i;
    int size;
@@ -504,22 +485,15 @@ Instruction* Recipe::postboilFermentablesIns()
 
    if( hasFerms )
    {
-      ins = Database::instance().newInstruction(this);
-      ins->setName(tr("Knockout additions"));
-      ins->setDirections(str);
-      ins->addReagent(tmp);
-      return ins;
-   }
-   else
-   {
-      return 0;
+      Instruction::Draft knockout(tr("Knockout additions"), str);
+      knockout.reagents.append(tmp);
+      ins.append(knockout);
    }
 }
 
-Instruction* Recipe::postboilIns()
+void Recipe::postboilIns(QList<Instruction::Draft>& ins)
 {
    QString str;
-   Instruction* ins;
    double wort_l = 0.0;
    double wortInBoil_l = 0.0;
 
@@ -543,45 +517,33 @@ Instruction* Recipe::postboilIns()
       str += tr("\nThe final volume in the primary is %1.")
              .arg(Brewtarget::displayAmount(wort_l,"tab_recipe", "batchSize_l",  Units::liters));
 
-      ins = Database::instance().newInstruction(this);
-      ins->setName(tr("Post boil"));
-      ins->setDirections(str);
-      return ins;
-   }
-   else
-   {
-      return 0;
+      ins.append( Instruction::Draft(tr("Post boil"), str) );
    }
 }
 
-void Recipe::addPreinstructions( QVector<PreInstruction> preins )
+void Recipe::addPreinstructions( QList<Instruction::Draft>& ins, QVector<PreInstruction> preins )
 {
    unsigned int i;
-   Instruction* ins;
 
     // Add instructions in descending mash time order.
     qSort( preins.begin(), preins.end(), qGreater<PreInstruction>() );
     for( i=0; static_cast<int>(i) < preins.size(); ++i )
     {
        PreInstruction pi = preins[i];
-       ins = Database::instance().newInstruction(this);
-       ins->setName(pi.getTitle());
-       ins->setDirections(pi.getText());
-       ins->setInterval(pi.getTime());
+       ins.append( Instruction::Draft(pi.getTitle(), pi.getText(), pi.getTime()) );
     }
 }
 
 void Recipe::generateInstructions()
 {
-   Instruction* ins;
+   QList<Instruction::Draft> ins;
    QString str, tmp;
    unsigned int i, size;
    double timeRemaining;
    double totalWaterAdded_l = 0.0;
 
-   if ( ! instructions().empty() )
-      clearInstructions();
-
+   // Everything gets written in one go at the end, so nothing here touches
+   // the database but to read.
    QVector<PreInstruction> preinstructions;
 
    // Mash instructions
@@ -590,10 +552,10 @@ void Recipe::generateInstructions()
    if( size > 0 )
    {
      /*** prepare mashed fermentables ***/
-     mashFermentableIns();
+     mashFermentableIns(ins);
 
      /*** Prepare water additions ***/
-     mashWaterIns(size);
+     mashWaterIns(ins, size);
 
      timeRemaining = mash()->totalTime();
 
@@ -607,15 +569,15 @@ void Recipe::generateInstructions()
      preinstructions += miscSteps(Misc::Mash);
 
      /*** Add the preinstructions into the instructions ***/
-     addPreinstructions(preinstructions);
+     addPreinstructions(ins, preinstructions);
 
    } // END mash instructions.
 
    // First wort hopping
-   firstWortHopsIns();
+   firstWortHopsIns(ins);
     
    // Need to top up the kettle before boil?
-   topOffIns();
+   topOffIns(ins);
 
    // Boil instructions
    preinstructions.clear();   
@@ -632,10 +594,7 @@ void Recipe::generateInstructions()
    }
    
    str = tr("Bring the wort to a boil and hold for %1.").arg(Brewtarget::displayAmount( timeRemaining, "tab_recipe", "boilTime_min", Units::minutes));
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Start boil"));
-   ins->setInterval(timeRemaining);
-   ins->setDirections(str);
+   ins.append( Instruction::Draft(tr("Start boil"), str, timeRemaining) );
    
    /*** Get fermentables unless we haven't added yet ***/
    if ( hasBoilFermentable() )
@@ -654,26 +613,24 @@ void Recipe::generateInstructions()
    // END boil instructions.
 
    // Add instructions in descending mash time order.
-   addPreinstructions(preinstructions);
+   addPreinstructions(ins, preinstructions);
 
    // FLAMEOUT
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Flameout"));
-   ins->setDirections(tr("Stop boiling the wort."));
+   ins.append( Instruction::Draft(tr("Flameout"), tr("Stop boiling the wort.")) );
 
    // Steeped aroma hops
    preinstructions.clear();
    preinstructions += hopSteps(Hop::UseAroma);
-   addPreinstructions(preinstructions);
+   addPreinstructions(ins, preinstructions);
    
    // Fermentation instructions
    preinstructions.clear();
 
    /*** Fermentables added after boil ***/
-   postboilFermentablesIns();
+   postboilFermentablesIns(ins);
 
    /*** post boil ***/
-   postboilIns();
+   postboilIns(ins);
    
    /*** Primary yeast ***/
    str = tr("Cool wort and pitch ");
@@ -685,34 +642,48 @@ void Recipe::generateInstructions()
          str += tr("%1 %2 yeast, ").arg(yeast->name()).arg(yeast->typeStringTr());
    }
    str += tr("to the primary.");
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Pitch yeast"));
-   ins->setDirections(str);
+   ins.append( Instruction::Draft(tr("Pitch yeast"), str) );
    /*** End primary yeast ***/
 
    /*** Primary misc ***/
-   addPreinstructions(miscSteps(Misc::Primary));
+   addPreinstructions(ins, miscSteps(Misc::Primary));
 
    str = tr("Let ferment until FG is %1.")
          .arg(Brewtarget::displayAmount(fg(), "tab_recipe", "fg", Units::sp_grav, 3));
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Ferment"));
-   ins->setDirections(str);
+   ins.append( Instruction::Draft(tr("Ferment"), str) );
 
    str = tr("Transfer beer to secondary.");
-   ins = Database::instance().newInstruction(this);
-   ins->setName(tr("Transfer to secondary"));
-   ins->setDirections(str);
+   ins.append( Instruction::Draft(tr("Transfer to secondary"), str) );
 
    /*** Secondary misc ***/
-   addPreinstructions(miscSteps(Misc::Secondary));
+   addPreinstructions(ins, miscSteps(Misc::Secondary));
 
    /*** Dry hopping ***/
-   addPreinstructions(hopSteps(Hop::Dry_Hop));
+   addPreinstructions(ins, hopSteps(Hop::Dry_Hop));
+
+   // END fermentation instructions. Out with the old, in with the new, and
+   // let everybody know just the once.
+   Database::instance().replaceInstructions(this, ins);
+}
 
-   // END fermentation instructions. Let everybody know that now is the time
-   // to update instructions
-   emit changed( metaProperty("instructions"), instructions().size() );
+void Recipe::generateInstructions( QList<Recipe*> const& recipes )
+{
+   Database& db = Database::instance();
+
+   try {
+      db.beginBatch();
+      foreach( Recipe* rec, recipes )
+      {
+         if( rec )
+            rec->generateInstructions();
+      }
+      db.commitBatch();
+   }
+   catch (QString e) {
+      Brewtarget::logE( QString("%1 %2").arg(Q_FUNC_INFO).arg(e) );
+      db.rollbackBatch();
+      throw;
+   }
 }
 
 QString Recipe::nextAddToBoil(double& time)
@@ -812,12 +783,12 @@ void Recipe::setType( const QString &var )
       tmp = QString(var);
    }
 
-   set( "type", "type", tmp );
+   set( PropertyIds::Recipe::type, "type", tmp );
 }
 
 void Recipe::setBrewer( const QString &var )
 {
-   set( "brewer", "brewer", var );
+   set( PropertyIds::Recipe::brewer, "brewer", var );
 }
 
 void Recipe::setBatchSize_l( double var )
@@ -833,7 +804,7 @@ void Recipe::setBatchSize_l( double var )
       tmp = var;
    }
 
-   set( "batchSize_l", "batch_size", tmp );
+   set( PropertyIds::Recipe::batchSize_l, "batch_size", tmp );
    
    // NOTE: this is bad, but we have to call recalcAll(), because the estimated
    // boil/batch volumes depend on the target volumes when there are no mash
@@ -854,7 +825,7 @@ void Recipe::setBoilSize_l( double var )
       tmp = var;
    }
 
-   set( "boilSize_l", "boil_size", tmp );
+   set( PropertyIds::Recipe::boilSize_l, "boil_size", tmp );
    
    // NOTE: this is bad, but we have to call recalcAll(), because the estimated
    // boil/batch volumes depend on the target volumes when there are no mash
@@ -875,7 +846,7 @@ void Recipe::setBoilTime_min( double var )
       tmp = var;
    }
 
-   set( "boilTime_min", "boil_time", tmp);
+   set( PropertyIds::Recipe::boilTime_min, "boil_time", tmp);
 }
 
 void Recipe::setEfficiency_pct( double var )
@@ -892,7 +863,7 @@ void Recipe::setEfficiency_pct( double var )
    }
 
 
-   set( "efficiency_pct", "efficiency", tmp );
+   set( PropertyIds::Recipe::efficiency_pct, "efficiency", tmp );
 
    // If you change the efficency, you really should recalc. And I'm afraid it
    // means recalc all, since og and fg will change, which means your ratios
@@ -902,17 +873,17 @@ void Recipe::setEfficiency_pct( double var )
 
 void Recipe::setAsstBrewer( const QString &var )
 {
-   set( "asstBrewer", "assistant_brewer", var );
+   set( PropertyIds::Recipe::asstBrewer, "assistant_brewer", var );
 }
 
 void Recipe::setNotes( const QString &var )
 {
-   set( "notes", "notes", var );
+   set( PropertyIds::Recipe::notes, "notes", var );
 }
 
 void Recipe::setTasteNotes( const QString &var )
 {
-   set( "tasteNotes", "taste_notes", var );
+   set( PropertyIds::Recipe::tasteNotes, "taste_notes", var );
 }
 
 void Recipe::setTasteRating( double var )
@@ -928,7 +899,7 @@ void Recipe::setTasteRating( double var )
       tmp = var;
    }
 
-   set( "tasteRating", "taste_rating", tmp );
+   set( PropertyIds::Recipe::tasteRating, "taste_rating", tmp );
 }
 
 void Recipe::setOg( double var )
@@ -944,7 +915,7 @@ void Recipe::setOg( double var )
       tmp = var;
    }
 
-   set( "og", "og", tmp );
+   set( PropertyIds::Recipe::og, "og", tmp );
 }
 
 void Recipe::setFg( double var )
@@ -960,7 +931,7 @@ void Recipe::setFg( double var )
       tmp = var;
    }
 
-   set( "fg", "fg", tmp );
+   set( PropertyIds::Recipe::fg, "fg", tmp );
 }
 
 void Recipe::setFermentationStages( int var )
@@ -976,7 +947,7 @@ void Recipe::setFermentationStages( int var )
       tmp = var;
    }
 
-   set( "fermentationStages", "fermentation_stages", tmp );
+   set( PropertyIds::Recipe::fermentationStages, "fermentation_stages", tmp );
 }
 
 void Recipe::setPrimaryAge_days( double var )
@@ -992,12 +963,12 @@ void Recipe::setPrimaryAge_days( double var )
       tmp = var;
    }
 
-   set( "primaryAge_days", "primary_age", tmp );
+   set( PropertyIds::Recipe::primaryAge_days, "primary_age", tmp );
 }
 
 void Recipe::setPrimaryTemp_c( double var )
 {
-   set( "primaryTemp_c", "primary_temp", var );
+   set( PropertyIds::Recipe::primaryTemp_c, "primary_temp", var );
 }
 
 void Recipe::setSecondaryAge_days( double var )
@@ -1013,12 +984,12 @@ void Recipe::setSecondaryAge_days( double var )
       tmp = var;
    }
 
-   set( "secondaryAge_days", "secondary_age", tmp );
+   set( PropertyIds::Recipe::secondaryAge_days, "secondary_age", tmp );
 }
 
 void Recipe::setSecondaryTemp_c( double var )
 {
-   set( "secondaryTemp_c", "secondary_temp", var );
+   set( PropertyIds::Recipe::secondaryTemp_c, "secondary_temp", var );
 }
 
 void Recipe::setTertiaryAge_days( double var )
@@ -1034,12 +1005,12 @@ void Recipe::setTertiaryAge_days( double var )
       tmp = var;
    }
 
-   set( "tertiaryAge_days", "tertiary_age", tmp );
+   set( PropertyIds::Recipe::tertiaryAge_days, "tertiary_age", tmp );
 }
 
 void Recipe::setTertiaryTemp_c( double var )
 {
-   set( "tertiaryTemp_c", "tertiary_temp", var );
+   set( PropertyIds::Recipe::tertiaryTemp_c, "tertiary_temp", var );
 }
 
 void Recipe::setAge_days( double var )
@@ -1055,17 +1026,17 @@ void Recipe::setAge_days( double var )
       tmp = var;
    }
 
-   set( "age", "age", tmp );
+   set( PropertyIds::Recipe::age, "age", tmp );
 }
 
 void Recipe::setAgeTemp_c( double var )
 {
-   set( "ageTemp_c", "age_temp", var );
+   set( PropertyIds::Recipe::ageTemp_c, "age_temp", var );
 }
 
 void Recipe::setDate( const QDate &var )
 {
-   set( "date", "date", var.toString("d/M/yyyy") );
+   set( PropertyIds::Recipe::date, "date", var.toString("d/M/yyyy") );
 }
 
 void Recipe::setCarbonation_vols( double var )
@@ -1081,22 +1052,22 @@ void Recipe::setCarbonation_vols( double var )
       tmp = var;
    }
 
-   set( "carbonation_vols", "carb_volume", tmp );
+   set( PropertyIds::Recipe::carbonation_vols, "carb_volume", tmp );
 }
 
 void Recipe::setForcedCarbonation( bool var )
 {
-   set( "forcedCarbonation", "forced_carb", var );
+   set( PropertyIds::Recipe::forcedCarbonation, "forced_carb", var );
 }
 
 void Recipe::setPrimingSugarName( const QString &var )
 {
-   set( "primingSugarName", "priming_sugar_name", var );
+   set( PropertyIds::Recipe::primingSugarName, "priming_sugar_name", var );
 }
 
 void Recipe::setCarbonationTemp_c( double var )
 {
-   set( "carbonationTemp_c", "carbonationTemp_c", var );
+   set( PropertyIds::Recipe::carbonationTemp_c, "carbonationTemp_c", var );
 }
 
 void Recipe::setPrimingSugarEquiv( double var )
@@ -1112,7 +1083,7 @@ void Recipe::setPrimingSugarEquiv( double var )
       tmp = var;
    }
 
-   set( "primingSugarEquiv", "priming_sugar_equiv", tmp );
+   set( PropertyIds::Recipe::primingSugarEquiv, "priming_sugar_equiv", tmp );
 }
 
 void Recipe::setKegPrimingFactor( double var )
@@ -1129,7 +1100,7 @@ void Recipe::setKegPrimingFactor( double var )
       tmp = var;
    }
 
-   set( "kegPrimingFactor", "keg_priming_factor", tmp );
+   set( PropertyIds::Recipe::kegPrimingFactor, "keg_priming_factor", tmp );
 }
 
 //==========================Calculated Getters============================
@@ -1347,16 +1318,6 @@ void Recipe::remove( BeerXMLElement *var )
       Database::instance().removeIngredientFromRecipe( this, var );
 }
 
-double Recipe::batchSizeNoLosses_l()
-{
-   double ret = batchSize_l();
-   Equipment* e = equipment();
-   if( e )
-      ret += e->trubChillerLoss_l();
-   
-   return ret;
-}
-
 //==============================Recalculators==================================
 
 void Recipe::recalcAll()
@@ -1371,259 +1332,194 @@ void Recipe::recalcAll()
    // Someone has already called this function back in the call stack, so return to avoid recursion.
    if( !_recalcMutex.tryLock() )
       return;
+
+   TraceSpan span("Recipe::recalcAll", "recalc", Trace::isEnabled() ? name() : QString());
+
+   // The first time through, see if what we saved last time is still good.
+   // If nothing it depends on has changed, there is nothing to calculate.
+   QString fingerprint;
+   if( _uninitializedCalcs )
+   {
+      fingerprint = Database::instance().recipeFingerprint(this);
+      if( loadCalcs(fingerprint) )
+      {
+         _uninitializedCalcs = false;
+         _recalcMutex.unlock();
+         return;
+      }
+   }
    
-   // Times are in seconds, and are cumulative.
-   recalcGrainsInMash_kg(); // 0.01
-   recalcGrains_kg(); // 0.03
-   recalcVolumeEstimates(); // 0.06
-   recalcColor_srm(); // 0.08
-   recalcSRMColor(); // 0.08
-   recalcOgFg(); // 0.11
-   recalcABV_pct(); // 0.12
-   recalcBoilGrav(); // 0.14
-   recalcIBU(); // 0.15
-   recalcCalories();
+   // Read everything once, work it all out, then tell everybody.
+   applyResults( RecipeCalculator::calculate( RecipeSnapshot::of(this) ) );
+
+   // Only worth saving on the way in. Anything that changes afterwards also
+   // changes the fingerprint, and gets saved on the next load.
+   if( _uninitializedCalcs )
+      saveCalcs(fingerprint);
    
    _uninitializedCalcs = false;
    
    _recalcMutex.unlock();
 }
 
-void Recipe::recalcABV_pct()
+void Recipe::applyResults( RecipeCalculator::Results const& calcs )
 {
-   double ret;
+   applyCalc( _grainsInMash_kg, calcs.grainsInMash_kg, "grainsInMash_kg" );
+   applyCalc( _grains_kg, calcs.grains_kg, "grains_kg" );
 
-   // The complex formula, and variations comes from Ritchie Products Ltd, (Zymurgy, Summer 1995, vol. 18, no. 2)
-   // Michael L. Hall’s article Brew by the Numbers: Add Up What’s in Your Beer, and Designing Great Beers by Daniels.
-   ret = (76.08 * (_og_fermentable - _fg_fermentable) / (1.775 - _og_fermentable)) * (_fg_fermentable / 0.794);
-  
-   if ( ret != _ABV_pct ) 
-   {
-      _ABV_pct = ret;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("ABV_pct"), _ABV_pct );
-      }
-   }
+   applyVolumes( calcs.volumes );
+   applyCalc( _color_srm, calcs.color_srm, "color_srm" );
+   recalcSRMColor();
+   applyGravities( calcs.gravities );
+   applyCalc( _ABV_pct, calcs.ABV_pct, "ABV_pct" );
+   applyCalc( _boilGrav, calcs.boilGrav, "boilGrav" );
+   _ibus = calcs.ibus.toList();
+   applyCalc( _IBU, calcs.IBU, "IBU" );
+   applyCalc( _calories, calcs.calories, "calories" );
 }
 
-void Recipe::recalcColor_srm()
+void Recipe::setCalcs( RecipeCalculator::Results const& calcs, QString const& fingerprint )
 {
-   Fermentable *ferm;
-   double mcu = 0.0;
-   double ret;
-   unsigned int i;
-
-   QList<Fermentable*> ferms = fermentables();
-   for( i = 0; static_cast<int>(i) < ferms.size(); ++i )
-   {
-      ferm = ferms[i];
-      // Conversion factor for lb/gal to kg/l = 8.34538.
-      mcu += ferm->color_srm()*8.34538 * ferm->amount_kg()/_finalVolumeNoLosses_l;
-   }
+   // Somebody is in recalcAll() already, and will get there on their own
+   if( !_recalcMutex.tryLock() )
+      return;
 
-   ret = ColorMethods::mcuToSrm(mcu);
- 
-   if ( _color_srm != ret ) 
-   {
-      _color_srm = ret;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("color_srm"), _color_srm );
-      }
-   }
+   // Unlike the first load, the point here is to get og and fg into the
+   // database, so act like we've been around for a while.
+   _uninitializedCalcs = false;
+   applyResults( calcs );
+   saveCalcs( fingerprint );
 
+   _recalcMutex.unlock();
 }
 
-void Recipe::recalcIBU()
-{
-   unsigned int i;
-   double ibus = 0.0;
-   double tmp = 0.0;
-   
-   // Bitterness due to hops...
+bool Recipe::loadCalcs(QString const& fingerprint)
+{
+   if( fingerprint.isEmpty() )
+      return false;
+
+   QJsonObject calcs = QJsonDocument::fromJson( Database::instance().calcCache(this).toUtf8() ).object();
+   if( calcs.value("fingerprint").toString() != fingerprint )
+      return false;
+
+   _ABV_pct               = calcs.value("ABV_pct").toDouble();
+   _color_srm             = calcs.value("color_srm").toDouble();
+   _boilGrav              = calcs.value("boilGrav").toDouble();
+   _IBU                   = calcs.value("IBU").toDouble();
+   _wortFromMash_l        = calcs.value("wortFromMash_l").toDouble();
+   _boilVolume_l          = calcs.value("boilVolume_l").toDouble();
+   _postBoilVolume_l      = calcs.value("postBoilVolume_l").toDouble();
+   _finalVolume_l         = calcs.value("finalVolume_l").toDouble();
+   _finalVolumeNoLosses_l = calcs.value("finalVolumeNoLosses_l").toDouble();
+   _calories              = calcs.value("calories").toDouble();
+   _grainsInMash_kg       = calcs.value("grainsInMash_kg").toDouble();
+   _grains_kg             = calcs.value("grains_kg").toDouble();
+   _og                    = calcs.value("og").toDouble();
+   _fg                    = calcs.value("fg").toDouble();
+   _og_fermentable        = calcs.value("og_fermentable").toDouble();
+   _fg_fermentable        = calcs.value("fg_fermentable").toDouble();
+
    _ibus.clear();
-   QList<Hop*> hhops = hops();
-   for( i = 0; static_cast<int>(i) < hhops.size(); ++i )
-   {
-      tmp = ibuFromHop(hhops[i]);
-      _ibus.append(tmp);
-      ibus += tmp;
-   }
+   foreach( QJsonValue ibu, calcs.value("ibus").toArray() )
+      _ibus.append( ibu.toDouble() );
 
-   // Bitterness due to hopped extracts...
-   QList<Fermentable*> ferms = fermentables();
-   for( i = 0; static_cast<int>(i) < ferms.size(); ++i )
-   {
-      // Conversion factor for lb/gal to kg/l = 8.34538.
-      ibus +=
-              ferms[i]->ibuGalPerLb() *
-              (ferms[i]->amount_kg() / batchSize_l()) / 8.34538;
-   }
+   // Cheaper to work out than to store
+   _SRMColor = Algorithms::srmToColor(_color_srm);
 
-   if ( ibus != _IBU ) 
-   {
-      _IBU = ibus;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("IBU"), _IBU );
-      }
-   }
+   return true;
 }
 
-void Recipe::recalcVolumeEstimates()
+void Recipe::saveCalcs(QString const& fingerprint)
 {
-   double waterAdded_l;
-   double absorption_lKg;
-   double tmp = 0.0;
-   double tmp_wfm = 0.0;
-   double tmp_bv = 0.0;
-   double tmp_fv = 0.0;
-   double tmp_pbv = 0.0;
+   QJsonObject calcs;
+   QJsonArray ibus;
 
-   // wortFromMash_l ==========================
-   if( mash() == 0 )
-      _wortFromMash_l = 0.0;
-   else
-   {
-      waterAdded_l = mash()->totalMashWater_l();
-      if( equipment() != 0 )
-         absorption_lKg = equipment()->grainAbsorption_LKg();
-      else
-         absorption_lKg = PhysicalConstants::grainAbsorption_Lkg;
+   if( fingerprint.isEmpty() )
+      return;
 
-      tmp_wfm = (waterAdded_l - absorption_lKg * _grainsInMash_kg);
-   }
-   
-   // boilVolume_l ==============================
-   
-   if( equipment() != 0 )
-      tmp = tmp_wfm - equipment()->lauterDeadspace_l() + equipment()->topUpKettle_l();
-   else
-      tmp = tmp_wfm;
-   
-   // Need to account for extract/sugar volume also.
-   QList<Fermentable*> ferms = fermentables();
-   foreach( Fermentable* f, ferms )
-   {
-      Fermentable::Type type = f->type();
-      if( type == Fermentable::Extract )
-         tmp += f->amount_kg() / PhysicalConstants::liquidExtractDensity_kgL;
-      else if( type == Fermentable::Sugar )
-         tmp += f->amount_kg() / PhysicalConstants::sucroseDensity_kgL;
-      else if( type == Fermentable::Dry_Extract )
-         tmp += f->amount_kg() / PhysicalConstants::dryExtractDensity_kgL;
-   }
-   
-   if( tmp <= 0.0 )
-      tmp = boilSize_l(); // Give up.
- 
-   tmp_bv = tmp;
-   
-   // finalVolume_l ==============================
-   
-   // NOTE: the following figure is not based on the other volume estimates
-   // since we want to show og,fg,ibus,etc. as if the collected wort is correct.
-   _finalVolumeNoLosses_l = batchSizeNoLosses_l();
-   if( equipment() != 0 )
-   {
-      //_finalVolumeNoLosses_l = equipment()->wortEndOfBoil_l(tmp_bv) + equipment()->topUpWater_l();
-      tmp_fv = equipment()->wortEndOfBoil_l(tmp_bv) + equipment()->topUpWater_l() - equipment()->trubChillerLoss_l();
-   }
-   else
-   {
-      _finalVolume_l = tmp_bv - 4.0; // This is just shooting in the dark. Can't do much without an equipment.
-      //_finalVolumeNoLosses_l = _finalVolume_l;
-   }
-   
-   // postBoilVolume_l ===========================
+   calcs.insert("fingerprint",           fingerprint);
+   calcs.insert("ABV_pct",               _ABV_pct);
+   calcs.insert("color_srm",             _color_srm);
+   calcs.insert("boilGrav",              _boilGrav);
+   calcs.insert("IBU",                   _IBU);
+   calcs.insert("wortFromMash_l",        _wortFromMash_l);
+   calcs.insert("boilVolume_l",          _boilVolume_l);
+   calcs.insert("postBoilVolume_l",      _postBoilVolume_l);
+   calcs.insert("finalVolume_l",         _finalVolume_l);
+   calcs.insert("finalVolumeNoLosses_l", _finalVolumeNoLosses_l);
+   calcs.insert("calories",              _calories);
+   calcs.insert("grainsInMash_kg",       _grainsInMash_kg);
+   calcs.insert("grains_kg",             _grains_kg);
+   calcs.insert("og",                    _og);
+   calcs.insert("fg",                    _fg);
+   calcs.insert("og_fermentable",        _og_fermentable);
+   calcs.insert("fg_fermentable",        _fg_fermentable);
+
+   foreach( double ibu, _ibus )
+      ibus.append(ibu);
+   calcs.insert("ibus", ibus);
+
+   // JSON has no NaN. Rather than load garbage next time, don't save at all
+   QList<double> values = _ibus;
+   values << _ABV_pct << _color_srm << _boilGrav << _IBU << _wortFromMash_l
+          << _boilVolume_l << _postBoilVolume_l << _finalVolume_l
+          << _finalVolumeNoLosses_l << _calories << _grainsInMash_kg
+          << _grains_kg << _og << _fg << _og_fermentable << _fg_fermentable;
+   foreach( double value, values )
+   {
+      if( Algorithms::isNan(value) )
+         return;
+   }
+
+   Database::instance().setCalcCache( this, QString(QJsonDocument(calcs).toJson(QJsonDocument::Compact)) );
+}
 
-   if( equipment() != 0 )
-      tmp_pbv = equipment()->wortEndOfBoil_l( tmp_bv );
-   else
-      tmp_pbv = batchSize_l(); // Give up.
+void Recipe::recalcABV_pct()
+{
+   applyCalc( _ABV_pct, RecipeCalculator::ABV_pct(_og_fermentable, _fg_fermentable), "ABV_pct" );
+}
 
-   if ( tmp_wfm != _wortFromMash_l )
-   {
-      _wortFromMash_l = tmp_wfm;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("wortFromMash_l"), _wortFromMash_l );
-      }
-   }
+void Recipe::recalcColor_srm()
+{
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Fermentables);
+   applyCalc( _color_srm, RecipeCalculator::color_srm(snap, _finalVolumeNoLosses_l), "color_srm" );
+}
 
-   if ( tmp_bv != _boilVolume_l )
-   {
-      _boilVolume_l = tmp_bv;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("boilVolume_l"), _boilVolume_l );
-      }
-   }
-   
-   if ( tmp_fv != _finalVolume_l )
-   {
-      _finalVolume_l = tmp_fv;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("finalVolume_l"), _finalVolume_l );
-      }
-   }
+void Recipe::recalcIBU()
+{
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Basics | RecipeSnapshot::Equip | RecipeSnapshot::Fermentables | RecipeSnapshot::Hops);
+   QVector<double> ibus;
+   double ibu = RecipeCalculator::IBU(snap, _og, _finalVolumeNoLosses_l, &ibus);
 
-   if ( tmp_pbv != _postBoilVolume_l )
-   {
-      _postBoilVolume_l = tmp_pbv;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("postBoilVolume_l"), _postBoilVolume_l );
-      }
-   }
+   _ibus = ibus.toList();
+   applyCalc( _IBU, ibu, "IBU" );
 }
 
-void Recipe::recalcGrainsInMash_kg()
+void Recipe::recalcVolumeEstimates()
 {
-   unsigned int i, size;
-   double ret = 0.0;
-   Fermentable* ferm;
-   
-   QList<Fermentable*> ferms = fermentables();
-   size = ferms.size();
-   for( i = 0; i < size; ++i )
-   {
-      ferm = ferms[i];
-      
-      if( ferm->type() == Fermentable::Grain && ferm->isMashed() )
-         ret += ferm->amount_kg();
-   }
-
-   if ( ret != _grainsInMash_kg ) 
-   {
-      _grainsInMash_kg = ret;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("grainsInMash_kg"), _grainsInMash_kg );
-      }
-   }
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Basics | RecipeSnapshot::Equip | RecipeSnapshot::MashSteps | RecipeSnapshot::Fermentables);
+   applyVolumes( RecipeCalculator::volumes(snap, _grainsInMash_kg) );
 }
 
-void Recipe::recalcGrains_kg()
+void Recipe::applyVolumes( RecipeCalculator::Volumes const& v )
 {
-   unsigned int i, size;
-   double ret = 0.0;
+   _finalVolumeNoLosses_l = v.finalVolumeNoLosses_l;
+   applyCalc( _wortFromMash_l, v.wortFromMash_l, "wortFromMash_l" );
+   applyCalc( _boilVolume_l, v.boilVolume_l, "boilVolume_l" );
+   applyCalc( _finalVolume_l, v.finalVolume_l, "finalVolume_l" );
+   applyCalc( _postBoilVolume_l, v.postBoilVolume_l, "postBoilVolume_l" );
+}
 
-   QList<Fermentable*> ferms = fermentables();
-   size = ferms.size();
-   for( i = 0; i < size; ++i )
-      ret += ferms[i]->amount_kg();
+void Recipe::recalcGrainsInMash_kg()
+{
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Fermentables);
+   applyCalc( _grainsInMash_kg, RecipeCalculator::grainsInMash_kg(snap), "grainsInMash_kg" );
+}
 
-   if ( ret != _grains_kg ) 
-   {
-      _grains_kg = ret;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("grains_kg"), _grains_kg );
-      }
-   }
+void Recipe::recalcGrains_kg()
+{
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Fermentables);
+   applyCalc( _grains_kg, RecipeCalculator::grains_kg(snap), "grains_kg" );
 }
 
 void Recipe::recalcSRMColor()
@@ -1640,43 +1536,9 @@ void Recipe::recalcSRMColor()
    }
 }
 
-// the formula in here are taken from http://hbd.org/ensmingr/
 void Recipe::recalcCalories()
 {
-   double startPlato, finishPlato, RE, abw, oog, ffg, tmp;
-
-   oog = _og;
-   ffg = _fg;
-
-   // Need to translate OG and FG into plato
-   startPlato  = -463.37 + ( 668.72 * oog ) - (205.35 * oog * oog);
-   finishPlato = -463.37 + ( 668.72 * ffg ) - (205.35 * ffg * ffg);
-
-   // RE (real extract)
-   RE = (0.1808 * startPlato) + (0.8192 * finishPlato);
-
-   // Alcohol by weight?
-   abw = (startPlato-RE)/(2.0665 - (0.010665 * startPlato));
-
-   // The final results of this formular are calories per 100 ml. 
-   // The 3.55 puts it in terms of 12 oz. I really should have stored it
-   // without that adjust.
-   tmp = ((6.9*abw) + 4.0 * (RE-0.1)) * ffg * 3.55;
-
-   //! If there are no fermentables in the recipe, if there is no mash, etc.,
-   //  then the calories/12 oz ends up negative. Since negative doesn't make
-   //  sense, set it to 0
-   if ( tmp < 0 )
-      tmp = 0;
-
-   if ( tmp != _calories ) 
-   {
-      _calories = tmp;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("calories"), _calories );
-      }
-   }
+   applyCalc( _calories, RecipeCalculator::calories(_og, _fg), "calories" );
 }
 
 // other efficiency calculations need access to the maximum theoretical sugars
@@ -1684,277 +1546,80 @@ void Recipe::recalcCalories()
 // split that calcuation out of recalcOgFg();
 QHash<QString,double> Recipe::calcTotalPoints()
 {
-   int i;
-   double sugar_kg_ignoreEfficiency = 0.0;
-   double sugar_kg                  = 0.0;
-   double nonFermetableSugars_kg    = 0.0;
-   double lateAddition_kg           = 0.0;
-   double lateAddition_kg_ignoreEff = 0.0;
-
-   Fermentable* ferm;
-
-   QList<Fermentable*> ferms = fermentables();
+   RecipeCalculator::Points points = RecipeCalculator::totalPoints( RecipeSnapshot::of(this, RecipeSnapshot::Fermentables) );
    QHash<QString,double> ret;
-   
-   for( i = 0; static_cast<int>(i) < ferms.size(); ++i )
-   {
-      ferm = ferms[i];
-
-      // If we have some sort of non-grain, we have to ignore efficiency.
-      if( ferm->isSugar() || ferm->isExtract() )
-      {
-         sugar_kg_ignoreEfficiency += ferm->equivSucrose_kg();
-
-         if (ferm->addAfterBoil())
-            lateAddition_kg_ignoreEff += ferm->equivSucrose_kg();
 
-         if ( !isFermentableSugar(ferm) )
-           nonFermetableSugars_kg += ferm->equivSucrose_kg();
-      }
-      else
-      {
-         sugar_kg += ferm->equivSucrose_kg();
-
-         if (ferm->addAfterBoil())
-            lateAddition_kg += ferm->equivSucrose_kg();
-      }
-   }   
-   
-   ret.insert("sugar_kg", sugar_kg);
-   ret.insert("nonFermetableSugars_kg", nonFermetableSugars_kg);
-   ret.insert("sugar_kg_ignoreEfficiency", sugar_kg_ignoreEfficiency);
-   ret.insert("lateAddition_kg", lateAddition_kg);
-   ret.insert("lateAddition_kg_ignoreEff", lateAddition_kg_ignoreEff);
+   ret.insert("sugar_kg", points.sugar_kg);
+   ret.insert("nonFermetableSugars_kg", points.nonFermetableSugars_kg);
+   ret.insert("sugar_kg_ignoreEfficiency", points.sugar_kg_ignoreEfficiency);
+   ret.insert("lateAddition_kg", points.lateAddition_kg);
+   ret.insert("lateAddition_kg_ignoreEff", points.lateAddition_kg_ignoreEff);
 
    return ret;
-
 }
 
 void Recipe::recalcBoilGrav()
 {
-   double sugar_kg = 0.0;
-   double sugar_kg_ignoreEfficiency = 0.0;
-   double lateAddition_kg           = 0.0;
-   double lateAddition_kg_ignoreEff = 0.0;
-   double ret;
-   QHash<QString,double> sugars;
-
-   sugars = calcTotalPoints();
-   sugar_kg = sugars.value("sugar_kg");
-   sugar_kg_ignoreEfficiency = sugars.value("sugar_kg_ignoreEfficiency");
-   lateAddition_kg = sugars.value("lateAddition_kg");
-   lateAddition_kg_ignoreEff = sugars.value("lateAddition_kg_ignoreEff");
-   
-   // Since the efficiency refers to how much sugar we get into the fermenter,
-   // we need to adjust for that here.
-   sugar_kg = (efficiency_pct()/100.0 * (sugar_kg - lateAddition_kg) + sugar_kg_ignoreEfficiency - lateAddition_kg_ignoreEff);
-
-   ret = Algorithms::PlatoToSG_20C20C( Algorithms::getPlato(sugar_kg, boilSize_l()) );
- 
-   if ( ret != _boilGrav )
-   {
-      _boilGrav = ret;
-      if (!_uninitializedCalcs)
-      {
-        emit changed( metaProperty("boilGrav"), _boilGrav );
-      }
-   }
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Basics | RecipeSnapshot::Fermentables);
+   applyCalc( _boilGrav, RecipeCalculator::boilGrav(snap), "boilGrav" );
 }
 
 void Recipe::recalcOgFg()
 {
-   unsigned int i;
-   double plato;
-   double sugar_kg = 0;
-   double sugar_kg_ignoreEfficiency = 0.0;
-   double nonFermetableSugars_kg = 0.0;
-   double kettleWort_l = 0.0;
-   double postBoilWort_l = 0.0;
-   double ratio = 0.0;
-   double ferm_kg = 0.0;
-   double attenuation_pct = 0.0;
-   double tmp_og, tmp_fg, tmp_pnts, tmp_ferm_pnts;
-   Yeast* yeast;
-   QHash<QString,double> sugars;
-  
-   _og_fermentable = _fg_fermentable = 0.0;
-
-   // The first time through really has to get the _og and _fg from the
-   // database, not use the initialized values of 1. I (maf) tried putting
-   // this in the initialize, but it just hung. So I moved it here, but only
-   // if if we aren't initialized yet.
-   //
-   // GSG: This doesn't work, this og and fg are already set to 1.0 so
-   // until we load these values from the database on startup, we have
-   // to calculate.
-   if ( _uninitializedCalcs )
-   {
-      _og = Brewtarget::toDouble(this,"og","Recipe::recalcOgFg()");
-      _fg = Brewtarget::toDouble(this,"fg","Recipe::recalcOgFg()");
-   }
-
-   // Find out how much sugar we have.
-   sugars = calcTotalPoints();
-   sugar_kg                  = sugars.value("sugar_kg");
-   sugar_kg_ignoreEfficiency = sugars.value("sugar_kg_ignoreEfficiency");
-   nonFermetableSugars_kg    = sugars.value("nonFermetableSugars_kg");
-
-   // We might lose some sugar in the form of Trub/Chiller loss and lauter deadspace.
-   if( equipment() != 0 )
-   {
-      
-      kettleWort_l = (_wortFromMash_l - equipment()->lauterDeadspace_l()) + equipment()->topUpKettle_l();
-      postBoilWort_l = equipment()->wortEndOfBoil_l(kettleWort_l);
-      ratio = (postBoilWort_l - equipment()->trubChillerLoss_l()) / postBoilWort_l;
-      if( ratio > 1.0 ) // Usually happens when we don't have a mash yet.
-         ratio = 1.0;
-      else if( ratio < 0.0 )
-         ratio = 0.0;
-      else if( Algorithms::isNan(ratio) )
-         ratio = 1.0;
-      // Ignore this again since it should be included in efficiency.
-      //sugar_kg *= ratio;
-      sugar_kg_ignoreEfficiency *= ratio;
-      if ( nonFermetableSugars_kg != 0.0 )
-         nonFermetableSugars_kg *= ratio;
-   }
-
-   sugar_kg = sugar_kg * efficiency_pct()/100.0 + sugar_kg_ignoreEfficiency;
-   plato = Algorithms::getPlato( sugar_kg, _finalVolumeNoLosses_l);
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Basics | RecipeSnapshot::Equip | RecipeSnapshot::Fermentables | RecipeSnapshot::Yeasts);
+   applyGravities( RecipeCalculator::ogFg(snap, _wortFromMash_l, _finalVolumeNoLosses_l) );
+}
 
-   tmp_og = Algorithms::PlatoToSG_20C20C( plato );
-   tmp_pnts = (tmp_og-1)*1000.0;
-   if ( nonFermetableSugars_kg != 0.0 )
-   {
-      ferm_kg = sugar_kg - nonFermetableSugars_kg;
-      plato = Algorithms::getPlato( ferm_kg, _finalVolumeNoLosses_l);
-      _og_fermentable = Algorithms::PlatoToSG_20C20C( plato );
-      plato = Algorithms::getPlato( nonFermetableSugars_kg, _finalVolumeNoLosses_l); 
-      tmp_ferm_pnts = ((Algorithms::PlatoToSG_20C20C( plato ))-1)*1000.0;
-   }
-   else
-   {
-      _og_fermentable = tmp_og;
-      tmp_ferm_pnts = 0;
-   }
+void Recipe::applyGravities( RecipeCalculator::Gravities const& g )
+{
+   _og_fermentable = g.og_fermentable;
+   _fg_fermentable = g.fg_fermentable;
 
-   // Calculage FG
-   QList<Yeast*> yeasties = yeasts();
-   for( i = 0; static_cast<int>(i) < yeasties.size(); ++i )
-   {
-      yeast = yeasties[i];
-      // Get the yeast with the greatest attenuation.
-      if( yeast->attenuation_pct() > attenuation_pct )
-         attenuation_pct = yeast->attenuation_pct();
-   }
-   if( yeasties.size() > 0 && attenuation_pct <= 0.0 ) // This means we have yeast, but they neglected to provide attenuation percentages.
-      attenuation_pct = 75.0; // 75% is an average attenuation.
-   
-   if ( nonFermetableSugars_kg != 0.0 )
-   {
-      tmp_ferm_pnts = (tmp_pnts-tmp_ferm_pnts) * (1.0 - attenuation_pct/100.0);
-      tmp_pnts *= (1.0 - attenuation_pct/100.0);
-      tmp_fg =  1 + tmp_pnts/1000.0;
-      _fg_fermentable =  1 + tmp_ferm_pnts/1000.0;
-   }
-   else
-   {
-      tmp_pnts *= (1.0 - attenuation_pct/100.0);
-      tmp_fg =  1 + tmp_pnts/1000.0;
-      _fg_fermentable = tmp_fg;
-   }
-   
-   if ( _og != tmp_og ) 
+   if ( _og != g.og )
    {
-      _og     = tmp_og;
+      _og     = g.og;
       // NOTE: We don't want to do this on the first load of the recipe.
-      // NOTE: We are we recalculating all of these on load? Shouldn't we be
-      // reading these values from the database somehow?
-      //
-      // GSG: Yes we can, but until the code is added to intialize these calculated
-      // values from the database, we can calculate them on load. They should be
-      // the same as the database values since the database values were set with
-      // these functions in the first place.
       if (!_uninitializedCalcs)
       {
-        set( "og", "og", _og, false );
+        set( PropertyIds::Recipe::og, "og", _og, false );
         emit changed( metaProperty("og"), _og );
         emit changed( metaProperty("points"), (_og-1.0)*1e3 );
       }
    }
 
-   if ( tmp_fg != _fg ) 
+   if ( g.fg != _fg )
    {
-      _fg     = tmp_fg;
+      _fg     = g.fg;
       if (!_uninitializedCalcs)
       {
-        set( "fg", "fg", _fg, false );
+        set( PropertyIds::Recipe::fg, "fg", _fg, false );
         emit changed( metaProperty("fg"), _fg );
       }
    }
 }
 
+void Recipe::applyCalc( double& member, double value, const char* prop )
+{
+   if ( member != value )
+   {
+      member = value;
+      if (!_uninitializedCalcs)
+      {
+        emit changed( metaProperty(prop), member );
+      }
+   }
+}
+
 //====================================Helpers===========================================
 
 double Recipe::ibuFromHop(Hop const* hop)
 {
-   Equipment* equip = equipment();
-   double ibus = 0.0;
-   double fwhAdjust = Brewtarget::toDouble(Brewtarget::option("firstWortHopAdjustment", 1.1).toString(), "Recipe::ibmFromHop()");
-   double mashHopAdjust = Brewtarget::toDouble(Brewtarget::option("mashHopAdjustment", 0).toString(), "Recipe::ibmFromHop()");
-   
    if( hop == 0 )
       return 0.0;
-   
-   double AArating = hop->alpha_pct()/100.0;
-   double grams = hop->amount_kg()*1000.0;
-   double minutes = hop->time_min();
-   // Assume 100% utilization until further notice
-   double hopUtilization = 1.0;
-   // Assume 60 min boil until further notice
-   int boilTime = 60;
-
-   // NOTE: we used to carefully calculate the average boil gravity and use it in the
-   // IBU calculations. However, due to John Palmer
-   // (http://homebrew.stackexchange.com/questions/7343/does-wort-gravity-affect-hop-utilization),
-   // it seems more appropriate to just use the OG directly, since it is the total
-   // amount of break material that truly affects the IBUs.
-   
-   if( equip )
-   {
-      hopUtilization = equip->hopUtilization_pct() / 100.0;
-      boilTime = equip->boilTime_min();
-   }
-   
-   if( hop->use() == Hop::Boil)
-      ibus = IbuMethods::getIbus( AArating, grams, _finalVolumeNoLosses_l, _og, minutes );
-   else if( hop->use() == Hop::First_Wort )
-      ibus = fwhAdjust * IbuMethods::getIbus( AArating, grams, _finalVolumeNoLosses_l, _og, boilTime );
-   else if( hop->use() == Hop::Mash && mashHopAdjust > 0.0 )
-      ibus = mashHopAdjust * IbuMethods::getIbus( AArating, grams, _finalVolumeNoLosses_l, _og, boilTime );
-
-   // Adjust for hop form. Tinseth's table was created from whole cone data,
-   // and it seems other formulae are optimized that way as well. So, the
-   // utilization is considered unadjusted for whole cones, and adjusted
-   // up for plugs and pellets.
-   //
-   // - http://www.realbeer.com/hops/FAQ.html
-   // - https://groups.google.com/forum/#!topic/brewtarget-help/mv2qvWBC4sU
-   switch( hop->form() ) {
-   case Hop::Plug:
-      hopUtilization *= 1.02;
-      break;
-   case Hop::Pellet:
-      hopUtilization *= 1.10;
-      break;
-   default:
-      break;
-   }
 
-   // Adjust for hop utilization. 
-   ibus *= hopUtilization;
-
-   return ibus;
+   RecipeSnapshot snap = RecipeSnapshot::of(this, RecipeSnapshot::Equip);
+   snap.readHopAdjustments();
+   return RecipeCalculator::ibuFromHop( snap, RecipeSnapshot::of(hop), _og, _finalVolumeNoLosses_l );
 }
 
 bool Recipe::isValidType( const QString &str )
@@ -2045,14 +1710,50 @@ QList<QString> Recipe::getReagents( QList<MashStep*> msteps )
 
 //==========================Accept changes from ingredients====================
 
+//! \returns true if \c prop is one of the base class bits no calculation cares about.
+//! Not the name: isFermentableSugar() looks at that.
+static bool isBookkeeping(QMetaProperty const& prop)
+{
+   switch( BeerXMLElement::propertyId<BeerXMLElement>(prop) )
+   {
+      case PropertyIds::BeerXMLElement::folder:
+      case PropertyIds::BeerXMLElement::display:
+         return true;
+      default:
+         return false;
+   }
+}
+
 void Recipe::acceptEquipChange(QMetaProperty prop, QVariant val)
 {
+   if( isBookkeeping(prop) || propertyId<Equipment>(prop) == PropertyIds::Equipment::notes )
+      return;
+
    recalcAll();
 }
 
 void Recipe::acceptFermChange(QMetaProperty prop, QVariant val)
 {
-   recalcAll();
+   if( isBookkeeping(prop) )
+      return;
+
+   // None of these go into any of the numbers
+   switch( propertyId<Fermentable>(prop) )
+   {
+      case PropertyIds::Fermentable::inventory:
+      case PropertyIds::Fermentable::origin:
+      case PropertyIds::Fermentable::supplier:
+      case PropertyIds::Fermentable::notes:
+      case PropertyIds::Fermentable::coarseFineDiff_pct:
+      case PropertyIds::Fermentable::moisture_pct:
+      case PropertyIds::Fermentable::diastaticPower_lintner:
+      case PropertyIds::Fermentable::protein_pct:
+      case PropertyIds::Fermentable::maxInBatch_pct:
+      case PropertyIds::Fermentable::recommendMash:
+         return;
+      default:
+         recalcAll();
+   }
 }
 
 void Recipe::acceptFermChange(Fermentable *ferm)
@@ -2062,7 +1763,23 @@ void Recipe::acceptFermChange(Fermentable *ferm)
 
 void Recipe::acceptHopChange(QMetaProperty prop, QVariant val)
 {
-   recalcIBU();
+   if( isBookkeeping(prop) )
+      return;
+
+   switch( propertyId<Hop>(prop) )
+   {
+      case PropertyIds::Hop::inventory:
+      case PropertyIds::Hop::notes:
+      case PropertyIds::Hop::origin:
+      case PropertyIds::Hop::substitutes:
+      case PropertyIds::Hop::humulene_pct:
+      case PropertyIds::Hop::caryophyllene_pct:
+      case PropertyIds::Hop::cohumulone_pct:
+      case PropertyIds::Hop::myrcene_pct:
+         return;
+      default:
+         recalcIBU();
+   }
 }
 
 void Recipe::acceptHopChange(Hop* hop) 
@@ -2072,6 +1789,23 @@ void Recipe::acceptHopChange(Hop* hop)
 
 void Recipe::acceptYeastChange(QMetaProperty prop, QVariant val)
 {
+   if( isBookkeeping(prop) )
+      return;
+
+   switch( propertyId<Yeast>(prop) )
+   {
+      case PropertyIds::Yeast::inventory:
+      case PropertyIds::Yeast::laboratory:
+      case PropertyIds::Yeast::productID:
+      case PropertyIds::Yeast::notes:
+      case PropertyIds::Yeast::bestFor:
+      case PropertyIds::Yeast::timesCultured:
+      case PropertyIds::Yeast::maxReuse:
+         return;
+      default:
+         break;
+   }
+
    recalcOgFg();
    recalcABV_pct();
 }
@@ -2086,7 +1820,7 @@ void Recipe::acceptMashChange(QMetaProperty prop, QVariant val)
 {
    Mash* mashSend = qobject_cast<Mash*>(sender());
 
-   if ( mashSend == 0 )
+   if ( mashSend == 0 || isBookkeeping(prop) || propertyId<Mash>(prop) == PropertyIds::Mash::notes )
       return;
    
    recalcAll();
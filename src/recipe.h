@@ -35,7 +35,9 @@ class Recipe;
 #include "BeerXMLElement.h"
 #include "hop.h" // Dammit! Have to include these for Hop::Use and Misc::Use.
 #include "misc.h"
+#include "instruction.h" // And this one for Instruction::Draft.
 #include "brewnote.h"
+#include "RecipeCalculator.h"
 
 // Forward declarations.
 //class Hop;
@@ -219,6 +221,11 @@ public:
    void insertInstruction( Instruction* ins, int pos );
    //! \brief Automagically generate a list of instructions.
    void generateInstructions();
+   /*!
+    * \brief generateInstructions() for each of \c recipes, all in one
+    * transaction. Throws whatever the database threw, after rolling back.
+    */
+   static void generateInstructions( QList<Recipe*> const& recipes );
    /*!
     * Finds the next ingredient to add that has a time
     * less than time. Changes time to be the time of the found
@@ -305,6 +312,13 @@ public:
    QList<QString> getReagents( QList<MashStep*> msteps );
    QList<QString> getReagents( QList<Hop*> hops, bool firstWort = false );
    QHash<QString,double> calcTotalPoints();
+
+   /*!
+    * \brief Takes \c calcs, worked out somewhere else from a snapshot of
+    * this recipe, as if recalcAll() had just come up with them, and saves
+    * them along with the \c fingerprint they go with.
+    */
+   void setCalcs( RecipeCalculator::Results const& calcs, QString const& fingerprint );
    
 signals:
    //! \brief Emitted when \c name() changes.
@@ -385,9 +399,6 @@ private:
    QMutex _uninitializedCalcsMutex;
    QMutex _recalcMutex;
    
-   // Batch size without losses.
-   double batchSizeNoLosses_l();
-   
    // Some recalculators for calculated properties.
    
    /* Recalculates all the calculated properties.
@@ -395,6 +406,14 @@ private:
     * WARNING: this call took 0.15s in rev 916!
     */
    void recalcAll();
+   // Stores and announces everything in \c calcs, in the order the recalc*() used to go in.
+   void applyResults( RecipeCalculator::Results const& calcs );
+   /* Loads the calculated values saved by saveCalcs(), but only if they were
+    * saved with this \b fingerprint. Returns false if they weren't.
+    */
+   bool loadCalcs(QString const& fingerprint);
+   // Saves the calculated values and the fingerprint of what they came from.
+   void saveCalcs(QString const& fingerprint);
    // Emits changed(ABV_pct). Depends on: _og, _fg
    Q_INVOKABLE void recalcABV_pct();
    // Emits changed(color_srm). Depends on: _finalVolume_l
@@ -415,17 +434,25 @@ private:
    Q_INVOKABLE void recalcCalories();
    // Emits changed(og), changed(fg). Depends on: _wortFromMash_l, _finalVolume_l
    Q_INVOKABLE void recalcOgFg();
+
+   // The recalc*() above work their numbers out with RecipeCalculator, and
+   // hand them to these to store and announce.
+   // Stores \c value in \c member and emits changed(\c prop), if it's new.
+   void applyCalc( double& member, double value, const char* prop );
+   void applyVolumes( RecipeCalculator::Volumes const& v );
+   // Also writes og and fg to the database.
+   void applyGravities( RecipeCalculator::Gravities const& g );
    
-   // Adds instructions to the recipe.
-   Instruction* postboilFermentablesIns();
-   Instruction* postboilIns();
-   Instruction* mashFermentableIns();
-   Instruction* mashWaterIns(unsigned int size);
-   Instruction* firstWortHopsIns();
-   Instruction* topOffIns();
+   // Append instructions to \c ins, if the recipe calls for them.
+   void postboilFermentablesIns(QList<Instruction::Draft>& ins);
+   void postboilIns(QList<Instruction::Draft>& ins);
+   void mashFermentableIns(QList<Instruction::Draft>& ins);
+   void mashWaterIns(QList<Instruction::Draft>& ins, unsigned int size);
+   void firstWortHopsIns(QList<Instruction::Draft>& ins);
+   void topOffIns(QList<Instruction::Draft>& ins);
    
    //void setDefaults();
-   void addPreinstructions( QVector<PreInstruction> preins );
+   void addPreinstructions( QList<Instruction::Draft>& ins, QVector<PreInstruction> preins );
    bool isValidType( const QString &str );
    
    static QHash<QString,QString> tagToProp;
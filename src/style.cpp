@@ -20,6 +20,7 @@
 
 #include "brewtarget.h"
 #include "style.h"
+#include "PropertyIds.h"
 #include <QDebug>
 
 QStringList Style::types = QStringList() << "Lager" << "Ale" << "Mead" << "Wheat" << "Mixed" << "Cider";
@@ -71,27 +72,27 @@ Style::Style()
 //==============================="SET" METHODS==================================
 void Style::setCategory( const QString& var )
 {
-   set( "category", "category", var );
+   set( PropertyIds::Style::category, "category", var );
 }
 
 void Style::setCategoryNumber( const QString& var )
 {
-   set( "categoryNumber", "category_number", var );
+   set( PropertyIds::Style::categoryNumber, "category_number", var );
 }
 
 void Style::setStyleLetter( const QString& var )
 {
-   set( "styleLetter", "style_letter", var );
+   set( PropertyIds::Style::styleLetter, "style_letter", var );
 }
 
 void Style::setStyleGuide( const QString& var )
 {
-   set( "styleGuide", "style_guide", var );
+   set( PropertyIds::Style::styleGuide, "style_guide", var );
 }
 
 void Style::setType( Type t )
 {
-   set( "type", "s_type", types.at(t) );
+   set( PropertyIds::Style::type, "s_type", types.at(t) );
 }
 
 void Style::setOgMin( double var )
@@ -100,7 +101,7 @@ void Style::setOgMin( double var )
       return;
    else
    {
-      set("ogMin", "og_min", var);
+      set(PropertyIds::Style::ogMin, "og_min", var);
    }
 }
 
@@ -110,7 +111,7 @@ void Style::setOgMax( double var )
       return;
    else
    {
-      set("ogMax", "og_max", var);
+      set(PropertyIds::Style::ogMax, "og_max", var);
    }
 }
 
@@ -120,7 +121,7 @@ void Style::setFgMin( double var )
       return;
    else
    {
-      set("fgMin", "fg_min", var);
+      set(PropertyIds::Style::fgMin, "fg_min", var);
    }
 }
 
@@ -130,7 +131,7 @@ void Style::setFgMax( double var )
       return;
    else
    {
-      set("fgMax", "fg_max", var);
+      set(PropertyIds::Style::fgMax, "fg_max", var);
    }
 }
 
@@ -140,7 +141,7 @@ void Style::setIbuMin( double var )
       return;
    else
    {
-      set("ibuMin", "ibu_min", var);
+      set(PropertyIds::Style::ibuMin, "ibu_min", var);
    }
 }
 
@@ -150,7 +151,7 @@ void Style::setIbuMax( double var )
       return;
    else
    {
-      set("ibuMax", "ibu_max", var);
+      set(PropertyIds::Style::ibuMax, "ibu_max", var);
    }
 }
 
@@ -160,7 +161,7 @@ void Style::setColorMin_srm( double var )
       return;
    else
    {
-      set("colorMin_srm", "color_min", var);
+      set(PropertyIds::Style::colorMin_srm, "color_min", var);
    }
 }
 
@@ -170,7 +171,7 @@ void Style::setColorMax_srm( double var )
       return;
    else
    {
-      set("colorMax_srm", "color_max", var);
+      set(PropertyIds::Style::colorMax_srm, "color_max", var);
    }
 }
 
@@ -180,7 +181,7 @@ void Style::setCarbMin_vol( double var )
       return;
    else
    {
-      set("carbMin_vol", "carb_min", var);
+      set(PropertyIds::Style::carbMin_vol, "carb_min", var);
    }
 }
 
@@ -190,7 +191,7 @@ void Style::setCarbMax_vol( double var )
       return;
    else
    {
-      set("carbMax_vol", "carb_max", var);
+      set(PropertyIds::Style::carbMax_vol, "carb_max", var);
    }
 }
 
@@ -200,7 +201,7 @@ void Style::setAbvMin_pct( double var )
       return;
    else
    {
-      set("abvMin_pct", "abv_min", var);
+      set(PropertyIds::Style::abvMin_pct, "abv_min", var);
    }
 }
 
@@ -210,28 +211,28 @@ void Style::setAbvMax_pct( double var )
       return;
    else
    {
-      set("abvMax_pct", "abv_max", var);
+      set(PropertyIds::Style::abvMax_pct, "abv_max", var);
    }
 }
 
 void Style::setNotes( const QString& var )
 {
-   set("notes", "notes", var);
+   set(PropertyIds::Style::notes, "notes", var);
 }
 
 void Style::setProfile( const QString& var )
 {
-   set("profile", "profile", var);
+   set(PropertyIds::Style::profile, "profile", var);
 }
 
 void Style::setIngredients( const QString& var )
 {
-   set("ingredients", "ingredients", var);
+   set(PropertyIds::Style::ingredients, "ingredients", var);
 }
 
 void Style::setExamples( const QString& var )
 {
-   set("examples", "examples", var);
+   set(PropertyIds::Style::examples, "examples", var);
 }
 
 //============================="GET" METHODS====================================
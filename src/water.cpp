@@ -19,6 +19,7 @@
 
 #include <QVector>
 #include "water.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 #include <QDomElement>
 #include <QDomText>
@@ -62,47 +63,47 @@ Water::Water()
 //================================"SET" METHODS=================================
 void Water::setAmount_l( double var )
 {
-   set("amount_l", "amount", var);
+   set(PropertyIds::Water::amount_l, "amount", var);
 }
 
 void Water::setCalcium_ppm( double var )
 {
-   set("calcium_ppm", "calcium", var);
+   set(PropertyIds::Water::calcium_ppm, "calcium", var);
 }
 
 void Water::setBicarbonate_ppm( double var )
 {
-   set("bicarbonate_ppm", "bicarbonate", var);
+   set(PropertyIds::Water::bicarbonate_ppm, "bicarbonate", var);
 }
 
 void Water::setChloride_ppm( double var )
 {
-   set("chloride_ppm", "chloride", var);
+   set(PropertyIds::Water::chloride_ppm, "chloride", var);
 }
 
 void Water::setSodium_ppm( double var )
 {
-   set("sodium_ppm", "sodium", var);
+   set(PropertyIds::Water::sodium_ppm, "sodium", var);
 }
 
 void Water::setMagnesium_ppm( double var )
 {
-   set("magnesium_ppm", "magnesium", var);
+   set(PropertyIds::Water::magnesium_ppm, "magnesium", var);
 }
 
 void Water::setPh( double var )
 {
-   set("ph", "ph", var);
+   set(PropertyIds::Water::ph, "ph", var);
 }
 
 void Water::setSulfate_ppm( double var )
 {
-   set("sulfate_ppm", "sulfate", var);
+   set(PropertyIds::Water::sulfate_ppm, "sulfate", var);
 }
 
 void Water::setNotes( const QString &var )
 {
-   set("notes", "notes", var);
+   set(PropertyIds::Water::notes, "notes", var);
 }
 
 //=========================="GET" METHODS=======================================
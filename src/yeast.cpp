@@ -25,6 +25,7 @@
 #include <QDomText>
 #include <QObject>
 #include "yeast.h"
+#include "PropertyIds.h"
 #include "brewtarget.h"
 
 QStringList Yeast::types = QStringList() << "Ale" << "Lager" << "Wheat" << "Wine" << "Champagne";
@@ -101,42 +102,57 @@ Yeast::Form Yeast::form() const { return static_cast<Yeast::Form>( forms.indexOf
 Yeast::Flocculation Yeast::flocculation() const { return static_cast<Yeast::Flocculation>( flocculations.indexOf(get("flocculation").toString())); }
 Yeast::Type Yeast::type() const { return static_cast<Yeast::Type>( types.indexOf(get("ytype").toString())); }
 const QString Yeast::typeStringTr() const
+{
+   return typeStringTr(get("ytype").toString());
+}
+
+QString Yeast::typeStringTr( QString const& type )
 {
    static QStringList typesTr = QStringList() << QObject::tr("Ale")
                                        << QObject::tr("Lager")
                                        << QObject::tr("Wheat")
                                        << QObject::tr("Wine")
                                        << QObject::tr("Champagne");
-   return typesTr.at(type());
+   return typesTr.at(types.indexOf(type));
 }
 
 const QString Yeast::formStringTr() const
+{
+   return formStringTr(get("form").toString());
+}
+
+QString Yeast::formStringTr( QString const& form )
 {
    static QStringList formsTr = QStringList() << QObject::tr("Liquid")
                                        << QObject::tr("Dry")
                                        << QObject::tr("Slant")
                                        << QObject::tr("Culture");
-   return formsTr.at(form());
+   return formsTr.at(forms.indexOf(form));
 }
 
 const QString Yeast::flocculationStringTr() const
+{
+   return flocculationStringTr(get("flocculation").toString());
+}
+
+QString Yeast::flocculationStringTr( QString const& flocculation )
 {
    static QStringList flocculationsTr = QStringList() << QObject::tr("Low")
                                                << QObject::tr("Medium")
                                                << QObject::tr("High")
                                                << QObject::tr("Very High");
-   return flocculationsTr.at(flocculation());
+   return flocculationsTr.at(flocculations.indexOf(flocculation));
 }
 
 //============================="SET" METHODS====================================
 void Yeast::setType( Yeast::Type t )
 {
-   set("type", "ytype", types.at(t));
+   set(PropertyIds::Yeast::type, "ytype", types.at(t));
 }
 
 void Yeast::setForm( Yeast::Form f )
 {
-   set("form", "form", forms.at(f));
+   set(PropertyIds::Yeast::form, "form", forms.at(f));
 }
 
 void Yeast::setAmount( double var )
@@ -144,7 +160,7 @@ void Yeast::setAmount( double var )
    if( var < 0.0 )
       Brewtarget::logW( QString("Yeast: amount < 0: %1").arg(var) );
    else
-      set("amount", "amount", var);
+      set(PropertyIds::Yeast::amount, "amount", var);
 }
 
 void Yeast::setInventoryQuanta( int var )
@@ -152,22 +168,22 @@ void Yeast::setInventoryQuanta( int var )
    if( var < 0.0 )
       Brewtarget::logW( QString("Yeast: inventory < 0: %1").arg(var) );
    else
-      setInventory("inventory", "quanta", var);
+      setInventory(PropertyIds::Yeast::inventory, "quanta", var);
 }
 
 void Yeast::setAmountIsWeight( bool var )
 {
-   set("amountIsWeight", "amount_is_weight", var);
+   set(PropertyIds::Yeast::amountIsWeight, "amount_is_weight", var);
 }
 
 void Yeast::setLaboratory( const QString& var )
 {
-   set("laboratory", "laboratory", var);
+   set(PropertyIds::Yeast::laboratory, "laboratory", var);
 }
 
 void Yeast::setProductID( const QString& var )
 {
-   set("productID", "product_id", var);
+   set(PropertyIds::Yeast::productID, "product_id", var);
 }
 
 void Yeast::setMinTemperature_c( double var )
@@ -175,7 +191,7 @@ void Yeast::setMinTemperature_c( double var )
    if( var < -273.15 )
       return;
    else
-      set("minTemperature_c", "min_temperature", var);
+      set(PropertyIds::Yeast::minTemperature_c, "min_temperature", var);
 }
 
 void Yeast::setMaxTemperature_c( double var )
@@ -183,12 +199,12 @@ void Yeast::setMaxTemperature_c( double var )
    if( var < -273.15 )
       return;
    else
-      set("maxTemperature_c", "max_temperature", var);
+      set(PropertyIds::Yeast::maxTemperature_c, "max_temperature", var);
 }
 
 void Yeast::setFlocculation( Yeast::Flocculation f )
 {
-   set("flocculation", "flocculation", flocculations.at(f));
+   set(PropertyIds::Yeast::flocculation, "flocculation", flocculations.at(f));
 }
 
 void Yeast::setAttenuation_pct( double var )
@@ -196,17 +212,17 @@ void Yeast::setAttenuation_pct( double var )
    if( var < 0.0 || var > 100.0 )
       return;
    else
-      set("attenuation", "attenuation", var);
+      set(PropertyIds::Yeast::attenuation_pct, "attenuation", var);
 }
 
 void Yeast::setNotes( const QString& var )
 {
-   set("notes", "notes", var);
+   set(PropertyIds::Yeast::notes, "notes", var);
 }
 
 void Yeast::setBestFor( const QString& var )
 {
-   set("bestFor", "best_for", var);
+   set(PropertyIds::Yeast::bestFor, "best_for", var);
 }
 
 void Yeast::setTimesCultured( int var )
@@ -214,7 +230,7 @@ void Yeast::setTimesCultured( int var )
    if( var < 0 )
       return;
    else
-      set("timesCultured", "times_cultured", var);
+      set(PropertyIds::Yeast::timesCultured, "times_cultured", var);
 }
 
 void Yeast::setMaxReuse( int var )
@@ -222,12 +238,12 @@ void Yeast::setMaxReuse( int var )
    if( var < 0 )
       return;
    else
-      set("maxReuse", "max_reuse", var);
+      set(PropertyIds::Yeast::maxReuse, "max_reuse", var);
 }
 
 void Yeast::setAddToSecondary( bool var )
 {
-   set("addToSecondary", "add_to_secondary", var);
+   set(PropertyIds::Yeast::addToSecondary, "add_to_secondary", var);
 }
 
 //========================OTHER METHODS=========================================
@@ -123,9 +123,13 @@ public:
    Type type() const;
    const QString typeString() const;
    const QString typeStringTr() const;
+   //! The translated name of what the database calls \b type
+   static QString typeStringTr( QString const& type );
    Form form() const;
    const QString formString() const;
    const QString formStringTr() const;
+   //! The translated name of what the database calls \b form
+   static QString formStringTr( QString const& form );
    double amount() const;
    int inventory() const;
    bool amountIsWeight() const;
@@ -136,6 +140,8 @@ public:
    Flocculation flocculation() const;
    const QString flocculationString() const;
    const QString flocculationStringTr() const;
+   //! The translated name of what the database calls \b flocculation
+   static QString flocculationStringTr( QString const& flocculation );
    double attenuation_pct() const;
    QString notes() const;
    QString bestFor() const;